@@ -0,0 +1,134 @@
+#include "include/BiquadFilter.hpp"
+#include <cmath>
+
+#if defined(ESP_PLATFORM) && __has_include("dsps_biquad.h")
+#include "dsps_biquad.h"
+#define BIQUAD_USE_ESP_DSP 1
+#endif
+
+BiquadCascade::BiquadCascade() : m_config(), m_dt(0.0f), m_sections(0), m_primed(false), m_section() {}
+
+bool BiquadCascade::isValid(const BiquadStageConfig& p_stage) {
+    return p_stage.type == BiquadType::NONE || (p_stage.frequencyHz > 0.0f && p_stage.q > 0.0f);
+}
+
+bool BiquadCascade::sameChain(const FilterChainConfig& p_a, const FilterChainConfig& p_b) {
+    if (p_a.stages != p_b.stages) {
+        return false;
+    }
+    for (int i = 0; i < p_a.stages; i++) {
+        if (p_a.stage[i].type != p_b.stage[i].type || p_a.stage[i].frequencyHz != p_b.stage[i].frequencyHz ||
+            p_a.stage[i].q != p_b.stage[i].q) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BiquadCascade::design(const BiquadStageConfig& p_stage, float p_dt, float (&p_coefficients)[5]) {
+    // Pass-through unless the stage is realizable at this sample rate
+    p_coefficients[0] = 1.0f;
+    p_coefficients[1] = p_coefficients[2] = p_coefficients[3] = p_coefficients[4] = 0.0f;
+    if (p_stage.type == BiquadType::NONE || !isValid(p_stage) || p_dt <= 0.0f || p_stage.frequencyHz >= 0.5f / p_dt) {
+        return;
+    }
+
+    // Bilinear transform designs from the RBJ audio EQ cookbook
+    float l_w0 = 2.0f * static_cast<float>(M_PI) * p_stage.frequencyHz * p_dt;
+    float l_cos = std::cos(l_w0);
+    float l_alpha = std::sin(l_w0) / (2.0f * p_stage.q);
+    float l_a0 = 1.0f + l_alpha;
+
+    float l_b0, l_b1, l_b2;
+    switch (p_stage.type) {
+        case BiquadType::LOW_PASS:
+            l_b0 = (1.0f - l_cos) / 2.0f;
+            l_b1 = 1.0f - l_cos;
+            l_b2 = l_b0;
+            break;
+        case BiquadType::HIGH_PASS:
+            l_b0 = (1.0f + l_cos) / 2.0f;
+            l_b1 = -(1.0f + l_cos);
+            l_b2 = l_b0;
+            break;
+        case BiquadType::NOTCH:
+        default:
+            l_b0 = 1.0f;
+            l_b1 = -2.0f * l_cos;
+            l_b2 = 1.0f;
+            break;
+    }
+    p_coefficients[0] = l_b0 / l_a0;
+    p_coefficients[1] = l_b1 / l_a0;
+    p_coefficients[2] = l_b2 / l_a0;
+    p_coefficients[3] = -2.0f * l_cos / l_a0;
+    p_coefficients[4] = (1.0f - l_alpha) / l_a0;
+}
+
+void BiquadCascade::configure(const FilterChainConfig& p_config, float p_dt) {
+    if (p_dt == m_dt && sameChain(p_config, m_config)) {
+        return;
+    }
+    bool l_sameStructure = p_config.stages == m_config.stages;
+    m_config = p_config;
+    m_dt = p_dt;
+
+    m_sections = 0;
+    for (int i = 0; i < p_config.stages && i < FilterChainConfig::MAX_STAGES; i++) {
+        design(p_config.stage[i], p_dt, m_section[m_sections].coefficients);
+        m_sections++;
+    }
+    // A retune keeps the state so the output does not step, a different stage count starts over
+    if (!l_sameStructure) {
+        m_primed = false;
+    }
+}
+
+void BiquadCascade::reset() {
+    m_primed = false;
+}
+
+void BiquadCascade::prime(float p_sample) {
+    // Settle every section on a constant input equal to the first sample instead of ringing up from zero
+    float l_input = p_sample;
+    for (int i = 0; i < m_sections; i++) {
+        const float* l_c = m_section[i].coefficients;
+        float l_state = l_input / (1.0f + l_c[3] + l_c[4]);
+        m_section[i].state[0] = m_section[i].state[1] = l_state;
+        l_input = l_state * (l_c[0] + l_c[1] + l_c[2]);
+    }
+    m_primed = true;
+}
+
+void BiquadCascade::process(float* p_samples, int p_count) {
+    if (m_sections == 0 || p_count <= 0) {
+        return;
+    }
+    if (!m_primed) {
+        prime(p_samples[0]);
+    }
+
+    // Section by section over the whole batch keeps the coefficients in registers
+    for (int i = 0; i < m_sections; i++) {
+        Section& l_section = m_section[i];
+#ifdef BIQUAD_USE_ESP_DSP
+        dsps_biquad_f32(p_samples, p_samples, p_count, l_section.coefficients, l_section.state);
+#else
+        const float* l_c = l_section.coefficients;
+        float l_w0 = l_section.state[0], l_w1 = l_section.state[1];
+        for (int n = 0; n < p_count; n++) {
+            float l_d = p_samples[n] - l_c[3] * l_w0 - l_c[4] * l_w1;
+            p_samples[n] = l_c[0] * l_d + l_c[1] * l_w0 + l_c[2] * l_w1;
+            l_w1 = l_w0;
+            l_w0 = l_d;
+        }
+        l_section.state[0] = l_w0;
+        l_section.state[1] = l_w1;
+#endif
+    }
+}
+
+float BiquadCascade::process(float p_sample) {
+    process(&p_sample, 1);
+    return p_sample;
+}
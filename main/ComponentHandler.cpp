@@ -1,27 +1,33 @@
 #include "include/ComponentHandler.hpp"
-
+#include "Include/HardwareManager.hpp"
+#include "Components/Include/MX1616HMotor.hpp"
 
 #include <algorithm>
 
 ComponentHandler::ComponentHandler() {
-    m_sensorDataQueue = xQueueCreate(10, sizeof(SensorData));
-    m_pidOutputQueue = xQueueCreate(10, sizeof(float));
-    m_motorControlQueue = xQueueCreate(10, sizeof(float));
-    m_telemetryQueue = xQueueCreate(10, sizeof(TelemetryData));
-    m_configQueue = xQueueCreate(1, sizeof(PIDConfig));
+    m_sysIdLog = std::make_unique<SysIdLog>();
+    m_telemetryRing = std::make_unique<TelemetryRing>();
+    m_flightRecorder = std::make_unique<FlightRecorder>();
+    m_udpTelemetrySender = std::make_unique<UdpTelemetrySender>();
 }
 
 esp_err_t ComponentHandler::init(IRuntimeConfig& p_runtimeConfig)  {
     ESP_LOGI(TAG, "Initializing ComponentHandler");
 
+    esp_err_t l_ret = m_mailboxes.create();
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create the control mailboxes");
+        return l_ret;
+    }
+
     m_wifiManager = std::make_unique<WiFiManager>();
-    esp_err_t l_ret = m_wifiManager->init(p_runtimeConfig);
+    l_ret = m_wifiManager->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize WiFiManager");
         return l_ret;
     }
 
-    m_webServer = std::make_unique<WebServer>();
+    m_webServer = std::make_unique<WebServer>(*m_sysIdLog, *m_flightRecorder);
     l_ret = m_webServer->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize WebServer");
@@ -35,59 +41,97 @@ esp_err_t ComponentHandler::init(IRuntimeConfig& p_runtimeConfig)  {
         return l_ret;
     }
 
-    m_sensorTask = std::make_unique<SensorTask>(*m_mpu6050Manager, m_sensorDataQueue, *m_stateMachine);
+    m_wheelOdometry = std::make_unique<WheelOdometry>(HardwareManager::instance().getEncoder(LEFT_ENCODER_ID),
+                                                      HardwareManager::instance().getEncoder(RIGHT_ENCODER_ID));
+    l_ret = m_wheelOdometry->init(p_runtimeConfig);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize WheelOdometry");
+        return l_ret;
+    }
+
+    m_sensorTask = std::make_unique<SensorTask>(*m_mpu6050Manager, *m_wheelOdometry, m_mailboxes, *m_stateMachine);
     l_ret = m_sensorTask->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize SensorTask");
         return l_ret;
     }
 
-    m_pidController = std::make_unique<PIDController>();
+    // The balance controller is chosen once at boot, switching it needs a restart
+    if (p_runtimeConfig.getControllerType() == ControllerType::LQR) {
+        ESP_LOGI(TAG, "Balancing with the LQR state feedback controller");
+        m_pidController = std::make_unique<LQRController>();
+    } else {
+        m_pidController = std::make_unique<PIDController>();
+    }
     l_ret = m_pidController->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize PIDController");
+        ESP_LOGE(TAG, "Failed to initialize balance controller");
         return l_ret;
     }
 
+    // Same controller, closed on the gyro Z rate; PIDTask loads the yaw gains
+    m_yawPidController = std::make_unique<PIDController>();
 
-    m_motorDriver = std::make_unique<MX1616H>();
-    l_ret = m_motorDriver->init(p_runtimeConfig);
+    l_ret = createMotorDriver(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize MotorDriver");
         return l_ret;
     }
 
 
-    m_configurationTask = std::make_unique<ConfigurationTask>(p_runtimeConfig, *m_webServer, m_configQueue);
+    m_configurationTask = std::make_unique<ConfigurationTask>(p_runtimeConfig, *m_webServer, m_mailboxes);
     l_ret = m_configurationTask->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize ConfigurationTask");
         return l_ret;
     }
 
-    m_stateMachine = std::make_unique<StateMachine>(m_sensorDataQueue, m_pidOutputQueue, m_motorControlQueue, m_telemetryQueue, m_configQueue);
+    m_stateMachine = std::make_unique<StateMachine>(m_mailboxes);
    
-    m_motorControlTask = std::make_unique<MotorControlTask>(*m_motorDriver, m_pidOutputQueue, *m_stateMachine);
+    m_motorControlTask = std::make_unique<MotorControlTask>(*m_motorDriver, m_mailboxes, *m_stateMachine);
         l_ret = m_motorControlTask->init(p_runtimeConfig);
         if (l_ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to initialize MotorControlTask");
             return l_ret;
         }
 
-    m_pidTask = std::make_unique<PIDTask>(*m_pidController, m_sensorDataQueue, m_pidOutputQueue, m_configQueue, *m_stateMachine);
+    m_pidTask = std::make_unique<PIDTask>(*m_pidController, *m_yawPidController, m_mailboxes, *m_sysIdLog, *m_telemetryRing,
+                                          *m_stateMachine);
     l_ret = m_pidTask->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize PIDTask");
         return l_ret;
     }
 
-    m_telemetryTask = std::make_unique<TelemetryTask>(*m_webServer, m_sensorDataQueue, m_pidOutputQueue, m_telemetryQueue);
+    // SPIFFS is mounted by the RuntimeConfig by now
+    l_ret = m_flightRecorder->init(p_runtimeConfig);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize FlightRecorder");
+        return l_ret;
+    }
+
+    // The network stack is up since the WiFiManager
+    l_ret = m_udpTelemetrySender->init(p_runtimeConfig);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize UdpTelemetrySender");
+        return l_ret;
+    }
+
+    m_telemetryTask = std::make_unique<TelemetryTask>(*m_webServer, *m_telemetryRing, *m_flightRecorder, *m_udpTelemetrySender,
+                                                      m_mailboxes.telemetry);
     l_ret = m_telemetryTask->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize TelemetryTask");
         return l_ret;
     }
 
+    m_vibrationAnalysisTask = std::make_unique<VibrationAnalysisTask>(*m_webServer, m_mailboxes.imuSample);
+    l_ret = m_vibrationAnalysisTask->init(p_runtimeConfig);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize VibrationAnalysisTask");
+        return l_ret;
+    }
+
 
     l_ret = m_stateMachine->init(p_runtimeConfig);
     if (l_ret != ESP_OK) {
@@ -98,4 +142,43 @@ esp_err_t ComponentHandler::init(IRuntimeConfig& p_runtimeConfig)  {
 
     ESP_LOGI(TAG, "ComponentHandler initialization complete");
     return ESP_OK;
+}
+
+esp_err_t ComponentHandler::createMotorDriver(const IRuntimeConfig& p_runtimeConfig) {
+    HardwareManager& l_hardware = HardwareManager::instance();
+    std::shared_ptr<IMotor> l_leftMotor;
+    std::shared_ptr<IMotor> l_rightMotor;
+
+    if (p_runtimeConfig.getMotorDriverType() == MotorDriverType::MCPWM) {
+        // Built and initialized by HardwareManager::configureMCPWM
+        l_leftMotor = l_hardware.getMCPWMMotor(LEFT_MOTOR_BRIDGE_ID);
+        l_rightMotor = l_hardware.getMCPWMMotor(RIGHT_MOTOR_BRIDGE_ID);
+        if (!l_leftMotor || !l_rightMotor) {
+            ESP_LOGE(TAG, "MCPWM motor driver selected but bridges %d and %d are not configured",
+                     LEFT_MOTOR_BRIDGE_ID, RIGHT_MOTOR_BRIDGE_ID);
+            return ESP_ERR_NOT_FOUND;
+        }
+        ESP_LOGI(TAG, "Using the MCPWM motor driver");
+    } else {
+        l_leftMotor = std::make_shared<MX1616HMotor>(l_hardware.getLEDCChannel(MOTOR_SPEED_MODE, LEFT_MOTOR_IN1),
+                                                     l_hardware.getLEDCChannel(MOTOR_SPEED_MODE, LEFT_MOTOR_IN2));
+        l_rightMotor = std::make_shared<MX1616HMotor>(l_hardware.getLEDCChannel(MOTOR_SPEED_MODE, RIGHT_MOTOR_IN1),
+                                                      l_hardware.getLEDCChannel(MOTOR_SPEED_MODE, RIGHT_MOTOR_IN2));
+
+        esp_err_t l_ret = l_leftMotor->init();
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize left motor");
+            return l_ret;
+        }
+
+        l_ret = l_rightMotor->init();
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize right motor");
+            return l_ret;
+        }
+        ESP_LOGI(TAG, "Using the LEDC motor driver");
+    }
+
+    m_motorDriver = std::make_unique<DifferentialDrive>(l_leftMotor, l_rightMotor);
+    return m_motorDriver->init(p_runtimeConfig);
 }
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "include/ConfigurationTask.hpp"
+#include "include/LoopPeriod.hpp"
 
 #include "interfaces/IRuntimeConfig.hpp"
 #include "interfaces/IWebServer.hpp"
 
-ConfigurationTask::ConfigurationTask(IRuntimeConfig& p_config, IWebServer& p_server, QueueHandle_t p_configQueue)
-    : m_runtimeConfig(p_config), m_webServer(p_server), m_configUpdateQueue(p_configQueue), m_taskHandle(nullptr) {}
+ConfigurationTask::ConfigurationTask(IRuntimeConfig& p_config, IWebServer& p_server, const ControlMailboxes& p_mailboxes)
+    : m_runtimeConfig(p_config), m_webServer(p_server), m_mailboxes(p_mailboxes), m_taskHandle(nullptr) {}
 
 ConfigurationTask::~ConfigurationTask() {
     if (m_taskHandle != nullptr) {
@@ -13,6 +14,10 @@ ConfigurationTask::~ConfigurationTask() {
 }
 
 esp_err_t ConfigurationTask::init(const IRuntimeConfig&) {
+    broadcastLoopPeriod();
+    broadcastFilterBank();
+    broadcastMotorShaping();
+
     BaseType_t result = xTaskCreate(
         taskFunction,
         TAG,
@@ -38,18 +43,29 @@ void ConfigurationTask::run() {
 
     while (true) {
         PIDConfig update;
-        if (xQueueReceive(m_configUpdateQueue, &update, 0) == pdTRUE) {
+        if (xQueueReceive(m_mailboxes.config, &update, 0) == pdTRUE) {
             applyConfigUpdate(update);
         }
 
         // Check for configuration requests from WebServer
         if (m_webServer.hasConfigurationRequest()) {
-            PIDConfig webUpdate = m_webServer.getConfigurationRequest();
+            std::string webUpdate = m_webServer.getConfigurationRequest();
             applyConfigUpdate(webUpdate);
         }
 
+        handleAutoTune();
+        handleSysId();
+
         // Periodically broadcast current configuration
         broadcastConfig();
+        broadcastYawConfig();
+        broadcastLQRConfig();
+        broadcastGainSchedule();
+        broadcastVelocityLoop();
+        broadcastPredictor();
+        broadcastFilterBank();
+        broadcastLoopPeriod();
+        broadcastMotorShaping();
 
         vTaskDelayUntil(&lastWakeTime, CHECK_PERIOD);
     }
@@ -75,10 +91,138 @@ void ConfigurationTask::applyConfigUpdate(const PIDConfig& update) {
     m_webServer.notifyConfigurationUpdated();
 }
 
+void ConfigurationTask::applyConfigUpdate(const std::string& p_json) {
+    ESP_LOGI(TAG, "Applying configuration update from web request");
+
+    // The only parse of the request, the WebServer queues it unchecked. Partial documents only
+    // touch the keys they contain.
+    esp_err_t ret = m_runtimeConfig.fromJson(p_json);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Rejected configuration update: %s", esp_err_to_name(ret));
+        m_webServer.notifyConfigurationResult(ret);
+        return;
+    }
+
+    int l_intervalMs = m_runtimeConfig.getMainLoopIntervalMs();
+    int l_clampedIntervalMs = LoopPeriod::clampIntervalMs(l_intervalMs);
+    if (l_clampedIntervalMs != l_intervalMs) {
+        ESP_LOGW(TAG, "Main loop interval clamped from %d ms to %d ms", l_intervalMs, l_clampedIntervalMs);
+        m_runtimeConfig.setMainLoopIntervalMs(l_clampedIntervalMs);
+    }
+
+    ret = m_runtimeConfig.save();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save updated configuration: %s", esp_err_to_name(ret));
+    }
+
+    broadcastConfig();
+    broadcastYawConfig();
+    broadcastLQRConfig();
+    broadcastGainSchedule();
+    broadcastVelocityLoop();
+    broadcastPredictor();
+    broadcastFilterBank();
+    broadcastLoopPeriod();
+    broadcastMotorShaping();
+
+    m_webServer.notifyConfigurationResult(ESP_OK);
+    m_webServer.notifyConfigurationUpdated();
+}
+
+void ConfigurationTask::handleAutoTune() {
+    if (m_webServer.hasAutoTuneRequest()) {
+        AutoTuneRequest request = m_webServer.getAutoTuneRequest();
+        request.baseConfig = m_runtimeConfig.getPidConfig();
+        if (xQueueOverwrite(m_mailboxes.autoTune, &request) != pdTRUE) {
+            ESP_LOGW(TAG, "Failed to forward auto-tune request");
+        }
+    }
+
+    PIDConfig tuned;
+    if (xQueueReceive(m_mailboxes.autoTuneResult, &tuned, 0) == pdTRUE) {
+        ESP_LOGI(TAG, "Persisting auto-tuned gains - Kp: %.4f, Ki: %.4f, Kd: %.4f", tuned.kp, tuned.ki, tuned.kd);
+        applyConfigUpdate(tuned);
+    }
+}
+
+void ConfigurationTask::handleSysId() {
+    if (m_webServer.hasSysIdRequest()) {
+        SysIdRequest request = m_webServer.getSysIdRequest();
+        if (xQueueOverwrite(m_mailboxes.sysId, &request) != pdTRUE) {
+            ESP_LOGW(TAG, "Failed to forward identification request");
+        }
+    }
+}
+
+void ConfigurationTask::broadcastLoopPeriod() {
+    int l_intervalMs = LoopPeriod::clampIntervalMs(m_runtimeConfig.getMainLoopIntervalMs());
+
+    // Single-slot mailbox, tasks peek it at their cycle boundary
+    if (xQueueOverwrite(m_mailboxes.loopPeriod, &l_intervalMs) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast loop period update");
+    }
+}
+
+void ConfigurationTask::broadcastMotorShaping() {
+    MotorShapingConfig l_config = m_runtimeConfig.getMotorShapingConfig();
+
+    if (xQueueOverwrite(m_mailboxes.motorShaping, &l_config) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast motor shaping update");
+    }
+}
+
 void ConfigurationTask::broadcastConfig() {
     PIDConfig l_currentConfig = m_runtimeConfig.getPidConfig();
 
-    if (xQueueOverwrite(m_configUpdateQueue, &l_currentConfig) != pdTRUE) {
+    if (xQueueOverwrite(m_mailboxes.config, &l_currentConfig) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to broadcast configuration update");
     }
+}
+
+void ConfigurationTask::broadcastYawConfig() {
+    PIDConfig l_yawConfig = m_runtimeConfig.getYawPidConfig();
+
+    if (xQueueOverwrite(m_mailboxes.yawConfig, &l_yawConfig) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast yaw configuration update");
+    }
+}
+
+void ConfigurationTask::broadcastLQRConfig() {
+    LQRConfig l_gains = m_runtimeConfig.getLQRConfig();
+
+    if (xQueueOverwrite(m_mailboxes.lqrConfig, &l_gains) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast LQR gains update");
+    }
+}
+
+void ConfigurationTask::broadcastGainSchedule() {
+    GainScheduleConfig l_schedule = m_runtimeConfig.getGainScheduleConfig();
+
+    if (xQueueOverwrite(m_mailboxes.gainSchedule, &l_schedule) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast gain schedule update");
+    }
+}
+
+void ConfigurationTask::broadcastVelocityLoop() {
+    VelocityLoopConfig l_config = m_runtimeConfig.getVelocityLoopConfig();
+
+    if (xQueueOverwrite(m_mailboxes.velocityLoop, &l_config) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast velocity loop update");
+    }
+}
+
+void ConfigurationTask::broadcastPredictor() {
+    PredictorConfig l_config = m_runtimeConfig.getPredictorConfig();
+
+    if (xQueueOverwrite(m_mailboxes.predictor, &l_config) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast pitch predictor update");
+    }
+}
+
+void ConfigurationTask::broadcastFilterBank() {
+    FilterBankConfig l_config = m_runtimeConfig.getFilterBankConfig();
+
+    if (xQueueOverwrite(m_mailboxes.filterBank, &l_config) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to broadcast filter bank update");
+    }
 }
\ No newline at end of file
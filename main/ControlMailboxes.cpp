@@ -0,0 +1,33 @@
+#include "include/ControlMailboxes.hpp"
+
+esp_err_t ControlMailboxes::create() {
+    sensorData = xQueueCreate(10, sizeof(SensorData));
+    pidOutput = xQueueCreate(10, sizeof(PIDOutput));
+    motorControl = xQueueCreate(10, sizeof(float));
+    telemetry = xQueueCreate(10, sizeof(TelemetryData));
+    config = xQueueCreate(1, sizeof(PIDConfig));
+    yawConfig = xQueueCreate(1, sizeof(PIDConfig));
+    lqrConfig = xQueueCreate(1, sizeof(LQRConfig));
+    gainSchedule = xQueueCreate(1, sizeof(GainScheduleConfig));
+    velocityLoop = xQueueCreate(1, sizeof(VelocityLoopConfig));
+    predictor = xQueueCreate(1, sizeof(PredictorConfig));
+    filterBank = xQueueCreate(1, sizeof(FilterBankConfig));
+    imuSample = xQueueCreate(32, sizeof(ImuSample));
+    motorFeedback = xQueueCreate(1, sizeof(MotorFeedback));
+    loopPeriod = xQueueCreate(1, sizeof(int));
+    motorShaping = xQueueCreate(1, sizeof(MotorShapingConfig));
+    autoTune = xQueueCreate(1, sizeof(AutoTuneRequest));
+    autoTuneResult = xQueueCreate(1, sizeof(PIDConfig));
+    sysId = xQueueCreate(1, sizeof(SysIdRequest));
+
+    const QueueHandle_t l_queues[] = {
+        sensorData, pidOutput, motorControl, telemetry, config, yawConfig, lqrConfig, gainSchedule, velocityLoop,
+        predictor, filterBank, imuSample, motorFeedback, loopPeriod, motorShaping, autoTune, autoTuneResult, sysId
+    };
+    for (QueueHandle_t l_queue : l_queues) {
+        if (l_queue == nullptr) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,46 @@
+#include "include/DifferentialDrive.hpp"
+#include "Components/Include/MotorGroup.hpp"
+#include <algorithm>
+#include <cmath>
+
+DifferentialDrive::DifferentialDrive(std::shared_ptr<IMotor> p_left, std::shared_ptr<IMotor> p_right)
+    : m_wheels(std::make_unique<MotorGroup>(std::vector<std::shared_ptr<IMotor>>{p_left, p_right})) {}
+
+DifferentialDrive::~DifferentialDrive() = default;
+
+esp_err_t DifferentialDrive::init(const IRuntimeConfig&) {
+    ESP_LOGI(TAG, "Initializing DifferentialDrive");
+
+    esp_err_t l_ret = m_wheels->init();
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize wheel motors: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = m_wheels->setSpeed(0.0f);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to stop wheel motors: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    ESP_LOGI(TAG, "DifferentialDrive initialized successfully");
+    return ESP_OK;
+}
+
+esp_err_t DifferentialDrive::setSpeed(float p_speed) {
+    return m_wheels->setSpeed(p_speed);
+}
+
+esp_err_t DifferentialDrive::setSpeed(float p_left, float p_right) {
+    const float l_speeds[] = {p_left, p_right};
+    return m_wheels->setSpeeds(l_speeds, 2);
+}
+
+void DifferentialDrive::mix(float p_balance, float p_turn, float& p_left, float& p_right) {
+    float l_balance = std::clamp(p_balance, -1.0f, 1.0f);
+    float l_headroom = 1.0f - std::abs(l_balance);
+    float l_turn = std::clamp(p_turn, -l_headroom, l_headroom);
+
+    p_left = l_balance - l_turn;
+    p_right = l_balance + l_turn;
+}
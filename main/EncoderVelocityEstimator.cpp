@@ -0,0 +1,88 @@
+#include "include/EncoderVelocityEstimator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+EncoderVelocityEstimator::EncoderVelocityEstimator()
+    : m_radiansPerCount(0.0f), m_originCount(0), m_lastCount(0), m_lastTimeUs(0), m_edges(), m_edgeHead(0), m_edgeCount(0),
+      m_countMethod(false), m_velocity(0.0f) {}
+
+void EncoderVelocityEstimator::setCountsPerRevolution(int p_countsPerRevolution) {
+    m_radiansPerCount = p_countsPerRevolution > 0 ? 2.0f * static_cast<float>(M_PI) / p_countsPerRevolution : 0.0f;
+}
+
+void EncoderVelocityEstimator::reset(int32_t p_count, int64_t p_timeUs) {
+    m_originCount = p_count;
+    m_lastCount = p_count;
+    m_lastTimeUs = p_timeUs;
+    m_edgeCount = 0;
+    pushEdge(p_count, p_timeUs);
+    m_countMethod = false;
+    m_velocity = 0.0f;
+}
+
+float EncoderVelocityEstimator::update(int32_t p_count, int64_t p_timeUs) {
+    int32_t l_delta = p_count - m_lastCount;
+
+    if (l_delta != 0) {
+        // Count method over the last cycle at speed, period method back over earlier edges when slow.
+        // Chosen on the previous estimate with a count of hysteresis: choosing on this cycle's count
+        // would take the count method whenever the quantization rounds up, and read fast on average.
+        int32_t l_counts = l_delta;
+        int64_t l_windowUs = p_timeUs - m_lastTimeUs;
+        float l_expectedCounts = std::abs(m_velocity) * (l_windowUs * 1e-6f) / m_radiansPerCount;
+        if (l_expectedCounts >= COUNT_METHOD_THRESHOLD || std::abs(l_delta) >= 2 * COUNT_METHOD_THRESHOLD) {
+            m_countMethod = true;
+        } else if (l_expectedCounts < COUNT_METHOD_THRESHOLD - 1) {
+            m_countMethod = false;
+        }
+        if (!m_countMethod) {
+            const Edge& l_start = periodStart(p_timeUs);
+            l_counts = p_count - l_start.count;
+            l_windowUs = p_timeUs - l_start.timeUs;
+        }
+        if (l_windowUs > 0) {
+            m_velocity = l_counts * m_radiansPerCount / (l_windowUs * 1e-6f);
+        }
+        pushEdge(p_count, p_timeUs);
+    } else {
+        int64_t l_sinceEdgeUs = p_timeUs - lastEdge().timeUs;
+        if (l_sinceEdgeUs >= STOP_TIMEOUT_US) {
+            m_velocity = 0.0f;
+        } else if (l_sinceEdgeUs > 0) {
+            float l_bound = m_radiansPerCount / (l_sinceEdgeUs * 1e-6f);
+            if (std::abs(m_velocity) > l_bound) {
+                m_velocity = std::copysign(l_bound, m_velocity);
+            }
+        }
+    }
+
+    m_lastCount = p_count;
+    m_lastTimeUs = p_timeUs;
+    return m_velocity;
+}
+
+float EncoderVelocityEstimator::getAngle() const {
+    return (m_lastCount - m_originCount) * m_radiansPerCount;
+}
+
+void EncoderVelocityEstimator::pushEdge(int32_t p_count, int64_t p_timeUs) {
+    m_edgeHead = (m_edgeHead + 1) % EDGE_HISTORY;
+    m_edges[m_edgeHead] = {p_count, p_timeUs};
+    m_edgeCount = std::min(m_edgeCount + 1, EDGE_HISTORY);
+}
+
+const EncoderVelocityEstimator::Edge& EncoderVelocityEstimator::periodStart(int64_t p_timeUs) const {
+    // A fixed number of edges back rather than until enough counts: stopping on the count picks
+    // the shortest windows and reads fast. An edge from before a standstill would drag a wheel
+    // that starts again towards zero, the previous edge is used whatever its age.
+    int l_index = m_edgeHead;
+    for (int i = 1; i < m_edgeCount; i++) {
+        int l_older = (l_index + EDGE_HISTORY - 1) % EDGE_HISTORY;
+        if (p_timeUs - m_edges[l_older].timeUs >= STOP_TIMEOUT_US) {
+            break;
+        }
+        l_index = l_older;
+    }
+    return m_edges[l_index];
+}
@@ -0,0 +1,221 @@
+#include "include/FlightRecorder.hpp"
+#include "interfaces/IStateMachine.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr const char* DUMP_PREFIX = "fall_";
+constexpr const char* DUMP_SUFFIX = ".bbx";
+constexpr int MAX_LISTED = 16;
+
+constexpr uint8_t BALANCING = static_cast<uint8_t>(IStateMachine::State::BALANCING);
+constexpr uint8_t FALLING = static_cast<uint8_t>(IStateMachine::State::FALLING);
+
+}  // namespace
+
+FlightRecorder::FlightRecorder()
+    : m_taskHandle(nullptr), m_frozen(false), m_triggered(false), m_triggerTimestamp(0), m_triggerIndex(0),
+      m_lastState(0), m_next(0), m_count(0), m_nextId(0) {}
+
+FlightRecorder::~FlightRecorder() {
+    if (m_taskHandle != nullptr) {
+        vTaskDelete(m_taskHandle);
+    }
+}
+
+esp_err_t FlightRecorder::init(const IRuntimeConfig&) {
+    m_nextId = findNextId();
+
+    // Left behind by a reset in the middle of a dump
+    char l_path[MAX_PATH];
+    snprintf(l_path, sizeof(l_path), "%s/fall.tmp", DIRECTORY);
+    remove(l_path);
+
+    BaseType_t result = xTaskCreate(
+        taskFunction,
+        TAG,
+        STACK_SIZE,
+        this,
+        PRIORITY,
+        &m_taskHandle
+    );
+
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create FlightRecorder task");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void FlightRecorder::taskFunction(void* pvParameters) {
+    auto* recorder = static_cast<FlightRecorder*>(pvParameters);
+    recorder->run();
+}
+
+void FlightRecorder::run() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (writeDump() != ESP_OK) {
+            ESP_LOGE(TAG, "Fall not recorded");
+        }
+        // The next dump starts from scratch, record() waits for the state to go back to BALANCING
+        m_triggered = false;
+        m_count = 0;
+        m_frozen.store(false, std::memory_order_release);
+    }
+}
+
+void FlightRecorder::record(const TelemetryData& p_record) {
+    if (m_frozen.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Stored encoded, half precision is plenty for a post-mortem at half the size of a TelemetryData
+    TelemetryCodec::encode(toTelemetryFrame(p_record), true, m_frames[m_next], FRAME_SIZE);
+
+    if (!m_triggered && m_lastState == BALANCING && p_record.state == FALLING) {
+        m_triggered = true;
+        m_triggerTimestamp = p_record.sensorData.timestamp;
+        m_triggerIndex = m_next;
+    }
+    m_lastState = p_record.state;
+    m_next = (m_next + 1) % CAPACITY;
+    m_count = std::min(m_count + 1, CAPACITY);
+
+    if (m_triggered && m_taskHandle != nullptr &&
+        p_record.sensorData.timestamp - m_triggerTimestamp >= POST_TRIGGER_US) {
+        m_frozen.store(true, std::memory_order_release);
+        xTaskNotifyGive(m_taskHandle);
+    }
+}
+
+esp_err_t FlightRecorder::writeDump() {
+    int l_oldest = (m_next - m_count + CAPACITY) % CAPACITY;
+
+    FlightRecordingHeader l_header;
+    l_header.frameSize = FRAME_SIZE;
+    l_header.frameCount = m_count;
+    l_header.triggerIndex = (m_triggerIndex - l_oldest + CAPACITY) % CAPACITY;
+    uint8_t l_headerBytes[FlightRecording::HEADER_SIZE];
+    FlightRecording::encodeHeader(l_header, l_headerBytes, sizeof(l_headerBytes));
+
+    removeOldDumps(sizeof(l_headerBytes) + m_count * FRAME_SIZE);
+
+    // Written under a temporary name, a half written file never shows up in the list
+    char l_tempPath[MAX_PATH];
+    char l_path[MAX_PATH];
+    snprintf(l_tempPath, sizeof(l_tempPath), "%s/fall.tmp", DIRECTORY);
+    snprintf(l_path, sizeof(l_path), "%s/%s%u%s", DIRECTORY, DUMP_PREFIX, static_cast<unsigned>(m_nextId), DUMP_SUFFIX);
+
+    FILE* l_file = fopen(l_tempPath, "wb");
+    if (l_file == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s", l_tempPath);
+        return ESP_FAIL;
+    }
+    // Straight from the buffer in at most two pieces, the ring wraps once
+    size_t l_first = std::min(m_count, CAPACITY - l_oldest);
+    size_t l_second = m_count - l_first;
+    bool l_ok = fwrite(l_headerBytes, sizeof(l_headerBytes), 1, l_file) == 1;
+    l_ok = l_ok && fwrite(m_frames[l_oldest], FRAME_SIZE, l_first, l_file) == l_first;
+    l_ok = l_ok && fwrite(m_frames[0], FRAME_SIZE, l_second, l_file) == l_second;
+    l_ok = fclose(l_file) == 0 && l_ok;
+
+    if (!l_ok || rename(l_tempPath, l_path) != 0) {
+        ESP_LOGE(TAG, "Failed to write %s", l_path);
+        remove(l_tempPath);
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Fall recorded to %s, %d cycles", l_path, m_count);
+    m_nextId++;
+    return ESP_OK;
+}
+
+void FlightRecorder::removeOldDumps(size_t p_needed) {
+    DumpInfo l_dumps[MAX_LISTED];
+    int l_count = listDumps(l_dumps, MAX_LISTED);
+
+    // Oldest first, until the new dump is within MAX_DUMPS and fits
+    for (int i = l_count - 1; i >= 0; i--) {
+        size_t l_total = 0;
+        size_t l_used = 0;
+        bool l_full = esp_spiffs_info(PARTITION, &l_total, &l_used) == ESP_OK && l_total - l_used < p_needed;
+        if (i < MAX_DUMPS - 1 && !l_full) {
+            break;
+        }
+        char l_path[MAX_PATH];
+        getDumpPath(l_dumps[i].id, l_path, sizeof(l_path));
+        if (remove(l_path) == 0) {
+            ESP_LOGI(TAG, "Removed %s", l_path);
+        }
+    }
+}
+
+int FlightRecorder::listDumps(DumpInfo* p_dumps, int p_max) const {
+    DIR* l_dir = opendir(DIRECTORY);
+    if (l_dir == nullptr) {
+        ESP_LOGE(TAG, "Failed to open directory %s", DIRECTORY);
+        return 0;
+    }
+
+    int l_count = 0;
+    struct dirent* l_entry;
+    while ((l_entry = readdir(l_dir)) != nullptr) {
+        uint32_t l_id;
+        if (!parseDumpName(l_entry->d_name, l_id)) {
+            continue;
+        }
+        char l_path[MAX_PATH];
+        snprintf(l_path, sizeof(l_path), "%s/%s", DIRECTORY, l_entry->d_name);
+        struct stat l_stat;
+        DumpInfo l_dump { l_id, stat(l_path, &l_stat) == 0 ? static_cast<size_t>(l_stat.st_size) : 0 };
+
+        // Insertion into the newest first list, the oldest falls off the end
+        int l_position = l_count;
+        while (l_position > 0 && p_dumps[l_position - 1].id < l_id) {
+            l_position--;
+        }
+        if (l_position >= p_max) {
+            continue;
+        }
+        int l_last = std::min(l_count, p_max - 1);
+        for (int i = l_last; i > l_position; i--) {
+            p_dumps[i] = p_dumps[i - 1];
+        }
+        p_dumps[l_position] = l_dump;
+        l_count = std::min(l_count + 1, p_max);
+    }
+    closedir(l_dir);
+    return l_count;
+}
+
+bool FlightRecorder::getDumpPath(uint32_t p_id, char* p_path, size_t p_size) const {
+    snprintf(p_path, p_size, "%s/%s%u%s", DIRECTORY, DUMP_PREFIX, static_cast<unsigned>(p_id), DUMP_SUFFIX);
+    struct stat l_stat;
+    return stat(p_path, &l_stat) == 0;
+}
+
+uint32_t FlightRecorder::findNextId() const {
+    DumpInfo l_newest;
+    return listDumps(&l_newest, 1) > 0 ? l_newest.id + 1 : 0;
+}
+
+bool FlightRecorder::parseDumpName(const char* p_name, uint32_t& p_id) {
+    size_t l_prefixLength = strlen(DUMP_PREFIX);
+    if (strncmp(p_name, DUMP_PREFIX, l_prefixLength) != 0 || !isdigit(static_cast<unsigned char>(p_name[l_prefixLength]))) {
+        return false;
+    }
+    char* l_end;
+    unsigned long l_id = strtoul(p_name + l_prefixLength, &l_end, 10);
+    if (strcmp(l_end, DUMP_SUFFIX) != 0) {
+        return false;
+    }
+    p_id = static_cast<uint32_t>(l_id);
+    return true;
+}
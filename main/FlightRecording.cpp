@@ -0,0 +1,219 @@
+#include "include/FlightRecording.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+void putU16(uint8_t* p_buffer, uint16_t p_value) {
+    p_buffer[0] = static_cast<uint8_t>(p_value);
+    p_buffer[1] = static_cast<uint8_t>(p_value >> 8);
+}
+
+void putU32(uint8_t* p_buffer, uint32_t p_value) {
+    for (int i = 0; i < 4; i++) p_buffer[i] = static_cast<uint8_t>(p_value >> (8 * i));
+}
+
+uint16_t getU16(const uint8_t* p_buffer) {
+    return static_cast<uint16_t>(p_buffer[0] | (p_buffer[1] << 8));
+}
+
+uint32_t getU32(const uint8_t* p_buffer) {
+    uint32_t l_value = 0;
+    for (int i = 0; i < 4; i++) l_value |= static_cast<uint32_t>(p_buffer[i]) << (8 * i);
+    return l_value;
+}
+
+}  // namespace
+
+size_t FlightRecording::encodeHeader(const FlightRecordingHeader& p_header, uint8_t* p_buffer, size_t p_size) {
+    if (p_size < HEADER_SIZE) {
+        return 0;
+    }
+    putU32(p_buffer, MAGIC);
+    putU16(p_buffer + 4, HEADER_SIZE);
+    putU16(p_buffer + 6, p_header.frameSize);
+    putU32(p_buffer + 8, p_header.frameCount);
+    putU32(p_buffer + 12, p_header.triggerIndex);
+    return HEADER_SIZE;
+}
+
+bool FlightRecording::decodeHeader(const uint8_t* p_buffer, size_t p_length, FlightRecordingHeader& p_header) {
+    if (p_length < HEADER_SIZE || getU32(p_buffer) != MAGIC) {
+        return false;
+    }
+    p_header.headerSize = getU16(p_buffer + 4);
+    p_header.frameSize = getU16(p_buffer + 6);
+    p_header.frameCount = getU32(p_buffer + 8);
+    p_header.triggerIndex = getU32(p_buffer + 12);
+    return p_header.headerSize >= HEADER_SIZE && p_header.frameSize >= TelemetryCodec::HEADER_SIZE;
+}
+
+FlightRecordingExport::FlightRecordingExport(Format p_format, Source p_source, void* p_context)
+    : m_format(p_format), m_source(p_source), m_context(p_context), m_header(), m_frameCount(0), m_size(0),
+      m_offset(0), m_failed(false), m_headerLineLength(0), m_blockFirst(0), m_blockCount(0), m_rowIndex(UINT32_MAX) {
+    m_headerLine[0] = '\0';
+}
+
+bool FlightRecordingExport::open(uint32_t p_fileSize) {
+    uint8_t l_bytes[FlightRecording::HEADER_SIZE];
+    if (p_fileSize < FlightRecording::HEADER_SIZE || !m_source(m_context, 0, l_bytes, sizeof(l_bytes)) ||
+        !FlightRecording::decodeHeader(l_bytes, sizeof(l_bytes), m_header)) {
+        return false;
+    }
+    // A dump cut short by a reset still exports the frames that made it
+    uint32_t l_stored = p_fileSize >= m_header.headerSize ? (p_fileSize - m_header.headerSize) / m_header.frameSize : 0;
+    m_frameCount = m_header.frameCount < l_stored ? m_header.frameCount : l_stored;
+
+    if (m_format == Format::BINARY) {
+        m_size = m_header.headerSize + m_frameCount * m_header.frameSize;
+        return true;
+    }
+
+    // Fields beyond the block slot are never looked at, but a frame must fit in it
+    if (m_header.frameSize > TelemetryCodec::MAX_SIZE) {
+        return false;
+    }
+    int l_length = snprintf(m_headerLine, sizeof(m_headerLine), "sequence,state,timestamp_us,trigger");
+    for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+        l_length += snprintf(m_headerLine + l_length, sizeof(m_headerLine) - l_length, ",%s", TelemetryCodec::fieldName(i));
+    }
+    l_length += snprintf(m_headerLine + l_length, sizeof(m_headerLine) - l_length, "\n");
+    m_headerLineLength = l_length;
+    m_size = m_headerLineLength + m_frameCount * CSV_ROW_SIZE;
+    return true;
+}
+
+bool FlightRecordingExport::seek(uint32_t p_offset) {
+    if (p_offset > m_size) {
+        return false;
+    }
+    m_offset = p_offset;
+    return true;
+}
+
+size_t FlightRecordingExport::read(char* p_buffer, size_t p_size) {
+    size_t l_total = 0;
+    while (!m_failed && l_total < p_size && m_offset < m_size) {
+        size_t l_wanted = p_size - l_total;
+        if (m_size - m_offset < l_wanted) {
+            l_wanted = m_size - m_offset;
+        }
+
+        if (m_format == Format::BINARY) {
+            // The file as it is, nothing to transcode
+            if (!m_source(m_context, m_offset, reinterpret_cast<uint8_t*>(p_buffer + l_total), l_wanted)) {
+                m_failed = true;
+                break;
+            }
+            l_total += l_wanted;
+            m_offset += l_wanted;
+            continue;
+        }
+
+        const char* l_text;
+        size_t l_available;
+        if (m_offset < m_headerLineLength) {
+            l_text = m_headerLine + m_offset;
+            l_available = m_headerLineLength - m_offset;
+        } else {
+            uint32_t l_position = m_offset - m_headerLineLength;
+            uint32_t l_index = l_position / CSV_ROW_SIZE;
+            if (!loadRow(l_index)) {
+                m_failed = true;
+                break;
+            }
+            uint32_t l_column = l_position - l_index * CSV_ROW_SIZE;
+            l_text = m_row + l_column;
+            l_available = CSV_ROW_SIZE - l_column;
+        }
+        size_t l_count = l_available < l_wanted ? l_available : l_wanted;
+        memcpy(p_buffer + l_total, l_text, l_count);
+        l_total += l_count;
+        m_offset += l_count;
+    }
+    return l_total;
+}
+
+bool FlightRecordingExport::loadRow(uint32_t p_index) {
+    if (p_index == m_rowIndex) {
+        return true;
+    }
+    if (p_index < m_blockFirst || p_index >= m_blockFirst + m_blockCount) {
+        uint32_t l_count = m_frameCount - p_index < BLOCK_FRAMES ? m_frameCount - p_index : BLOCK_FRAMES;
+        if (!m_source(m_context, m_header.headerSize + p_index * m_header.frameSize, m_block, l_count * m_header.frameSize)) {
+            return false;
+        }
+        m_blockFirst = p_index;
+        m_blockCount = l_count;
+    }
+
+    TelemetryFrame l_frame;
+    if (!TelemetryCodec::decode(m_block + (p_index - m_blockFirst) * m_header.frameSize, m_header.frameSize, l_frame)) {
+        return false;
+    }
+
+    // Fixed widths: a u32 takes 10 digits, a u8 3, an i64 20 with its sign, and every value 10
+    int l_length = snprintf(m_row, sizeof(m_row), "%10u,%3u,%20lld,%d", static_cast<unsigned>(l_frame.sequence),
+                            static_cast<unsigned>(l_frame.state), static_cast<long long>(l_frame.timestamp),
+                            p_index == m_header.triggerIndex ? 1 : 0);
+    for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+        float l_value = l_frame.values[i];
+        char* l_cell = m_row + l_length;
+        size_t l_space = sizeof(m_row) - l_length;
+        if (!std::isfinite(l_value)) {
+            l_length += snprintf(l_cell, l_space, ",%10s", std::isnan(l_value) ? "nan" : (l_value > 0 ? "inf" : "-inf"));
+        } else if (std::fabs(l_value) < 1e5f) {
+            // Every half precision value, at most "-65504.000"
+            l_length += snprintf(l_cell, l_space, ",%10.3f", l_value);
+        } else {
+            l_length += snprintf(l_cell, l_space, ",%10.3e", l_value);
+        }
+    }
+    l_length += snprintf(m_row + l_length, sizeof(m_row) - l_length, "\n");
+    if (l_length != static_cast<int>(CSV_ROW_SIZE)) {
+        return false;
+    }
+    m_rowIndex = p_index;
+    return true;
+}
+
+bool FlightRecordingExport::parseRange(const char* p_value, uint32_t p_size, uint32_t& p_first, uint32_t& p_last) {
+    const char* l_prefix = "bytes=";
+    if (strncmp(p_value, l_prefix, strlen(l_prefix)) != 0 || p_size == 0) {
+        return false;
+    }
+    const char* l_text = p_value + strlen(l_prefix);
+    char* l_end;
+
+    if (*l_text == '-') {
+        // The last bytes, a resume from the end
+        unsigned long l_suffix = strtoul(l_text + 1, &l_end, 10);
+        if (l_end == l_text + 1 || *l_end != '\0' || l_suffix == 0) {
+            return false;
+        }
+        p_first = l_suffix < p_size ? p_size - static_cast<uint32_t>(l_suffix) : 0;
+        p_last = p_size - 1;
+        return true;
+    }
+
+    unsigned long l_first = strtoul(l_text, &l_end, 10);
+    if (l_end == l_text || *l_end != '-' || l_first >= p_size) {
+        return false;
+    }
+    l_text = l_end + 1;
+    unsigned long l_last = p_size - 1;
+    if (*l_text != '\0') {
+        l_last = strtoul(l_text, &l_end, 10);
+        if (*l_end != '\0' || l_last < l_first) {
+            return false;
+        }
+        if (l_last >= p_size) {
+            l_last = p_size - 1;
+        }
+    }
+    p_first = static_cast<uint32_t>(l_first);
+    p_last = static_cast<uint32_t>(l_last);
+    return true;
+}
@@ -0,0 +1,74 @@
+#include "include/GainSchedule.hpp"
+#include <cmath>
+
+GainSchedule::GainSchedule() : m_config() {}
+
+bool GainSchedule::isValid(const GainScheduleConfig& p_config) {
+    if (p_config.errorPoints < 1 || p_config.errorPoints > GainScheduleConfig::MAX_POINTS ||
+        p_config.speedPoints < 1 || p_config.speedPoints > GainScheduleConfig::MAX_POINTS) {
+        return false;
+    }
+    for (int i = 1; i < p_config.errorPoints; i++) {
+        if (!(p_config.errorBreakpoints[i] > p_config.errorBreakpoints[i - 1])) return false;
+    }
+    for (int i = 1; i < p_config.speedPoints; i++) {
+        if (!(p_config.speedBreakpoints[i] > p_config.speedBreakpoints[i - 1])) return false;
+    }
+    for (int s = 0; s < p_config.speedPoints; s++) {
+        for (int e = 0; e < p_config.errorPoints; e++) {
+            if (!(p_config.kpScale[s][e] >= 0.0f) || !(p_config.kiScale[s][e] >= 0.0f) || !(p_config.kdScale[s][e] >= 0.0f)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool GainSchedule::setConfig(const GainScheduleConfig& p_config) {
+    if (p_config.enabled && !isValid(p_config)) {
+        return false;
+    }
+    m_config = p_config;
+    return true;
+}
+
+GainSchedule::Segment GainSchedule::locate(const float* p_breakpoints, int p_count, float p_value) {
+    if (p_count < 2 || p_value <= p_breakpoints[0]) {
+        return {0, 0.0f};
+    }
+    // At most MAX_POINTS entries, a linear scan beats a binary search here
+    int i = 1;
+    while (i < p_count - 1 && p_value > p_breakpoints[i]) {
+        i++;
+    }
+    float l_fraction = (p_value - p_breakpoints[i - 1]) / (p_breakpoints[i] - p_breakpoints[i - 1]);
+    return {i - 1, l_fraction > 1.0f ? 1.0f : l_fraction};
+}
+
+float GainSchedule::interpolate(const float (&p_table)[GainScheduleConfig::MAX_POINTS][GainScheduleConfig::MAX_POINTS],
+                                const Segment& p_speed, const Segment& p_error) {
+    // A single breakpoint gives a zero fraction, index + 1 would fall off the table
+    int l_e1 = p_error.fraction > 0.0f ? p_error.index + 1 : p_error.index;
+    int l_s1 = p_speed.fraction > 0.0f ? p_speed.index + 1 : p_speed.index;
+
+    float l_low = p_table[p_speed.index][p_error.index] +
+                  p_error.fraction * (p_table[p_speed.index][l_e1] - p_table[p_speed.index][p_error.index]);
+    float l_high = p_table[l_s1][p_error.index] +
+                   p_error.fraction * (p_table[l_s1][l_e1] - p_table[l_s1][p_error.index]);
+    return l_low + p_speed.fraction * (l_high - l_low);
+}
+
+GainScale GainSchedule::evaluate(float p_pitchError, float p_wheelSpeed) const {
+    GainScale l_scale;
+    if (!m_config.enabled) {
+        return l_scale;
+    }
+
+    Segment l_error = locate(m_config.errorBreakpoints, m_config.errorPoints, std::fabs(p_pitchError));
+    Segment l_speed = locate(m_config.speedBreakpoints, m_config.speedPoints, std::fabs(p_wheelSpeed));
+
+    l_scale.kp = interpolate(m_config.kpScale, l_speed, l_error);
+    l_scale.ki = interpolate(m_config.kiScale, l_speed, l_error);
+    l_scale.kd = interpolate(m_config.kdScale, l_speed, l_error);
+    return l_scale;
+}
@@ -20,6 +20,8 @@ public:
 
     //IMotor
     esp_err_t setSpeed(float) const override;
+    esp_err_t stageSpeed(float) const override;
+    esp_err_t commitSpeed() const override;
 
 private:
     static constexpr const char* TAG = "L298NMotor";
@@ -30,7 +32,12 @@ private:
     std::shared_ptr<IGPIO> m_in2;
     std::shared_ptr<IPWM> m_pwm;
 
-    esp_err_t setDirection(float) const;
+    // Shadow of the IN1/IN2 pins like the PWM duty one, 1 clockwise, -1 counter clockwise, 0 unknown.
+    // Staged with the duty and written with it in commitSpeed, only when it changes.
+    mutable int m_direction = 0;
+    mutable int m_stagedDirection = 0;
+
+    esp_err_t setDirection(int) const;
     esp_err_t setClockwise() const;
     esp_err_t setCounterClockwise() const;
 };
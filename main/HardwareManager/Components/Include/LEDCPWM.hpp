@@ -16,10 +16,18 @@ class LEDCPWM : public IPWM {
         //IPWM
         int getPinNum() const override;
         esp_err_t setDuty(float) const override;
+        esp_err_t stageDuty(float) const override;
+        esp_err_t commitDuty() const override;
     private:
         static constexpr const char* TAG = "LEDCPWM";
 
         esp_err_t notInitialized() const override;
+        uint32_t quantizeDuty(float) const;
 
         const LEDCChannelConfig m_config;
+
+        // Shadow of the hardware duty registers, used to suppress redundant driver calls
+        mutable uint32_t m_currentDuty;
+        mutable uint32_t m_stagedDuty;
+        mutable bool m_pending;
 };
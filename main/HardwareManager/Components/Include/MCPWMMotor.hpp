@@ -0,0 +1,39 @@
+#pragma once
+#include "interface/IMotor.hpp"
+#include "interface/IMCPWMTimer.hpp"
+#include <memory>
+
+class IPWM;
+
+// Two-input H-bridge (MX1616H style) driven by one MCPWM operator. Both legs share the
+// operator's timer, so a direction change is latched by the hardware in a single PWM period.
+class MCPWMMotor : public IMotor {
+public:
+    MCPWMMotor(const MCPWMBridgeConfig&, std::shared_ptr<IMCPWMTimer>);
+    ~MCPWMMotor() = default;
+    MCPWMMotor(const MCPWMMotor&) = delete;
+    MCPWMMotor& operator=(const MCPWMMotor&) = delete;
+    MCPWMMotor(MCPWMMotor&&) = delete;
+    MCPWMMotor& operator=(MCPWMMotor&&) = delete;
+
+    //IHalComponent
+    esp_err_t init() override;
+
+    //IMotor
+    esp_err_t setSpeed(float) const override;
+    esp_err_t stageSpeed(float) const override;
+    esp_err_t commitSpeed() const override;
+
+private:
+    static constexpr const char* TAG = "MCPWMMotor";
+
+    esp_err_t notInitialized() const override;
+
+    const MCPWMBridgeConfig m_config;
+    std::shared_ptr<IMCPWMTimer> m_timer;
+    mcpwm_oper_handle_t m_operator;
+
+    std::shared_ptr<IPWM> m_in1;
+    std::shared_ptr<IPWM> m_in2;
+    std::unique_ptr<IMotor> m_bridge;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include "interface/IPWM.hpp"
+#include "interface/IMCPWMTimer.hpp"
+#include <memory>
+
+// One PWM leg: a comparator and a generator on an operator owned by the caller.
+// Compare values are shadowed and latched by the hardware when the timer hits zero,
+// so every leg on the same timer switches duty in the same PWM period.
+class MCPWMPWM : public IPWM {
+    public:
+        MCPWMPWM(int p_pinNum, mcpwm_oper_handle_t p_operator, std::shared_ptr<IMCPWMTimer> p_timer, uint32_t p_deadTimeTicks);
+        ~MCPWMPWM() = default;
+        MCPWMPWM(const MCPWMPWM&) = delete;
+        MCPWMPWM& operator=(const MCPWMPWM&) = delete;
+        MCPWMPWM(MCPWMPWM&&) = delete;
+        MCPWMPWM& operator=(MCPWMPWM&&) = delete;
+
+        //IHalComponent
+        esp_err_t init() override;
+
+        //IPWM
+        int getPinNum() const override;
+        esp_err_t setDuty(float) const override;
+        esp_err_t stageDuty(float) const override;
+        esp_err_t commitDuty() const override;
+    private:
+        static constexpr const char* TAG = "MCPWMPWM";
+
+        esp_err_t notInitialized() const override;
+        esp_err_t configureActions() const;
+        uint32_t quantizeDuty(float) const;
+
+        const int m_pinNum;
+        const uint32_t m_deadTimeTicks;
+        mcpwm_oper_handle_t m_operator;
+        std::shared_ptr<IMCPWMTimer> m_timer;
+        mcpwm_cmpr_handle_t m_comparator;
+        mcpwm_gen_handle_t m_generator;
+
+        // Shadow of the compare register, used to suppress redundant driver calls
+        mutable uint32_t m_currentTicks;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "interface/IMCPWMTimer.hpp"
+
+class MCPWMTimer : public IMCPWMTimer {
+    public:
+        MCPWMTimer(const MCPWMTimerConfig&);
+        ~MCPWMTimer() = default;
+        MCPWMTimer(const MCPWMTimer&) = delete;
+        MCPWMTimer& operator=(const MCPWMTimer&) = delete;
+        MCPWMTimer(MCPWMTimer&&) = delete;
+        MCPWMTimer& operator=(MCPWMTimer&&) = delete;
+
+        //IHalComponent
+        esp_err_t init() override;
+
+        //IMCPWMTimer
+        mcpwm_timer_handle_t getHandle() const override;
+        int getGroupId() const override;
+        mcpwm_timer_count_mode_t getCountMode() const override;
+        uint32_t getPeakTicks() const override;
+    private:
+        static constexpr const char* TAG = "MCPWMTimer";
+
+        esp_err_t notInitialized() const override;
+
+        const MCPWMTimerConfig m_config;
+        mcpwm_timer_handle_t m_handle;
+};
@@ -18,6 +18,8 @@ public:
 
     //IMotor
     esp_err_t setSpeed(float) const override;
+    esp_err_t stageSpeed(float) const override;
+    esp_err_t commitSpeed() const override;
 
 private:
     static constexpr const char* TAG = "MX1616H";
@@ -0,0 +1,33 @@
+#pragma once
+#include "interface/IMotorGroup.hpp"
+#include <memory>
+#include <vector>
+
+class IMotor;
+
+class MotorGroup : public IMotorGroup {
+public:
+    MotorGroup(const std::vector<std::shared_ptr<IMotor>>&);
+    ~MotorGroup() = default;
+    MotorGroup(const MotorGroup&) = delete;
+    MotorGroup& operator=(const MotorGroup&) = delete;
+    MotorGroup(MotorGroup&&) = delete;
+    MotorGroup& operator=(MotorGroup&&) = delete;
+
+    //IHalComponent
+    esp_err_t init() override;
+
+    //IMotorGroup
+    esp_err_t setSpeeds(const float*, size_t) const override;
+    esp_err_t setSpeed(float) const override;
+    size_t getMotorCount() const override;
+
+private:
+    static constexpr const char* TAG = "MotorGroup";
+
+    esp_err_t notInitialized() const override;
+
+    std::vector<std::shared_ptr<IMotor>> m_motors;
+
+    esp_err_t commitAll() const;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "interface/IEncoder.hpp"
+
+class PCNTEncoder : public IEncoder {
+    public:
+        PCNTEncoder(const EncoderConfig&);
+        ~PCNTEncoder() = default;
+        PCNTEncoder(const PCNTEncoder&) = delete;
+        PCNTEncoder& operator=(const PCNTEncoder&) = delete;
+        PCNTEncoder(PCNTEncoder&&) = delete;
+        PCNTEncoder& operator=(PCNTEncoder&&) = delete;
+
+        //IHalComponent
+        esp_err_t init() override;
+
+        //IEncoder
+        esp_err_t getCount(int32_t&) const override;
+        int getCountsPerRevolution() const override;
+    private:
+        static constexpr const char* TAG = "PCNTEncoder";
+        // The hardware counter is 16 bit, the driver extends it when it crosses these limits
+        static constexpr int COUNT_LIMIT = 30000;
+
+        esp_err_t notInitialized() const override;
+        esp_err_t configureChannels();
+
+        const EncoderConfig m_config;
+        pcnt_unit_handle_t m_unit;
+        pcnt_channel_handle_t m_channelA;
+        pcnt_channel_handle_t m_channelB;
+};
@@ -3,6 +3,8 @@
 #include "interface/IPWM.hpp"
 #include "esp_err.h"
 #include "esp_log.h"
+#include <algorithm>
+#include <cmath>
 
 L298NMotor::L298NMotor(const std::shared_ptr<IGPIO> p_in1,
                        const std::shared_ptr<IGPIO> p_in2,
@@ -69,20 +71,26 @@ esp_err_t L298NMotor::setCounterClockwise() const {
     return ESP_OK;
 }
 
-esp_err_t L298NMotor::setDirection(float p_speed) const {
-    ESP_LOGD(TAG, "Setting direction for speed %.2f", p_speed);
-
-    if (p_speed >= 0) {
-        ESP_LOGD(TAG, "Setting direction to clockwise");
-        return setClockwise();
-    } else {
-        ESP_LOGD(TAG, "Setting direction to counter clockwise");
-        return setCounterClockwise();
+esp_err_t L298NMotor::setDirection(int p_direction) const {
+    if (p_direction == 0 || p_direction == m_direction) {
+        return ESP_OK;
     }
+
+    esp_err_t l_ret = (p_direction > 0) ? setClockwise() : setCounterClockwise();
+    m_direction = (l_ret == ESP_OK) ? p_direction : 0;
+    return l_ret;
 }
 
 esp_err_t L298NMotor::setSpeed(float p_speed) const {
-    ESP_LOGD(TAG, "Setting motor speed to %.2f", p_speed);
+    esp_err_t l_ret = stageSpeed(p_speed);
+    if (l_ret != ESP_OK) {
+        return l_ret;
+    }
+    return commitSpeed();
+}
+
+esp_err_t L298NMotor::stageSpeed(float p_speed) const {
+    ESP_LOGV(TAG, "Staging motor speed %.2f", p_speed);
 
     if (!isInitialized()) {
         return notInitialized();
@@ -90,25 +98,30 @@ esp_err_t L298NMotor::setSpeed(float p_speed) const {
 
     float l_clampedSpeed = std::max(-1.0f, std::min(1.0f, p_speed));
     if (l_clampedSpeed != p_speed) {
-        ESP_LOGW(TAG, "Speed value clamped from %.2f to %.2f", p_speed, l_clampedSpeed);
+        ESP_LOGV(TAG, "Speed value clamped from %.2f to %.2f", p_speed, l_clampedSpeed);
     }
-    
-    esp_err_t l_ret = setDirection(l_clampedSpeed);
+    m_stagedDirection = (l_clampedSpeed >= 0) ? 1 : -1;
+
+    float l_duty = std::abs(l_clampedSpeed);
+    esp_err_t l_ret = m_pwm->stageDuty(l_duty);
     if (l_ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set direction for speed %.2f, error: %s", l_clampedSpeed, esp_err_to_name(l_ret));
+        ESP_LOGE(TAG, "Failed to set PWM duty cycle to %.2f, error: %s", l_duty, esp_err_to_name(l_ret));
         return l_ret;
     }
+    return ESP_OK;
+}
 
-    float l_duty = std::abs(l_clampedSpeed);
-    
-    ESP_LOGD(TAG, "Setting PWM duty cycle to %.2f", l_duty);
+esp_err_t L298NMotor::commitSpeed() const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
 
-    l_ret = m_pwm->setDuty(l_duty);
+    esp_err_t l_ret = setDirection(m_stagedDirection);
     if (l_ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set PWM duty cycle to %.2f, error: %s", l_duty, esp_err_to_name(l_ret));
+        ESP_LOGE(TAG, "Failed to set direction %d, error: %s", m_stagedDirection, esp_err_to_name(l_ret));
         return l_ret;
     }
-    return ESP_OK;
+    return m_pwm->commitDuty();
 }
 
 esp_err_t L298NMotor::notInitialized() const {
@@ -1,9 +1,11 @@
 #include "include/LEDCPWM.hpp"
 #include "esp_err.h"
 #include "esp_log.h"
+#include <algorithm>
 #include <cmath>
 
-LEDCPWM::LEDCPWM(const LEDCChannelConfig& p_channelConfig) : m_config(p_channelConfig) {}
+LEDCPWM::LEDCPWM(const LEDCChannelConfig& p_channelConfig) 
+    : m_config(p_channelConfig), m_currentDuty(p_channelConfig.duty), m_stagedDuty(p_channelConfig.duty), m_pending(false) {}
 
 esp_err_t LEDCPWM::init() {
     ESP_LOGD(TAG, "Initializing LEDC Channel Num: %d, Speed Mode: %d, Timer Num: %d, GPIO Num: %d, Initial Duty: %d, Hpoint: %d",
@@ -35,9 +37,14 @@ int LEDCPWM::getPinNum() const {
 }
 
 esp_err_t LEDCPWM::setDuty(float p_duty) const {
-    ESP_LOGD(TAG, "Setting duty for LEDC Channel Num: %d, Speed Mode: %d, Timer Num: %d, GPIO Num: %d, Duty: %.2f", 
-        m_config.channelNum, m_config.speedMode, m_config.timerNum, m_config.pinNum, p_duty);
+    esp_err_t l_ret = stageDuty(p_duty);
+    if (l_ret != ESP_OK) {
+        return l_ret;
+    }
+    return commitDuty();
+}
 
+esp_err_t LEDCPWM::stageDuty(float p_duty) const {
     if(!isInitialized()) {
         return notInitialized();
     }
@@ -47,23 +54,43 @@ esp_err_t LEDCPWM::setDuty(float p_duty) const {
         return ESP_ERR_INVALID_ARG;
     }
 
-    uint32_t l_duty = static_cast<uint32_t>(p_duty * m_config.maxDuty);
-        
+    uint32_t l_duty = quantizeDuty(p_duty);
+    uint32_t l_registerDuty = m_pending ? m_stagedDuty : m_currentDuty;
+    if (l_duty == l_registerDuty) {
+        return ESP_OK;
+    }
+
     esp_err_t l_ret = ledc_set_duty(m_config.speedMode, m_config.channelNum, l_duty);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set duty for LEDC %d: %s", m_config.channelNum, esp_err_to_name(l_ret));
         return l_ret;
     }
+    m_stagedDuty = l_duty;
+    m_pending = true;
+    ESP_LOGV(TAG, "Duty for LEDC Channel %d staged to %u", m_config.channelNum, l_duty);
+    return ESP_OK;
+}
+
+esp_err_t LEDCPWM::commitDuty() const {
+    if (!m_pending) {
+        return ESP_OK;
+    }
 
-    l_ret = ledc_update_duty(m_config.speedMode, m_config.channelNum);
+    esp_err_t l_ret = ledc_update_duty(m_config.speedMode, m_config.channelNum);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to update duty for LEDC %d: %s", m_config.channelNum, esp_err_to_name(l_ret));
         return l_ret;
     }
-    ESP_LOGV(TAG, "Duty for LEDC Channel %d set to %.2f", m_config.channelNum, p_duty);
+    m_currentDuty = m_stagedDuty;
+    m_pending = false;
+    ESP_LOGV(TAG, "Duty for LEDC Channel %d set to %u", m_config.channelNum, m_currentDuty);
     return ESP_OK;
 }
 
+uint32_t LEDCPWM::quantizeDuty(float p_duty) const {
+    return static_cast<uint32_t>(std::min(p_duty, 1.0f) * m_config.maxDuty);
+}
+
 esp_err_t LEDCPWM::notInitialized() const {
     ESP_LOGE(TAG, "LEDC Channel %d is not initialized: %s", m_config.channelNum, esp_err_to_name(ESP_ERR_INVALID_STATE));
     return ESP_ERR_INVALID_STATE;
@@ -0,0 +1,88 @@
+#include "include/MCPWMMotor.hpp"
+#include "include/MCPWMPWM.hpp"
+#include "include/MX1616HMotor.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+
+MCPWMMotor::MCPWMMotor(const MCPWMBridgeConfig& p_config, std::shared_ptr<IMCPWMTimer> p_timer)
+    : m_config(p_config), m_timer(p_timer), m_operator(nullptr) {}
+
+esp_err_t MCPWMMotor::init() {
+    ESP_LOGI(TAG, "Initializing MCPWM motor bridge %d", m_config.bridgeId);
+
+    if (!m_timer || !m_timer->isInitialized()) {
+        setStateError();
+        ESP_LOGE(TAG, "Timer %d for bridge %d is not initialized: %s",
+                 m_config.timerId, m_config.bridgeId, esp_err_to_name(ESP_ERR_INVALID_STATE));
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mcpwm_operator_config_t l_operatorConfig = {};
+    l_operatorConfig.group_id = m_config.groupId;
+
+    esp_err_t l_ret = mcpwm_new_operator(&l_operatorConfig, &m_operator);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to create operator for bridge %d: %s", m_config.bridgeId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = mcpwm_operator_connect_timer(m_operator, m_timer->getHandle());
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to connect operator to timer for bridge %d: %s", m_config.bridgeId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    m_in1 = std::make_shared<MCPWMPWM>(m_config.pinIn1, m_operator, m_timer, m_config.deadTimeTicks);
+    m_in2 = std::make_shared<MCPWMPWM>(m_config.pinIn2, m_operator, m_timer, m_config.deadTimeTicks);
+
+    l_ret = m_in1->init();
+    if (l_ret == ESP_OK) {
+        l_ret = m_in2->init();
+    }
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to initialize legs for bridge %d: %s", m_config.bridgeId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    // Same IN1/IN2 direction logic as the LEDC driven MX1616H
+    m_bridge = std::make_unique<MX1616HMotor>(m_in1, m_in2);
+    l_ret = m_bridge->init();
+    if (l_ret != ESP_OK) {
+        setStateError();
+        return l_ret;
+    }
+    setStateInitialized();
+    ESP_LOGI(TAG, "MCPWM motor bridge %d initialized successfully on IN1: %d, IN2: %d, dead time: %u ticks",
+             m_config.bridgeId, m_config.pinIn1, m_config.pinIn2, m_config.deadTimeTicks);
+    return ESP_OK;
+}
+
+esp_err_t MCPWMMotor::setSpeed(float p_speed) const {
+    esp_err_t l_ret = stageSpeed(p_speed);
+    if (l_ret != ESP_OK) {
+        return l_ret;
+    }
+    return commitSpeed();
+}
+
+esp_err_t MCPWMMotor::stageSpeed(float p_speed) const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+    return m_bridge->stageSpeed(p_speed);
+}
+
+esp_err_t MCPWMMotor::commitSpeed() const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+    return m_bridge->commitSpeed();
+}
+
+esp_err_t MCPWMMotor::notInitialized() const {
+    ESP_LOGE(TAG, "MCPWM motor bridge %d is not initialized: %s", m_config.bridgeId, esp_err_to_name(ESP_ERR_INVALID_STATE));
+    return ESP_ERR_INVALID_STATE;
+}
@@ -0,0 +1,145 @@
+#include "include/MCPWMPWM.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <cmath>
+
+MCPWMPWM::MCPWMPWM(int p_pinNum, mcpwm_oper_handle_t p_operator, std::shared_ptr<IMCPWMTimer> p_timer, uint32_t p_deadTimeTicks)
+    : m_pinNum(p_pinNum), m_deadTimeTicks(p_deadTimeTicks), m_operator(p_operator), m_timer(p_timer),
+      m_comparator(nullptr), m_generator(nullptr), m_currentTicks(0) {}
+
+esp_err_t MCPWMPWM::init() {
+    ESP_LOGD(TAG, "Initializing MCPWM leg on GPIO Num: %d, Dead Time: %u ticks", m_pinNum, m_deadTimeTicks);
+
+    if (!m_operator || !m_timer || !m_timer->isInitialized()) {
+        setStateError();
+        ESP_LOGE(TAG, "MCPWM operator or timer for GPIO %d is not initialized: %s", m_pinNum, esp_err_to_name(ESP_ERR_INVALID_STATE));
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mcpwm_comparator_config_t l_comparatorConfig = {};
+    l_comparatorConfig.flags.update_cmp_on_tez = true;
+
+    esp_err_t l_ret = mcpwm_new_comparator(m_operator, &l_comparatorConfig, &m_comparator);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to create comparator for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = mcpwm_comparator_set_compare_value(m_comparator, m_currentTicks);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to set initial compare value for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    mcpwm_generator_config_t l_generatorConfig = {};
+    l_generatorConfig.gen_gpio_num = m_pinNum;
+
+    l_ret = mcpwm_new_generator(m_operator, &l_generatorConfig, &m_generator);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to create generator for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = configureActions();
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to configure generator actions for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    if (m_deadTimeTicks > 0) {
+        // Delaying only the rising edge keeps the other leg of the bridge time to switch off first
+        mcpwm_dead_time_config_t l_deadTimeConfig = {};
+        l_deadTimeConfig.posedge_delay_ticks = m_deadTimeTicks;
+        l_deadTimeConfig.negedge_delay_ticks = 0;
+
+        l_ret = mcpwm_generator_set_dead_time(m_generator, m_generator, &l_deadTimeConfig);
+        if (l_ret != ESP_OK) {
+            setStateError();
+            ESP_LOGE(TAG, "Failed to set dead time for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+            return l_ret;
+        }
+    }
+    setStateInitialized();
+    ESP_LOGI(TAG, "MCPWM leg on GPIO %d initialized successfully with %u duty steps", m_pinNum, m_timer->getPeakTicks());
+    return ESP_OK;
+}
+
+esp_err_t MCPWMPWM::configureActions() const {
+    if (m_timer->getCountMode() == MCPWM_TIMER_COUNT_MODE_UP_DOWN) {
+        // Center aligned: high while the counter is below the compare value, on both slopes
+        esp_err_t l_ret = mcpwm_generator_set_action_on_compare_event(m_generator,
+            MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, m_comparator, MCPWM_GEN_ACTION_LOW));
+        if (l_ret != ESP_OK) { return l_ret; }
+
+        return mcpwm_generator_set_action_on_compare_event(m_generator,
+            MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_DOWN, m_comparator, MCPWM_GEN_ACTION_HIGH));
+    }
+
+    // Edge aligned: high from the start of the period until the compare value
+    esp_err_t l_ret = mcpwm_generator_set_action_on_timer_event(m_generator,
+        MCPWM_GEN_TIMER_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_EVENT_EMPTY, MCPWM_GEN_ACTION_HIGH));
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    return mcpwm_generator_set_action_on_compare_event(m_generator,
+        MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, m_comparator, MCPWM_GEN_ACTION_LOW));
+}
+
+int MCPWMPWM::getPinNum() const {
+    return m_pinNum;
+}
+
+esp_err_t MCPWMPWM::setDuty(float p_duty) const {
+    esp_err_t l_ret = stageDuty(p_duty);
+    if (l_ret != ESP_OK) {
+        return l_ret;
+    }
+    return commitDuty();
+}
+
+esp_err_t MCPWMPWM::stageDuty(float p_duty) const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+
+    if (p_duty < 0) {
+        ESP_LOGE(TAG, "Duty cannot be negative");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t l_ticks = quantizeDuty(p_duty);
+    if (l_ticks == m_currentTicks) {
+        return ESP_OK;
+    }
+
+    // Writes the shadow register, the hardware latches it on the next timer zero
+    esp_err_t l_ret = mcpwm_comparator_set_compare_value(m_comparator, l_ticks);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set compare value for GPIO %d: %s", m_pinNum, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+    m_currentTicks = l_ticks;
+    ESP_LOGV(TAG, "Compare value for GPIO %d staged to %u", m_pinNum, l_ticks);
+    return ESP_OK;
+}
+
+esp_err_t MCPWMPWM::commitDuty() const {
+    // Nothing to do, the comparator shadow register is latched in hardware
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+    return ESP_OK;
+}
+
+uint32_t MCPWMPWM::quantizeDuty(float p_duty) const {
+    return static_cast<uint32_t>(std::lround(std::min(p_duty, 1.0f) * m_timer->getPeakTicks()));
+}
+
+esp_err_t MCPWMPWM::notInitialized() const {
+    ESP_LOGE(TAG, "MCPWM leg on GPIO %d is not initialized: %s", m_pinNum, esp_err_to_name(ESP_ERR_INVALID_STATE));
+    return ESP_ERR_INVALID_STATE;
+}
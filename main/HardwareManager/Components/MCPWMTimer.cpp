@@ -0,0 +1,66 @@
+#include "include/MCPWMTimer.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+
+MCPWMTimer::MCPWMTimer(const MCPWMTimerConfig& p_config) : m_config(p_config), m_handle(nullptr) {}
+
+esp_err_t MCPWMTimer::init() {
+    ESP_LOGD(TAG, "Initializing MCPWM Timer Group: %d, Timer Id: %d, Resolution: %u Hz, Frequency: %u Hz, Count Mode: %d",
+             m_config.groupId, m_config.timerId, m_config.resolutionHz, m_config.frequency, m_config.countMode);
+
+    mcpwm_timer_config_t l_timerConfig = {
+        .group_id = m_config.groupId,
+        .clk_src = MCPWM_TIMER_CLK_SRC_DEFAULT,
+        .resolution_hz = m_config.resolutionHz,
+        .count_mode = m_config.countMode,
+        .period_ticks = m_config.resolutionHz / m_config.frequency
+    };
+
+    esp_err_t l_ret = mcpwm_new_timer(&l_timerConfig, &m_handle);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to create MCPWM Timer: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = mcpwm_timer_enable(m_handle);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to enable MCPWM Timer: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = mcpwm_timer_start_stop(m_handle, MCPWM_TIMER_START_NO_STOP);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to start MCPWM Timer: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+    setStateInitialized();
+    ESP_LOGI(TAG, "MCPWM Timer %d in group %d initialized successfully with %u duty steps",
+             m_config.timerId, m_config.groupId, getPeakTicks());
+    return ESP_OK;
+}
+
+mcpwm_timer_handle_t MCPWMTimer::getHandle() const {
+    return m_handle;
+}
+
+int MCPWMTimer::getGroupId() const {
+    return m_config.groupId;
+}
+
+mcpwm_timer_count_mode_t MCPWMTimer::getCountMode() const {
+    return m_config.countMode;
+}
+
+uint32_t MCPWMTimer::getPeakTicks() const {
+    uint32_t l_periodTicks = m_config.resolutionHz / m_config.frequency;
+    // Counting up and back down again spends half the period reaching the peak
+    return m_config.countMode == MCPWM_TIMER_COUNT_MODE_UP_DOWN ? l_periodTicks / 2 : l_periodTicks;
+}
+
+esp_err_t MCPWMTimer::notInitialized() const {
+    ESP_LOGE(TAG, "MCPWM Timer %d in group %d is not initialized: %s", m_config.timerId, m_config.groupId, esp_err_to_name(ESP_ERR_INVALID_STATE));
+    return ESP_ERR_INVALID_STATE;
+}
@@ -1,6 +1,9 @@
 #include "include/MX1616HMotor.hpp"
+#include "interface/IPWM.hpp"
 #include "esp_err.h"
 #include "esp_log.h"
+#include <algorithm>
+#include <cmath>
 
 MX1616HMotor::MX1616HMotor(std::shared_ptr<IPWM> p_in1, std::shared_ptr<IPWM> p_in2) : m_in1(p_in1), m_in2(p_in2) {}
 
@@ -25,43 +28,49 @@ esp_err_t MX1616HMotor::init() {
 }
 
 esp_err_t MX1616HMotor::setClockwise(float p_duty) const {
-    ESP_LOGD(TAG, "Setting clockwise direction with duty %.2f", p_duty);
+    ESP_LOGV(TAG, "Staging clockwise direction with duty %.2f", p_duty);
 
-    esp_err_t l_ret = m_in2->setDuty(0.0f);
+    esp_err_t l_ret = m_in2->stageDuty(0.0f);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set IN2 duty to 0: %s", esp_err_to_name(l_ret));
         return l_ret;
     }
 
-    l_ret = m_in1->setDuty(p_duty);
+    l_ret = m_in1->stageDuty(p_duty);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set IN1 duty to %.2f: %s", p_duty, esp_err_to_name(l_ret));
         return l_ret;
     }    
-    ESP_LOGV(TAG, "Direction set to clockwise");
     return ESP_OK;
 }
 
 esp_err_t MX1616HMotor::setCounterClockwise(float p_duty) const {
-    ESP_LOGD(TAG, "Setting counter-clockwise direction with duty %.2f", p_duty);
+    ESP_LOGV(TAG, "Staging counter-clockwise direction with duty %.2f", p_duty);
 
-    esp_err_t l_ret = m_in1->setDuty(0.0f);
+    esp_err_t l_ret = m_in1->stageDuty(0.0f);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set IN1 duty to 0: %s", esp_err_to_name(l_ret));
         return l_ret;
     }
 
-    l_ret = m_in2->setDuty(p_duty);
+    l_ret = m_in2->stageDuty(p_duty);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set IN2 duty to %.2f: %s", p_duty, esp_err_to_name(l_ret));
         return l_ret;
     }
-    ESP_LOGV(TAG, "Direction set to counter clockwise");
     return ESP_OK;
 }
 
 esp_err_t MX1616HMotor::setSpeed(float p_speed) const {
-    ESP_LOGD(TAG, "Setting MX1616H speed to %.2f", p_speed);
+    esp_err_t l_ret = stageSpeed(p_speed);
+    if (l_ret != ESP_OK) {
+        return l_ret;
+    }
+    return commitSpeed();
+}
+
+esp_err_t MX1616HMotor::stageSpeed(float p_speed) const {
+    ESP_LOGV(TAG, "Staging MX1616H speed %.2f", p_speed);
 
     if (!isInitialized()) {
         return notInitialized();
@@ -72,14 +81,12 @@ esp_err_t MX1616HMotor::setSpeed(float p_speed) const {
 
     esp_err_t l_ret;
     if (l_clampedSpeed >= 0) {
-        ESP_LOGD(TAG, "Setting clockwise direction with duty %.2f", l_duty);
         l_ret = setClockwise(l_duty);
         if (l_ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to set clockwise direction");
             return l_ret;
         }
     } else {
-        ESP_LOGD(TAG, "Setting counter-clockwise direction with duty %.2f", l_duty);
         l_ret = setCounterClockwise(l_duty);
         if (l_ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to set counter-clockwise direction");
@@ -89,6 +96,21 @@ esp_err_t MX1616HMotor::setSpeed(float p_speed) const {
     return ESP_OK;
 }
 
+esp_err_t MX1616HMotor::commitSpeed() const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+
+    // Latch both legs back to back so the direction change lands in one PWM period
+    esp_err_t l_ret = m_in1->commitDuty();
+    esp_err_t l_ret2 = m_in2->commitDuty();
+    if (l_ret != ESP_OK || l_ret2 != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to commit duty: %s", esp_err_to_name(l_ret != ESP_OK ? l_ret : l_ret2));
+        return l_ret != ESP_OK ? l_ret : l_ret2;
+    }
+    return ESP_OK;
+}
+
 esp_err_t MX1616HMotor::notInitialized() const {
     ESP_LOGE(TAG, "MX1616H motor driver is not initialized: %s", esp_err_to_name(ESP_ERR_INVALID_STATE));
     return ESP_ERR_INVALID_STATE;
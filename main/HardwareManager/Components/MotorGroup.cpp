@@ -0,0 +1,87 @@
+#include "include/MotorGroup.hpp"
+#include "interface/IMotor.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+
+MotorGroup::MotorGroup(const std::vector<std::shared_ptr<IMotor>>& p_motors) : m_motors(p_motors) {}
+
+esp_err_t MotorGroup::init() {
+    ESP_LOGD(TAG, "Initializing motor group with %d motors", m_motors.size());
+
+    if (m_motors.empty()) {
+        setStateError();
+        ESP_LOGE(TAG, "Motor group is empty");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < m_motors.size(); i++) {
+        if (!m_motors[i] || !m_motors[i]->isInitialized()) {
+            setStateError();
+            ESP_LOGE(TAG, "Motor %d is not initialized: %s", i, esp_err_to_name(ESP_ERR_INVALID_STATE));
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    setStateInitialized();
+    ESP_LOGI(TAG, "Motor group initialized successfully with %d motors", m_motors.size());
+    return ESP_OK;
+}
+
+esp_err_t MotorGroup::setSpeeds(const float* p_speeds, size_t p_count) const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+
+    if (p_speeds == nullptr || p_count != m_motors.size()) {
+        ESP_LOGE(TAG, "Expected %d speeds, got %d", m_motors.size(), p_count);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Phase 1: quantize and stage every channel, unchanged duties never reach the driver
+    for (size_t i = 0; i < p_count; i++) {
+        esp_err_t l_ret = m_motors[i]->stageSpeed(p_speeds[i]);
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to stage speed for motor %d: %s", i, esp_err_to_name(l_ret));
+            return l_ret;
+        }
+    }
+
+    // Phase 2: latch all staged channels back to back
+    return commitAll();
+}
+
+esp_err_t MotorGroup::setSpeed(float p_speed) const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+
+    for (size_t i = 0; i < m_motors.size(); i++) {
+        esp_err_t l_ret = m_motors[i]->stageSpeed(p_speed);
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to stage speed for motor %d: %s", i, esp_err_to_name(l_ret));
+            return l_ret;
+        }
+    }
+    return commitAll();
+}
+
+size_t MotorGroup::getMotorCount() const {
+    return m_motors.size();
+}
+
+esp_err_t MotorGroup::commitAll() const {
+    esp_err_t l_result = ESP_OK;
+    for (size_t i = 0; i < m_motors.size(); i++) {
+        // Keep latching the remaining motors even if one fails, a half-applied update is worse
+        esp_err_t l_ret = m_motors[i]->commitSpeed();
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to commit speed for motor %d: %s", i, esp_err_to_name(l_ret));
+            l_result = l_ret;
+        }
+    }
+    return l_result;
+}
+
+esp_err_t MotorGroup::notInitialized() const {
+    ESP_LOGE(TAG, "Motor group is not initialized: %s", esp_err_to_name(ESP_ERR_INVALID_STATE));
+    return ESP_ERR_INVALID_STATE;
+}
@@ -0,0 +1,121 @@
+#include "include/PCNTEncoder.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+
+PCNTEncoder::PCNTEncoder(const EncoderConfig& p_config)
+    : m_config(p_config), m_unit(nullptr), m_channelA(nullptr), m_channelB(nullptr) {}
+
+esp_err_t PCNTEncoder::init() {
+    ESP_LOGD(TAG, "Initializing Encoder Id: %d, Pin A: %d, Pin B: %d, Counts Per Revolution: %d, Glitch Filter: %u ns",
+             m_config.encoderId, m_config.pinA, m_config.pinB, m_config.countsPerRevolution, m_config.glitchFilterNs);
+
+    pcnt_unit_config_t l_unitConfig = {};
+    l_unitConfig.low_limit = -COUNT_LIMIT;
+    l_unitConfig.high_limit = COUNT_LIMIT;
+    l_unitConfig.flags.accum_count = true;
+
+    esp_err_t l_ret = pcnt_new_unit(&l_unitConfig, &m_unit);
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to create PCNT unit for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    if (m_config.glitchFilterNs > 0) {
+        pcnt_glitch_filter_config_t l_filterConfig = {};
+        l_filterConfig.max_glitch_ns = m_config.glitchFilterNs;
+
+        l_ret = pcnt_unit_set_glitch_filter(m_unit, &l_filterConfig);
+        if (l_ret != ESP_OK) {
+            setStateError();
+            ESP_LOGE(TAG, "Failed to set glitch filter for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+            return l_ret;
+        }
+    }
+
+    l_ret = configureChannels();
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to configure channels for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    // Watch points on the limits let the driver accumulate overflows into a 32 bit count
+    l_ret = pcnt_unit_add_watch_point(m_unit, COUNT_LIMIT);
+    if (l_ret == ESP_OK) {
+        l_ret = pcnt_unit_add_watch_point(m_unit, -COUNT_LIMIT);
+    }
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to add watch points for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    l_ret = pcnt_unit_enable(m_unit);
+    if (l_ret == ESP_OK) {
+        l_ret = pcnt_unit_clear_count(m_unit);
+    }
+    if (l_ret == ESP_OK) {
+        l_ret = pcnt_unit_start(m_unit);
+    }
+    if (l_ret != ESP_OK) {
+        setStateError();
+        ESP_LOGE(TAG, "Failed to start PCNT unit for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+    setStateInitialized();
+    ESP_LOGI(TAG, "Encoder %d initialized successfully on A: %d, B: %d", m_config.encoderId, m_config.pinA, m_config.pinB);
+    return ESP_OK;
+}
+
+esp_err_t PCNTEncoder::configureChannels() {
+    // Full quadrature decoding: each channel counts the edges of one signal, gated by the level of the other
+    pcnt_chan_config_t l_channelAConfig = {};
+    l_channelAConfig.edge_gpio_num = m_config.pinA;
+    l_channelAConfig.level_gpio_num = m_config.pinB;
+
+    esp_err_t l_ret = pcnt_new_channel(m_unit, &l_channelAConfig, &m_channelA);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    pcnt_chan_config_t l_channelBConfig = {};
+    l_channelBConfig.edge_gpio_num = m_config.pinB;
+    l_channelBConfig.level_gpio_num = m_config.pinA;
+
+    l_ret = pcnt_new_channel(m_unit, &l_channelBConfig, &m_channelB);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = pcnt_channel_set_edge_action(m_channelA, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = pcnt_channel_set_level_action(m_channelA, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = pcnt_channel_set_edge_action(m_channelB, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    return pcnt_channel_set_level_action(m_channelB, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+}
+
+esp_err_t PCNTEncoder::getCount(int32_t& p_count) const {
+    if (!isInitialized()) {
+        return notInitialized();
+    }
+
+    int l_count = 0;
+    esp_err_t l_ret = pcnt_unit_get_count(m_unit, &l_count);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read count for encoder %d: %s", m_config.encoderId, esp_err_to_name(l_ret));
+        return l_ret;
+    }
+    p_count = m_config.reversed ? -l_count : l_count;
+    return ESP_OK;
+}
+
+int PCNTEncoder::getCountsPerRevolution() const {
+    return m_config.countsPerRevolution;
+}
+
+esp_err_t PCNTEncoder::notInitialized() const {
+    ESP_LOGE(TAG, "Encoder %d is not initialized: %s", m_config.encoderId, esp_err_to_name(ESP_ERR_INVALID_STATE));
+    return ESP_ERR_INVALID_STATE;
+}
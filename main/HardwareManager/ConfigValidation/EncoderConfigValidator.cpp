@@ -0,0 +1,149 @@
+#include "Include/EncoderConfigValidator.hpp"
+#include "soc/soc_caps.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <initializer_list>
+#include <unordered_set>
+
+esp_err_t EncoderConfigValidator::validateConfig(const HardwareConfig& p_config) {
+    ESP_LOGD(TAG, "Validating encoder configuration");
+
+    const EncodersConfig& l_config = p_config.encoderConfigs;
+
+    esp_err_t l_ret = validateNumberOfEncoders(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateUniqueEncoderIds(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateCountsPerRevolution(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateGlitchFilters(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validatePinNumbers(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateUniquePinNumbers(p_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    ESP_LOGI(TAG, "Encoder configuration validated successfully");
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validateNumberOfEncoders(const EncodersConfig& p_config) {
+    ESP_LOGD(TAG, "Number of encoders found in configuration: %d", p_config.size());
+
+    // Every encoder takes one PCNT unit
+    if (p_config.size() > SOC_PCNT_UNITS_PER_GROUP) {
+        ESP_LOGE(TAG, "Too many encoders configured, only %d PCNT units available", SOC_PCNT_UNITS_PER_GROUP);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validateUniqueEncoderIds(const EncodersConfig& p_config) {
+    std::unordered_set<int> l_encoderIds;
+    ESP_LOGD(TAG, "Validating unique encoder IDs in configuration");
+    for (const auto& l_encoderConfig : p_config) {
+        if (!l_encoderIds.insert(l_encoderConfig.encoderId).second) {
+            ESP_LOGE(TAG, "Duplicate encoder ID %d", l_encoderConfig.encoderId);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validateCountsPerRevolution(const EncodersConfig& p_config) {
+    ESP_LOGD(TAG, "Validating counts per revolution in configuration");
+    auto l_invalidEncoder = std::find_if(p_config.begin(), p_config.end(),
+        [](const EncoderConfig& p_encoderConfig) { return p_encoderConfig.countsPerRevolution <= 0; });
+
+    if (l_invalidEncoder != p_config.end()) {
+        ESP_LOGE(TAG, "Invalid counts per revolution %d for encoder %d",
+                 l_invalidEncoder->countsPerRevolution, l_invalidEncoder->encoderId);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validateGlitchFilters(const EncodersConfig& p_config) {
+    ESP_LOGD(TAG, "Validating glitch filters in configuration");
+    auto l_invalidEncoder = std::find_if(p_config.begin(), p_config.end(),
+        [](const EncoderConfig& p_encoderConfig) { return p_encoderConfig.glitchFilterNs > MAX_GLITCH_FILTER_NS; });
+
+    if (l_invalidEncoder != p_config.end()) {
+        ESP_LOGE(TAG, "Glitch filter of %u ns for encoder %d exceeds %u ns",
+                 l_invalidEncoder->glitchFilterNs, l_invalidEncoder->encoderId, MAX_GLITCH_FILTER_NS);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validatePinNumbers(const EncodersConfig& p_config) {
+    ESP_LOGD(TAG, "Validating pin numbers in configuration");
+
+    // Non-existent pins
+    const std::unordered_set<int> l_nonExistentPins = {20, 24, 28, 29, 30, 31};
+
+    // Flash interface pins (6-11) - generally unavailable
+    const std::unordered_set<int> l_flashPins = {6, 7, 8, 9, 10, 11};
+
+    // Input-only GPIOs (34-39) are fine here, the encoder only reads
+
+    auto l_isInvalidPin = [&](int pin) {
+        if (pin < 0 || pin >= GPIO_NUM_MAX) {
+            ESP_LOGE(TAG, "Encoder pin number out of range: %d", pin);
+            return true;
+        }
+
+        if (l_nonExistentPins.find(pin) != l_nonExistentPins.end()) {
+            ESP_LOGE(TAG, "Non-existent GPIO pin number for encoder: %d", pin);
+            return true;
+        }
+
+        if (l_flashPins.find(pin) != l_flashPins.end()) {
+            ESP_LOGE(TAG, "Flash interface pin cannot be used for encoder: %d", pin);
+            return true;
+        }
+
+        return false;
+    };
+
+    auto l_invalidEncoder = std::find_if(p_config.begin(), p_config.end(),
+        [&](const EncoderConfig& p_encoderConfig) {
+            return l_isInvalidPin(p_encoderConfig.pinA) || l_isInvalidPin(p_encoderConfig.pinB);
+        });
+
+    if (l_invalidEncoder != p_config.end()) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t EncoderConfigValidator::validateUniquePinNumbers(const HardwareConfig& p_config) {
+    std::unordered_set<int> l_usedPins;
+    ESP_LOGD(TAG, "Validating unique pin numbers in configuration");
+
+    for (const auto& l_channelConfig : p_config.ledcConfigs.channelConfigs) {
+        l_usedPins.insert(l_channelConfig.pinNum);
+    }
+    for (const auto& l_bridgeConfig : p_config.mcpwmConfigs.bridgeConfigs) {
+        l_usedPins.insert(l_bridgeConfig.pinIn1);
+        l_usedPins.insert(l_bridgeConfig.pinIn2);
+    }
+    for (const auto& l_gpioConfig : p_config.gpioConfigs) {
+        l_usedPins.insert(l_gpioConfig.pinNum);
+    }
+
+    for (const auto& l_encoderConfig : p_config.encoderConfigs) {
+        for (int l_pin : {l_encoderConfig.pinA, l_encoderConfig.pinB}) {
+            if (!l_usedPins.insert(l_pin).second) {
+                ESP_LOGE(TAG, "Duplicate GPIO pin number: %d", l_pin);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "IConfigValidator.hpp"
+
+class EncoderConfigValidator : public IConfigValidator {
+public:
+    esp_err_t validateConfig(const HardwareConfig&) override;
+
+private:
+    static constexpr const char* TAG = "EncoderConfigValidator";
+    static constexpr uint32_t MAX_GLITCH_FILTER_NS = 12000;   // 1023 APB cycles at 80 MHz, rounded down
+
+    esp_err_t validateNumberOfEncoders(const EncodersConfig& p_config);
+    esp_err_t validateUniqueEncoderIds(const EncodersConfig& p_config);
+    esp_err_t validateCountsPerRevolution(const EncodersConfig& p_config);
+    esp_err_t validateGlitchFilters(const EncodersConfig& p_config);
+    esp_err_t validatePinNumbers(const EncodersConfig& p_config);
+    esp_err_t validateUniquePinNumbers(const HardwareConfig& p_config);
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include "IConfigValidator.hpp"
+
+class MCPWMConfigValidator : public IConfigValidator {
+public:
+    esp_err_t validateConfig(const HardwareConfig&) override;
+
+private:
+    static constexpr const char* TAG = "MCPWMConfigValidator";
+    static constexpr uint32_t MIN_DUTY_STEPS = 1024;    // Anything coarser is no better than the LEDC backend
+
+    esp_err_t validateGroupIds(const MCPWMConfig& p_config);
+    esp_err_t validateNumberOfTimers(const MCPWMConfig& p_config, int p_groupId);
+    esp_err_t validateUniqueTimerIds(const MCPWMConfig& p_config);
+    esp_err_t validateTimerFrequencies(const MCPWMConfig& p_config);
+    esp_err_t validateNumberOfBridges(const MCPWMConfig& p_config, int p_groupId);
+    esp_err_t validateUniqueBridgeIds(const MCPWMConfig& p_config);
+    esp_err_t validateBridgeTimers(const MCPWMConfig& p_config);
+    esp_err_t validatePinNumbers(const MCPWMConfig& p_config);
+    esp_err_t validateUniquePinNumbers(const HardwareConfig& p_config);
+};
@@ -0,0 +1,238 @@
+#include "Include/MCPWMConfigValidator.hpp"
+#include "soc/soc_caps.h"
+#include "esp_log.h"
+#include <algorithm>
+#include <initializer_list>
+#include <set>
+#include <unordered_set>
+
+esp_err_t MCPWMConfigValidator::validateConfig(const HardwareConfig& p_config) {
+    ESP_LOGD(TAG, "Validating MCPWM configuration");
+
+    const MCPWMConfig& l_config = p_config.mcpwmConfigs;
+
+    esp_err_t l_ret = validateGroupIds(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    for (int l_groupId = 0; l_groupId < SOC_MCPWM_GROUPS; l_groupId++) {
+        l_ret = validateNumberOfTimers(l_config, l_groupId);
+        if (l_ret != ESP_OK) { return l_ret; }
+
+        l_ret = validateNumberOfBridges(l_config, l_groupId);
+        if (l_ret != ESP_OK) { return l_ret; }
+    }
+
+    l_ret = validateUniqueTimerIds(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateTimerFrequencies(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateUniqueBridgeIds(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateBridgeTimers(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validatePinNumbers(l_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    l_ret = validateUniquePinNumbers(p_config);
+    if (l_ret != ESP_OK) { return l_ret; }
+
+    ESP_LOGI(TAG, "MCPWM configuration validated successfully");
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateGroupIds(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Validating group IDs in configuration");
+    auto l_invalidTimer = std::find_if(p_config.timerConfigs.begin(), p_config.timerConfigs.end(),
+        [](const MCPWMTimerConfig& p_timerConfig) { return p_timerConfig.groupId < 0 || p_timerConfig.groupId >= SOC_MCPWM_GROUPS; });
+
+    if (l_invalidTimer != p_config.timerConfigs.end()) {
+        ESP_LOGE(TAG, "Invalid group id %d for timer %d", l_invalidTimer->groupId, l_invalidTimer->timerId);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    auto l_invalidBridge = std::find_if(p_config.bridgeConfigs.begin(), p_config.bridgeConfigs.end(),
+        [](const MCPWMBridgeConfig& p_bridgeConfig) { return p_bridgeConfig.groupId < 0 || p_bridgeConfig.groupId >= SOC_MCPWM_GROUPS; });
+
+    if (l_invalidBridge != p_config.bridgeConfigs.end()) {
+        ESP_LOGE(TAG, "Invalid group id %d for bridge %d", l_invalidBridge->groupId, l_invalidBridge->bridgeId);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateNumberOfTimers(const MCPWMConfig& p_config, int p_groupId) {
+    auto l_count = std::count_if(p_config.timerConfigs.begin(), p_config.timerConfigs.end(),
+        [p_groupId](const MCPWMTimerConfig& p_timerConfig) { return p_timerConfig.groupId == p_groupId; });
+
+    ESP_LOGD(TAG, "Number of timers found in configuration for group %d: %d", p_groupId, l_count);
+
+    if (l_count > SOC_MCPWM_TIMERS_PER_GROUP) {
+        ESP_LOGE(TAG, "Too many timers configured for group %d", p_groupId);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateUniqueTimerIds(const MCPWMConfig& p_config) {
+    std::set<std::pair<int, int>> l_timerIds;
+    ESP_LOGD(TAG, "Validating unique timer IDs in configuration");
+    for (const auto& l_timerConfig : p_config.timerConfigs) {
+        if (!l_timerIds.insert(std::make_pair(l_timerConfig.groupId, l_timerConfig.timerId)).second) {
+            ESP_LOGE(TAG, "Duplicate timer ID %d for group %d", l_timerConfig.timerId, l_timerConfig.groupId);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateTimerFrequencies(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Validating timer frequencies in configuration");
+    for (const auto& l_timerConfig : p_config.timerConfigs) {
+        if (l_timerConfig.countMode != MCPWM_TIMER_COUNT_MODE_UP && l_timerConfig.countMode != MCPWM_TIMER_COUNT_MODE_UP_DOWN) {
+            ESP_LOGE(TAG, "Unsupported count mode %d for timer %d", l_timerConfig.countMode, l_timerConfig.timerId);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        if (l_timerConfig.frequency == 0 || l_timerConfig.resolutionHz < l_timerConfig.frequency) {
+            ESP_LOGE(TAG, "Invalid frequency %u Hz for timer %d with resolution %u Hz",
+                     l_timerConfig.frequency, l_timerConfig.timerId, l_timerConfig.resolutionHz);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        uint32_t l_dutySteps = l_timerConfig.resolutionHz / l_timerConfig.frequency;
+        if (l_timerConfig.countMode == MCPWM_TIMER_COUNT_MODE_UP_DOWN) {
+            l_dutySteps /= 2;
+        }
+        if (l_dutySteps < MIN_DUTY_STEPS) {
+            ESP_LOGE(TAG, "Timer %d only has %u duty steps, raise the resolution or lower the frequency",
+                     l_timerConfig.timerId, l_dutySteps);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateNumberOfBridges(const MCPWMConfig& p_config, int p_groupId) {
+    auto l_count = std::count_if(p_config.bridgeConfigs.begin(), p_config.bridgeConfigs.end(),
+        [p_groupId](const MCPWMBridgeConfig& p_bridgeConfig) { return p_bridgeConfig.groupId == p_groupId; });
+
+    ESP_LOGD(TAG, "Number of bridges found in configuration for group %d: %d", p_groupId, l_count);
+
+    // Every bridge takes one operator
+    if (l_count > SOC_MCPWM_OPERATORS_PER_GROUP) {
+        ESP_LOGE(TAG, "Too many bridges configured for group %d", p_groupId);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateUniqueBridgeIds(const MCPWMConfig& p_config) {
+    std::unordered_set<int> l_bridgeIds;
+    ESP_LOGD(TAG, "Validating unique bridge IDs in configuration");
+    for (const auto& l_bridgeConfig : p_config.bridgeConfigs) {
+        if (!l_bridgeIds.insert(l_bridgeConfig.bridgeId).second) {
+            ESP_LOGE(TAG, "Duplicate bridge ID %d", l_bridgeConfig.bridgeId);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateBridgeTimers(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Validating bridge timers in configuration");
+    for (const auto& l_bridgeConfig : p_config.bridgeConfigs) {
+        auto l_matchingTimer = std::find_if(p_config.timerConfigs.begin(), p_config.timerConfigs.end(),
+            [&l_bridgeConfig](const MCPWMTimerConfig& p_timerConfig) {
+                return p_timerConfig.timerId == l_bridgeConfig.timerId
+                    && p_timerConfig.groupId == l_bridgeConfig.groupId;
+            });
+        if (l_matchingTimer == p_config.timerConfigs.end()) {
+            ESP_LOGE(TAG, "Bridge %d references non-existent timer %d in group %d",
+                     l_bridgeConfig.bridgeId, l_bridgeConfig.timerId, l_bridgeConfig.groupId);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Dead time longer than half a period would swallow the whole pulse
+        uint32_t l_periodTicks = l_matchingTimer->resolutionHz / l_matchingTimer->frequency;
+        if (l_bridgeConfig.deadTimeTicks >= l_periodTicks / 2) {
+            ESP_LOGE(TAG, "Dead time of %u ticks for bridge %d exceeds half the PWM period",
+                     l_bridgeConfig.deadTimeTicks, l_bridgeConfig.bridgeId);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validatePinNumbers(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Validating pin numbers in configuration");
+
+    // Non-existent pins
+    const std::unordered_set<int> l_nonExistentPins = {20, 24, 28, 29, 30, 31};
+
+    // Flash interface pins (6-11) - generally unavailable
+    const std::unordered_set<int> l_flashPins = {6, 7, 8, 9, 10, 11};
+
+    // Input-only GPIOs (34-39)
+    const std::unordered_set<int> l_inputOnlyPins = {34, 35, 36, 37, 38, 39};
+
+    auto l_isInvalidPin = [&](int pin) {
+        if (pin < 0 || pin >= GPIO_NUM_MAX) {
+            ESP_LOGE(TAG, "MCPWM pin number out of range: %d", pin);
+            return true;
+        }
+
+        if (l_nonExistentPins.find(pin) != l_nonExistentPins.end()) {
+            ESP_LOGE(TAG, "Non-existent GPIO pin number for MCPWM: %d", pin);
+            return true;
+        }
+
+        if (l_flashPins.find(pin) != l_flashPins.end()) {
+            ESP_LOGE(TAG, "Flash interface pin cannot be used for MCPWM: %d", pin);
+            return true;
+        }
+
+        if (l_inputOnlyPins.find(pin) != l_inputOnlyPins.end()) {
+            ESP_LOGE(TAG, "Input-only pin cannot be used for MCPWM: %d", pin);
+            return true;
+        }
+
+        return false;
+    };
+
+    auto l_invalidBridge = std::find_if(p_config.bridgeConfigs.begin(), p_config.bridgeConfigs.end(),
+        [&](const MCPWMBridgeConfig& p_bridgeConfig) {
+            return l_isInvalidPin(p_bridgeConfig.pinIn1) || l_isInvalidPin(p_bridgeConfig.pinIn2);
+        });
+
+    if (l_invalidBridge != p_config.bridgeConfigs.end()) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t MCPWMConfigValidator::validateUniquePinNumbers(const HardwareConfig& p_config) {
+    std::unordered_set<int> l_usedPins;
+    ESP_LOGD(TAG, "Validating unique pin numbers in configuration");
+
+    // A pin already driven by LEDC or configured as plain GPIO cannot also be an MCPWM leg
+    for (const auto& l_channelConfig : p_config.ledcConfigs.channelConfigs) {
+        l_usedPins.insert(l_channelConfig.pinNum);
+    }
+    for (const auto& l_gpioConfig : p_config.gpioConfigs) {
+        l_usedPins.insert(l_gpioConfig.pinNum);
+    }
+
+    for (const auto& l_bridgeConfig : p_config.mcpwmConfigs.bridgeConfigs) {
+        for (int l_pin : {l_bridgeConfig.pinIn1, l_bridgeConfig.pinIn2}) {
+            if (!l_usedPins.insert(l_pin).second) {
+                ESP_LOGE(TAG, "Duplicate GPIO pin number: %d", l_pin);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+    }
+    return ESP_OK;
+}
@@ -2,6 +2,9 @@
 
 #include "Components/include/LEDCTimer.hpp"
 #include "Components/include/LEDCPWM.hpp"
+#include "Components/Include/MCPWMTimer.hpp"
+#include "Components/Include/MCPWMMotor.hpp"
+#include "Components/Include/PCNTEncoder.hpp"
 #include "Components/Include/GPIO.hpp"
 #include "Components/Include/I2CBus.hpp"
 #include "Components/Include/I2CDevice.hpp"
@@ -36,6 +39,18 @@ esp_err_t HardwareManager::configure(const HardwareConfig& p_config) {
         return l_ret;
     }
 
+    l_ret = configureMCPWM(p_config.mcpwmConfigs);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure MCPWM");
+        return l_ret;
+    }
+
+    l_ret = configureEncoders(p_config.encoderConfigs);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure encoders");
+        return l_ret;
+    }
+
     l_ret = configureGPIO(p_config.gpioConfigs);
     if (l_ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to configure GPIO");
@@ -72,6 +87,36 @@ esp_err_t HardwareManager::configureLEDCPWM(const LEDCConfig& p_config) {
     return ESP_OK;
 }   
 
+esp_err_t HardwareManager::configureMCPWM(const MCPWMConfig& p_config) {
+    esp_err_t l_ret = configureAndInitializeMCPWMTimers(p_config);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure MCPWM timers");
+        return l_ret;
+    }
+
+    l_ret = configureAndInitializeBridges(p_config);
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure MCPWM bridges");
+        return l_ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t HardwareManager::configureEncoders(const EncodersConfig& p_config) {
+    ESP_LOGD(TAG, "Configuring encoders");
+    for (const auto& l_encoderConfig : p_config) {
+        auto l_encoder = std::make_shared<PCNTEncoder>(l_encoderConfig);
+        esp_err_t l_ret = l_encoder->init();
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize encoder %d", l_encoderConfig.encoderId);
+            return l_ret;
+        }
+        m_encoders[l_encoderConfig.encoderId] = l_encoder;
+        ESP_LOGI(TAG, "Encoder %d configured successfully", l_encoderConfig.encoderId);
+    }
+    return ESP_OK;
+}
+
 esp_err_t HardwareManager::configureGPIO(const GPIOSConfig& p_config) {
     esp_err_t l_ret = ESP_OK;
     for (const auto& l_gpioConfig : p_config) {
@@ -127,6 +172,69 @@ esp_err_t HardwareManager::configureAndInitializeChannels(const LEDCConfig& p_co
     return ESP_OK;
 }
 
+esp_err_t HardwareManager::configureAndInitializeMCPWMTimers(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Configuring and initializing MCPWM timers");
+    for (const auto& l_timerConfig : p_config.timerConfigs) {
+        auto l_timer = std::make_shared<MCPWMTimer>(l_timerConfig);
+
+        esp_err_t l_ret = l_timer->init();
+        if (l_ret != ESP_OK) { return l_ret; }
+
+        m_mcpwmTimers.emplace(std::make_pair(l_timerConfig.groupId, l_timerConfig.timerId), l_timer);
+    }
+    return ESP_OK;
+}
+
+esp_err_t HardwareManager::configureAndInitializeBridges(const MCPWMConfig& p_config) {
+    ESP_LOGD(TAG, "Configuring and initializing MCPWM bridges");
+    for (const auto& l_bridgeConfig : p_config.bridgeConfigs) {
+        auto l_timerIt = m_mcpwmTimers.find(std::make_pair(l_bridgeConfig.groupId, l_bridgeConfig.timerId));
+        if (l_timerIt == m_mcpwmTimers.end()) {
+            ESP_LOGE(TAG, "Bridge %d references non-existent timer %d in group %d",
+                     l_bridgeConfig.bridgeId, l_bridgeConfig.timerId, l_bridgeConfig.groupId);
+            return ESP_ERR_NOT_FOUND;
+        }
+
+        auto l_motor = std::make_shared<MCPWMMotor>(l_bridgeConfig, l_timerIt->second);
+        esp_err_t l_ret = l_motor->init();
+        if (l_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to initialize MCPWM bridge %d", l_bridgeConfig.bridgeId);
+            return l_ret;
+        }
+
+        m_mcpwmMotors.emplace(l_bridgeConfig.bridgeId, l_motor);
+        ESP_LOGD(TAG, "MCPWM bridge %d configured successfully", l_bridgeConfig.bridgeId);
+    }
+    return ESP_OK;
+}
+
+std::shared_ptr<IPWM> HardwareManager::getLEDCChannel(ledc_mode_t p_speedMode, ledc_channel_t p_channel) const {
+    auto l_channelIt = m_ledcChannels.find(std::make_pair(p_speedMode, p_channel));
+    if (l_channelIt == m_ledcChannels.end()) {
+        ESP_LOGE(TAG, "LEDC channel %d for speed mode %d not found", p_channel, p_speedMode);
+        return nullptr;
+    }
+    return l_channelIt->second;
+}
+
+std::shared_ptr<IMotor> HardwareManager::getMCPWMMotor(int p_bridgeId) const {
+    auto l_motorIt = m_mcpwmMotors.find(p_bridgeId);
+    if (l_motorIt == m_mcpwmMotors.end()) {
+        ESP_LOGE(TAG, "MCPWM bridge %d not found", p_bridgeId);
+        return nullptr;
+    }
+    return l_motorIt->second;
+}
+
+std::shared_ptr<IEncoder> HardwareManager::getEncoder(int p_encoderId) const {
+    auto l_encoderIt = m_encoders.find(p_encoderId);
+    if (l_encoderIt == m_encoders.end()) {
+        ESP_LOGE(TAG, "Encoder %d not found", p_encoderId);
+        return nullptr;
+    }
+    return l_encoderIt->second;
+}
+
 esp_err_t HardwareManager::configureI2C(const I2CConfig& p_config) {
     ESP_LOGD(TAG, "Configuring I2C");
 
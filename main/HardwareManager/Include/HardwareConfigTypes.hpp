@@ -1,6 +1,7 @@
 #pragma once
 #include "driver/ledc.h"
-#include "driver/mcpwm.h"
+#include "driver/mcpwm_prelude.h"
+#include "driver/pulse_cnt.h"
 #include "driver/i2c_master.h"
 #include "esp_wifi_types.h"
 #include "freertos/event_groups.h"
@@ -93,10 +94,36 @@ struct LEDCChannelConfig {
 };
 
 struct MCPWMTimerConfig {
+    int groupId = 0;
+    int timerId = 0;                                                        // Referenced by bridges, unique within a group
+    uint32_t resolutionHz = 80000000;                                       // Timer tick, 12.5 ns
+    uint32_t frequency = 20000;                                             // PWM frequency, above the audible range
+    mcpwm_timer_count_mode_t countMode = MCPWM_TIMER_COUNT_MODE_UP_DOWN;    // Center aligned
+};
+
+// One H-bridge: one operator with a generator per input leg, both clocked by the same timer
+struct MCPWMBridgeConfig {
+    int bridgeId;
+    int groupId = 0;
+    int timerId = 0;
+    int pinIn1;
+    int pinIn2;
+    uint32_t deadTimeTicks = 0;     // Rising-edge delay applied to each leg, in timer ticks
 };
 
 struct MCPWMConfig {
     std::vector<MCPWMTimerConfig> timerConfigs;
+    std::vector<MCPWMBridgeConfig> bridgeConfigs;
+};
+
+// Quadrature wheel encoder counted by one PCNT unit
+struct EncoderConfig {
+    int encoderId;
+    int pinA;
+    int pinB;
+    int countsPerRevolution;        // Quadrature counts (4x line count) per wheel revolution
+    uint32_t glitchFilterNs = 1000; // Pulses shorter than this are ignored, 0 disables
+    bool reversed = false;          // Flip the sign for the mirrored wheel
 };
 
 struct WIFIConfig {
@@ -106,6 +133,7 @@ struct WIFIConfig {
 };
 
 typedef std::vector<GPIOConfig> GPIOSConfig;
+typedef std::vector<EncoderConfig> EncodersConfig;
 
 struct LEDCConfig {
     std::vector<LEDCTimerConfig> timerConfigs;
@@ -120,6 +148,8 @@ struct I2CConfig {
 struct HardwareConfig {
     GPIOSConfig gpioConfigs;
     LEDCConfig ledcConfigs;
+    MCPWMConfig mcpwmConfigs;
+    EncodersConfig encoderConfigs;
     I2CConfig i2cConfigs;
     MPU6050Config mpu6050Config;
     WIFIConfig wifiConfig;
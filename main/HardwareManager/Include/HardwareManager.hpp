@@ -3,6 +3,8 @@
 #include "HardwareConfigTypes.hpp"
 #include "ConfigValidation/Include/GPIOConfigValidator.hpp"
 #include "ConfigValidation/Include/LEDCConfigValidator.hpp"
+#include "ConfigValidation/Include/MCPWMConfigValidator.hpp"
+#include "ConfigValidation/Include/EncoderConfigValidator.hpp"
 #include "ConfigValidation/Include/I2CConfigValidator.hpp"
 #include "ConfigValidation/Include/WIFIConfigValidator.hpp"
 
@@ -10,7 +12,10 @@
 #include <map>
 
 class ILEDCTimer;
-class ILEDCPWM;
+class IPWM;
+class IMCPWMTimer;
+class IMotor;
+class IEncoder;
 class IGPIO;
 class II2CBus;
 class II2CDevice;
@@ -26,10 +31,16 @@ public:
 
     esp_err_t configure(const HardwareConfig&);
     esp_err_t configureLEDCPWM(const LEDCConfig&);
+    esp_err_t configureMCPWM(const MCPWMConfig&);
+    esp_err_t configureEncoders(const EncodersConfig&);
     esp_err_t configureGPIO(const GPIOSConfig&);
     esp_err_t configureI2C(const I2CConfig&);
     esp_err_t configureWIFI(const WIFIConfig&);
 
+    std::shared_ptr<IPWM> getLEDCChannel(ledc_mode_t p_speedMode, ledc_channel_t p_channel) const;
+    std::shared_ptr<IMotor> getMCPWMMotor(int p_bridgeId) const;
+    std::shared_ptr<IEncoder> getEncoder(int p_encoderId) const;
+
 private:
     static constexpr const char* TAG = "HardwareManager";
 
@@ -37,12 +48,17 @@ private:
 
     esp_err_t configureAndInitializeTimers(const LEDCConfig&);
     esp_err_t configureAndInitializeChannels(const LEDCConfig&);
+    esp_err_t configureAndInitializeMCPWMTimers(const MCPWMConfig&);
+    esp_err_t configureAndInitializeBridges(const MCPWMConfig&);
     esp_err_t configureAndInitializeBuses(const I2CConfig&);
     esp_err_t configureAndInitializeDevices(const I2CConfig&);
     esp_err_t initializeNVS();
 
     std::map<std::pair<ledc_mode_t, ledc_timer_t>, std::shared_ptr<ILEDCTimer>> m_ledcTimers;
-    std::map<std::pair<ledc_mode_t, ledc_channel_t>, std::shared_ptr<ILEDCPWM>> m_ledcChannels;
+    std::map<std::pair<ledc_mode_t, ledc_channel_t>, std::shared_ptr<IPWM>> m_ledcChannels;
+    std::map<std::pair<int, int>, std::shared_ptr<IMCPWMTimer>> m_mcpwmTimers;
+    std::map<int, std::shared_ptr<IMotor>> m_mcpwmMotors;
+    std::map<int, std::shared_ptr<IEncoder>> m_encoders;
     std::map<gpio_num_t, std::shared_ptr<IGPIO>> m_gpios;
     
     std::map<i2c_port_num_t, std::shared_ptr<II2CBus>> m_i2cBuses;
@@ -53,6 +69,8 @@ private:
 
     std::vector<std::unique_ptr<IConfigValidator>> m_configValidators = {
         std::make_unique<LEDCConfigValidator>(),
+        std::make_unique<MCPWMConfigValidator>(),
+        std::make_unique<EncoderConfigValidator>(),
         std::make_unique<GPIOConfigValidator>(),
         std::make_unique<I2CConfigValidator>(),
         std::make_unique<WIFIConfigValidator>()
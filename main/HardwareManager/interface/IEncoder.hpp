@@ -0,0 +1,11 @@
+#pragma once
+#include "IHalComponent.hpp"
+
+class IEncoder : public IHalComponent {
+    public:
+        virtual ~IEncoder() = default;
+
+        // Accumulated quadrature count since init, sign already corrected for mounting
+        virtual esp_err_t getCount(int32_t&) const = 0;
+        virtual int getCountsPerRevolution() const = 0;
+};
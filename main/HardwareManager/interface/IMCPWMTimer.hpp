@@ -1,10 +1,13 @@
 #pragma once
-#include <driver/mcpwm.h>
+#include "IHalComponent.hpp"
 
-class IMCPWMTimer {
+class IMCPWMTimer : public IHalComponent {
     public:
         virtual ~IMCPWMTimer() = default;
-        virtual esp_err_t init() = 0;
-        virtual mcpwm_unit_t getUnit() const = 0;
-        virtual mcpwm_timer_t  getTimer() const = 0;
-};
\ No newline at end of file
+        virtual mcpwm_timer_handle_t getHandle() const = 0;
+        virtual int getGroupId() const = 0;
+        virtual mcpwm_timer_count_mode_t getCountMode() const = 0;
+
+        // Highest compare value, i.e. the number of duty steps
+        virtual uint32_t getPeakTicks() const = 0;
+};
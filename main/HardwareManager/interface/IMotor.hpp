@@ -5,4 +5,8 @@ class IMotor : public IHalComponent {
     public:
         virtual ~IMotor() = default;
         virtual esp_err_t setSpeed(float speed) const = 0;
+
+        // Two-phase update used by IMotorGroup, see IPWM
+        virtual esp_err_t stageSpeed(float speed) const = 0;
+        virtual esp_err_t commitSpeed() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+#include "IHalComponent.hpp"
+#include <cstddef>
+
+class IMotorGroup : public IHalComponent {
+    public:
+        virtual ~IMotorGroup() = default;
+        virtual esp_err_t setSpeeds(const float*, size_t) const = 0;
+        virtual esp_err_t setSpeed(float) const = 0;
+        virtual size_t getMotorCount() const = 0;
+};
@@ -1,5 +1,4 @@
 #pragma once
-#include "include/ConfigTypes.hpp"
 #include "interface/IHalComponent.hpp"
 
 class IPWM : public IHalComponent { 
@@ -7,4 +6,9 @@ class IPWM : public IHalComponent {
         virtual ~IPWM() = default;
         virtual int getPinNum() const = 0;
         virtual esp_err_t setDuty(float) const = 0;
+
+        // Two-phase update: stage the new duty, then latch every staged channel back to back.
+        // Staging a duty that quantizes to the current one is a no-op.
+        virtual esp_err_t stageDuty(float) const = 0;
+        virtual esp_err_t commitDuty() const = 0;
 };
\ No newline at end of file
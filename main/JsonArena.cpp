@@ -0,0 +1,82 @@
+#include "include/JsonArena.hpp"
+#include <cstdlib>
+#include <new>
+#include "cJSON.h"
+
+namespace {
+
+// Arena of the scope the calling task is in, nullptr outside any scope
+thread_local JsonArena* t_current = nullptr;
+
+void* arenaMalloc(size_t p_size) {
+    return t_current ? t_current->allocate(p_size) : malloc(p_size);
+}
+
+void arenaFree(void* p_pointer) {
+    // Released with the scope, anything else was allocated before it began
+    if (t_current && t_current->owns(p_pointer)) {
+        return;
+    }
+    free(p_pointer);
+}
+
+void installHooks() {
+    cJSON_Hooks hooks = {arenaMalloc, arenaFree};
+    cJSON_InitHooks(&hooks);
+}
+
+}  // namespace
+
+JsonArena::JsonArena(size_t p_capacity)
+    : m_buffer(new (std::nothrow) uint8_t[p_capacity]),
+      // Without its block the arena refuses everything, the parse fails as oversized
+      m_capacity(m_buffer ? p_capacity : 0),
+      m_used(0),
+      m_highWater(0),
+      m_exhausted(false) {
+    // The hooks are global to cJSON, they only need to go in once and before the first scope
+    static const bool s_hooksInstalled = (installHooks(), true);
+    (void)s_hooksInstalled;
+}
+
+JsonArena::~JsonArena() {
+    delete[] m_buffer;
+}
+
+JsonArena::Scope::Scope(JsonArena& p_arena) : m_lock(p_arena.m_mutex), m_arena(p_arena), m_previous(t_current) {
+    m_arena.reset();
+    t_current = &m_arena;
+}
+
+JsonArena::Scope::~Scope() {
+    t_current = m_previous;
+    m_arena.m_used = 0;
+}
+
+size_t JsonArena::capacityFor(size_t p_values, size_t p_text) {
+    return p_values * ((sizeof(cJSON) + ALIGNMENT - 1) & ~(ALIGNMENT - 1)) + p_text;
+}
+
+void* JsonArena::allocate(size_t p_size) {
+    size_t l_size = (p_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (l_size > m_capacity - m_used) {
+        m_exhausted = true;
+        return nullptr;
+    }
+    void* l_pointer = m_buffer + m_used;
+    m_used += l_size;
+    if (m_used > m_highWater) {
+        m_highWater = m_used;
+    }
+    return l_pointer;
+}
+
+bool JsonArena::owns(const void* p_pointer) const {
+    const uint8_t* l_pointer = static_cast<const uint8_t*>(p_pointer);
+    return l_pointer >= m_buffer && l_pointer < m_buffer + m_capacity;
+}
+
+void JsonArena::reset() {
+    m_used = 0;
+    m_exhausted = false;
+}
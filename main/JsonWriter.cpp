@@ -0,0 +1,270 @@
+#include "include/JsonWriter.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+constexpr int MAX_FIXED_DECIMALS = 6;
+
+// Scaled integer formatting for the telemetry hot path, several times faster than printf's %f.
+// |value| < 1e9 with at most 6 decimals stays well inside 64 bits.
+int formatFixed(char* p_text, double p_value, int p_decimals) {
+    static const long long SCALE[MAX_FIXED_DECIMALS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    long long l_scaled = llround(p_value * SCALE[p_decimals]);
+    bool l_negative = l_scaled < 0;
+    unsigned long long l_magnitude = l_negative ? -static_cast<unsigned long long>(l_scaled) : l_scaled;
+
+    // Digits are produced backwards, the integer part always gets at least one
+    char l_digits[24];
+    int l_count = 0;
+    do {
+        l_digits[l_count++] = static_cast<char>('0' + l_magnitude % 10);
+        l_magnitude /= 10;
+    } while (l_magnitude > 0 || l_count <= p_decimals);
+
+    int l_length = 0;
+    if (l_negative) p_text[l_length++] = '-';
+    while (l_count > 0) {
+        if (l_count == p_decimals) p_text[l_length++] = '.';
+        p_text[l_length++] = l_digits[--l_count];
+    }
+    return l_length;
+}
+
+}  // namespace
+
+JsonWriter::JsonWriter(char* p_buffer, size_t p_size, Sink p_sink, void* p_context, bool p_pretty)
+    : m_buffer(p_buffer),
+      // Without a sink the last byte is kept for the terminator
+      m_capacity(p_sink || p_size == 0 ? p_size : p_size - 1),
+      m_used(0),
+      m_flushed(0),
+      m_sink(p_sink),
+      m_context(p_context),
+      m_pretty(p_pretty),
+      m_ok(p_buffer != nullptr && p_size > 0),
+      m_depth(0) {
+}
+
+JsonWriter& JsonWriter::beginObject(const char* p_key) {
+    return open(p_key, true);
+}
+
+JsonWriter& JsonWriter::endObject() {
+    return close(true);
+}
+
+JsonWriter& JsonWriter::beginArray(const char* p_key) {
+    return open(p_key, false);
+}
+
+JsonWriter& JsonWriter::endArray() {
+    return close(false);
+}
+
+JsonWriter& JsonWriter::number(const char* p_key, double p_value, int p_decimals) {
+    if (beginValue(p_key)) {
+        formatNumber(p_value, p_decimals);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::numbers(const char* p_key, const float* p_values, int p_count, int p_decimals) {
+    beginArray(p_key);
+    for (int i = 0; i < p_count; i++) {
+        number(nullptr, p_values[i], p_decimals);
+    }
+    return endArray();
+}
+
+JsonWriter& JsonWriter::integer(const char* p_key, long long p_value) {
+    if (beginValue(p_key)) {
+        char l_text[24];
+        int l_length = snprintf(l_text, sizeof(l_text), "%lld", p_value);
+        write(l_text, l_length);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::boolean(const char* p_key, bool p_value) {
+    if (beginValue(p_key)) {
+        if (p_value) write("true", 4);
+        else write("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::string(const char* p_key, const char* p_value) {
+    if (beginValue(p_key)) {
+        quoted(p_value ? p_value : "");
+    }
+    return *this;
+}
+
+bool JsonWriter::finish() {
+    if (m_depth != 0) {
+        m_ok = false;
+    }
+    if (!m_ok) {
+        return false;
+    }
+    if (m_sink) {
+        return m_used == 0 || flush();
+    }
+    m_buffer[m_used] = '\0';
+    return true;
+}
+
+// Separator, indentation and key of the next member, false once the writer has failed
+bool JsonWriter::beginValue(const char* p_key) {
+    if (!m_ok) {
+        return false;
+    }
+    if (m_depth == 0) {
+        // A single top level value
+        if (p_key != nullptr || length() > 0) {
+            m_ok = false;
+        }
+        return m_ok;
+    }
+
+    int l_level = m_depth - 1;
+    if (m_inObject[l_level] != (p_key != nullptr)) {
+        m_ok = false;
+        return false;
+    }
+    if (m_hasMembers[l_level]) {
+        put(',');
+        if (m_pretty && !m_inObject[l_level]) put(' ');
+    }
+    m_hasMembers[l_level] = true;
+
+    if (p_key != nullptr) {
+        if (m_pretty) newline(m_depth);
+        quoted(p_key);
+        put(':');
+        if (m_pretty) put(' ');
+    }
+    return m_ok;
+}
+
+JsonWriter& JsonWriter::open(const char* p_key, bool p_object) {
+    if (m_depth == MAX_DEPTH) {
+        m_ok = false;
+    }
+    if (beginValue(p_key)) {
+        put(p_object ? '{' : '[');
+        m_inObject[m_depth] = p_object;
+        m_hasMembers[m_depth] = false;
+        m_depth++;
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::close(bool p_object) {
+    if (!m_ok) {
+        return *this;
+    }
+    if (m_depth == 0 || m_inObject[m_depth - 1] != p_object) {
+        m_ok = false;
+        return *this;
+    }
+    m_depth--;
+    if (m_pretty && p_object && m_hasMembers[m_depth]) {
+        newline(m_depth);
+    }
+    put(p_object ? '}' : ']');
+    return *this;
+}
+
+void JsonWriter::write(const char* p_data, size_t p_length) {
+    while (m_ok && p_length > 0) {
+        if (m_used == m_capacity && !flush()) {
+            return;
+        }
+        size_t l_count = m_capacity - m_used < p_length ? m_capacity - m_used : p_length;
+        memcpy(m_buffer + m_used, p_data, l_count);
+        m_used += l_count;
+        p_data += l_count;
+        p_length -= l_count;
+    }
+}
+
+void JsonWriter::put(char p_char) {
+    write(&p_char, 1);
+}
+
+void JsonWriter::newline(int p_depth) {
+    put('\n');
+    for (int i = 0; i < p_depth; i++) put('\t');
+}
+
+void JsonWriter::quoted(const char* p_text) {
+    put('"');
+    const char* l_run = p_text;
+    for (const char* c = p_text; *c != '\0'; c++) {
+        unsigned char l_char = static_cast<unsigned char>(*c);
+        if (l_char >= 0x20 && l_char != '"' && l_char != '\\') {
+            continue;
+        }
+        // Plain characters go out in one piece up to the one that needs escaping
+        write(l_run, c - l_run);
+        l_run = c + 1;
+        char l_escape[8];
+        switch (l_char) {
+            case '"': write("\\\"", 2); break;
+            case '\\': write("\\\\", 2); break;
+            case '\n': write("\\n", 2); break;
+            case '\r': write("\\r", 2); break;
+            case '\t': write("\\t", 2); break;
+            default:
+                snprintf(l_escape, sizeof(l_escape), "\\u%04x", l_char);
+                write(l_escape, 6);
+                break;
+        }
+    }
+    write(l_run, strlen(l_run));
+    put('"');
+}
+
+void JsonWriter::formatNumber(double p_value, int p_decimals) {
+    if (!std::isfinite(p_value)) {
+        write("null", 4);
+        return;
+    }
+    char l_text[32];
+    int l_length;
+    if (p_decimals >= 0 && p_decimals <= MAX_FIXED_DECIMALS && std::fabs(p_value) < 1e9) {
+        l_length = formatFixed(l_text, p_value, p_decimals);
+    } else if (p_decimals >= 0) {
+        l_length = snprintf(l_text, sizeof(l_text), "%.*f", p_decimals, p_value);
+    } else if (std::fabs(p_value) < 1e9 && p_value == std::floor(p_value)) {
+        // Whole numbers are common in the config and need no search
+        l_length = formatFixed(l_text, p_value, 0);
+    } else {
+        // 9 significant digits always reproduce a float, most values need far fewer
+        float l_value = static_cast<float>(p_value);
+        for (int l_digits = 6; ; l_digits++) {
+            l_length = snprintf(l_text, sizeof(l_text), "%.*g", l_digits, static_cast<double>(l_value));
+            if (l_digits == 9 || strtof(l_text, nullptr) == l_value) break;
+        }
+    }
+    if (l_length <= 0 || l_length >= static_cast<int>(sizeof(l_text))) {
+        m_ok = false;
+        return;
+    }
+    write(l_text, l_length);
+}
+
+bool JsonWriter::flush() {
+    // Without a sink there is nowhere to put a full buffer, the document does not fit
+    if (!m_sink || !m_sink(m_context, m_buffer, m_used)) {
+        m_ok = false;
+        return false;
+    }
+    m_flushed += m_used;
+    m_used = 0;
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "include/LQRController.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
+#include <algorithm>
+
+LQRController::LQRController() : m_config(), m_gains(), m_lastTerms() {
+    m_mutex = xSemaphoreCreateMutex();
+}
+
+LQRController::~LQRController() {
+    if (m_mutex) {
+        vSemaphoreDelete(m_mutex);
+    }
+}
+
+esp_err_t LQRController::init(const IRuntimeConfig& p_config) {
+    ESP_LOGI(TAG, "Initializing LQR Controller");
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_config = p_config.getPidConfig();
+        m_gains = p_config.getLQRConfig();
+        xSemaphoreGive(m_mutex);
+        ESP_LOGI(TAG, "LQR gains - pitch: %.3f, pitch rate: %.3f, position: %.3f, velocity: %.3f",
+                 m_gains.kPitch, m_gains.kPitchRate, m_gains.kPosition, m_gains.kVelocity);
+        return ESP_OK;
+    }
+    ESP_LOGE(TAG, "Failed to acquire mutex in init");
+    return ESP_FAIL;
+}
+
+esp_err_t LQRController::setConfig(const PIDConfig& p_config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_config = p_config;
+        xSemaphoreGive(m_mutex);
+        return ESP_OK;
+    }
+    return ESP_FAIL;
+}
+
+void LQRController::setTargetAngle(float p_targetAngle) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_config.targetAngle = p_targetAngle;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+esp_err_t LQRController::setLQRConfig(const LQRConfig& p_gains) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_gains = p_gains;
+        xSemaphoreGive(m_mutex);
+        ESP_LOGD(TAG, "LQR gains set - pitch: %.3f, pitch rate: %.3f, position: %.3f, velocity: %.3f",
+                 p_gains.kPitch, p_gains.kPitchRate, p_gains.kPosition, p_gains.kVelocity);
+        return ESP_OK;
+    }
+    return ESP_FAIL;
+}
+
+void LQRController::setGainScale(const GainScale&) {
+    // The schedule is defined on PID gains, the LQR gains already cover the operating range
+}
+
+void LQRController::setDerivativeFilterChain(const FilterChainConfig&) {
+    // The pitch rate state comes filtered from the gyro chain, there is no differenced D term to clean up
+}
+
+float LQRController::bumplessIntegral(const PIDConfig&, float p_integral) const {
+    // The "integral" is wheel travel, a state of the plant rather than of the controller
+    return p_integral;
+}
+
+void LQRController::seedDerivative(float& p_lastError, float p_currentValue) const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        p_lastError = m_config.targetAngle - p_currentValue;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+void LQRController::reset() {
+    // Stateless apart from what PIDTask passes in
+}
+
+float LQRController::compute(float& p_integral, float& p_lastError, const SensorData& p_sensorData) const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        float l_pitchError = (p_sensorData.pitch - m_config.targetAngle) * DEG_TO_RAD;
+        float l_pitchRate = p_sensorData.pitchRate * DEG_TO_RAD;
+        float l_wheelSpeed = 0.5f * (p_sensorData.leftWheelSpeed + p_sensorData.rightWheelSpeed);
+
+        // Wheel travel is integrated here so it restarts from zero whenever PIDTask clears the integrator
+        p_integral += l_wheelSpeed * p_sensorData.dt;
+        p_lastError = m_config.targetAngle - p_sensorData.pitch;
+
+        m_lastTerms = {-m_gains.kPitch * l_pitchError,
+                       -(m_gains.kPosition * p_integral + m_gains.kVelocity * l_wheelSpeed),
+                       -m_gains.kPitchRate * l_pitchRate};
+        float l_output = mapOutput(m_lastTerms.p + m_lastTerms.i + m_lastTerms.d);
+
+        ESP_LOGV(TAG, "LQR - pitch: %.3f rad, rate: %.3f rad/s, travel: %.3f rad, speed: %.3f rad/s, output: %.2f",
+                 l_pitchError, l_pitchRate, p_integral, l_wheelSpeed, l_output);
+        xSemaphoreGive(m_mutex);
+        return l_output;
+    }
+    ESP_LOGW(TAG, "Failed to acquire mutex in compute");
+    return 0.0f;
+}
+
+float LQRController::compute(float& p_integral, float& p_lastError, float p_currentValue, float p_dt) const {
+    // Pitch only fallback, the rate comes from the error difference and the wheel states are left out
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        float l_error = m_config.targetAngle - p_currentValue;
+        float l_pitchRate = (p_dt > 0.0f) ? (p_lastError - l_error) / p_dt : 0.0f;
+        p_lastError = l_error;
+
+        m_lastTerms = {m_gains.kPitch * l_error * DEG_TO_RAD, 0.0f, -m_gains.kPitchRate * l_pitchRate * DEG_TO_RAD};
+        float l_output = mapOutput(m_lastTerms.p + m_lastTerms.d);
+        xSemaphoreGive(m_mutex);
+        return l_output;
+    }
+    ESP_LOGW(TAG, "Failed to acquire mutex in compute");
+    return 0.0f;
+}
+
+ControllerTerms LQRController::getLastTerms() const {
+    ControllerTerms l_terms {};
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        l_terms = m_lastTerms;
+        xSemaphoreGive(m_mutex);
+    }
+    return l_terms;
+}
+
+float LQRController::mapOutput(float p_output) const {
+    float l_output = std::max(-1.0f, std::min(p_output, 1.0f));
+
+    // Same mapping as the PID so the motor output shaper sees identical units
+    if (l_output > 0) {
+        l_output = l_output * m_config.outputMax;
+    } else if (l_output < 0) {
+        l_output = -l_output * m_config.outputMin;
+    } else {
+        l_output = 0;
+    }
+    return l_output;
+}
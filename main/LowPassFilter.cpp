@@ -0,0 +1,74 @@
+#include "include/LowPassFilter.hpp"
+#include <cmath>
+
+LowPassFilter::LowPassFilter()
+    : m_requestedType(DerivativeFilterType::NONE), m_type(DerivativeFilterType::NONE), m_cutoffHz(0.0f), m_dt(0.0f), m_primed(false), m_alpha(1.0f),
+      m_b0(1.0f), m_b1(0.0f), m_b2(0.0f), m_a1(0.0f), m_a2(0.0f), m_z1(0.0f), m_z2(0.0f), m_output(0.0f) {}
+
+void LowPassFilter::configure(DerivativeFilterType p_type, float p_cutoffHz, float p_dt) {
+    if (p_type == m_requestedType && p_cutoffHz == m_cutoffHz && p_dt == m_dt) {
+        return;
+    }
+    m_requestedType = p_type;
+    m_cutoffHz = p_cutoffHz;
+    m_dt = p_dt;
+
+    // A cutoff at or above Nyquist filters nothing useful, pass the signal through
+    DerivativeFilterType l_type = p_type;
+    if (p_cutoffHz <= 0.0f || p_dt <= 0.0f || p_cutoffHz >= 0.5f / p_dt) {
+        l_type = DerivativeFilterType::NONE;
+    }
+    if (l_type != m_type) {
+        // The other structure's state means nothing, re-prime on the next sample
+        m_primed = false;
+        m_type = l_type;
+    }
+
+    float l_omega = 2.0f * static_cast<float>(M_PI) * p_cutoffHz;
+    if (m_type == DerivativeFilterType::FIRST_ORDER) {
+        m_alpha = p_dt * l_omega / (1.0f + p_dt * l_omega);
+    } else if (m_type == DerivativeFilterType::BIQUAD) {
+        float l_w0 = l_omega * p_dt;
+        float l_cos = std::cos(l_w0);
+        float l_alpha = std::sin(l_w0) / (2.0f * static_cast<float>(M_SQRT1_2));
+        float l_a0 = 1.0f + l_alpha;
+
+        m_b0 = (1.0f - l_cos) / 2.0f / l_a0;
+        m_b1 = (1.0f - l_cos) / l_a0;
+        m_b2 = m_b0;
+        m_a1 = -2.0f * l_cos / l_a0;
+        m_a2 = (1.0f - l_alpha) / l_a0;
+    }
+    // Same structure keeps its state, a retune mid-flight should not step the D term
+}
+
+void LowPassFilter::reset() {
+    m_primed = false;
+}
+
+float LowPassFilter::apply(float p_input) {
+    if (!m_primed) {
+        // Start settled on the first sample instead of ramping up from zero
+        m_output = p_input;
+        m_z1 = p_input * (1.0f - m_b0);
+        m_z2 = p_input * (m_b2 - m_a2);
+        m_primed = true;
+        return p_input;
+    }
+
+    switch (m_type) {
+        case DerivativeFilterType::FIRST_ORDER:
+            m_output += m_alpha * (p_input - m_output);
+            break;
+        case DerivativeFilterType::BIQUAD:
+            m_output = m_b0 * p_input + m_z1;
+            m_z1 = m_b1 * p_input - m_a1 * m_output + m_z2;
+            m_z2 = m_b2 * p_input - m_a2 * m_output;
+            break;
+        case DerivativeFilterType::NONE:
+        default:
+            m_output = p_input;
+            break;
+    }
+    return m_output;
+}
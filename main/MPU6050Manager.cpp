@@ -32,7 +32,7 @@ esp_err_t MPU6050Manager::init(const IRuntimeConfig& config) {
     return ESP_OK;
 }
 
-float MPU6050Manager::calculatePitch(float& pitch) const {
+float MPU6050Manager::calculatePitch(float& pitch, float p_dt) const {
     float acceleration_x, acceleration_y, acceleration_z;
     float omega_x, omega_y, omega_z;
 
@@ -46,10 +46,24 @@ float MPU6050Manager::calculatePitch(float& pitch) const {
         return pitch; 
     }
 
+    // The vibration analysis wants to see what the filter bank is up against
+    _last_sample = {{acceleration_x, acceleration_y, acceleration_z}, {omega_x, omega_y - _gyro_error, omega_z - _gyro_error_z}, p_dt};
+
+    // Strip motor and gearbox vibration before it reaches the tilt estimate
+    for (BiquadCascade& filter : _accel_filter) filter.configure(_accel_chain, p_dt);
+    for (BiquadCascade& filter : _gyro_filter) filter.configure(_gyro_chain, p_dt);
+    acceleration_x = _accel_filter[0].process(acceleration_x);
+    acceleration_y = _accel_filter[1].process(acceleration_y);
+    acceleration_z = _accel_filter[2].process(acceleration_z);
+    omega_y = _gyro_filter[0].process(omega_y - _gyro_error);
+    omega_z = _gyro_filter[1].process(omega_z - _gyro_error_z);
+
     float angleY_accel = std::atan2(-acceleration_x, std::sqrt(acceleration_y*acceleration_y + acceleration_z*acceleration_z)) * 180.0f / M_PI;
-    omega_y -= _gyro_error;
+    _pitch_rate = omega_y;
+    // Same read as the pitch update, so the yaw loop costs no extra I2C transfer
+    _yaw_rate = omega_z;
 
-    pitch = ALPHA * (pitch + omega_y * 0.01f) + (1 - ALPHA) * angleY_accel;
+    pitch = ALPHA * (pitch + omega_y * p_dt) + (1 - ALPHA) * angleY_accel;
 
     ESP_LOGV(TAG, "Calculated pitch: %.2f", pitch);
     return pitch;
@@ -63,10 +77,28 @@ float MPU6050Manager::calculateYaw(float& pitch) const {
     return 0.0f; //not implemented yet
 }
 
+float MPU6050Manager::getPitchRate() const {
+    return _pitch_rate;
+}
+
+float MPU6050Manager::getYawRate() const {
+    return _yaw_rate;
+}
+
+ImuSample MPU6050Manager::getLastImuSample() const {
+    return _last_sample;
+}
+
+void MPU6050Manager::setFilterConfig(const FilterChainConfig& p_gyro, const FilterChainConfig& p_accel) {
+    _gyro_chain = p_gyro;
+    _accel_chain = p_accel;
+}
+
 esp_err_t MPU6050Manager::calibrateGyro() {
     ESP_LOGI(TAG, "Calibrating gyroscope...");
     float omega_x, omega_y, omega_z;
     _gyro_error = 0.0f;
+    _gyro_error_z = 0.0f;
 
     for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
         if (_sensor.getRotation(omega_x, omega_y, omega_z) != ESP_OK) {
@@ -74,10 +106,12 @@ esp_err_t MPU6050Manager::calibrateGyro() {
             return ESP_FAIL;
         }
         _gyro_error += omega_y;
+        _gyro_error_z += omega_z;
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 
     _gyro_error /= CALIBRATION_SAMPLES;
-    ESP_LOGI(TAG, "Calibration complete. Gyro error: %.2f", _gyro_error);
+    _gyro_error_z /= CALIBRATION_SAMPLES;
+    ESP_LOGI(TAG, "Calibration complete. Gyro error: %.2f, Gyro Z error: %.2f", _gyro_error, _gyro_error_z);
     return ESP_OK;
 }
\ No newline at end of file
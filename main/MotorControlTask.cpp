@@ -1,11 +1,15 @@
 #include "include/MotorControlTask.hpp"
 #include "interfaces/IMotorDriver.hpp"
 #include "include/StateMachine.hpp"
+#include "include/DifferentialDrive.hpp"
+#include "include/LoopPeriod.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
 
 #include <algorithm>
 
-MotorControlTask::MotorControlTask(IMotorDriver& p_motor, QueueHandle_t p_pidQueue, IStateMachine& p_sm)
-    : m_motorDriver(p_motor), m_pidOutputQueue(p_pidQueue), m_stateMachine(p_sm), m_taskHandle(nullptr), currentSpeed(0.0f) {}
+MotorControlTask::MotorControlTask(IMotorDriver& p_motor, const ControlMailboxes& p_mailboxes, IStateMachine& p_sm)
+    : m_motorDriver(p_motor), m_mailboxes(p_mailboxes), m_stateMachine(p_sm), m_taskHandle(nullptr),
+      m_controlPeriod(LoopPeriod::toTicks(LoopPeriod::DEFAULT_INTERVAL_MS)), m_feedback(), currentSpeed(0.0f) {}
 
 MotorControlTask::~MotorControlTask() {
     if (m_taskHandle != nullptr) {
@@ -13,7 +17,11 @@ MotorControlTask::~MotorControlTask() {
     }
 }
 
-esp_err_t MotorControlTask::init(const IRuntimeConfig&) {
+esp_err_t MotorControlTask::init(const IRuntimeConfig& p_config) {
+    m_controlPeriod = LoopPeriod::toTicks(p_config.getMainLoopIntervalMs());
+    m_outputShaper.setConfig(p_config.getMotorShapingConfig());
+    m_outputFilterConfig = p_config.getFilterBankConfig().motor;
+
     BaseType_t result = xTaskCreate(
         taskFunction,
         TAG,
@@ -38,29 +46,76 @@ void MotorControlTask::run() {
     TickType_t lastWakeTime = xTaskGetTickCount();
     
     while (true) {
+        LoopPeriod::peekTicks(m_mailboxes.loopPeriod, m_controlPeriod);
+        updateShapingConfig();
+        updateFilterConfig();
+
         if (m_stateMachine.getState() == StateMachine::State::BALANCING) {
-            float pidOutput;
-            if (xQueueReceive(m_pidOutputQueue, &pidOutput, 0) == pdTRUE) {
+            PIDOutput pidOutput;
+            if (xQueueReceive(m_mailboxes.pidOutput, &pidOutput, 0) == pdTRUE) {
                 if (isSafeToOperate()) {
-                    currentSpeed = applySpeedLimits(pidOutput);
-                    m_motorDriver.setSpeed(currentSpeed);
+                    applySpeed(pidOutput);
                 } else {
-                    m_motorDriver.setSpeed(0);
+                    stopMotors();
                     m_stateMachine.setState(StateMachine::State::FALLING);
                 }
             }
         } else {
             // If not in BALANCING state, ensure motors are stopped
-            m_motorDriver.setSpeed(0);
-            currentSpeed = 0;
+            stopMotors();
         }
 
-        vTaskDelayUntil(&lastWakeTime, CONTROL_PERIOD);
+        vTaskDelayUntil(&lastWakeTime, m_controlPeriod);
+    }
+}
+
+void MotorControlTask::updateShapingConfig() {
+    MotorShapingConfig l_config;
+    if (xQueuePeek(m_mailboxes.motorShaping, &l_config, 0) == pdTRUE) {
+        m_outputShaper.setConfig(l_config);
+    }
+}
+
+void MotorControlTask::updateFilterConfig() {
+    FilterBankConfig l_filters;
+    if (xQueuePeek(m_mailboxes.filterBank, &l_filters, 0) == pdTRUE) {
+        m_outputFilterConfig = l_filters.motor;
     }
 }
 
-float MotorControlTask::applySpeedLimits(float speed) {
-    return std::clamp(speed, -MAX_MOTOR_SPEED, MAX_MOTOR_SPEED);
+esp_err_t MotorControlTask::applySpeed(const PIDOutput& p_output) {
+    float l_dt = LoopPeriod::toSeconds(m_controlPeriod);
+    m_outputFilter.configure(m_outputFilterConfig, l_dt);
+    currentSpeed = m_outputShaper.normalize(m_outputFilter.process(p_output.output));
+
+    // Shaped per wheel after the mix, so the yaw share is slew limited and lifted over the
+    // deadband and static friction like the balance one
+    float l_left, l_right;
+    DifferentialDrive::mix(currentSpeed, p_output.yawOutput, l_left, l_right);
+
+    m_feedback.leftDuty = m_outputShaper.shape(l_left, MotorOutputShaper::MotorSide::LEFT, l_dt);
+    m_feedback.rightDuty = m_outputShaper.shape(l_right, MotorOutputShaper::MotorSide::RIGHT, l_dt);
+
+    // Both wheels are latched together by the driver
+    esp_err_t l_ret = m_motorDriver.setSpeed(m_feedback.leftDuty, m_feedback.rightDuty);
+
+    // Age of the sample this command was computed from, including the wait in the output queue
+    m_feedback.latency = (esp_timer_get_time() - p_output.sampleTimestamp) * 1e-6f;
+    xQueueOverwrite(m_mailboxes.motorFeedback, &m_feedback);
+    return l_ret;
+}
+
+void MotorControlTask::stopMotors() {
+    // Bypass the slew limit, a stop must be immediate
+    m_outputShaper.reset();
+    m_outputFilter.reset();
+    m_motorDriver.setSpeed(0.0f);
+    currentSpeed = 0.0f;
+
+    // The last latency stays, the predictor resumes from it on the next engage
+    m_feedback.leftDuty = 0.0f;
+    m_feedback.rightDuty = 0.0f;
+    xQueueOverwrite(m_mailboxes.motorFeedback, &m_feedback);
 }
 
 bool MotorControlTask::isSafeToOperate() {
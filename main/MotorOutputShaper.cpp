@@ -0,0 +1,55 @@
+#include "include/MotorOutputShaper.hpp"
+#include <algorithm>
+#include <cmath>
+
+MotorOutputShaper::MotorOutputShaper() : m_config(), m_lastCommand{0.0f, 0.0f} {}
+
+void MotorOutputShaper::setConfig(const MotorShapingConfig& p_config) {
+    m_config = p_config;
+    m_config.inputScale = std::max(std::abs(p_config.inputScale), 1e-6f);
+    m_config.deadband = std::clamp(p_config.deadband, 0.0f, 1.0f);
+    m_config.frictionOffset = std::clamp(p_config.frictionOffset, 0.0f, 1.0f);
+    m_config.slewRate = std::max(p_config.slewRate, 0.0f);
+}
+
+void MotorOutputShaper::reset() {
+    m_lastCommand[0] = 0.0f;
+    m_lastCommand[1] = 0.0f;
+}
+
+float MotorOutputShaper::shape(float p_command, MotorSide p_side, float p_dt) {
+    float l_command = limitSlew(std::clamp(p_command, -1.0f, 1.0f), p_side, p_dt);
+    float l_shaped = applyTrim(compensateFriction(l_command), p_side);
+
+    ESP_LOGV(TAG, "Shaped %s command %.3f -> %.3f", p_side == MotorSide::LEFT ? "left" : "right", p_command, l_shaped);
+    return l_shaped;
+}
+
+float MotorOutputShaper::applyTrim(float p_command, MotorSide p_side) const {
+    float l_trim = (p_side == MotorSide::LEFT) ? m_config.trimLeft : m_config.trimRight;
+    return std::clamp(p_command * l_trim, -1.0f, 1.0f);
+}
+
+float MotorOutputShaper::normalize(float p_command) const {
+    return std::clamp(p_command / m_config.inputScale, -1.0f, 1.0f);
+}
+
+float MotorOutputShaper::limitSlew(float p_command, MotorSide p_side, float p_dt) {
+    float& l_last = m_lastCommand[p_side == MotorSide::LEFT ? 0 : 1];
+    if (m_config.slewRate > 0.0f) {
+        float l_maxStep = m_config.slewRate * p_dt;
+        p_command = std::clamp(p_command, l_last - l_maxStep, l_last + l_maxStep);
+    }
+    l_last = p_command;
+    return p_command;
+}
+
+float MotorOutputShaper::compensateFriction(float p_command) const {
+    float l_magnitude = std::abs(p_command);
+    if (l_magnitude < m_config.deadband) {
+        return 0.0f;
+    }
+    // Lift every non-zero command above the static friction level, full scale stays full scale
+    float l_compensated = m_config.frictionOffset + (1.0f - m_config.frictionOffset) * l_magnitude;
+    return std::copysign(l_compensated, p_command);
+}
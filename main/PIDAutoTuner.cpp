@@ -0,0 +1,177 @@
+#include "include/PIDAutoTuner.hpp"
+#include <algorithm>
+#include <cmath>
+
+PIDAutoTuner::PIDAutoTuner()
+    : m_request(), m_status(Status::IDLE), m_result(), m_relayOutput(0.0f), m_elapsed(0.0f),
+      m_lastRisingSwitch(-1.0f), m_errorMax(0.0f), m_errorMin(0.0f), m_cycles(0), m_periodSum(0.0f),
+      m_amplitudeSum(0.0f), m_measuredCycles(0), m_lastPeriod(0.0f), m_lastAmplitude(0.0f), m_bias(0.0f),
+      m_halfErrorIntegral(0.0f), m_halfTime(0.0f), m_previousHalfErrorIntegral(0.0f), m_previousHalfTime(0.0f),
+      m_ultimateGain(0.0f), m_ultimatePeriod(0.0f) {}
+
+void PIDAutoTuner::start(const AutoTuneRequest& p_request) {
+    m_request = p_request;
+    m_result = p_request.baseConfig;
+    m_elapsed = 0.0f;
+    m_lastRisingSwitch = -1.0f;
+    m_errorMax = 0.0f;
+    m_errorMin = 0.0f;
+    m_cycles = 0;
+    m_periodSum = 0.0f;
+    m_amplitudeSum = 0.0f;
+    m_measuredCycles = 0;
+    m_lastPeriod = 0.0f;
+    m_lastAmplitude = 0.0f;
+    m_bias = 0.0f;
+    m_halfErrorIntegral = 0.0f;
+    m_halfTime = 0.0f;
+    m_previousHalfErrorIntegral = 0.0f;
+    m_previousHalfTime = 0.0f;
+    m_ultimateGain = 0.0f;
+    m_ultimatePeriod = 0.0f;
+
+    if (p_request.relayAmplitude <= 0.0f || p_request.relayAmplitude > MAX_RELAY_AMPLITUDE) {
+        fail("relay amplitude out of range");
+        return;
+    }
+    if (p_request.hysteresis < 0.0f || p_request.maxPitchDeviation <= p_request.hysteresis) {
+        fail("invalid hysteresis or pitch deviation limit");
+        return;
+    }
+
+    m_relayOutput = p_request.relayAmplitude;
+    m_status = Status::RUNNING;
+    ESP_LOGI(TAG, "Relay auto-tune started - d: %.2f, h: %.2f, max deviation: %.2f, rule: %d",
+             p_request.relayAmplitude, p_request.hysteresis, p_request.maxPitchDeviation, static_cast<int>(p_request.rule));
+}
+
+void PIDAutoTuner::abort() {
+    if (m_status == Status::RUNNING) {
+        fail("aborted");
+    }
+}
+
+float PIDAutoTuner::update(float p_pitch, float p_dt) {
+    if (m_status != Status::RUNNING) {
+        return 0.0f;
+    }
+
+    m_elapsed += p_dt;
+    float l_error = m_request.baseConfig.targetAngle - p_pitch;
+
+    if (std::abs(l_error) > m_request.maxPitchDeviation) {
+        fail("pitch deviation limit exceeded");
+        return 0.0f;
+    }
+    if (m_elapsed > TIMEOUT) {
+        fail("no stable oscillation before timeout");
+        return 0.0f;
+    }
+
+    m_errorMax = std::max(m_errorMax, l_error);
+    m_errorMin = std::min(m_errorMin, l_error);
+    m_halfErrorIntegral += l_error * p_dt;
+    m_halfTime += p_dt;
+
+    if (m_relayOutput < 0.0f && l_error > m_request.hysteresis) {
+        m_relayOutput = m_request.relayAmplitude;
+        onRisingSwitch();
+        recenter();
+    } else if (m_relayOutput > 0.0f && l_error < -m_request.hysteresis) {
+        m_relayOutput = -m_request.relayAmplitude;
+        recenter();
+    }
+
+    return m_status == Status::RUNNING ? m_relayOutput + m_bias : 0.0f;
+}
+
+void PIDAutoTuner::recenter() {
+    // The relay alone cannot hold the mean pitch: a balancing robot only leans back while the wheels
+    // accelerate, so an off-centre oscillation drifts over. Integrating the mean error of the last
+    // full cycle into a relay bias holds it, the oscillation itself averages out of that mean. The
+    // integral time is CENTERING_PERIODS cycles at the relay's describing function gain, which keeps
+    // the correction independent of the robot's motor and wheel constants.
+    float l_cycleTime = m_halfTime + m_previousHalfTime;
+    if (m_lastPeriod > 0.0f && m_lastAmplitude > 0.0f && l_cycleTime > 0.0f) {
+        float l_relayGain = 4.0f * m_request.relayAmplitude / (static_cast<float>(M_PI) * m_lastAmplitude);
+        float l_meanError = (m_halfErrorIntegral + m_previousHalfErrorIntegral) / l_cycleTime;
+        m_bias += l_relayGain / (CENTERING_PERIODS * m_lastPeriod) * l_meanError * m_halfTime;
+        m_bias = std::clamp(m_bias, -m_request.relayAmplitude, m_request.relayAmplitude);
+    }
+    m_previousHalfErrorIntegral = m_halfErrorIntegral;
+    m_previousHalfTime = m_halfTime;
+    m_halfErrorIntegral = 0.0f;
+    m_halfTime = 0.0f;
+}
+
+void PIDAutoTuner::onRisingSwitch() {
+    if (m_lastRisingSwitch >= 0.0f) {
+        float l_period = m_elapsed - m_lastRisingSwitch;
+        float l_amplitude = (m_errorMax - m_errorMin) / 2.0f;
+        m_cycles++;
+        m_lastPeriod = l_period;
+        m_lastAmplitude = l_amplitude;
+
+        ESP_LOGD(TAG, "Cycle %d - period: %.3f s, amplitude: %.2f deg", m_cycles, l_period, l_amplitude);
+
+        if (m_cycles > SETTLE_CYCLES) {
+            if (l_period < MIN_PERIOD || l_period > MAX_PERIOD) {
+                fail("oscillation period out of range");
+                return;
+            }
+            m_periodSum += l_period;
+            m_amplitudeSum += l_amplitude;
+            m_measuredCycles++;
+        }
+    }
+
+    m_lastRisingSwitch = m_elapsed;
+    m_errorMax = 0.0f;
+    m_errorMin = 0.0f;
+
+    if (m_measuredCycles >= MEASURE_CYCLES) {
+        finish();
+    }
+}
+
+void PIDAutoTuner::finish() {
+    float l_amplitude = m_amplitudeSum / m_measuredCycles;
+    float l_hysteresis = m_request.hysteresis;
+    if (l_amplitude <= l_hysteresis) {
+        fail("oscillation amplitude below hysteresis");
+        return;
+    }
+
+    m_ultimatePeriod = m_periodSum / m_measuredCycles;
+    m_ultimateGain = 4.0f * m_request.relayAmplitude /
+                     (static_cast<float>(M_PI) * std::sqrt(l_amplitude * l_amplitude - l_hysteresis * l_hysteresis));
+
+    float l_kp, l_ti, l_td;
+    switch (m_request.rule) {
+        case AutoTuneRule::TYREUS_LUYBEN:
+            l_kp = m_ultimateGain / 2.2f;
+            l_ti = 2.2f * m_ultimatePeriod;
+            l_td = m_ultimatePeriod / 6.3f;
+            break;
+        case AutoTuneRule::ZIEGLER_NICHOLS:
+        default:
+            l_kp = 0.6f * m_ultimateGain;
+            l_ti = 0.5f * m_ultimatePeriod;
+            l_td = 0.125f * m_ultimatePeriod;
+            break;
+    }
+
+    m_result.kp = std::min(l_kp, MAX_KP);
+    m_result.ki = std::min(l_kp / l_ti, MAX_KI);
+    m_result.kd = std::min(l_kp * l_td, MAX_KD);
+    m_status = Status::DONE;
+
+    ESP_LOGI(TAG, "Auto-tune complete - Ku: %.4f, Tu: %.3f s -> Kp: %.4f, Ki: %.4f, Kd: %.4f",
+             m_ultimateGain, m_ultimatePeriod, m_result.kp, m_result.ki, m_result.kd);
+}
+
+void PIDAutoTuner::fail(const char* p_reason) {
+    m_status = Status::ABORTED;
+    m_relayOutput = 0.0f;
+    ESP_LOGW(TAG, "Auto-tune aborted: %s", p_reason);
+}
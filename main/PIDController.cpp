@@ -2,7 +2,8 @@
 #include "include/RuntimeConfig.hpp"
 #include <algorithm>
 
-PIDController::PIDController() {
+PIDController::PIDController() : m_config(), m_gainScale(), m_lastErrorSample(0.0f), m_lastDerivative(0.0f),
+                                 m_lastTerms() {
     m_mutex = xSemaphoreCreateMutex();
 }
 
@@ -20,6 +21,68 @@ esp_err_t PIDController::setConfig(const PIDConfig& p_config) {
     return ESP_OK;
 }
 
+void PIDController::setTargetAngle(float p_targetAngle) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_config.targetAngle = p_targetAngle;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+void PIDController::setGainScale(const GainScale& p_scale) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_gainScale = p_scale;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+void PIDController::setDerivativeFilterChain(const FilterChainConfig& p_chain) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        // Coefficients follow in the next compute(), where the sample period is known
+        m_derivativeChainConfig = p_chain;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+float PIDController::bumplessIntegral(const PIDConfig& p_newConfig, float p_integral) const {
+    float l_integral = p_integral;
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        bool l_gainsChanged = p_newConfig.kp != m_config.kp || p_newConfig.ki != m_config.ki || p_newConfig.kd != m_config.kd;
+        float l_newKi = p_newConfig.ki * m_gainScale.ki;
+
+        // Without an integral gain there is nothing to absorb the step
+        if (l_gainsChanged && l_newKi != 0.0f) {
+            float l_oldOutput = m_config.kp * m_gainScale.kp * m_lastErrorSample + m_config.ki * m_gainScale.ki * p_integral +
+                                m_config.kd * m_gainScale.kd * m_lastDerivative;
+            float l_newProportional = p_newConfig.kp * m_gainScale.kp * m_lastErrorSample +
+                                      p_newConfig.kd * m_gainScale.kd * m_lastDerivative;
+            l_integral = applyLimits((l_oldOutput - l_newProportional) / l_newKi, p_newConfig.itermMin, p_newConfig.itermMax);
+            ESP_LOGD(TAG, "Bumpless gain change - integral %.3f -> %.3f", p_integral, l_integral);
+        }
+        xSemaphoreGive(m_mutex);
+    }
+    return l_integral;
+}
+
+void PIDController::seedDerivative(float& p_lastError, float p_currentValue) const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        p_lastError = m_config.targetAngle - p_currentValue;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+void PIDController::reset() {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_derivativeFilter.reset();
+        m_derivativeChain.reset();
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+esp_err_t PIDController::setLQRConfig(const LQRConfig&) {
+    // No state feedback gains in a PID, the LQR section only applies when it is the selected controller
+    return ESP_OK;
+}
+
 esp_err_t PIDController::init(const IRuntimeConfig& p_config) {
     ESP_LOGI(TAG, "Initializing PID Controller");
     if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
@@ -35,35 +98,10 @@ esp_err_t PIDController::init(const IRuntimeConfig& p_config) {
 float PIDController::compute(float& p_integral, float& p_lastError, float p_currentValue, float p_dt) const {
     if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
         float l_currentError = m_config.targetAngle - p_currentValue;
-        
-        // Proportional term
-        float l_pTerm = m_config.kp * l_currentError;
-        
-        // Integral term 
-        p_integral += l_currentError * p_dt;
-        p_integral = applyLimits(p_integral, m_config.itermMin, m_config.itermMax);
-        float l_iTerm = m_config.ki * p_integral;
-        
-        // Derivative term
-        float dTerm = m_config.kd * (l_currentError - p_lastError) / p_dt;
+        float l_errorRate = (l_currentError - p_lastError) / p_dt;
         p_lastError = l_currentError;
-        
-        // Calculate total output
-        float l_output = l_pTerm + l_iTerm + dTerm;
-        
-        // Limit output value
-        l_output = std::max(-1.0f, std::min(l_output, 1.0f));
-
-        if (l_output > 0) {
-            l_output = m_config.outputMin + (l_output) * (m_config.outputMax-m_config.outputMin);
-        } else if (l_output < 0) {
-            l_output = -m_config.outputMin + (l_output) * (m_config.outputMax-m_config.outputMin);
-        } else {
-            l_output = 0;
-        }   
-
-        ESP_LOGV(TAG, "PID Computation - Error: %.2f, P: %.2f, I: %.2f, D: %.2f, Output: %.2f", 
-                        l_currentError, l_pTerm, l_iTerm, dTerm, l_output);
+
+        float l_output = computeOutput(p_integral, l_currentError, l_errorRate, p_dt);
         xSemaphoreGive(m_mutex);
         return l_output;
     }
@@ -71,6 +109,70 @@ float PIDController::compute(float& p_integral, float& p_lastError, float p_curr
     return 0.0f;  // Return 0 if mutex couldn't be obtained    
 }
 
+float PIDController::compute(float& p_integral, float& p_lastError, const SensorData& p_sensorData) const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        float l_currentError = m_config.targetAngle - p_sensorData.pitch;
+        p_lastError = l_currentError;
+
+        // Derivative on measurement: the gyro rate is cleaner than a differenced complementary
+        // filter angle and does not kick when the setpoint moves
+        float l_output = computeOutput(p_integral, l_currentError, -p_sensorData.pitchRate, p_sensorData.dt);
+        xSemaphoreGive(m_mutex);
+        return l_output;
+    }
+    ESP_LOGW(TAG, "Failed to acquire mutex in compute");
+    return 0.0f;
+}
+
+float PIDController::computeOutput(float& p_integral, float p_error, float p_errorRate, float p_dt) const {
+    // Proportional term
+    float l_pTerm = m_config.kp * m_gainScale.kp * p_error;
+
+    // Integral term 
+    p_integral += p_error * p_dt;
+    p_integral = applyLimits(p_integral, m_config.itermMin, m_config.itermMax);
+    float l_iTerm = m_config.ki * m_gainScale.ki * p_integral;
+
+    // Derivative term, low-passed and notched before the gain
+    m_derivativeFilter.configure(m_config.dFilterType, m_config.dCutoffHz, p_dt);
+    m_derivativeChain.configure(m_derivativeChainConfig, p_dt);
+    m_lastDerivative = m_derivativeChain.process(m_derivativeFilter.apply(p_errorRate));
+    m_lastErrorSample = p_error;
+    float l_dTerm = m_config.kd * m_gainScale.kd * m_lastDerivative;
+    m_lastTerms = {l_pTerm, l_iTerm, l_dTerm};
+
+    // Calculate total output
+    float l_output = mapOutput(l_pTerm + l_iTerm + l_dTerm);
+
+    ESP_LOGV(TAG, "PID Computation - Error: %.2f, P: %.2f, I: %.2f, D: %.2f, Output: %.2f", 
+                    p_error, l_pTerm, l_iTerm, l_dTerm, l_output);
+    return l_output;
+}
+
+ControllerTerms PIDController::getLastTerms() const {
+    ControllerTerms l_terms {};
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        l_terms = m_lastTerms;
+        xSemaphoreGive(m_mutex);
+    }
+    return l_terms;
+}
+
+float PIDController::mapOutput(float p_output) const {
+    // Limit output value
+    float l_output = std::max(-1.0f, std::min(p_output, 1.0f));
+
+    // Linear map onto [outputMin, outputMax]; deadband and friction are handled by the motor output shaper
+    if (l_output > 0) {
+        l_output = l_output * m_config.outputMax;
+    } else if (l_output < 0) {
+        l_output = -l_output * m_config.outputMin;
+    } else {
+        l_output = 0;
+    }
+    return l_output;
+}
+
 float PIDController::applyLimits(float p_value, float p_min, float p_max) const {
     return std::max(p_min, std::min(p_value, p_max));
 }
\ No newline at end of file
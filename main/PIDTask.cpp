@@ -1,12 +1,19 @@
 #include "include/PIDTask.hpp"
 #include "include/StateMachine.hpp"
+#include "include/LoopPeriod.hpp"
+#include "include/SysIdLog.hpp"
 #include "interfaces/IPIDController.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
 
-PIDTask::PIDTask(IPIDController& p_pid, QueueHandle_t p_sensorQueue, QueueHandle_t p_outputQueue, 
-                 QueueHandle_t p_cfgQueue, IStateMachine& p_sm)
-    : m_pidController(p_pid), m_sensorDataQueue(p_sensorQueue), m_pidOutputQueue(p_outputQueue),
-      m_configQueue(p_cfgQueue), m_stateMachine(p_sm), m_taskHandle(nullptr), 
-      m_integral(0.0f), m_lastError(0.0f) {}
+#include <algorithm>
+
+PIDTask::PIDTask(IPIDController& p_pid, IPIDController& p_yawPid, const ControlMailboxes& p_mailboxes,
+                 SysIdLog& p_sysIdLog, TelemetryRing& p_telemetryRing, IStateMachine& p_sm)
+    : m_pidController(p_pid), m_yawController(p_yawPid), m_mailboxes(p_mailboxes), m_stateMachine(p_sm), m_taskHandle(nullptr), 
+      m_controlPeriod(LoopPeriod::toTicks(LoopPeriod::DEFAULT_INTERVAL_MS)), m_integral(0.0f), m_lastError(0.0f),
+      m_wasBalancing(false), m_seedPending(false), m_engageElapsed(0.0f), m_engageRampTime(0.0f),
+      m_yawIntegral(0.0f), m_yawLastError(0.0f), m_baseTargetAngle(0.0f), m_systemIdentifier(p_sysIdLog),
+      m_telemetryRing(p_telemetryRing), m_telemetrySequence(0) {}
 
 PIDTask::~PIDTask() {
     if (m_taskHandle != nullptr) {
@@ -14,7 +21,16 @@ PIDTask::~PIDTask() {
     }
 }
 
-esp_err_t PIDTask::init(const IRuntimeConfig&) {
+esp_err_t PIDTask::init(const IRuntimeConfig& p_config) {
+    m_controlPeriod = LoopPeriod::toTicks(p_config.getMainLoopIntervalMs());
+    m_yawController.setConfig(p_config.getYawPidConfig());
+    m_velocityLoop.setConfig(p_config.getVelocityLoopConfig());
+    m_gainSchedule.setConfig(p_config.getGainScheduleConfig());
+    m_predictor.setConfig(p_config.getPredictorConfig());
+    m_pidController.setDerivativeFilterChain(p_config.getFilterBankConfig().dTerm);
+    m_baseTargetAngle = p_config.getPidConfig().targetAngle;
+    m_engageRampTime = p_config.getPidConfig().engageRampMs / 1000.0f;
+
     BaseType_t result = xTaskCreate(
         taskFunction,
         TAG,
@@ -40,32 +56,244 @@ void PIDTask::run() {
     
     while (true) {
         updateConfig();
+        checkAutoTuneRequest();
+        checkSysIdRequest();
+        LoopPeriod::peekTicks(m_mailboxes.loopPeriod, m_controlPeriod);
 
         if (m_stateMachine.getState() == StateMachine::State::BALANCING) {
+            if (!m_wasBalancing) {
+                m_wasBalancing = true;
+                m_seedPending = true;
+                m_engageElapsed = 0.0f;
+            }
+
             SensorData sensorData;
-            if (xQueueReceive(m_sensorDataQueue, &sensorData, 0) == pdTRUE) {
-                float dt = CONTROL_PERIOD / 1000.0f;  // Convert to seconds
-                float output = m_pidController.compute(m_integral, m_lastError, sensorData.pitch, dt);
+            if (xQueueReceive(m_mailboxes.sensorData, &sensorData, 0) == pdTRUE) {
+                MotorFeedback l_feedback {};
+                if (xQueuePeek(m_mailboxes.motorFeedback, &l_feedback, 0) == pdTRUE) {
+                    m_predictor.updateLatency(l_feedback.latency);
+                }
+                SensorData l_predicted = m_predictor.predict(sensorData);
+
+                if (m_seedPending) {
+                    onEngage(l_predicted);
+                }
+
+                PIDOutput output { computeOutput(l_predicted), computeYawOutput(sensorData),
+                                   sensorData.timestamp, l_predicted.pitch, m_predictor.getHorizon(),
+                                   m_pidController.getLastTerms() };
+
+                float l_ramp = engageRamp(sensorData.dt);
+                output.output *= l_ramp;
+                output.yawOutput *= l_ramp;
+
+                // Checked against the measured pitch, the excitation goes on top of the full command
+                float l_excitation = m_systemIdentifier.update(sensorData);
+                output.output += m_pidController.mapOutput(l_excitation);
+                m_systemIdentifier.record(sensorData, output.output);
             
-                if (xQueueSend(m_pidOutputQueue, &output, 0) != pdTRUE) {
+                if (xQueueSend(m_mailboxes.pidOutput, &output, 0) != pdTRUE) {
                     ESP_LOGW(TAG, "Failed to send PID output - queue might be full");
                 }
                 
-                ESP_LOGV(TAG, "PID Output: %.2f", output);
+                recordTelemetry(sensorData, &output, l_feedback);
+
+                ESP_LOGV(TAG, "PID Output: %.2f, Yaw Output: %.3f", output.output, output.yawOutput);
             }
         } else {
+            m_wasBalancing = false;
+
+            // Nothing is computed, but the attitude stays observable at loop rate. Drained rather than
+            // peeked: nobody else consumes the queue while idle, once full it would only ever show
+            // its oldest sample and the SensorTask's sends would fail.
+            SensorData l_sensorData;
+            bool l_received = false;
+            while (xQueueReceive(m_mailboxes.sensorData, &l_sensorData, 0) == pdTRUE) {
+                l_received = true;
+            }
+            if (l_received) {
+                MotorFeedback l_feedback {};
+                xQueuePeek(m_mailboxes.motorFeedback, &l_feedback, 0);
+                recordTelemetry(l_sensorData, nullptr, l_feedback);
+            }
+
+            // The relay experiment only makes sense while the robot is up
+            m_autoTuner.abort();
+            m_systemIdentifier.abort();
+
             // Reset integral term when not balancing
             m_integral = 0.0f;
             m_lastError = 0.0f;
+            m_yawIntegral = 0.0f;
+            m_yawLastError = 0.0f;
+            m_pidController.reset();
+            m_yawController.reset();
+            m_velocityLoop.reset();
+            m_predictor.reset();
         }
 
-        vTaskDelayUntil(&lastWakeTime, CONTROL_PERIOD);
+        vTaskDelayUntil(&lastWakeTime, m_controlPeriod);
     }
 }
 
 void PIDTask::updateConfig() {
+    bool l_balancing = m_wasBalancing && !m_seedPending;
+
     PIDConfig newConfig;
-    if (xQueueReceive(m_configQueue, &newConfig, 0) == pdTRUE) {
+    if (xQueueReceive(m_mailboxes.config, &newConfig, 0) == pdTRUE) {
+        // Re-seed the integrator so a retune while balancing does not step the motor command
+        if (l_balancing) {
+            m_integral = m_pidController.bumplessIntegral(newConfig, m_integral);
+        }
         m_pidController.setConfig(newConfig);
+        m_engageRampTime = newConfig.engageRampMs / 1000.0f;
+        m_baseTargetAngle = newConfig.targetAngle;
+    }
+
+    LQRConfig newLQRConfig;
+    if (xQueueReceive(m_mailboxes.lqrConfig, &newLQRConfig, 0) == pdTRUE) {
+        m_pidController.setLQRConfig(newLQRConfig);
+    }
+
+    if (xQueueReceive(m_mailboxes.gainSchedule, &m_receivedSchedule, 0) == pdTRUE) {
+        if (!m_gainSchedule.setConfig(m_receivedSchedule)) {
+            ESP_LOGW(TAG, "Rejected malformed gain schedule");
+        }
+        if (!m_gainSchedule.isEnabled()) {
+            m_pidController.setGainScale(GainScale());
+        }
+    }
+
+    VelocityLoopConfig newVelocityLoopConfig;
+    if (xQueueReceive(m_mailboxes.velocityLoop, &newVelocityLoopConfig, 0) == pdTRUE) {
+        m_velocityLoop.setConfig(newVelocityLoopConfig);
+    }
+
+    PredictorConfig newPredictorConfig;
+    if (xQueueReceive(m_mailboxes.predictor, &newPredictorConfig, 0) == pdTRUE) {
+        m_predictor.setConfig(newPredictorConfig);
+    }
+
+    // Shared with the sensor and motor tasks, so peeked rather than consumed
+    FilterBankConfig l_filters;
+    if (xQueuePeek(m_mailboxes.filterBank, &l_filters, 0) == pdTRUE) {
+        m_pidController.setDerivativeFilterChain(l_filters.dTerm);
+    }
+
+    PIDConfig newYawConfig;
+    if (xQueueReceive(m_mailboxes.yawConfig, &newYawConfig, 0) == pdTRUE) {
+        if (l_balancing) {
+            m_yawIntegral = m_yawController.bumplessIntegral(newYawConfig, m_yawIntegral);
+        }
+        m_yawController.setConfig(newYawConfig);
     }
 }
+
+
+void PIDTask::onEngage(const SensorData& p_sensorData) {
+    // Integrators start from zero, the first differenced D term must not see a jump from zero error
+    m_pidController.setTargetAngle(m_baseTargetAngle);
+    m_pidController.seedDerivative(m_lastError, p_sensorData.pitch);
+    m_yawController.seedDerivative(m_yawLastError, p_sensorData.yawRate);
+    m_seedPending = false;
+}
+
+float PIDTask::engageRamp(float p_dt) {
+    if (m_engageElapsed >= m_engageRampTime) {
+        return 1.0f;
+    }
+    m_engageElapsed += p_dt;
+    return std::min(m_engageElapsed / m_engageRampTime, 1.0f);
+}
+
+void PIDTask::checkAutoTuneRequest() {
+    AutoTuneRequest request;
+    if (xQueueReceive(m_mailboxes.autoTune, &request, 0) == pdTRUE) {
+        if (m_stateMachine.getState() != StateMachine::State::BALANCING) {
+            ESP_LOGW(TAG, "Auto-tune request ignored - robot is not balancing");
+            return;
+        }
+        if (m_systemIdentifier.getStatus() == SystemIdentifier::Status::RUNNING) {
+            ESP_LOGW(TAG, "Auto-tune request ignored - identification run in progress");
+            return;
+        }
+        m_autoTuner.start(request);
+        // The relay owns the setpoint while it runs, the outer loop restarts bumplessly afterwards
+        m_velocityLoop.reset();
+    }
+}
+
+void PIDTask::checkSysIdRequest() {
+    SysIdRequest request;
+    if (xQueueReceive(m_mailboxes.sysId, &request, 0) == pdTRUE) {
+        if (m_stateMachine.getState() != StateMachine::State::BALANCING) {
+            ESP_LOGW(TAG, "Identification request ignored - robot is not balancing");
+            return;
+        }
+        if (m_autoTuner.getStatus() == PIDAutoTuner::Status::RUNNING) {
+            ESP_LOGW(TAG, "Identification request ignored - auto-tune in progress");
+            return;
+        }
+        m_systemIdentifier.start(request, m_baseTargetAngle, LoopPeriod::toSeconds(m_controlPeriod));
+    }
+}
+
+float PIDTask::computeOutput(const SensorData& p_sensorData) {
+    if (m_autoTuner.getStatus() != PIDAutoTuner::Status::RUNNING) {
+        float l_targetAngle = m_velocityLoop.update(p_sensorData, m_baseTargetAngle);
+        m_pidController.setTargetAngle(l_targetAngle);
+
+        if (m_gainSchedule.isEnabled()) {
+            float l_wheelSpeed = 0.5f * (p_sensorData.leftWheelSpeed + p_sensorData.rightWheelSpeed);
+            m_pidController.setGainScale(m_gainSchedule.evaluate(l_targetAngle - p_sensorData.pitch, l_wheelSpeed));
+        }
+
+        // dt travels with the sample so the estimator and PID always agree on the period
+        return m_pidController.compute(m_integral, m_lastError, p_sensorData);
+    }
+
+    float l_relay = m_autoTuner.update(p_sensorData.pitch, p_sensorData.dt);
+
+    switch (m_autoTuner.getStatus()) {
+        case PIDAutoTuner::Status::RUNNING:
+            return m_pidController.mapOutput(l_relay);
+        case PIDAutoTuner::Status::DONE: {
+            PIDConfig l_tuned = m_autoTuner.getResult();
+            m_pidController.setConfig(l_tuned);
+            m_integral = 0.0f;
+            m_lastError = l_tuned.targetAngle - p_sensorData.pitch;
+            // ConfigurationTask persists the result and re-broadcasts it
+            xQueueOverwrite(m_mailboxes.autoTuneResult, &l_tuned);
+            return m_pidController.compute(m_integral, m_lastError, p_sensorData);
+        }
+        default:
+            // Aborted - fall back to the previous gains straight away
+            m_integral = 0.0f;
+            m_pidController.seedDerivative(m_lastError, p_sensorData.pitch);
+            return m_pidController.compute(m_integral, m_lastError, p_sensorData);
+    }
+}
+
+float PIDTask::computeYawOutput(const SensorData& p_sensorData) {
+    // Closed on the gyro rate, the target "angle" of the yaw config is the target yaw rate
+    return m_yawController.compute(m_yawIntegral, m_yawLastError, p_sensorData.yawRate, p_sensorData.dt);
+}
+void PIDTask::recordTelemetry(const SensorData& p_sensorData, const PIDOutput* p_output, const MotorFeedback& p_feedback) {
+    TelemetryData l_record {};
+    l_record.sequence = m_telemetrySequence++;
+    l_record.state = static_cast<uint8_t>(m_stateMachine.getState());
+    l_record.sensorData = p_sensorData;
+    if (p_output != nullptr) {
+        l_record.pidOutput = p_output->output;
+        l_record.predictedPitch = p_output->predictedPitch;
+        l_record.predictionHorizon = p_output->predictionHorizon;
+        l_record.terms = p_output->terms;
+    }
+    // From the motor update of the previous cycle
+    l_record.measuredLatency = p_feedback.latency;
+    l_record.leftDuty = p_feedback.leftDuty;
+    l_record.rightDuty = p_feedback.rightDuty;
+
+    // Never waits, a full ring drops the record and the sequence gap shows where
+    m_telemetryRing.push(l_record);
+}
@@ -0,0 +1,57 @@
+#include "include/PitchPredictor.hpp"
+#include <algorithm>
+
+PitchPredictor::PitchPredictor()
+    : m_config(), m_haveLatency(false), m_latency(0.0f), m_horizon(0.0f), m_havePrevious(false), m_previousRate(0.0f) {}
+
+void PitchPredictor::setConfig(const PredictorConfig& p_config) {
+    if (p_config.secondOrder && !m_config.secondOrder) {
+        // The rate history is stale when second order was off
+        m_havePrevious = false;
+        m_accelFilter.reset();
+    }
+    m_config = p_config;
+}
+
+void PitchPredictor::reset() {
+    // The latency estimate survives, it is a property of the pipeline and not of the run
+    m_havePrevious = false;
+    m_accelFilter.reset();
+}
+
+void PitchPredictor::updateLatency(float p_latency) {
+    // Negative or absurd values come from a command older than the last loop period change, drop them
+    if (!(p_latency >= 0.0f) || p_latency > 1.0f) {
+        return;
+    }
+    if (!m_haveLatency) {
+        m_latency = p_latency;
+        m_haveLatency = true;
+    } else {
+        m_latency += LATENCY_SMOOTHING * (p_latency - m_latency);
+    }
+}
+
+SensorData PitchPredictor::predict(const SensorData& p_sample) {
+    SensorData l_predicted = p_sample;
+    if (!m_config.enabled) {
+        m_horizon = 0.0f;
+        return l_predicted;
+    }
+
+    m_horizon = std::clamp(m_latency + m_config.extraLatencyMs / 1000.0f, 0.0f, m_config.maxLatencyMs / 1000.0f);
+
+    float l_accel = 0.0f;
+    if (m_config.secondOrder) {
+        m_accelFilter.configure(DerivativeFilterType::FIRST_ORDER, m_config.accelCutoffHz, p_sample.dt);
+        if (m_havePrevious && p_sample.dt > 0.0f) {
+            l_accel = m_accelFilter.apply((p_sample.pitchRate - m_previousRate) / p_sample.dt);
+        }
+        m_previousRate = p_sample.pitchRate;
+        m_havePrevious = true;
+    }
+
+    l_predicted.pitch += p_sample.pitchRate * m_horizon + 0.5f * l_accel * m_horizon * m_horizon;
+    l_predicted.pitchRate += l_accel * m_horizon;
+    return l_predicted;
+}
@@ -1,9 +1,169 @@
 #include "include/RuntimeConfig.hpp"
+#include "include/JsonWriter.hpp"
+#include "include/JsonArena.hpp"
 #include <fstream>
+#include <cstring>
 #include "dirent.h" 
 #include "cJSON.h"
 
 
+namespace {
+
+const char* derivativeFilterName(DerivativeFilterType p_type) {
+    switch (p_type) {
+        case DerivativeFilterType::FIRST_ORDER: return "first_order";
+        case DerivativeFilterType::BIQUAD: return "biquad";
+        default: return "none";
+    }
+}
+
+void parseDerivativeFilter(cJSON* p_section, PIDConfig& p_config) {
+    cJSON* item = cJSON_GetObjectItem(p_section, "d_filter");
+    if (item && cJSON_IsString(item)) {
+        if (strcmp(item->valuestring, "first_order") == 0) p_config.dFilterType = DerivativeFilterType::FIRST_ORDER;
+        else if (strcmp(item->valuestring, "biquad") == 0) p_config.dFilterType = DerivativeFilterType::BIQUAD;
+        else p_config.dFilterType = DerivativeFilterType::NONE;
+    }
+    if ((item = cJSON_GetObjectItem(p_section, "d_cutoff_hz")) && cJSON_IsNumber(item)) p_config.dCutoffHz = item->valuedouble;
+}
+
+typedef float GainTable[GainScheduleConfig::MAX_POINTS][GainScheduleConfig::MAX_POINTS];
+
+void writeGainTable(JsonWriter& p_json, const char* p_key, const GainTable& p_table, const GainScheduleConfig& p_config) {
+    p_json.beginArray(p_key);
+    for (int s = 0; s < p_config.speedPoints; s++) {
+        p_json.numbers(nullptr, p_table[s], p_config.errorPoints);
+    }
+    p_json.endArray();
+}
+
+int parseBreakpoints(cJSON* p_array, float* p_breakpoints) {
+    if (!p_array || !cJSON_IsArray(p_array) || cJSON_GetArraySize(p_array) > GainScheduleConfig::MAX_POINTS) {
+        return -1;
+    }
+    int count = 0;
+    cJSON* item = NULL;
+    cJSON_ArrayForEach(item, p_array) {
+        if (!cJSON_IsNumber(item)) return -1;
+        p_breakpoints[count++] = item->valuedouble;
+    }
+    return count;
+}
+
+// Either rows per speed breakpoint or, for a 1-D schedule, a flat row over the error breakpoints
+bool parseGainTable(cJSON* p_array, GainTable& p_table, const GainScheduleConfig& p_config) {
+    if (!p_array || !cJSON_IsArray(p_array)) return false;
+    cJSON* first = cJSON_GetArrayItem(p_array, 0);
+    bool flat = first && cJSON_IsNumber(first);
+    if (flat) {
+        return p_config.speedPoints == 1 && parseBreakpoints(p_array, p_table[0]) == p_config.errorPoints;
+    }
+    if (cJSON_GetArraySize(p_array) != p_config.speedPoints) return false;
+    int s = 0;
+    cJSON* row = NULL;
+    cJSON_ArrayForEach(row, p_array) {
+        if (parseBreakpoints(row, p_table[s++]) != p_config.errorPoints) return false;
+    }
+    return true;
+}
+
+bool parseGainSchedule(cJSON* p_section, GainScheduleConfig& p_config) {
+    cJSON* item = NULL;
+    if ((item = cJSON_GetObjectItem(p_section, "enabled")) && cJSON_IsBool(item)) p_config.enabled = cJSON_IsTrue(item);
+
+    cJSON* errors = cJSON_GetObjectItem(p_section, "error_breakpoints");
+    if (!errors) {
+        // Only toggling the schedule, keep the tables
+        return true;
+    }
+    p_config.errorPoints = parseBreakpoints(errors, p_config.errorBreakpoints);
+
+    cJSON* speeds = cJSON_GetObjectItem(p_section, "speed_breakpoints");
+    if (speeds) {
+        p_config.speedPoints = parseBreakpoints(speeds, p_config.speedBreakpoints);
+    } else {
+        p_config.speedPoints = 1;
+        p_config.speedBreakpoints[0] = 0.0f;
+    }
+    if (p_config.errorPoints < 1 || p_config.speedPoints < 1) return false;
+
+    return parseGainTable(cJSON_GetObjectItem(p_section, "kp_scale"), p_config.kpScale, p_config) &&
+           parseGainTable(cJSON_GetObjectItem(p_section, "ki_scale"), p_config.kiScale, p_config) &&
+           parseGainTable(cJSON_GetObjectItem(p_section, "kd_scale"), p_config.kdScale, p_config) &&
+           GainSchedule::isValid(p_config);
+}
+
+const char* biquadTypeName(BiquadType p_type) {
+    switch (p_type) {
+        case BiquadType::LOW_PASS: return "low_pass";
+        case BiquadType::HIGH_PASS: return "high_pass";
+        case BiquadType::NOTCH: return "notch";
+        default: return "none";
+    }
+}
+
+void writeFilterChain(JsonWriter& p_json, const char* p_key, const FilterChainConfig& p_chain) {
+    p_json.beginArray(p_key);
+    for (int i = 0; i < p_chain.stages; i++) {
+        p_json.beginObject()
+            .string("type", biquadTypeName(p_chain.stage[i].type))
+            .number("freq_hz", p_chain.stage[i].frequencyHz)
+            .number("q", p_chain.stage[i].q)
+            .endObject();
+    }
+    p_json.endArray();
+}
+
+bool appendToString(void* p_context, const char* p_data, size_t p_length) {
+    static_cast<std::string*>(p_context)->append(p_data, p_length);
+    return true;
+}
+
+bool writeToFile(void* p_context, const char* p_data, size_t p_length) {
+    std::ofstream& file = *static_cast<std::ofstream*>(p_context);
+    file.write(p_data, p_length);
+    return file.good();
+}
+
+// An array of {"type", "freq_hz", "q"} stages, applied in order
+bool parseFilterChain(cJSON* p_array, FilterChainConfig& p_chain) {
+    if (!cJSON_IsArray(p_array) || cJSON_GetArraySize(p_array) > FilterChainConfig::MAX_STAGES) return false;
+    FilterChainConfig chain;
+    cJSON* stage = NULL;
+    cJSON_ArrayForEach(stage, p_array) {
+        BiquadStageConfig& config = chain.stage[chain.stages++];
+        cJSON* item = cJSON_GetObjectItem(stage, "type");
+        if (!item || !cJSON_IsString(item)) return false;
+        if (strcmp(item->valuestring, "low_pass") == 0) config.type = BiquadType::LOW_PASS;
+        else if (strcmp(item->valuestring, "high_pass") == 0) config.type = BiquadType::HIGH_PASS;
+        else if (strcmp(item->valuestring, "notch") == 0) config.type = BiquadType::NOTCH;
+        else if (strcmp(item->valuestring, "none") == 0) config.type = BiquadType::NONE;
+        else return false;
+        if ((item = cJSON_GetObjectItem(stage, "freq_hz")) && cJSON_IsNumber(item)) config.frequencyHz = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(stage, "q")) && cJSON_IsNumber(item)) config.q = item->valuedouble;
+        if (!BiquadCascade::isValid(config)) return false;
+    }
+    p_chain = chain;
+    return true;
+}
+
+// Chains missing from the section are kept, a malformed chain keeps its previous stages
+bool parseFilterBank(cJSON* p_section, FilterBankConfig& p_bank) {
+    const struct { const char* name; FilterChainConfig* chain; } chains[] = {
+        {"gyro", &p_bank.gyro}, {"accel", &p_bank.accel}, {"d_term", &p_bank.dTerm}, {"motor", &p_bank.motor}
+    };
+    bool valid = true;
+    for (const auto& entry : chains) {
+        cJSON* item = cJSON_GetObjectItem(p_section, entry.name);
+        if (item && !parseFilterChain(item, *entry.chain)) {
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+}
+
 RuntimeConfig::RuntimeConfig() {
     m_mutex = xSemaphoreCreateMutex();
 }
@@ -99,14 +259,19 @@ esp_err_t RuntimeConfig::init(const std::string& filename) {
 
 esp_err_t RuntimeConfig::save(const std::string& filename) const {
     ESP_LOGI(TAG, "Saving RuntimeConfig to file: %s", filename.c_str());
-    std::string json = toJson();
     std::ofstream file(filename);
     if (!file.is_open()) {
         ESP_LOGE(TAG, "Failed to open config file for writing: %s", filename.c_str());
         return ESP_FAIL;
     }
 
-    file << json;
+    // Streamed straight into the file, the document never exists in RAM as a whole
+    char buffer[JSON_CHUNK_SIZE];
+    JsonWriter json(buffer, sizeof(buffer), writeToFile, &file, true);
+    if (!writeJson(json, true)) {
+        ESP_LOGE(TAG, "Failed to write config file: %s", filename.c_str());
+        return ESP_FAIL;
+    }
     file.close();
 
     ESP_LOGI(TAG, "RuntimeConfig saved successfully");
@@ -115,47 +280,170 @@ esp_err_t RuntimeConfig::save(const std::string& filename) const {
 
 std::string RuntimeConfig::toJson() const {
     ESP_LOGD(TAG, "Converting RuntimeConfig to JSON");
-    cJSON *root = cJSON_CreateObject();
-
-    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
-        cJSON *wifi = cJSON_CreateObject();
-        cJSON_AddStringToObject(wifi, "ssid", m_wifiSSID.c_str());
-        cJSON_AddStringToObject(wifi, "password", m_wifiPassword.c_str());
-        cJSON_AddItemToObject(root, "wifi", wifi);
-
-        cJSON *pid = cJSON_CreateObject();
-        cJSON_AddNumberToObject(pid, "kp", m_pidConfig.kp);
-        cJSON_AddNumberToObject(pid, "ki", m_pidConfig.ki);
-        cJSON_AddNumberToObject(pid, "kd", m_pidConfig.kd);
-        cJSON_AddNumberToObject(pid, "target_angle", m_pidConfig.targetAngle);
-        cJSON_AddNumberToObject(pid, "iterm_min", m_pidConfig.itermMin);
-        cJSON_AddNumberToObject(pid, "iterm_max", m_pidConfig.itermMax);
-        cJSON_AddNumberToObject(pid, "output_min", m_pidConfig.outputMin);
-        cJSON_AddNumberToObject(pid, "output_max", m_pidConfig.outputMax);
-
-        cJSON_AddItemToObject(root, "pid", pid);
-
-        cJSON *mpu6050 = cJSON_CreateObject();
-        cJSON_AddNumberToObject(mpu6050, "calibration_samples", m_mpuCalibrationSamples);
-        cJSON_AddItemToObject(root, "mpu6050", mpu6050);
-
-        cJSON *main_loop = cJSON_CreateObject();
-        cJSON_AddNumberToObject(main_loop, "interval_ms", m_mainLoopIntervalSamples);
-        cJSON_AddItemToObject(root, "main_loop", main_loop);
-        xSemaphoreGive(m_mutex);
+    std::string result;
+    char buffer[JSON_CHUNK_SIZE];
+    JsonWriter json(buffer, sizeof(buffer), appendToString, &result, true);
+    if (!writeJson(json, true)) {
+        ESP_LOGE(TAG, "Failed to serialize configuration");
+        return std::string();
     }
+    return result;
+}
 
-    char *json_str = cJSON_Print(root);
-    std::string result(json_str);
-    free(json_str);
-    cJSON_Delete(root);
+bool RuntimeConfig::writeJson(JsonWriter& p_json, bool p_includeWifi) const {
+    // Copied out so the lock is not held while the writer waits on a socket or a file
+    PIDConfig l_pid, l_yaw;
+    ControllerType l_controllerType = ControllerType::PID;
+    LQRConfig l_lqr;
+    GainScheduleConfig l_schedule;
+    VelocityLoopConfig l_velocity;
+    PredictorConfig l_predictor;
+    FilterBankConfig l_filters;
+    MotorDriverType l_motorDriver = MotorDriverType::LEDC;
+    MotorShapingConfig l_motor;
+    UdpTelemetryConfig l_udp;
+    int l_calibrationSamples = 0, l_mainLoopInterval = 0;
+    std::string l_ssid, l_password;
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    l_pid = m_pidConfig;
+    l_yaw = m_yawPidConfig;
+    l_controllerType = m_controllerType;
+    l_lqr = m_lqrConfig;
+    l_schedule = m_gainScheduleConfig;
+    l_velocity = m_velocityLoopConfig;
+    l_predictor = m_predictorConfig;
+    l_filters = m_filterBankConfig;
+    l_motorDriver = m_motorDriverType;
+    l_motor = m_motorShapingConfig;
+    l_udp = m_udpTelemetryConfig;
+    l_calibrationSamples = m_mpuCalibrationSamples;
+    l_mainLoopInterval = m_mainLoopIntervalSamples;
+    if (p_includeWifi) {
+        l_ssid = m_wifiSSID;
+        l_password = m_wifiPassword;
+    }
+    xSemaphoreGive(m_mutex);
+
+    p_json.beginObject();
+    if (p_includeWifi) {
+        p_json.beginObject("wifi")
+            .string("ssid", l_ssid.c_str())
+            .string("password", l_password.c_str())
+            .endObject();
+    }
 
-    return result;
+    p_json.beginObject("pid")
+        .number("kp", l_pid.kp)
+        .number("ki", l_pid.ki)
+        .number("kd", l_pid.kd)
+        .number("target_angle", l_pid.targetAngle)
+        .number("iterm_min", l_pid.itermMin)
+        .number("iterm_max", l_pid.itermMax)
+        .number("output_min", l_pid.outputMin)
+        .number("output_max", l_pid.outputMax)
+        .string("d_filter", derivativeFilterName(l_pid.dFilterType))
+        .number("d_cutoff_hz", l_pid.dCutoffHz)
+        .number("engage_ramp_ms", l_pid.engageRampMs)
+        .endObject();
+
+    p_json.beginObject("yaw")
+        .number("kp", l_yaw.kp)
+        .number("ki", l_yaw.ki)
+        .number("kd", l_yaw.kd)
+        .number("target_rate", l_yaw.targetAngle)
+        .number("iterm_min", l_yaw.itermMin)
+        .number("iterm_max", l_yaw.itermMax)
+        .number("output_min", l_yaw.outputMin)
+        .number("output_max", l_yaw.outputMax)
+        .string("d_filter", derivativeFilterName(l_yaw.dFilterType))
+        .number("d_cutoff_hz", l_yaw.dCutoffHz)
+        .endObject();
+
+    p_json.string("controller", l_controllerType == ControllerType::LQR ? "lqr" : "pid");
+
+    p_json.beginObject("lqr")
+        .number("k_pitch", l_lqr.kPitch)
+        .number("k_pitch_rate", l_lqr.kPitchRate)
+        .number("k_position", l_lqr.kPosition)
+        .number("k_velocity", l_lqr.kVelocity)
+        .endObject();
+
+    p_json.beginObject("gain_schedule")
+        .boolean("enabled", l_schedule.enabled)
+        .numbers("error_breakpoints", l_schedule.errorBreakpoints, l_schedule.errorPoints)
+        .numbers("speed_breakpoints", l_schedule.speedBreakpoints, l_schedule.speedPoints);
+    writeGainTable(p_json, "kp_scale", l_schedule.kpScale, l_schedule);
+    writeGainTable(p_json, "ki_scale", l_schedule.kiScale, l_schedule);
+    writeGainTable(p_json, "kd_scale", l_schedule.kdScale, l_schedule);
+    p_json.endObject();
+
+    p_json.beginObject("velocity_loop")
+        .boolean("enabled", l_velocity.enabled)
+        .number("kp", l_velocity.kp)
+        .number("ki", l_velocity.ki)
+        .number("position_kp", l_velocity.positionKp)
+        .number("target_speed", l_velocity.targetSpeed)
+        .number("iterm_min", l_velocity.itermMin)
+        .number("iterm_max", l_velocity.itermMax)
+        .number("max_tilt", l_velocity.maxTilt)
+        .integer("divider", l_velocity.divider)
+        .endObject();
+
+    p_json.beginObject("predictor")
+        .boolean("enabled", l_predictor.enabled)
+        .boolean("second_order", l_predictor.secondOrder)
+        .number("extra_latency_ms", l_predictor.extraLatencyMs)
+        .number("max_latency_ms", l_predictor.maxLatencyMs)
+        .number("accel_cutoff_hz", l_predictor.accelCutoffHz)
+        .endObject();
+
+    p_json.beginObject("filters");
+    writeFilterChain(p_json, "gyro", l_filters.gyro);
+    writeFilterChain(p_json, "accel", l_filters.accel);
+    writeFilterChain(p_json, "d_term", l_filters.dTerm);
+    writeFilterChain(p_json, "motor", l_filters.motor);
+    p_json.endObject();
+
+    p_json.beginObject("motor")
+        .string("driver", l_motorDriver == MotorDriverType::MCPWM ? "mcpwm" : "ledc")
+        .number("input_scale", l_motor.inputScale)
+        .number("deadband", l_motor.deadband)
+        .number("friction_offset", l_motor.frictionOffset)
+        .number("slew_rate", l_motor.slewRate)
+        .number("trim_left", l_motor.trimLeft)
+        .number("trim_right", l_motor.trimRight)
+        .endObject();
+
+    p_json.beginObject("udp_telemetry")
+        .boolean("enabled", l_udp.enabled)
+        .string("host", l_udp.host)
+        .integer("port", l_udp.port)
+        .endObject();
+
+    p_json.beginObject("mpu6050")
+        .integer("calibration_samples", l_calibrationSamples)
+        .endObject();
+
+    p_json.beginObject("main_loop")
+        .integer("interval_ms", l_mainLoopInterval)
+        .endObject();
+
+    p_json.endObject();
+    return p_json.finish();
 }
 
 esp_err_t RuntimeConfig::fromJson(const std::string& json) {
     ESP_LOGD(TAG, "Parsing JSON to RuntimeConfig");
+    // Taken for this parse only, updates are rare and the block is released in one piece
+    JsonArena arena(JsonArena::capacityFor(MAX_JSON_VALUES, MAX_JSON_TEXT));
+    JsonArena::Scope scope(arena);
     cJSON *root = cJSON_Parse(json.c_str());
+    if (root == NULL && arena.exhausted()) {
+        ESP_LOGE(TAG, "Configuration needs more than %u bytes to parse", static_cast<unsigned>(arena.capacity()));
+        return ESP_ERR_INVALID_SIZE;
+    }
     if (root == NULL) {
         const char *error_ptr = cJSON_GetErrorPtr();
         if (error_ptr != NULL) {
@@ -190,11 +478,139 @@ esp_err_t RuntimeConfig::fromJson(const std::string& json) {
             if ((item = cJSON_GetObjectItem(pid, "output_max")) && cJSON_IsNumber(item)) m_pidConfig.outputMax = item->valuedouble;
             if ((item = cJSON_GetObjectItem(pid, "iterm_min")) && cJSON_IsNumber(item)) m_pidConfig.itermMin = item->valuedouble;
             if ((item = cJSON_GetObjectItem(pid, "iterm_max")) && cJSON_IsNumber(item)) m_pidConfig.itermMax = item->valuedouble;
+            parseDerivativeFilter(pid, m_pidConfig);
+            if ((item = cJSON_GetObjectItem(pid, "engage_ramp_ms")) && cJSON_IsNumber(item)) m_pidConfig.engageRampMs = item->valueint;
             ESP_LOGI(TAG, "Loaded PID configuration");
         } else {
             ESP_LOGW(TAG, "PID configuration not found in JSON");
         }
 
+        cJSON *yaw = cJSON_GetObjectItem(root, "yaw");
+        if (yaw) {
+            if ((item = cJSON_GetObjectItem(yaw, "kp")) && cJSON_IsNumber(item)) m_yawPidConfig.kp = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "ki")) && cJSON_IsNumber(item)) m_yawPidConfig.ki = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "kd")) && cJSON_IsNumber(item)) m_yawPidConfig.kd = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "target_rate")) && cJSON_IsNumber(item)) m_yawPidConfig.targetAngle = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "output_min")) && cJSON_IsNumber(item)) m_yawPidConfig.outputMin = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "output_max")) && cJSON_IsNumber(item)) m_yawPidConfig.outputMax = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "iterm_min")) && cJSON_IsNumber(item)) m_yawPidConfig.itermMin = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(yaw, "iterm_max")) && cJSON_IsNumber(item)) m_yawPidConfig.itermMax = item->valuedouble;
+            parseDerivativeFilter(yaw, m_yawPidConfig);
+            ESP_LOGI(TAG, "Loaded yaw PID configuration");
+        } else {
+            ESP_LOGW(TAG, "Yaw PID configuration not found in JSON");
+        }
+
+        if ((item = cJSON_GetObjectItem(root, "controller")) && cJSON_IsString(item)) {
+            if (strcmp(item->valuestring, "lqr") == 0) {
+                m_controllerType = ControllerType::LQR;
+            } else if (strcmp(item->valuestring, "pid") == 0) {
+                m_controllerType = ControllerType::PID;
+            } else {
+                ESP_LOGW(TAG, "Unknown controller type '%s', keeping the current one", item->valuestring);
+            }
+        }
+
+        cJSON *lqr = cJSON_GetObjectItem(root, "lqr");
+        if (lqr) {
+            if ((item = cJSON_GetObjectItem(lqr, "k_pitch")) && cJSON_IsNumber(item)) m_lqrConfig.kPitch = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(lqr, "k_pitch_rate")) && cJSON_IsNumber(item)) m_lqrConfig.kPitchRate = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(lqr, "k_position")) && cJSON_IsNumber(item)) m_lqrConfig.kPosition = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(lqr, "k_velocity")) && cJSON_IsNumber(item)) m_lqrConfig.kVelocity = item->valuedouble;
+            ESP_LOGI(TAG, "Loaded LQR configuration");
+        } else {
+            ESP_LOGW(TAG, "LQR configuration not found in JSON");
+        }
+
+        cJSON *gain_schedule = cJSON_GetObjectItem(root, "gain_schedule");
+        if (gain_schedule) {
+            // Parse into a copy, a malformed table must not leave a half-written schedule behind
+            GainScheduleConfig l_schedule = m_gainScheduleConfig;
+            if (parseGainSchedule(gain_schedule, l_schedule) && (!l_schedule.enabled || GainSchedule::isValid(l_schedule))) {
+                m_gainScheduleConfig = l_schedule;
+                ESP_LOGI(TAG, "Loaded gain schedule - %d x %d points", l_schedule.speedPoints, l_schedule.errorPoints);
+            } else {
+                ESP_LOGW(TAG, "Ignoring malformed gain schedule");
+            }
+        } else {
+            ESP_LOGW(TAG, "Gain schedule not found in JSON");
+        }
+
+        cJSON *velocity_loop = cJSON_GetObjectItem(root, "velocity_loop");
+        if (velocity_loop) {
+            if ((item = cJSON_GetObjectItem(velocity_loop, "enabled")) && cJSON_IsBool(item)) m_velocityLoopConfig.enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(velocity_loop, "kp")) && cJSON_IsNumber(item)) m_velocityLoopConfig.kp = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "ki")) && cJSON_IsNumber(item)) m_velocityLoopConfig.ki = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "position_kp")) && cJSON_IsNumber(item)) m_velocityLoopConfig.positionKp = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "target_speed")) && cJSON_IsNumber(item)) m_velocityLoopConfig.targetSpeed = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "iterm_min")) && cJSON_IsNumber(item)) m_velocityLoopConfig.itermMin = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "iterm_max")) && cJSON_IsNumber(item)) m_velocityLoopConfig.itermMax = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "max_tilt")) && cJSON_IsNumber(item)) m_velocityLoopConfig.maxTilt = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(velocity_loop, "divider")) && cJSON_IsNumber(item)) m_velocityLoopConfig.divider = item->valueint;
+            ESP_LOGI(TAG, "Loaded velocity loop configuration");
+        } else {
+            ESP_LOGW(TAG, "Velocity loop configuration not found in JSON");
+        }
+
+        cJSON *predictor = cJSON_GetObjectItem(root, "predictor");
+        if (predictor) {
+            if ((item = cJSON_GetObjectItem(predictor, "enabled")) && cJSON_IsBool(item)) m_predictorConfig.enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(predictor, "second_order")) && cJSON_IsBool(item)) m_predictorConfig.secondOrder = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(predictor, "extra_latency_ms")) && cJSON_IsNumber(item)) m_predictorConfig.extraLatencyMs = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(predictor, "max_latency_ms")) && cJSON_IsNumber(item)) m_predictorConfig.maxLatencyMs = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(predictor, "accel_cutoff_hz")) && cJSON_IsNumber(item)) m_predictorConfig.accelCutoffHz = item->valuedouble;
+            ESP_LOGI(TAG, "Loaded pitch predictor configuration");
+        } else {
+            ESP_LOGW(TAG, "Pitch predictor configuration not found in JSON");
+        }
+
+        cJSON *filters = cJSON_GetObjectItem(root, "filters");
+        if (filters) {
+            if (parseFilterBank(filters, m_filterBankConfig)) {
+                ESP_LOGI(TAG, "Loaded filter bank configuration");
+            } else {
+                ESP_LOGW(TAG, "Ignoring malformed filter chains");
+            }
+        } else {
+            ESP_LOGW(TAG, "Filter bank configuration not found in JSON");
+        }
+
+        cJSON *motor = cJSON_GetObjectItem(root, "motor");
+        if (motor) {
+            if ((item = cJSON_GetObjectItem(motor, "driver")) && cJSON_IsString(item)) {
+                if (strcmp(item->valuestring, "mcpwm") == 0) {
+                    m_motorDriverType = MotorDriverType::MCPWM;
+                } else if (strcmp(item->valuestring, "ledc") == 0) {
+                    m_motorDriverType = MotorDriverType::LEDC;
+                } else {
+                    ESP_LOGW(TAG, "Unknown motor driver '%s', keeping the current one", item->valuestring);
+                }
+            }
+            if ((item = cJSON_GetObjectItem(motor, "input_scale")) && cJSON_IsNumber(item)) m_motorShapingConfig.inputScale = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(motor, "deadband")) && cJSON_IsNumber(item)) m_motorShapingConfig.deadband = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(motor, "friction_offset")) && cJSON_IsNumber(item)) m_motorShapingConfig.frictionOffset = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(motor, "slew_rate")) && cJSON_IsNumber(item)) m_motorShapingConfig.slewRate = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(motor, "trim_left")) && cJSON_IsNumber(item)) m_motorShapingConfig.trimLeft = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(motor, "trim_right")) && cJSON_IsNumber(item)) m_motorShapingConfig.trimRight = item->valuedouble;
+            ESP_LOGI(TAG, "Loaded motor shaping configuration");
+        } else {
+            ESP_LOGW(TAG, "Motor shaping configuration not found in JSON");
+        }
+
+        cJSON *udp = cJSON_GetObjectItem(root, "udp_telemetry");
+        if (udp) {
+            if ((item = cJSON_GetObjectItem(udp, "enabled")) && cJSON_IsBool(item)) m_udpTelemetryConfig.enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(udp, "host")) && cJSON_IsString(item)) {
+                strncpy(m_udpTelemetryConfig.host, item->valuestring, sizeof(m_udpTelemetryConfig.host) - 1);
+                m_udpTelemetryConfig.host[sizeof(m_udpTelemetryConfig.host) - 1] = '\0';
+            }
+            if ((item = cJSON_GetObjectItem(udp, "port")) && cJSON_IsNumber(item) && item->valueint > 0 && item->valueint < 65536)
+                m_udpTelemetryConfig.port = static_cast<uint16_t>(item->valueint);
+            ESP_LOGI(TAG, "Loaded UDP telemetry configuration");
+        } else {
+            ESP_LOGW(TAG, "UDP telemetry configuration not found in JSON");
+        }
+
         cJSON *mpu6050 = cJSON_GetObjectItem(root, "mpu6050");
         if (mpu6050) {
             if ((item = cJSON_GetObjectItem(mpu6050, "calibration_samples")) && cJSON_IsNumber(item)) 
@@ -235,6 +651,156 @@ void RuntimeConfig::setPidConfig(PIDConfig config) {
     }
 };
 
+PIDConfig RuntimeConfig::getYawPidConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        PIDConfig config = m_yawPidConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return PIDConfig(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+void RuntimeConfig::setYawPidConfig(const PIDConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_yawPidConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+ControllerType RuntimeConfig::getControllerType() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        ControllerType type = m_controllerType;
+        xSemaphoreGive(m_mutex);
+        return type;
+    }
+    return ControllerType::PID;
+}
+void RuntimeConfig::setControllerType(ControllerType type) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_controllerType = type;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+LQRConfig RuntimeConfig::getLQRConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        LQRConfig config = m_lqrConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return LQRConfig();
+}
+void RuntimeConfig::setLQRConfig(const LQRConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_lqrConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+GainScheduleConfig RuntimeConfig::getGainScheduleConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        GainScheduleConfig config = m_gainScheduleConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return GainScheduleConfig();
+}
+void RuntimeConfig::setGainScheduleConfig(const GainScheduleConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_gainScheduleConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+VelocityLoopConfig RuntimeConfig::getVelocityLoopConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        VelocityLoopConfig config = m_velocityLoopConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return VelocityLoopConfig();
+}
+void RuntimeConfig::setVelocityLoopConfig(const VelocityLoopConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_velocityLoopConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+PredictorConfig RuntimeConfig::getPredictorConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        PredictorConfig config = m_predictorConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return PredictorConfig();
+}
+void RuntimeConfig::setPredictorConfig(const PredictorConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_predictorConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+FilterBankConfig RuntimeConfig::getFilterBankConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        FilterBankConfig config = m_filterBankConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return FilterBankConfig();
+}
+void RuntimeConfig::setFilterBankConfig(const FilterBankConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_filterBankConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+MotorShapingConfig RuntimeConfig::getMotorShapingConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        MotorShapingConfig config = m_motorShapingConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return MotorShapingConfig();
+}
+MotorDriverType RuntimeConfig::getMotorDriverType() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        MotorDriverType type = m_motorDriverType;
+        xSemaphoreGive(m_mutex);
+        return type;
+    }
+    return MotorDriverType::LEDC;
+}
+void RuntimeConfig::setMotorDriverType(MotorDriverType type) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_motorDriverType = type;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+void RuntimeConfig::setMotorShapingConfig(const MotorShapingConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_motorShapingConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+UdpTelemetryConfig RuntimeConfig::getUdpTelemetryConfig() const {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        UdpTelemetryConfig config = m_udpTelemetryConfig;
+        xSemaphoreGive(m_mutex);
+        return config;
+    }
+    return UdpTelemetryConfig();
+}
+void RuntimeConfig::setUdpTelemetryConfig(const UdpTelemetryConfig& config) {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_udpTelemetryConfig = config;
+        xSemaphoreGive(m_mutex);
+    }
+}
+
 int RuntimeConfig::getMpu6050CalibrationSamples() const { 
     if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
         int value = m_mpuCalibrationSamples;
@@ -1,10 +1,14 @@
 #include "interfaces/IMPU6050Manager.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
 
 #include "include/SensorTask.hpp"
 #include "include/StateMachine.hpp"
+#include "include/LoopPeriod.hpp"
+#include "include/WheelOdometry.hpp"
 
-SensorTask::SensorTask(IMPU6050Manager& p_mpu, QueueHandle_t p_dataQueue, IStateMachine& p_sm)
-    : m_mpu6050(p_mpu), m_sensorDataQueue(p_dataQueue), m_stateMachine(p_sm), m_taskHandle(nullptr) {}
+SensorTask::SensorTask(IMPU6050Manager& p_mpu, WheelOdometry& p_odometry, const ControlMailboxes& p_mailboxes, IStateMachine& p_sm)
+    : m_mpu6050(p_mpu), m_wheelOdometry(p_odometry), m_mailboxes(p_mailboxes), m_stateMachine(p_sm), 
+      m_taskHandle(nullptr), m_samplingPeriod(LoopPeriod::toTicks(LoopPeriod::DEFAULT_INTERVAL_MS)) {}
 
 SensorTask::~SensorTask() {
     if (m_taskHandle != nullptr) {
@@ -12,7 +16,11 @@ SensorTask::~SensorTask() {
     }
 }
 
-esp_err_t SensorTask::init(const IRuntimeConfig&) {
+esp_err_t SensorTask::init(const IRuntimeConfig& p_config) {
+    m_samplingPeriod = LoopPeriod::toTicks(p_config.getMainLoopIntervalMs());
+    FilterBankConfig l_filters = p_config.getFilterBankConfig();
+    m_mpu6050.setFilterConfig(l_filters.gyro, l_filters.accel);
+
     BaseType_t result = xTaskCreate(
         taskFunction,
         TAG,
@@ -34,17 +42,33 @@ void SensorTask::taskFunction(void* p_pvParameters) {
 
 void SensorTask::run() {
     TickType_t lastWakeTime = xTaskGetTickCount();
-    SensorData l_sensorData {0.0f, 0.0f, 0.0f, esp_timer_get_time() }; 
+    SensorData l_sensorData {};
+    l_sensorData.dt = LoopPeriod::toSeconds(m_samplingPeriod);
+    l_sensorData.timestamp = esp_timer_get_time();
 
     while (true) {
+        // Pick up a new loop period at the cycle boundary, the sample carries the dt it was integrated with
+        if (LoopPeriod::peekTicks(m_mailboxes.loopPeriod, m_samplingPeriod)) {
+            l_sensorData.dt = LoopPeriod::toSeconds(m_samplingPeriod);
+        }
+        updateFilterConfig();
+
         // Get processed sensor data directly from MPU6050Manager
-        l_sensorData.pitch = m_mpu6050.calculatePitch(l_sensorData.pitch);
+        l_sensorData.pitch = m_mpu6050.calculatePitch(l_sensorData.pitch, l_sensorData.dt);
+        l_sensorData.pitchRate = m_mpu6050.getPitchRate();
+
+        // Never wait on the analysis, a full queue just drops the sample
+        ImuSample l_imuSample = m_mpu6050.getLastImuSample();
+        xQueueSend(m_mailboxes.imuSample, &l_imuSample, 0);
+
         l_sensorData.roll = m_mpu6050.calculateRoll(l_sensorData.roll);
         l_sensorData.yaw = m_mpu6050.calculateYaw(l_sensorData.yaw);
+        l_sensorData.yawRate = m_mpu6050.getYawRate();
         l_sensorData.timestamp = esp_timer_get_time();
+        m_wheelOdometry.update(l_sensorData);
         
         // Send data to queue
-        if (xQueueSend(m_sensorDataQueue, &l_sensorData, 0) != pdTRUE) {
+        if (xQueueSend(m_mailboxes.sensorData, &l_sensorData, 0) != pdTRUE) {
             ESP_LOGW(TAG, "Failed to send sensor data to queue");
         }
         
@@ -56,6 +80,14 @@ void SensorTask::run() {
         ESP_LOGV(TAG, "Sensor data: Pitch: %.2f, Roll: %.2f, Yaw: %.2f", 
                  l_sensorData.pitch, l_sensorData.roll, l_sensorData.yaw);
 
-        vTaskDelayUntil(&lastWakeTime, SAMPLING_PERIOD);
+        vTaskDelayUntil(&lastWakeTime, m_samplingPeriod);
+    }
+}
+
+void SensorTask::updateFilterConfig() {
+    FilterBankConfig l_filters;
+    if (xQueuePeek(m_mailboxes.filterBank, &l_filters, 0) == pdTRUE) {
+        // Unchanged chains cost a compare, coefficients are only redesigned on a change
+        m_mpu6050.setFilterConfig(l_filters.gyro, l_filters.accel);
     }
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "include/SpectrumAnalyzer.hpp"
+#include <cmath>
+
+#if defined(ESP_PLATFORM) && __has_include("dsps_fft2r.h")
+#include "dsps_fft2r.h"
+#define SPECTRUM_USE_ESP_DSP 1
+#endif
+
+SpectrumAnalyzer::SpectrumAnalyzer() : m_samples(), m_count(0), m_elapsed(0.0f), m_work() {
+    for (int n = 0; n < N; n++) {
+        m_window[n] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * n / N);
+    }
+    for (int k = 0; k < N / 2; k++) {
+        m_twiddle[2 * k] = std::cos(2.0f * static_cast<float>(M_PI) * k / N);
+        m_twiddle[2 * k + 1] = -std::sin(2.0f * static_cast<float>(M_PI) * k / N);
+    }
+#ifdef SPECTRUM_USE_ESP_DSP
+    // The kernel keeps a global table, hand it ours so nothing is allocated
+    dsps_fft2r_init_fc32(m_twiddle, N);
+#endif
+}
+
+const char* SpectrumAnalyzer::axisName(int p_axis) {
+    static const char* const NAMES[VibrationSpectrum::AXES] = {"gyro_x", "gyro_y", "gyro_z", "accel_x", "accel_y", "accel_z"};
+    return p_axis >= 0 && p_axis < VibrationSpectrum::AXES ? NAMES[p_axis] : "";
+}
+
+bool SpectrumAnalyzer::addSample(const ImuSample& p_sample) {
+    if (m_count < N) {
+        for (int i = 0; i < 3; i++) {
+            m_samples[i][m_count] = p_sample.gyro[i];
+            m_samples[3 + i][m_count] = p_sample.accel[i];
+        }
+        m_elapsed += p_sample.dt;
+        m_count++;
+    }
+    return m_count == N;
+}
+
+void SpectrumAnalyzer::transform() {
+#ifdef SPECTRUM_USE_ESP_DSP
+    dsps_fft2r_fc32(m_work, N);
+    dsps_bit_rev_fc32(m_work, N);
+#else
+    // Iterative radix-2 decimation in time, same result as the ESP-DSP kernel
+    for (int i = 1, j = 0; i < N; i++) {
+        int l_bit = N >> 1;
+        for (; j & l_bit; l_bit >>= 1) j ^= l_bit;
+        j ^= l_bit;
+        if (i < j) {
+            float l_re = m_work[2 * i], l_im = m_work[2 * i + 1];
+            m_work[2 * i] = m_work[2 * j];
+            m_work[2 * i + 1] = m_work[2 * j + 1];
+            m_work[2 * j] = l_re;
+            m_work[2 * j + 1] = l_im;
+        }
+    }
+    for (int l_length = 2; l_length <= N; l_length <<= 1) {
+        int l_stride = N / l_length;
+        for (int l_start = 0; l_start < N; l_start += l_length) {
+            for (int k = 0; k < l_length / 2; k++) {
+                float l_wr = m_twiddle[2 * k * l_stride], l_wi = m_twiddle[2 * k * l_stride + 1];
+                float* l_a = &m_work[2 * (l_start + k)];
+                float* l_b = &m_work[2 * (l_start + k + l_length / 2)];
+                float l_tr = l_b[0] * l_wr - l_b[1] * l_wi;
+                float l_ti = l_b[0] * l_wi + l_b[1] * l_wr;
+                l_b[0] = l_a[0] - l_tr;
+                l_b[1] = l_a[1] - l_ti;
+                l_a[0] += l_tr;
+                l_a[1] += l_ti;
+            }
+        }
+    }
+#endif
+}
+
+void SpectrumAnalyzer::separate(float* p_magnitudeA, float* p_magnitudeB) const {
+    // z = a + jb: A[k] = (Z[k] + conj(Z[N-k])) / 2, B[k] = (Z[k] - conj(Z[N-k])) / 2j.
+    // Hann has a coherent gain of 1/2, single-sided bins are doubled except DC and Nyquist.
+    for (int k = 0; k < VibrationSpectrum::BINS; k++) {
+        int l_mirror = (N - k) % N;
+        float l_re = m_work[2 * k], l_im = m_work[2 * k + 1];
+        float l_mre = m_work[2 * l_mirror], l_mim = m_work[2 * l_mirror + 1];
+        float l_scale = (k == 0 || k == N / 2 ? 1.0f : 2.0f) / (0.5f * N) * 0.5f;
+        p_magnitudeA[k] = l_scale * std::hypot(l_re + l_mre, l_im - l_mim);
+        p_magnitudeB[k] = l_scale * std::hypot(l_im + l_mim, l_re - l_mre);
+    }
+}
+
+void SpectrumAnalyzer::findPeaks(const float* p_magnitude, float p_resolution, VibrationPeak* p_peaks, int& p_count) {
+    p_count = 0;
+    for (int k = 1; k < VibrationSpectrum::BINS - 1; k++) {
+        float l_left = p_magnitude[k - 1], l_centre = p_magnitude[k], l_right = p_magnitude[k + 1];
+        if (!(l_centre > l_left && l_centre >= l_right)) {
+            continue;
+        }
+        // Parabolic interpolation between bins, the true tone rarely sits on a bin centre
+        float l_curvature = l_left - 2.0f * l_centre + l_right;
+        float l_offset = l_curvature != 0.0f ? 0.5f * (l_left - l_right) / l_curvature : 0.0f;
+        VibrationPeak l_peak {(k + l_offset) * p_resolution, l_centre};
+
+        // Keep the strongest MAX_PEAKS, sorted descending
+        int l_slot = p_count < VibrationSpectrum::MAX_PEAKS ? p_count++ : VibrationSpectrum::MAX_PEAKS;
+        while (l_slot > 0 && p_peaks[l_slot - 1].magnitude < l_peak.magnitude) {
+            if (l_slot < VibrationSpectrum::MAX_PEAKS) p_peaks[l_slot] = p_peaks[l_slot - 1];
+            l_slot--;
+        }
+        if (l_slot < VibrationSpectrum::MAX_PEAKS) p_peaks[l_slot] = l_peak;
+    }
+}
+
+void SpectrumAnalyzer::analyze(VibrationSpectrum& p_result) {
+    if (m_count < N || m_elapsed <= 0.0f) {
+        return;
+    }
+    p_result.sampleRateHz = N / m_elapsed;
+    float l_resolution = p_result.sampleRateHz / N;
+
+    for (int l_axis = 0; l_axis < VibrationSpectrum::AXES; l_axis += 2) {
+        const float* l_a = m_samples[l_axis];
+        const float* l_b = m_samples[l_axis + 1];
+        // Gravity and gyro bias would swamp the low bins
+        float l_meanA = 0.0f, l_meanB = 0.0f;
+        for (int n = 0; n < N; n++) {
+            l_meanA += l_a[n];
+            l_meanB += l_b[n];
+        }
+        l_meanA /= N;
+        l_meanB /= N;
+        for (int n = 0; n < N; n++) {
+            m_work[2 * n] = (l_a[n] - l_meanA) * m_window[n];
+            m_work[2 * n + 1] = (l_b[n] - l_meanB) * m_window[n];
+        }
+
+        transform();
+        separate(p_result.magnitude[l_axis], p_result.magnitude[l_axis + 1]);
+        findPeaks(p_result.magnitude[l_axis], l_resolution, p_result.peaks[l_axis], p_result.peakCount[l_axis]);
+        findPeaks(p_result.magnitude[l_axis + 1], l_resolution, p_result.peaks[l_axis + 1], p_result.peakCount[l_axis + 1]);
+    }
+
+    p_result.valid = true;
+    p_result.sequence++;
+    m_count = 0;
+    m_elapsed = 0.0f;
+}
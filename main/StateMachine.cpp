@@ -1,11 +1,8 @@
 #include "include/StateMachine.hpp"
 #include "esp_log.h"
 
-StateMachine::StateMachine(QueueHandle_t sensorQueue, QueueHandle_t pidQueue, QueueHandle_t motorQueue,
-                           QueueHandle_t telemetryQueue, QueueHandle_t configQueue)
-    : currentState(State::INIT), eventGroup(nullptr), taskHandle(nullptr),
-      sensorDataQueue(sensorQueue), pidOutputQueue(pidQueue), motorControlQueue(motorQueue),
-      telemetryQueue(telemetryQueue), configQueue(configQueue), targetAngle(0.0f) {}
+StateMachine::StateMachine(const ControlMailboxes& mailboxes)
+    : currentState(State::INIT), eventGroup(nullptr), taskHandle(nullptr), mailboxes(mailboxes), targetAngle(0.0f) {}
 
 StateMachine::~StateMachine() {
     if (eventGroup) {
@@ -81,12 +78,12 @@ void StateMachine::handleIdle() {
     ESP_LOGV(TAG, "Handling IDLE state");
     
     SensorData sensorData;
-    if (xQueuePeek(sensorDataQueue, &sensorData, 0) == pdTRUE) {
+    if (xQueuePeek(mailboxes.sensorData, &sensorData, 0) == pdTRUE) {
         if (std::abs(sensorData.pitch - targetAngle) < BALANCE_THRESHOLD) {
             setState(State::BALANCING);
         } else {
             float zeroSpeed = 0.0f;
-            xQueueOverwrite(motorControlQueue, &zeroSpeed);
+            xQueueOverwrite(mailboxes.motorControl, &zeroSpeed);
         }
     }
 }
@@ -95,7 +92,7 @@ void StateMachine::handleBalancing() {
     ESP_LOGV(TAG, "Handling BALANCING state");
     
     SensorData sensorData;
-    if (xQueuePeek(sensorDataQueue, &sensorData, 0) == pdTRUE) {
+    if (xQueuePeek(mailboxes.sensorData, &sensorData, 0) == pdTRUE) {
         if (std::abs(sensorData.pitch - targetAngle) > FALL_THRESHOLD) {
             setState(State::FALLING);
             return;
@@ -109,12 +106,12 @@ void StateMachine::handleFalling() {
     ESP_LOGW(TAG, "Handling FALLING state");
     
     float zeroSpeed = 0.0f;
-    xQueueOverwrite(motorControlQueue, &zeroSpeed);
+    xQueueOverwrite(mailboxes.motorControl, &zeroSpeed);
     
     vTaskDelay(pdMS_TO_TICKS(2000));
     
     SensorData sensorData;
-    if (xQueuePeek(sensorDataQueue, &sensorData, 0) == pdTRUE) {
+    if (xQueuePeek(mailboxes.sensorData, &sensorData, 0) == pdTRUE) {
         if (std::abs(sensorData.pitch - targetAngle) < BALANCE_THRESHOLD) {
             setState(State::IDLE);
         } else {
@@ -128,7 +125,7 @@ void StateMachine::handleError() {
     ESP_LOGE(TAG, "Handling ERROR state");
     
     float zeroSpeed = 0.0f;
-    xQueueOverwrite(motorControlQueue, &zeroSpeed);
+    xQueueOverwrite(mailboxes.motorControl, &zeroSpeed);
     
     vTaskDelay(pdMS_TO_TICKS(5000));
     setState(State::INIT);
@@ -136,35 +133,38 @@ void StateMachine::handleError() {
 
 void StateMachine::checkConfigUpdate() {
     PIDConfig update;
-    if (xQueueReceive(configQueue, &update, 0) == pdTRUE) {
+    if (xQueueReceive(mailboxes.config, &update, 0) == pdTRUE) {
         targetAngle = update.targetAngle;
         // Forward the PID parameters to the PID task
-        xQueueSend(configQueue, &update, 0);
+        xQueueSend(mailboxes.config, &update, 0);
         xEventGroupSetBits(eventGroup, CONFIG_UPDATE_BIT);
         ESP_LOGI(TAG, "Configuration updated. New target angle: %.2f", targetAngle);
     }
 }
 
 void StateMachine::updateTelemetry() {
-    TelemetryData telemetryData;
+    TelemetryData telemetryData{};
 
     // Safely peek at the sensor data
-    if (xQueuePeek(sensorDataQueue, &telemetryData.sensorData, 0) != pdTRUE) {
+    if (xQueuePeek(mailboxes.sensorData, &telemetryData.sensorData, 0) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to peek sensor data");
     }
 
-    // Safely peek at the PID output
-    if (xQueuePeek(pidOutputQueue, &telemetryData.pidOutput, 0) != pdTRUE) {
+    // Safely peek at the PID output, the queue carries the whole PIDOutput
+    PIDOutput pidOutput;
+    if (xQueuePeek(mailboxes.pidOutput, &pidOutput, 0) == pdTRUE) {
+        telemetryData.pidOutput = pidOutput.output;
+    } else {
         ESP_LOGW(TAG, "Failed to peek PID output");
     }
 
     // Safely peek at the motor speed
-    if (xQueuePeek(motorControlQueue, &telemetryData.motorSpeed, 0) != pdTRUE) {
+    if (xQueuePeek(mailboxes.motorControl, &telemetryData.motorSpeed, 0) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to peek motor speed");
     }
 
     // Try to send the telemetry data, but don't block if the queue is full
-    if (xQueueSend(telemetryQueue, &telemetryData, 0) != pdTRUE) {
+    if (xQueueSend(mailboxes.telemetry, &telemetryData, 0) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to send telemetry data - queue might be full");
     }
 }
\ No newline at end of file
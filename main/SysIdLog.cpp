@@ -0,0 +1,60 @@
+#include "include/SysIdLog.hpp"
+
+SysIdLog::SysIdLog() : m_state(State::EMPTY), m_exporting(false), m_request(), m_dt(0.0f), m_count(0) {
+    m_mutex = xSemaphoreCreateMutex();
+}
+
+SysIdLog::~SysIdLog() {
+    if (m_mutex) {
+        vSemaphoreDelete(m_mutex);
+    }
+}
+
+bool SysIdLog::begin(const SysIdRequest& p_request, float p_dt) {
+    // Never block the control loop on a slow HTTP client
+    if (xSemaphoreTake(m_mutex, 0) != pdTRUE) {
+        return false;
+    }
+    bool l_free = !m_exporting;
+    if (l_free) {
+        m_request = p_request;
+        m_dt = p_dt;
+        m_count = 0;
+        m_state.store(State::RECORDING);
+    }
+    xSemaphoreGive(m_mutex);
+    return l_free;
+}
+
+bool SysIdLog::append(const SysIdRecord& p_record) {
+    if (m_count >= CAPACITY) {
+        return false;
+    }
+    m_records[m_count++] = p_record;
+    return true;
+}
+
+void SysIdLog::finish(State p_state) {
+    // Publishes m_count to the reader, which checks the state before looking at the records
+    m_state.store(p_state);
+}
+
+bool SysIdLog::acquire() {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    State l_state = m_state.load();
+    bool l_ready = l_state == State::COMPLETE || l_state == State::ABORTED;
+    if (l_ready) {
+        m_exporting = true;
+    }
+    xSemaphoreGive(m_mutex);
+    return l_ready;
+}
+
+void SysIdLog::release() {
+    if (xSemaphoreTake(m_mutex, portMAX_DELAY) == pdTRUE) {
+        m_exporting = false;
+        xSemaphoreGive(m_mutex);
+    }
+}
@@ -0,0 +1,128 @@
+#include "include/SystemIdentifier.hpp"
+#include "include/SysIdLog.hpp"
+#include <cmath>
+
+SystemIdentifier::SystemIdentifier(SysIdLog& p_log)
+    : m_log(p_log), m_request(), m_status(Status::IDLE), m_targetAngle(0.0f), m_elapsed(0.0f), m_cycle(0),
+      m_excitation(0.0f), m_lfsr(1) {}
+
+void SystemIdentifier::start(const SysIdRequest& p_request, float p_targetAngle, float p_dt) {
+    m_request = p_request;
+    m_targetAngle = p_targetAngle;
+    m_elapsed = 0.0f;
+    m_cycle = 0;
+    m_excitation = 0.0f;
+    m_lfsr = 0xACE1;
+
+    if (p_request.amplitude <= 0.0f || p_request.amplitude > MAX_AMPLITUDE) {
+        fail("amplitude out of range");
+        return;
+    }
+    if (p_request.duration <= 0.0f || p_request.duration > MAX_DURATION || p_request.maxPitchDeviation <= 0.0f) {
+        fail("invalid duration or pitch deviation limit");
+        return;
+    }
+    if (p_request.type == ExcitationType::CHIRP &&
+        (p_request.startFrequencyHz <= 0.0f || p_request.endFrequencyHz < p_request.startFrequencyHz ||
+         p_request.endFrequencyHz >= 0.5f / p_dt)) {
+        fail("chirp band must be positive, increasing and below Nyquist");
+        return;
+    }
+    if (p_request.type == ExcitationType::PRBS && p_request.prbsBitCycles < 1) {
+        fail("PRBS bit length must be at least one cycle");
+        return;
+    }
+    if (!m_log.begin(p_request, p_dt)) {
+        fail("previous recording is being exported");
+        return;
+    }
+
+    m_status = Status::RUNNING;
+    ESP_LOGI(TAG, "Identification started - type: %d, amplitude: %.2f, duration: %.1f s",
+             static_cast<int>(p_request.type), p_request.amplitude, p_request.duration);
+}
+
+void SystemIdentifier::abort() {
+    if (m_status == Status::RUNNING) {
+        fail("aborted");
+    }
+}
+
+float SystemIdentifier::update(const SensorData& p_sample) {
+    if (m_status != Status::RUNNING) {
+        return 0.0f;
+    }
+    if (std::fabs(p_sample.pitch - m_targetAngle) > m_request.maxPitchDeviation) {
+        fail("pitch deviation limit exceeded");
+        return 0.0f;
+    }
+    if (m_elapsed >= m_request.duration) {
+        finish();
+        return 0.0f;
+    }
+
+    m_excitation = generate();
+    return m_excitation;
+}
+
+void SystemIdentifier::record(const SensorData& p_sample, float p_command) {
+    if (m_status != Status::RUNNING) {
+        return;
+    }
+
+    SysIdRecord l_record {m_elapsed, m_excitation, p_command, p_sample.pitch, p_sample.pitchRate,
+                          p_sample.leftWheelSpeed, p_sample.rightWheelSpeed,
+                          0.5f * (p_sample.leftWheelAngle + p_sample.rightWheelAngle)};
+    if (!m_log.append(l_record)) {
+        // The buffer ends the run, what was recorded is complete
+        finish();
+        return;
+    }
+    m_elapsed += p_sample.dt;
+    m_cycle++;
+}
+
+float SystemIdentifier::generate() {
+    switch (m_request.type) {
+        case ExcitationType::CHIRP: {
+            // Logarithmic sweep, equal time per octave
+            float l_ratio = m_request.endFrequencyHz / m_request.startFrequencyHz;
+            float l_phase;
+            if (l_ratio > 1.0f) {
+                float l_rate = std::log(l_ratio) / m_request.duration;
+                l_phase = 2.0f * static_cast<float>(M_PI) * m_request.startFrequencyHz * (std::exp(l_rate * m_elapsed) - 1.0f) / l_rate;
+            } else {
+                l_phase = 2.0f * static_cast<float>(M_PI) * m_request.startFrequencyHz * m_elapsed;
+            }
+            return m_request.amplitude * std::sin(l_phase);
+        }
+        case ExcitationType::PRBS:
+            if (m_cycle % m_request.prbsBitCycles == 0) {
+                // 16-bit Fibonacci LFSR, taps 16 14 13 11, period 65535
+                uint16_t l_bit = ((m_lfsr >> 0) ^ (m_lfsr >> 2) ^ (m_lfsr >> 3) ^ (m_lfsr >> 5)) & 1u;
+                m_lfsr = static_cast<uint16_t>((m_lfsr >> 1) | (l_bit << 15));
+            }
+            return (m_lfsr & 1u) ? m_request.amplitude : -m_request.amplitude;
+        case ExcitationType::STEP:
+        default:
+            return m_elapsed >= m_request.stepDelay ? m_request.amplitude : 0.0f;
+    }
+}
+
+void SystemIdentifier::finish() {
+    m_status = Status::DONE;
+    m_excitation = 0.0f;
+    m_log.finish(SysIdLog::State::COMPLETE);
+    ESP_LOGI(TAG, "Identification finished - %d cycles recorded", m_log.size());
+}
+
+void SystemIdentifier::fail(const char* p_reason) {
+    bool l_wasRunning = m_status == Status::RUNNING;
+    m_status = Status::ABORTED;
+    m_excitation = 0.0f;
+    if (l_wasRunning) {
+        // Keep what was recorded, the export marks it as aborted
+        m_log.finish(SysIdLog::State::ABORTED);
+    }
+    ESP_LOGW(TAG, "Identification aborted: %s", p_reason);
+}
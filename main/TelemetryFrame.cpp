@@ -0,0 +1,175 @@
+#include "include/TelemetryFrame.hpp"
+#include <cstring>
+
+namespace {
+
+void putU32(uint8_t* p_buffer, uint32_t p_value) {
+    for (int i = 0; i < 4; i++) p_buffer[i] = static_cast<uint8_t>(p_value >> (8 * i));
+}
+
+uint32_t getU32(const uint8_t* p_buffer) {
+    uint32_t l_value = 0;
+    for (int i = 0; i < 4; i++) l_value |= static_cast<uint32_t>(p_buffer[i]) << (8 * i);
+    return l_value;
+}
+
+uint32_t floatBits(float p_value) {
+    uint32_t l_bits;
+    std::memcpy(&l_bits, &p_value, sizeof(l_bits));
+    return l_bits;
+}
+
+float bitsFloat(uint32_t p_bits) {
+    float l_value;
+    std::memcpy(&l_value, &p_bits, sizeof(l_value));
+    return l_value;
+}
+
+}  // namespace
+
+size_t TelemetryCodec::encode(const TelemetryFrame& p_frame, bool p_halfFloat, uint8_t* p_buffer, size_t p_size) {
+    size_t l_valueSize = p_halfFloat ? sizeof(uint16_t) : sizeof(float);
+    size_t l_length = HEADER_SIZE + TelemetryFrame::FIELD_COUNT * l_valueSize;
+    if (p_size < l_length) {
+        return 0;
+    }
+
+    p_buffer[0] = MAGIC;
+    p_buffer[1] = VERSION;
+    p_buffer[2] = p_halfFloat ? FLAG_HALF_FLOAT : 0;
+    p_buffer[3] = p_frame.state;
+    putU32(p_buffer + 4, p_frame.sequence);
+    uint64_t l_timestamp = static_cast<uint64_t>(p_frame.timestamp);
+    putU32(p_buffer + 8, static_cast<uint32_t>(l_timestamp));
+    putU32(p_buffer + 12, static_cast<uint32_t>(l_timestamp >> 32));
+
+    uint8_t* l_value = p_buffer + HEADER_SIZE;
+    for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+        if (p_halfFloat) {
+            uint16_t l_half = toHalf(p_frame.values[i]);
+            l_value[0] = static_cast<uint8_t>(l_half);
+            l_value[1] = static_cast<uint8_t>(l_half >> 8);
+        } else {
+            putU32(l_value, floatBits(p_frame.values[i]));
+        }
+        l_value += l_valueSize;
+    }
+    return l_length;
+}
+
+bool TelemetryCodec::decode(const uint8_t* p_buffer, size_t p_length, TelemetryFrame& p_frame) {
+    if (p_length < HEADER_SIZE || p_buffer[0] != MAGIC || p_buffer[1] < 1) {
+        return false;
+    }
+    p_frame = TelemetryFrame();
+    p_frame.version = p_buffer[1];
+    p_frame.flags = p_buffer[2];
+    p_frame.state = p_buffer[3];
+    p_frame.sequence = getU32(p_buffer + 4);
+    p_frame.timestamp = static_cast<int64_t>(getU32(p_buffer + 8) | (static_cast<uint64_t>(getU32(p_buffer + 12)) << 32));
+
+    bool l_half = (p_frame.flags & FLAG_HALF_FLOAT) != 0;
+    size_t l_valueSize = l_half ? sizeof(uint16_t) : sizeof(float);
+    size_t l_available = (p_length - HEADER_SIZE) / l_valueSize;
+    p_frame.fieldCount = l_available < TelemetryFrame::FIELD_COUNT ? static_cast<int>(l_available) : TelemetryFrame::FIELD_COUNT;
+
+    const uint8_t* l_value = p_buffer + HEADER_SIZE;
+    for (int i = 0; i < p_frame.fieldCount; i++) {
+        p_frame.values[i] = l_half ? fromHalf(static_cast<uint16_t>(l_value[0] | (l_value[1] << 8))) : bitsFloat(getU32(l_value));
+        l_value += l_valueSize;
+    }
+    return true;
+}
+
+uint16_t TelemetryCodec::toHalf(float p_value) {
+    uint32_t l_bits = floatBits(p_value);
+    uint16_t l_sign = static_cast<uint16_t>((l_bits >> 16) & 0x8000u);
+    int l_exponent = static_cast<int>((l_bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t l_mantissa = l_bits & 0x7FFFFFu;
+
+    if (((l_bits >> 23) & 0xFF) == 0xFF) {
+        // Infinity stays infinity, NaN stays a quiet NaN
+        return l_sign | 0x7C00u | (l_mantissa ? 0x200u : 0u);
+    }
+    if (l_exponent >= 31) {
+        return l_sign | 0x7C00u;
+    }
+    if (l_exponent <= 0) {
+        // Subnormal half, or zero below its range
+        if (l_exponent < -10) {
+            return l_sign;
+        }
+        l_mantissa |= 0x800000u;
+        int l_shift = 14 - l_exponent;
+        uint32_t l_half = l_mantissa >> l_shift;
+        uint32_t l_rest = l_mantissa & ((1u << l_shift) - 1);
+        uint32_t l_halfway = 1u << (l_shift - 1);
+        if (l_rest > l_halfway || (l_rest == l_halfway && (l_half & 1u))) l_half++;
+        return l_sign | static_cast<uint16_t>(l_half);
+    }
+
+    uint32_t l_half = (static_cast<uint32_t>(l_exponent) << 10) | (l_mantissa >> 13);
+    uint32_t l_rest = l_mantissa & 0x1FFFu;
+    // A carry out of the mantissa bumps the exponent, up to infinity, which is what we want
+    if (l_rest > 0x1000u || (l_rest == 0x1000u && (l_half & 1u))) l_half++;
+    return l_sign | static_cast<uint16_t>(l_half);
+}
+
+float TelemetryCodec::fromHalf(uint16_t p_half) {
+    uint32_t l_sign = static_cast<uint32_t>(p_half & 0x8000u) << 16;
+    uint32_t l_exponent = (p_half >> 10) & 0x1Fu;
+    uint32_t l_mantissa = p_half & 0x3FFu;
+
+    if (l_exponent == 0x1F) {
+        return bitsFloat(l_sign | 0x7F800000u | (l_mantissa << 13));
+    }
+    if (l_exponent == 0) {
+        if (l_mantissa == 0) {
+            return bitsFloat(l_sign);
+        }
+        // Normalize the subnormal
+        int l_shift = 0;
+        while (!(l_mantissa & 0x400u)) {
+            l_mantissa <<= 1;
+            l_shift++;
+        }
+        l_mantissa &= 0x3FFu;
+        return bitsFloat(l_sign | (static_cast<uint32_t>(127 - 15 + 1 - l_shift) << 23) | (l_mantissa << 13));
+    }
+    return bitsFloat(l_sign | ((l_exponent + 127 - 15) << 23) | (l_mantissa << 13));
+}
+
+const char* TelemetryCodec::fieldName(int p_field) {
+    static const char* const NAMES[TelemetryFrame::FIELD_COUNT] = {
+        "pitch", "roll", "yaw", "pitchRate", "yawRate", "leftWheelSpeed", "rightWheelSpeed",
+        "pTerm", "iTerm", "dTerm", "pidOutput", "leftDuty", "rightDuty",
+        "predictedPitch", "predictionHorizonMs", "latencyMs"
+    };
+    return (p_field >= 0 && p_field < TelemetryFrame::FIELD_COUNT) ? NAMES[p_field] : "unknown";
+}
+
+size_t TelemetryDatagram::encodeHeader(const TelemetryDatagramHeader& p_header, uint8_t* p_buffer, size_t p_size) {
+    if (p_size < HEADER_SIZE) {
+        return 0;
+    }
+    p_buffer[0] = MAGIC;
+    p_buffer[1] = VERSION;
+    p_buffer[2] = static_cast<uint8_t>(p_header.frameSize);
+    p_buffer[3] = static_cast<uint8_t>(p_header.frameSize >> 8);
+    putU32(p_buffer + 4, p_header.sequence);
+    uint64_t l_sent = static_cast<uint64_t>(p_header.sentUs);
+    putU32(p_buffer + 8, static_cast<uint32_t>(l_sent));
+    putU32(p_buffer + 12, static_cast<uint32_t>(l_sent >> 32));
+    return HEADER_SIZE;
+}
+
+bool TelemetryDatagram::decodeHeader(const uint8_t* p_buffer, size_t p_length, TelemetryDatagramHeader& p_header) {
+    if (p_length < HEADER_SIZE || p_buffer[0] != MAGIC || p_buffer[1] < 1) {
+        return false;
+    }
+    p_header.version = p_buffer[1];
+    p_header.frameSize = static_cast<uint16_t>(p_buffer[2] | (p_buffer[3] << 8));
+    p_header.sequence = getU32(p_buffer + 4);
+    p_header.sentUs = static_cast<int64_t>(getU32(p_buffer + 8) | (static_cast<uint64_t>(getU32(p_buffer + 12)) << 32));
+    return p_header.frameSize >= TelemetryCodec::HEADER_SIZE;
+}
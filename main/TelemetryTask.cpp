@@ -1,8 +1,14 @@
 #include "include/TelemetryTask.hpp"
+#include "include/FlightRecorder.hpp"
+#include "include/UdpTelemetrySender.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
 #include "interfaces/IWebServer.hpp"
 
-TelemetryTask::TelemetryTask(IWebServer& server, QueueHandle_t sensorQueue, QueueHandle_t pidQueue, QueueHandle_t motorQueue)
-    : m_webServer(server), m_sensorDataQueue(sensorQueue), m_pidOutputQueue(pidQueue), m_motorSpeedQueue(motorQueue), m_taskHandle(nullptr) {}
+TelemetryTask::TelemetryTask(IWebServer& server, TelemetryRing& ring, FlightRecorder& recorder, UdpTelemetrySender& udpSender,
+                             QueueHandle_t motorQueue)
+    : m_webServer(server), m_telemetryRing(ring), m_flightRecorder(recorder), m_udpSender(udpSender), m_motorSpeedQueue(motorQueue),
+      m_taskHandle(nullptr), m_reportedDrops(0), m_unstreamed(0), m_reportedUnstreamed(0), m_reportedUdpFailures(0),
+      m_lastDropReportUs(0) {}
 
 TelemetryTask::~TelemetryTask() {
     if (m_taskHandle != nullptr) {
@@ -35,30 +41,67 @@ void TelemetryTask::run() {
     TickType_t lastWakeTime = xTaskGetTickCount();
 
     while (true) {
-        collectAndSendTelemetry();
-        vTaskDelayUntil(&lastWakeTime, UPDATE_PERIOD);
+        drainAndSendTelemetry();
+        reportDrops();
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(BATCH_PERIOD_MS));
     }
 }
 
-void TelemetryTask::collectAndSendTelemetry() {
+void TelemetryTask::drainAndSendTelemetry() {
+    // The ring is emptied every period whatever the web server does, the flight recorder must not
+    // miss cycles because a WebSocket client is on a slow link
+    size_t count;
+    do {
+        count = m_telemetryRing.pop(m_batch, MAX_BATCH);
+        if (count == 0) {
+            return;
+        }
 
-    TelemetryData telemetryData;
+        // Not part of the control record, the latest value goes with the whole batch. The queue
+        // carries the state machine's TelemetryData, peeking it into a float would overrun the stack.
+        float motorSpeed = 0.0f;
+        TelemetryData stateTelemetry;
+        if (xQueuePeek(m_motorSpeedQueue, &stateTelemetry, 0) == pdTRUE) {
+            motorSpeed = stateTelemetry.motorSpeed;
+        } else {
+            ESP_LOGD(TAG, "Failed to read motor speed");
+        }
+        for (size_t i = 0; i < count; i++) {
+            m_batch[i].motorSpeed = motorSpeed;
+            m_flightRecorder.record(m_batch[i]);
+        }
+        // Never waits on the network, unlike the WebSocket stream it cannot fall behind
+        m_udpSender.send(m_batch, count);
 
-    // Collect latest data from queues
-    if (xQueuePeek(m_sensorDataQueue, &telemetryData.sensorData, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Failed to read sensor data");
-    }
+        if (m_webServer.update_telemetry(m_batch, count)) {
+            ESP_LOGD(TAG, "Telemetry sent - %u records, last pitch: %.2f", static_cast<unsigned>(count),
+                     m_batch[count - 1].sensorData.pitch);
+        } else {
+            m_unstreamed += count;
+        }
+    } while (count == MAX_BATCH);
+}
 
-    if (xQueuePeek(m_pidOutputQueue, &telemetryData.pidOutput, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Failed to read PID output");
+void TelemetryTask::reportDrops() {
+    uint32_t dropped = m_telemetryRing.dropped();
+    uint32_t udpFailures = m_udpSender.failed();
+    int64_t now = esp_timer_get_time();
+    if ((dropped == m_reportedDrops && m_unstreamed == m_reportedUnstreamed && udpFailures == m_reportedUdpFailures) ||
+        now - m_lastDropReportUs < DROP_REPORT_INTERVAL_US) {
+        return;
     }
-
-    if (xQueuePeek(m_motorSpeedQueue, &telemetryData.motorSpeed, 0) != pdTRUE) {
-        ESP_LOGW(TAG, "Failed to read motor speed");
+    if (dropped != m_reportedDrops) {
+        ESP_LOGW(TAG, "Telemetry ring full, %u records dropped (%u since boot)",
+                 static_cast<unsigned>(dropped - m_reportedDrops), static_cast<unsigned>(dropped));
     }
-
-    m_webServer.update_telemetry(telemetryData);
-
-    ESP_LOGD(TAG, "Telemetry sent - Pitch: %.2f, PID Output: %.2f, Motor Speed: %.2f",
-             telemetryData.sensorData.pitch, telemetryData.pidOutput, telemetryData.motorSpeed);
-}
\ No newline at end of file
+    if (m_unstreamed != m_reportedUnstreamed) {
+        ESP_LOGW(TAG, "Web server busy, %u records not streamed", static_cast<unsigned>(m_unstreamed - m_reportedUnstreamed));
+    }
+    if (udpFailures != m_reportedUdpFailures) {
+        ESP_LOGW(TAG, "UDP send failed, %u datagrams lost", static_cast<unsigned>(udpFailures - m_reportedUdpFailures));
+    }
+    m_reportedDrops = dropped;
+    m_reportedUnstreamed = m_unstreamed;
+    m_reportedUdpFailures = udpFailures;
+    m_lastDropReportUs = now;
+}
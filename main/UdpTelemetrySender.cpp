@@ -0,0 +1,76 @@
+#include "include/UdpTelemetrySender.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+UdpTelemetrySender::UdpTelemetrySender() : m_socket(-1), m_sequence(0), m_failed(0), m_length(0) {
+    memset(&m_destination, 0, sizeof(m_destination));
+}
+
+UdpTelemetrySender::~UdpTelemetrySender() {
+    if (m_socket >= 0) {
+        close(m_socket);
+    }
+}
+
+esp_err_t UdpTelemetrySender::init(const IRuntimeConfig& p_runtimeConfig) {
+    UdpTelemetryConfig l_config = p_runtimeConfig.getUdpTelemetryConfig();
+    if (!l_config.enabled) {
+        ESP_LOGI(TAG, "UDP telemetry disabled");
+        return ESP_OK;
+    }
+
+    // The robot balances without it, a bad address only leaves the stream off
+    m_destination.sin_family = AF_INET;
+    m_destination.sin_port = htons(l_config.port);
+    if (inet_pton(AF_INET, l_config.host, &m_destination.sin_addr) != 1) {
+        ESP_LOGE(TAG, "Invalid collector address '%s', UDP telemetry disabled", l_config.host);
+        return ESP_OK;
+    }
+    m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_socket < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "Streaming telemetry to %s:%u", l_config.host, static_cast<unsigned>(l_config.port));
+    return ESP_OK;
+}
+
+void UdpTelemetrySender::send(const TelemetryData* p_records, size_t p_count) {
+    if (m_socket < 0) {
+        return;
+    }
+    for (size_t i = 0; i < p_count; i++) {
+        if (m_length == 0) {
+            m_length = TelemetryDatagram::HEADER_SIZE;
+        }
+        m_length += TelemetryCodec::encode(toTelemetryFrame(p_records[i]), false, m_datagram + m_length,
+                                           sizeof(m_datagram) - m_length);
+        if (sizeof(m_datagram) - m_length < FRAME_SIZE) {
+            flush();
+        }
+    }
+    flush();
+}
+
+void UdpTelemetrySender::flush() {
+    if (m_length <= TelemetryDatagram::HEADER_SIZE) {
+        return;
+    }
+    // A refused datagram still takes its sequence number, the collector counts it as lost
+    TelemetryDatagramHeader l_header;
+    l_header.frameSize = FRAME_SIZE;
+    l_header.sequence = m_sequence++;
+    l_header.sentUs = esp_timer_get_time();
+    TelemetryDatagram::encodeHeader(l_header, m_datagram, sizeof(m_datagram));
+
+    // Never waits for a buffer, ENOMEM while the Wi-Fi queue is full is a lost datagram
+    int l_sent = sendto(m_socket, m_datagram, m_length, MSG_DONTWAIT,
+                        reinterpret_cast<struct sockaddr*>(&m_destination), sizeof(m_destination));
+    if (l_sent != static_cast<int>(m_length)) {
+        m_failed++;
+    }
+    m_length = 0;
+}
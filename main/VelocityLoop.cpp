@@ -0,0 +1,71 @@
+#include "include/VelocityLoop.hpp"
+#include <algorithm>
+
+VelocityLoop::VelocityLoop()
+    : m_config(), m_handoverPending(true), m_cycle(0), m_elapsed(0.0f), m_integral(0.0f), m_holdPosition(0.0f), m_tilt(0.0f) {}
+
+void VelocityLoop::setConfig(const VelocityLoopConfig& p_config) {
+    if (p_config.enabled && !m_config.enabled) {
+        ESP_LOGI(TAG, "Velocity loop enabled - Kp: %.3f, Ki: %.3f, Position Kp: %.3f, max tilt: %.1f deg",
+                 p_config.kp, p_config.ki, p_config.positionKp, p_config.maxTilt);
+        m_handoverPending = true;
+    }
+    m_config = p_config;
+    m_config.divider = std::max(p_config.divider, 1);
+    m_config.maxTilt = std::max(p_config.maxTilt, 0.0f);
+}
+
+void VelocityLoop::reset() {
+    m_handoverPending = true;
+    m_cycle = 0;
+    m_elapsed = 0.0f;
+    m_integral = 0.0f;
+    m_tilt = 0.0f;
+}
+
+float VelocityLoop::update(const SensorData& p_sensorData, float p_baseTarget) {
+    if (!m_config.enabled) {
+        return p_baseTarget;
+    }
+
+    m_elapsed += p_sensorData.dt;
+    if (++m_cycle < m_config.divider && !m_handoverPending) {
+        return p_baseTarget + m_tilt;
+    }
+
+    float l_speed = 0.5f * (p_sensorData.leftWheelSpeed + p_sensorData.rightWheelSpeed);
+    float l_position = 0.5f * (p_sensorData.leftWheelAngle + p_sensorData.rightWheelAngle);
+
+    if (m_handoverPending) {
+        // Hold the position the robot is at when the loop takes over
+        m_holdPosition = l_position;
+        handover(m_config.targetSpeed - l_speed, 0.0f);
+    } else {
+        float l_speedError = m_config.targetSpeed - l_speed;
+        float l_positionError = m_holdPosition - l_position;
+
+        m_integral = std::clamp(m_integral + l_speedError * m_elapsed, m_config.itermMin, m_config.itermMax);
+        m_tilt = computeTilt(l_speedError, l_positionError);
+    }
+
+    m_cycle = 0;
+    m_elapsed = 0.0f;
+
+    ESP_LOGV(TAG, "Wheel speed: %.3f rad/s, tilt: %.2f deg", l_speed, m_tilt);
+    return p_baseTarget + m_tilt;
+}
+
+float VelocityLoop::computeTilt(float p_speedError, float p_positionError) const {
+    // A positive pitch is corrected by a negative command and the encoders count with the command,
+    // so slowing wheels that run ahead of the target takes a tilt towards positive pitch
+    float l_tilt = -(m_config.kp * p_speedError + m_config.ki * m_integral + m_config.positionKp * p_positionError);
+    return std::clamp(l_tilt, -m_config.maxTilt, m_config.maxTilt);
+}
+
+void VelocityLoop::handover(float p_speedError, float p_positionError) {
+    // Bumpless: pre-load the integrator so the first output equals the setpoint the inner loop already has
+    float l_proportional = m_config.kp * p_speedError + m_config.positionKp * p_positionError;
+    m_integral = (m_config.ki != 0.0f) ? std::clamp(-l_proportional / m_config.ki, m_config.itermMin, m_config.itermMax) : 0.0f;
+    m_tilt = computeTilt(p_speedError, p_positionError);
+    m_handoverPending = false;
+}
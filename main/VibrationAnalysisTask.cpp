@@ -0,0 +1,50 @@
+#include "include/VibrationAnalysisTask.hpp"
+#include "interfaces/IWebServer.hpp"
+
+VibrationAnalysisTask::VibrationAnalysisTask(IWebServer& p_server, QueueHandle_t p_sampleQueue)
+    : m_webServer(p_server), m_imuSampleQueue(p_sampleQueue), m_taskHandle(nullptr) {}
+
+VibrationAnalysisTask::~VibrationAnalysisTask() {
+    if (m_taskHandle != nullptr) {
+        vTaskDelete(m_taskHandle);
+    }
+}
+
+esp_err_t VibrationAnalysisTask::init(const IRuntimeConfig&) {
+    BaseType_t result = xTaskCreate(
+        taskFunction,
+        TAG,
+        STACK_SIZE,
+        this,
+        PRIORITY,
+        &m_taskHandle
+    );
+
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create VibrationAnalysisTask");
+    }
+    return ESP_OK;
+}
+
+void VibrationAnalysisTask::taskFunction(void* pvParameters) {
+    auto* task = static_cast<VibrationAnalysisTask*>(pvParameters);
+    task->run();
+}
+
+void VibrationAnalysisTask::run() {
+    while (true) {
+        ImuSample l_sample;
+        if (xQueueReceive(m_imuSampleQueue, &l_sample, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (!m_analyzer.addSample(l_sample)) {
+            continue;
+        }
+
+        m_analyzer.analyze(m_spectrum);
+        m_webServer.update_spectrum(m_spectrum);
+
+        ESP_LOGD(TAG, "Spectrum %u at %.1f Hz - strongest gyro Y peak %.1f Hz", static_cast<unsigned>(m_spectrum.sequence),
+                 m_spectrum.sampleRateHz, m_spectrum.peakCount[1] > 0 ? m_spectrum.peaks[1][0].frequencyHz : 0.0f);
+    }
+}
@@ -1,12 +1,42 @@
 #include "include/WebServer.hpp"
+#include "include/SysIdLog.hpp"
+#include "include/FlightRecorder.hpp"
+#include "include/JsonWriter.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <memory>
 #include <sstream>
 #include "cJSON.h"
 
-WebServer::WebServer() {
-    m_configRequestQueue = xQueueCreate(CONFIG_QUEUE_SIZE, sizeof(PIDConfig));
+extern const uint8_t index_html_gz_start[] asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[] asm("_binary_index_html_gz_end");
+extern const uint8_t telemetry_js_gz_start[] asm("_binary_telemetry_js_gz_start");
+extern const uint8_t telemetry_js_gz_end[] asm("_binary_telemetry_js_gz_end");
+
+const WebServer::StaticAsset WebServer::ASSETS[2] = {
+    { "/", "text/html", index_html_gz_start, index_html_gz_end, WEB_INDEX_ETAG, false },
+    { "/telemetry.js", "application/javascript", telemetry_js_gz_start, telemetry_js_gz_end, WEB_SCRIPT_ETAG, true }
+};
+
+WebServer::WebServer(SysIdLog& p_sysIdLog, FlightRecorder& p_flightRecorder)
+    : m_runtimeConfig(nullptr), m_server(nullptr), m_sysIdLog(p_sysIdLog), m_flightRecorder(p_flightRecorder),
+                                             m_wsClientCount(0), m_wsSendPending(false), m_wsBatchCount(0), m_wsFrameLength(0),
+                                             m_wsBinaryFrameLength(0), m_wsHalfFrameLength(0),
+                                             m_configUpdated(false), m_configStatus(ConfigStatus::NONE), m_configResult(ESP_OK),
+                                             m_jsonArena(PARSE_ARENA_SIZE) {
+    for (WsClient& client : m_wsClients) {
+        client.fd = -1;
+    }
+    m_configRequestQueue = xQueueCreate(CONFIG_QUEUE_SIZE, sizeof(std::string*));
+    m_autoTuneRequestQueue = xQueueCreate(1, sizeof(AutoTuneRequest));
+    m_sysIdRequestQueue = xQueueCreate(1, sizeof(SysIdRequest));
     m_telemetryMutex = xSemaphoreCreateMutex();
+    m_spectrumMutex = xSemaphoreCreateMutex();
 }
 
 WebServer::~WebServer() {
@@ -14,18 +44,33 @@ WebServer::~WebServer() {
         httpd_stop(m_server);
     }
     if (m_configRequestQueue) {
+        std::string* body;
+        while (xQueueReceive(m_configRequestQueue, &body, 0) == pdTRUE) {
+            delete body;
+        }
         vQueueDelete(m_configRequestQueue);
     }
+    if (m_autoTuneRequestQueue) {
+        vQueueDelete(m_autoTuneRequestQueue);
+    }
+    if (m_sysIdRequestQueue) {
+        vQueueDelete(m_sysIdRequestQueue);
+    }
     if (m_telemetryMutex) {
         vSemaphoreDelete(m_telemetryMutex);
     }
+    if (m_spectrumMutex) {
+        vSemaphoreDelete(m_spectrumMutex);
+    }
 }
 
-esp_err_t WebServer::init(const IRuntimeConfig&) {
+esp_err_t WebServer::init(const IRuntimeConfig& p_runtimeConfig) {
     ESP_LOGI(TAG, "Initializing web server");
+    m_runtimeConfig = &p_runtimeConfig;
     httpd_config_t l_config = HTTPD_DEFAULT_CONFIG();
     l_config.lru_purge_enable = true;
     l_config.stack_size = 8192;
+    l_config.max_uri_handlers = MAX_URI_HANDLERS;
 
     esp_err_t ret = httpd_start(&m_server, &l_config);
     if (ret == ESP_OK) {
@@ -38,13 +83,15 @@ esp_err_t WebServer::init(const IRuntimeConfig&) {
 }
 
 void WebServer::setupRoutes() {
-    httpd_uri_t index = {
-        .uri = "/",
-        .method = HTTP_GET,
-        .handler = indexHandler,
-        .user_ctx = this
-    };
-    httpd_register_uri_handler(m_server, &index);
+    for (const StaticAsset& asset : ASSETS) {
+        httpd_uri_t route = {
+            .uri = asset.uri,
+            .method = HTTP_GET,
+            .handler = assetHandler,
+            .user_ctx = const_cast<StaticAsset*>(&asset)
+        };
+        httpd_register_uri_handler(m_server, &route);
+    }
 
     httpd_uri_t telemetry = {
         .uri = "/telemetry",
@@ -54,6 +101,23 @@ void WebServer::setupRoutes() {
     };
     httpd_register_uri_handler(m_server, &telemetry);
 
+    httpd_uri_t telemetryStream = {
+        .uri = "/ws/telemetry",
+        .method = HTTP_GET,
+        .handler = telemetryStreamHandler,
+        .user_ctx = this,
+        .is_websocket = true
+    };
+    httpd_register_uri_handler(m_server, &telemetryStream);
+
+    httpd_uri_t spectrum = {
+        .uri = "/spectrum",
+        .method = HTTP_GET,
+        .handler = spectrumHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &spectrum);
+
     httpd_uri_t config = {
         .uri = "/config",
         .method = HTTP_POST,
@@ -61,36 +125,310 @@ void WebServer::setupRoutes() {
         .user_ctx = this
     };
     httpd_register_uri_handler(m_server, &config);
+
+    httpd_uri_t configGet = {
+        .uri = "/config",
+        .method = HTTP_GET,
+        .handler = configGetHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &configGet);
+
+    httpd_uri_t configStatus = {
+        .uri = "/config/status",
+        .method = HTTP_GET,
+        .handler = configStatusHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &configStatus);
+
+    httpd_uri_t autoTune = {
+        .uri = "/autotune",
+        .method = HTTP_POST,
+        .handler = autoTuneHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &autoTune);
+
+    httpd_uri_t sysId = {
+        .uri = "/sysid",
+        .method = HTTP_POST,
+        .handler = sysIdHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &sysId);
+
+    httpd_uri_t sysIdExport = {
+        .uri = "/sysid",
+        .method = HTTP_GET,
+        .handler = sysIdExportHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &sysIdExport);
+
+    httpd_uri_t blackBox = {
+        .uri = "/blackbox",
+        .method = HTTP_GET,
+        .handler = blackBoxHandler,
+        .user_ctx = this
+    };
+    httpd_register_uri_handler(m_server, &blackBox);
     ESP_LOGI(TAG, "All URI handlers registered");
 }
 
-void WebServer::update_telemetry(const TelemetryData& telemetry) {
+bool WebServer::update_telemetry(const TelemetryData* batch, size_t count) {
+    if (count == 0) {
+        return true;
+    }
     if (xSemaphoreTake(m_telemetryMutex, portMAX_DELAY) == pdTRUE) {
-        m_lastTelemetry = telemetry;
+        m_lastTelemetry = batch[count - 1];
         xSemaphoreGive(m_telemetryMutex);
     }
+    return publishTelemetry(batch, count);
+}
+
+bool WebServer::publishTelemetry(const TelemetryData* p_batch, size_t p_count) {
+    if (m_wsClientCount.load() == 0) {
+        return true;
+    }
+    // The httpd task is still sending the previous batch, skip this one rather than queue behind it
+    if (m_wsSendPending.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Larger batches lose their oldest records, the sequence numbers show the gap
+    if (p_count > MAX_TELEMETRY_BATCH) {
+        p_batch += p_count - MAX_TELEMETRY_BATCH;
+        p_count = MAX_TELEMETRY_BATCH;
+    }
+    std::copy(p_batch, p_batch + p_count, m_wsBatch);
+    m_wsBatchCount = p_count;
+
+    m_wsSendPending.store(true, std::memory_order_release);
+    if (httpd_queue_work(m_server, telemetryStreamWork, this) != ESP_OK) {
+        m_wsSendPending.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+size_t WebServer::encodeTelemetry(const TelemetryData& p_telemetry, StreamFormat p_format) {
+    switch (p_format) {
+        case StreamFormat::BINARY:
+            m_wsBinaryFrameLength = TelemetryCodec::encode(toTelemetryFrame(p_telemetry), false, m_wsBinaryFrame, sizeof(m_wsBinaryFrame));
+            return m_wsBinaryFrameLength;
+        case StreamFormat::BINARY_HALF:
+            m_wsHalfFrameLength = TelemetryCodec::encode(toTelemetryFrame(p_telemetry), true, m_wsHalfFrame, sizeof(m_wsHalfFrame));
+            return m_wsHalfFrameLength;
+        default: {
+            int length = formatTelemetry(p_telemetry, m_wsFrame, sizeof(m_wsFrame));
+            m_wsFrameLength = (length > 0 && length < static_cast<int>(sizeof(m_wsFrame))) ? length : 0;
+            return m_wsFrameLength;
+        }
+    }
+}
+
+void WebServer::telemetryStreamWork(void *arg) {
+    WebServer* server = static_cast<WebServer*>(arg);
+
+    for (size_t n = 0; n < server->m_wsBatchCount; n++) {
+        const TelemetryData& telemetry = server->m_wsBatch[n];
+        // Clients are thinned on the sample time, a batch arriving late does not change which cycles they get
+        int64_t sampleUs = telemetry.sensorData.timestamp;
+        // Serialized at most once per format, every client of a format gets the same bytes
+        bool encoded[3] = {};
+
+        for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+            WsClient& client = server->m_wsClients[i];
+            // A little slack for sampling jitter, a client at the loop rate would otherwise lose cycles
+            if (client.fd < 0 || sampleUs + client.intervalUs / 8 < client.nextSendUs) {
+                continue;
+            }
+
+            int formatIndex = static_cast<int>(client.format);
+            if (!encoded[formatIndex]) {
+                server->encodeTelemetry(telemetry, client.format);
+                encoded[formatIndex] = true;
+            }
+
+            httpd_ws_frame_t frame = {};
+            frame.final = true;
+            switch (client.format) {
+                case StreamFormat::BINARY:
+                    frame.type = HTTPD_WS_TYPE_BINARY;
+                    frame.payload = server->m_wsBinaryFrame;
+                    frame.len = server->m_wsBinaryFrameLength;
+                    break;
+                case StreamFormat::BINARY_HALF:
+                    frame.type = HTTPD_WS_TYPE_BINARY;
+                    frame.payload = server->m_wsHalfFrame;
+                    frame.len = server->m_wsHalfFrameLength;
+                    break;
+                default:
+                    frame.type = HTTPD_WS_TYPE_TEXT;
+                    frame.payload = reinterpret_cast<uint8_t*>(server->m_wsFrame);
+                    frame.len = server->m_wsFrameLength;
+                    break;
+            }
+            if (frame.len == 0) {
+                continue;
+            }
+            if (httpd_ws_get_fd_info(server->m_server, client.fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+                httpd_ws_send_frame_async(server->m_server, client.fd, &frame) != ESP_OK) {
+                server->removeWsClient(i);
+                continue;
+            }
+            // Keep the client's cadence, but do not burst to catch up after a gap in the samples
+            client.nextSendUs += client.intervalUs;
+            if (client.nextSendUs <= sampleUs) {
+                client.nextSendUs = sampleUs + client.intervalUs;
+            }
+        }
+    }
+
+    server->m_wsSendPending.store(false, std::memory_order_release);
+}
+
+bool WebServer::addWsClient(int p_fd, int p_rateHz, StreamFormat p_format) {
+    int freeSlot = -1;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (m_wsClients[i].fd == p_fd) {
+            freeSlot = i;
+            break;
+        }
+        // Slots of sockets that closed without a failed send are reclaimed here
+        if (m_wsClients[i].fd >= 0 && httpd_ws_get_fd_info(m_server, m_wsClients[i].fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+            removeWsClient(i);
+        }
+        if (m_wsClients[i].fd < 0 && freeSlot < 0) {
+            freeSlot = i;
+        }
+    }
+    if (freeSlot < 0) {
+        return false;
+    }
+    if (m_wsClients[freeSlot].fd != p_fd) {
+        m_wsClients[freeSlot].fd = p_fd;
+        m_wsClientCount++;
+    }
+    m_wsClients[freeSlot].format = p_format;
+    m_wsClients[freeSlot].nextSendUs = 0;
+    setWsClientRate(p_fd, p_rateHz);
+    return true;
+}
+
+void WebServer::setWsClientFormat(int p_fd, StreamFormat p_format) {
+    for (WsClient& client : m_wsClients) {
+        if (client.fd == p_fd) {
+            client.format = p_format;
+        }
+    }
+}
+
+bool WebServer::parseStreamFormat(const char *name, StreamFormat& format) {
+    if (strcmp(name, "json") == 0) {
+        format = StreamFormat::JSON;
+    } else if (strcmp(name, "binary") == 0) {
+        format = StreamFormat::BINARY;
+    } else if (strcmp(name, "binary16") == 0) {
+        format = StreamFormat::BINARY_HALF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void WebServer::setWsClientRate(int p_fd, int p_rateHz) {
+    int rateHz = std::clamp(p_rateHz, 1, MAX_WS_RATE_HZ);
+    for (WsClient& client : m_wsClients) {
+        if (client.fd == p_fd) {
+            client.intervalUs = 1000000 / rateHz;
+            ESP_LOGI(TAG, "Telemetry stream on socket %d at %d Hz", p_fd, rateHz);
+        }
+    }
+}
+
+void WebServer::removeWsClient(int p_index) {
+    ESP_LOGI(TAG, "Telemetry stream on socket %d closed", m_wsClients[p_index].fd);
+    m_wsClients[p_index].fd = -1;
+    m_wsClientCount--;
+}
+
+void WebServer::update_spectrum(const VibrationSpectrum& spectrum) {
+    if (xSemaphoreTake(m_spectrumMutex, portMAX_DELAY) == pdTRUE) {
+        m_lastSpectrum = spectrum;
+        xSemaphoreGive(m_spectrumMutex);
+    }
 }
 
 bool WebServer::hasConfigurationRequest() {
     return uxQueueMessagesWaiting(m_configRequestQueue) > 0;
 }
 
-PIDConfig WebServer::getConfigurationRequest() {
-    PIDConfig config;
-    if (xQueueReceive(m_configRequestQueue, &config, 0) == pdTRUE) {
-        return config;
+std::string WebServer::getConfigurationRequest() {
+    std::string* body;
+    if (xQueueReceive(m_configRequestQueue, &body, 0) == pdTRUE) {
+        std::unique_ptr<std::string> owned(body);
+        return std::move(*owned);
     }
-    return PIDConfig(); // Return default config if queue is empty
+    return std::string(); // Return empty request if queue is empty
 }
 
 void WebServer::notifyConfigurationUpdated() {
     m_configUpdated = true;
 }
 
-esp_err_t WebServer::indexHandler(httpd_req_t *req) {
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_sendstr(req, "<!DOCTYPE html><html><body><h1>Balancing Robot Control</h1></body></html>");
-    return ESP_OK;
+void WebServer::notifyConfigurationResult(esp_err_t p_result) {
+    m_configResult.store(p_result);
+    m_configStatus.store(p_result == ESP_OK ? ConfigStatus::APPLIED : ConfigStatus::REJECTED);
+}
+
+bool WebServer::hasAutoTuneRequest() {
+    return uxQueueMessagesWaiting(m_autoTuneRequestQueue) > 0;
+}
+
+AutoTuneRequest WebServer::getAutoTuneRequest() {
+    AutoTuneRequest request{};
+    xQueueReceive(m_autoTuneRequestQueue, &request, 0);
+    return request;
+}
+
+bool WebServer::hasSysIdRequest() {
+    return uxQueueMessagesWaiting(m_sysIdRequestQueue) > 0;
+}
+
+SysIdRequest WebServer::getSysIdRequest() {
+    SysIdRequest request{};
+    xQueueReceive(m_sysIdRequestQueue, &request, 0);
+    return request;
+}
+
+esp_err_t WebServer::assetHandler(httpd_req_t *req) {
+    const StaticAsset* asset = static_cast<const StaticAsset*>(req->user_ctx);
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%s\"", asset->etag);
+
+    // Only the URL the current page links to is immutable, a bare one may outlive a firmware update
+    char query[32];
+    char version[20];
+    bool immutable = asset->versioned && httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+                     httpd_query_key_value(query, "v", version, sizeof(version)) == ESP_OK &&
+                     strcmp(version, asset->etag) == 0;
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", immutable ? "public, max-age=31536000, immutable" : "no-cache");
+
+    char ifNoneMatch[64];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", ifNoneMatch, sizeof(ifNoneMatch)) == ESP_OK &&
+        strstr(ifNoneMatch, etag) != nullptr) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // Every browser takes gzip, there is no uncompressed copy to fall back to. Sent straight from
+    // flash with its length, httpd hands it to the socket in pieces without a buffer of its own.
+    httpd_resp_set_type(req, asset->type);
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, reinterpret_cast<const char*>(asset->start), asset->end - asset->start);
 }
 
 
@@ -103,28 +441,230 @@ esp_err_t WebServer::telemetryHandler(httpd_req_t *req) {
         xSemaphoreGive(server->m_telemetryMutex);
     }
 
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddNumberToObject(root, "pitch", telemetry.sensorData.pitch);
-    cJSON_AddNumberToObject(root, "roll", telemetry.sensorData.roll);
-    cJSON_AddNumberToObject(root, "yaw", telemetry.sensorData.yaw);
-    cJSON_AddNumberToObject(root, "pidOutput", telemetry.pidOutput);
-    cJSON_AddNumberToObject(root, "motorSpeed", telemetry.motorSpeed);
-
-    char *json_str = cJSON_Print(root);
+    // Sized to go out as a single chunk
+    char buf[WS_FRAME_SIZE];
+    JsonWriter json(buf, sizeof(buf), sendChunk, req);
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_sendstr(req, json_str);
+    if (!writeTelemetry(json, telemetry) || httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Telemetry response aborted");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+int WebServer::formatTelemetry(const TelemetryData& telemetry, char *buf, size_t size) {
+    JsonWriter json(buf, size);
+    return writeTelemetry(json, telemetry) ? static_cast<int>(json.length()) : -1;
+}
 
-    free(json_str);
+bool WebServer::writeTelemetry(JsonWriter& json, const TelemetryData& telemetry) {
+    // Same keys as the binary frame fields, for clients without a frame decoder
+    const SensorData& sensor = telemetry.sensorData;
+    return json.beginObject()
+        .integer("sequence", telemetry.sequence)
+        .integer("state", telemetry.state)
+        .integer("timestamp", sensor.timestamp)
+        .number("pitch", sensor.pitch, 3)
+        .number("roll", sensor.roll, 3)
+        .number("yaw", sensor.yaw, 3)
+        .number("pitchRate", sensor.pitchRate, 2)
+        .number("yawRate", sensor.yawRate, 2)
+        .number("leftWheelSpeed", sensor.leftWheelSpeed, 3)
+        .number("rightWheelSpeed", sensor.rightWheelSpeed, 3)
+        .number("pTerm", telemetry.terms.p, 4)
+        .number("iTerm", telemetry.terms.i, 4)
+        .number("dTerm", telemetry.terms.d, 4)
+        .number("pidOutput", telemetry.pidOutput, 2)
+        .number("motorSpeed", telemetry.motorSpeed, 2)
+        .number("leftDuty", telemetry.leftDuty, 4)
+        .number("rightDuty", telemetry.rightDuty, 4)
+        .number("predictedPitch", telemetry.predictedPitch, 3)
+        .number("predictionHorizonMs", telemetry.predictionHorizon * 1000.0f, 2)
+        .number("latencyMs", telemetry.measuredLatency * 1000.0f, 2)
+        .endObject()
+        .finish();
+}
+
+bool WebServer::sendChunk(void *context, const char *data, size_t length) {
+    return httpd_resp_send_chunk(static_cast<httpd_req_t*>(context), data, length) == ESP_OK;
+}
+
+esp_err_t WebServer::telemetryStreamHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    int fd = httpd_req_to_sockfd(req);
+
+    // The handshake: ?rate_hz=N&format=json|binary|binary16, both can change later with a
+    // {"rate_hz":N,"format":"..."} message
+    if (req->method == HTTP_GET) {
+        int rateHz = DEFAULT_WS_RATE_HZ;
+        StreamFormat format = StreamFormat::JSON;
+        char query[64];
+        char value[12];
+        if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+            if (httpd_query_key_value(query, "rate_hz", value, sizeof(value)) == ESP_OK) {
+                rateHz = atoi(value);
+            }
+            if (httpd_query_key_value(query, "format", value, sizeof(value)) == ESP_OK) {
+                parseStreamFormat(value, format);
+            }
+        }
+        if (!server->addWsClient(fd, rateHz, format)) {
+            ESP_LOGW(TAG, "Telemetry stream refused - %d clients connected", MAX_WS_CLIENTS);
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+
+    char buf[64];
+    httpd_ws_frame_t frame = {};
+    // Length first, anything bigger than a rate change is not for us
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK || frame.len >= sizeof(buf)) {
+        return ret;
+    }
+    frame.payload = reinterpret_cast<uint8_t*>(buf);
+    ret = httpd_ws_recv_frame(req, &frame, frame.len);
+    if (ret != ESP_OK || frame.type != HTTPD_WS_TYPE_TEXT) {
+        return ret;
+    }
+    buf[frame.len] = '\0';
+
+    JsonArena::Scope scope(server->m_jsonArena);
+    cJSON *root = cJSON_Parse(buf);
+    cJSON *rate = root ? cJSON_GetObjectItem(root, "rate_hz") : NULL;
+    cJSON *formatName = root ? cJSON_GetObjectItem(root, "format") : NULL;
+    if (cJSON_IsNumber(rate)) {
+        server->setWsClientRate(fd, rate->valueint);
+    }
+    StreamFormat format;
+    if (cJSON_IsString(formatName) && parseStreamFormat(formatName->valuestring, format)) {
+        server->setWsClientFormat(fd, format);
+    }
     cJSON_Delete(root);
+    return ESP_OK;
+}
+
+esp_err_t WebServer::spectrumHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
 
+    // Copied out so the analysis task is not held up while the response goes out
+    VibrationSpectrum& spectrum = server->m_spectrumResponse;
+    if (xSemaphoreTake(server->m_spectrumMutex, portMAX_DELAY) == pdTRUE) {
+        spectrum = server->m_lastSpectrum;
+        xSemaphoreGive(server->m_spectrumMutex);
+    }
+
+    char buf[JSON_CHUNK_SIZE];
+    JsonWriter json(buf, sizeof(buf), sendChunk, req);
+    httpd_resp_set_type(req, "application/json");
+    json.beginObject()
+        .boolean("valid", spectrum.valid)
+        .integer("sequence", spectrum.sequence)
+        .number("sample_rate_hz", spectrum.sampleRateHz)
+        .number("resolution_hz", spectrum.sampleRateHz / VibrationSpectrum::WINDOW)
+        .beginObject("axes");
+    for (int axis = 0; axis < VibrationSpectrum::AXES; axis++) {
+        json.beginObject(SpectrumAnalyzer::axisName(axis)).beginArray("peaks");
+        for (int i = 0; i < spectrum.peakCount[axis]; i++) {
+            json.beginObject()
+                .number("freq_hz", spectrum.peaks[axis][i].frequencyHz)
+                .number("magnitude", spectrum.peaks[axis][i].magnitude)
+                .endObject();
+        }
+        json.endArray()
+            .numbers("magnitude", spectrum.magnitude[axis], VibrationSpectrum::BINS)
+            .endObject();
+    }
+    json.endObject().endObject();
+    if (!json.finish() || httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Spectrum response aborted");
+        return ESP_FAIL;
+    }
     return ESP_OK;
 }
 
 esp_err_t WebServer::configHandler(httpd_req_t *req) {
     WebServer* server = static_cast<WebServer*>(req->user_ctx);
-    char buf[100];
+    if (req->content_len >= MAX_CONFIG_SIZE) {
+        ESP_LOGE(TAG, "Configuration request too large: %u bytes", static_cast<unsigned>(req->content_len));
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Configuration too large");
+        return ESP_FAIL;
+    }
+
+    // Up to a few kB with a full gain schedule, on the heap and handed to the ConfigurationTask as is
+    auto body = std::make_unique<std::string>(req->content_len, '\0');
+    size_t received = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, &(*body)[received], req->content_len - received);
+        if (ret <= 0) {
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+
+    // Parsed once, by RuntimeConfig on the ConfigurationTask. GET /config/status tells whether it was applied.
+    std::string* queued = body.get();
+    ConfigStatus previous = server->m_configStatus.exchange(ConfigStatus::PENDING);
+    if (xQueueSend(server->m_configRequestQueue, &queued, 0) != pdTRUE) {
+        server->m_configStatus.store(previous);
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    body.release();
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"accepted\"}");
+    return ESP_OK;
+}
+
+esp_err_t WebServer::configStatusHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    static const char* const NAMES[] = { "none", "pending", "applied", "rejected" };
+    ConfigStatus status = server->m_configStatus.load();
+
+    char buf[JSON_CHUNK_SIZE];
+    JsonWriter json(buf, sizeof(buf));
+    json.beginObject().string("status", NAMES[static_cast<int>(status)]);
+    if (status == ConfigStatus::REJECTED) {
+        json.string("error", esp_err_to_name(server->m_configResult.load()));
+    }
+    json.endObject();
+    if (!json.finish()) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, buf);
+    return ESP_OK;
+}
+
+esp_err_t WebServer::configGetHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    if (server->m_runtimeConfig == nullptr) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    // Streamed in chunks, never with the WiFi credentials
+    char buf[JSON_CHUNK_SIZE];
+    JsonWriter json(buf, sizeof(buf), sendChunk, req, true);
+    httpd_resp_set_type(req, "application/json");
+    if (!server->m_runtimeConfig->writeJson(json, false) || httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Configuration response aborted");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+
+esp_err_t WebServer::autoTuneHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    char buf[128];
     int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (ret <= 0) {
+    if (ret < 0) {
         if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
             httpd_resp_send_408(req);
         }
@@ -132,34 +672,264 @@ esp_err_t WebServer::configHandler(httpd_req_t *req) {
     }
     buf[ret] = '\0';
 
-    cJSON *root = cJSON_Parse(buf);
-    if (root == NULL) {
-        const char *error_ptr = cJSON_GetErrorPtr();
-        if (error_ptr != NULL) {
-            ESP_LOGE(TAG, "JSON Parse Error before: %s", error_ptr);
+    AutoTuneRequest request{};
+    request.rule = AutoTuneRule::ZIEGLER_NICHOLS;
+    request.relayAmplitude = AutoTuneRequest::DEFAULT_RELAY_AMPLITUDE;
+    request.hysteresis = AutoTuneRequest::DEFAULT_HYSTERESIS;
+    request.maxPitchDeviation = AutoTuneRequest::DEFAULT_MAX_PITCH_DEVIATION;
+
+    // An empty body starts the experiment with the defaults
+    if (ret > 0) {
+        JsonArena::Scope scope(server->m_jsonArena);
+        cJSON *root = cJSON_Parse(buf);
+        if (root == NULL) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+            return ESP_FAIL;
+        }
+
+        cJSON *rule = cJSON_GetObjectItem(root, "rule");
+        cJSON *relayAmplitude = cJSON_GetObjectItem(root, "relay_amplitude");
+        cJSON *hysteresis = cJSON_GetObjectItem(root, "hysteresis");
+        cJSON *maxDeviation = cJSON_GetObjectItem(root, "max_deviation");
+
+        if (cJSON_IsString(rule) && strcmp(rule->valuestring, "tyreus_luyben") == 0) {
+            request.rule = AutoTuneRule::TYREUS_LUYBEN;
         }
+        if (cJSON_IsNumber(relayAmplitude)) request.relayAmplitude = relayAmplitude->valuedouble;
+        if (cJSON_IsNumber(hysteresis)) request.hysteresis = hysteresis->valuedouble;
+        if (cJSON_IsNumber(maxDeviation)) request.maxPitchDeviation = maxDeviation->valuedouble;
+
+        cJSON_Delete(root);
+    }
+
+    if (xQueueOverwrite(server->m_autoTuneRequestQueue, &request) != pdTRUE) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
 
-    PIDConfig config;
-    cJSON *kp = cJSON_GetObjectItem(root, "kp");
-    cJSON *ki = cJSON_GetObjectItem(root, "ki");
-    cJSON *kd = cJSON_GetObjectItem(root, "kd");
-    cJSON *targetAngle = cJSON_GetObjectItem(root, "targetAngle");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"accepted\"}");
+    return ESP_OK;
+}
+esp_err_t WebServer::sysIdHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    char buf[256];
+    int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
+    if (ret < 0) {
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+            httpd_resp_send_408(req);
+        }
+        return ESP_FAIL;
+    }
+    buf[ret] = '\0';
+
+    // An empty body runs a chirp with the defaults, PIDTask validates the rest
+    SysIdRequest request{};
+    if (ret > 0) {
+        JsonArena::Scope scope(server->m_jsonArena);
+        cJSON *root = cJSON_Parse(buf);
+        if (root == NULL) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+            return ESP_FAIL;
+        }
 
-    if (cJSON_IsNumber(kp)) config.kp = kp->valuedouble;
-    if (cJSON_IsNumber(ki)) config.ki = ki->valuedouble;
-    if (cJSON_IsNumber(kd)) config.kd = kd->valuedouble;
-    if (cJSON_IsNumber(targetAngle)) config.targetAngle = targetAngle->valuedouble;
+        cJSON *item;
+        if ((item = cJSON_GetObjectItem(root, "type")) && cJSON_IsString(item)) {
+            if (strcmp(item->valuestring, "prbs") == 0) request.type = ExcitationType::PRBS;
+            else if (strcmp(item->valuestring, "step") == 0) request.type = ExcitationType::STEP;
+        }
+        if ((item = cJSON_GetObjectItem(root, "amplitude")) && cJSON_IsNumber(item)) request.amplitude = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(root, "duration")) && cJSON_IsNumber(item)) request.duration = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(root, "start_freq_hz")) && cJSON_IsNumber(item)) request.startFrequencyHz = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(root, "end_freq_hz")) && cJSON_IsNumber(item)) request.endFrequencyHz = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(root, "prbs_bit_cycles")) && cJSON_IsNumber(item)) request.prbsBitCycles = item->valueint;
+        if ((item = cJSON_GetObjectItem(root, "step_delay")) && cJSON_IsNumber(item)) request.stepDelay = item->valuedouble;
+        if ((item = cJSON_GetObjectItem(root, "max_deviation")) && cJSON_IsNumber(item)) request.maxPitchDeviation = item->valuedouble;
 
-    cJSON_Delete(root);
+        cJSON_Delete(root);
+    }
 
-    if (xQueueSend(server->m_configRequestQueue, &config, 0) != pdTRUE) {
+    if (xQueueOverwrite(server->m_sysIdRequestQueue, &request) != pdTRUE) {
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
 
-    httpd_resp_sendstr(req, "Configuration updated");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"accepted\"}");
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t WebServer::sysIdExportHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    SysIdLog& log = server->m_sysIdLog;
+
+    // Holds off a new run until the whole buffer has been sent
+    if (!log.acquire()) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No finished identification run");
+        return ESP_FAIL;
+    }
+
+    static const char* const TYPE_NAMES[] = {"chirp", "prbs", "step"};
+    const SysIdRequest& request = log.getRequest();
+
+    char chunk[EXPORT_CHUNK_SIZE];
+    int length = snprintf(chunk, sizeof(chunk),
+                          "# type=%s amplitude=%.3f dt=%.4f start_freq_hz=%.3f end_freq_hz=%.3f prbs_bit_cycles=%d status=%s\n"
+                          "time_s,excitation,command,pitch_deg,pitch_rate_dps,left_speed,right_speed,wheel_angle\n",
+                          TYPE_NAMES[static_cast<int>(request.type)], request.amplitude, log.getDt(),
+                          request.startFrequencyHz, request.endFrequencyHz, request.prbsBitCycles,
+                          log.getState() == SysIdLog::State::COMPLETE ? "complete" : "aborted");
+
+    httpd_resp_set_type(req, "text/csv");
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < log.size() && ret == ESP_OK; i++) {
+        const SysIdRecord& r = log.at(i);
+        length += snprintf(chunk + length, sizeof(chunk) - length, "%.4f,%.4f,%.2f,%.3f,%.2f,%.3f,%.3f,%.4f\n",
+                           r.time, r.excitation, r.command, r.pitch, r.pitchRate,
+                           r.leftWheelSpeed, r.rightWheelSpeed, r.wheelAngle);
+        // Flush while the next row still fits
+        if (length > static_cast<int>(sizeof(chunk)) - 128) {
+            ret = httpd_resp_send_chunk(req, chunk, length);
+            length = 0;
+        }
+    }
+    if (ret == ESP_OK && length > 0) {
+        ret = httpd_resp_send_chunk(req, chunk, length);
+    }
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    log.release();
+    return ret;
+}
+
+esp_err_t WebServer::blackBoxHandler(httpd_req_t *req) {
+    // GET /blackbox lists the fall dumps, GET /blackbox?id=N[&format=binary|csv] downloads one
+    char query[48];
+    char value[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "id", value, sizeof(value)) == ESP_OK) {
+        char *end;
+        unsigned long id = strtoul(value, &end, 10);
+        if (end == value || *end != '\0') {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid dump id");
+            return ESP_FAIL;
+        }
+        FlightRecordingExport::Format format = FlightRecordingExport::Format::BINARY;
+        if (httpd_query_key_value(query, "format", value, sizeof(value)) == ESP_OK) {
+            if (strcmp(value, "csv") == 0) {
+                format = FlightRecordingExport::Format::CSV;
+            } else if (strcmp(value, "binary") != 0) {
+                httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown format");
+                return ESP_FAIL;
+            }
+        }
+        return blackBoxDumpHandler(req, static_cast<uint32_t>(id), format);
+    }
+    return blackBoxListHandler(req);
+}
+
+esp_err_t WebServer::blackBoxListHandler(httpd_req_t *req) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    FlightRecorder::DumpInfo dumps[FlightRecorder::MAX_DUMPS];
+    int count = server->m_flightRecorder.listDumps(dumps, FlightRecorder::MAX_DUMPS);
+
+    char buf[JSON_CHUNK_SIZE];
+    JsonWriter json(buf, sizeof(buf), sendChunk, req);
+    httpd_resp_set_type(req, "application/json");
+    json.beginObject().beginArray("dumps");
+    for (int i = 0; i < count; i++) {
+        json.beginObject()
+            .integer("id", dumps[i].id)
+            .integer("size", static_cast<long long>(dumps[i].size))
+            .integer("frames", static_cast<long long>(dumps[i].size >= FlightRecording::HEADER_SIZE ?
+                                                      (dumps[i].size - FlightRecording::HEADER_SIZE) / FlightRecorder::FRAME_SIZE : 0))
+            .endObject();
+    }
+    json.endArray().endObject();
+    if (!json.finish() || httpd_resp_send_chunk(req, NULL, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Black box list aborted");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t WebServer::blackBoxDumpHandler(httpd_req_t *req, uint32_t id, FlightRecordingExport::Format format) {
+    WebServer* server = static_cast<WebServer*>(req->user_ctx);
+    char path[32];
+    struct stat fileStat;
+    if (!server->m_flightRecorder.getDumpPath(id, path, sizeof(path)) || stat(path, &fileStat) != 0) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such dump");
+        return ESP_FAIL;
+    }
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to open dump");
+        return ESP_FAIL;
+    }
+
+    // Transcoded a block of frames at a time, the file never is in RAM as a whole
+    FlightRecordingExport recording(format, readDumpAt, file);
+    if (!recording.open(static_cast<uint32_t>(fileStat.st_size))) {
+        fclose(file);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Corrupt dump");
+        return ESP_FAIL;
+    }
+
+    // Dumps never change once written, a range of an earlier response is still valid
+    uint32_t size = recording.size();
+    uint32_t first = 0;
+    uint32_t last = size > 0 ? size - 1 : 0;
+    char range[48];
+    char contentRange[48];
+    httpd_resp_set_hdr(req, "Accept-Ranges", "bytes");
+    if (httpd_req_get_hdr_value_str(req, "Range", range, sizeof(range)) == ESP_OK) {
+        if (!FlightRecordingExport::parseRange(range, size, first, last)) {
+            fclose(file);
+            snprintf(contentRange, sizeof(contentRange), "bytes */%u", static_cast<unsigned>(size));
+            httpd_resp_set_status(req, "416 Range Not Satisfiable");
+            httpd_resp_set_hdr(req, "Content-Range", contentRange);
+            return httpd_resp_send(req, NULL, 0);
+        }
+        snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u", static_cast<unsigned>(first),
+                 static_cast<unsigned>(last), static_cast<unsigned>(size));
+        httpd_resp_set_status(req, "206 Partial Content");
+        httpd_resp_set_hdr(req, "Content-Range", contentRange);
+    }
+
+    bool csv = format == FlightRecordingExport::Format::CSV;
+    char disposition[48];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"fall_%u.%s\"", static_cast<unsigned>(id), csv ? "csv" : "bbx");
+    httpd_resp_set_type(req, csv ? "text/csv" : "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", disposition);
+
+    char chunk[EXPORT_CHUNK_SIZE];
+    esp_err_t ret = ESP_OK;
+    uint32_t remaining = size > 0 ? last - first + 1 : 0;
+    recording.seek(first);
+    while (ret == ESP_OK && remaining > 0) {
+        size_t length = recording.read(chunk, std::min<size_t>(sizeof(chunk), remaining));
+        if (length == 0) {
+            ESP_LOGE(TAG, "Failed to read %s", path);
+            ret = ESP_FAIL;
+            break;
+        }
+        ret = httpd_resp_send_chunk(req, chunk, length);
+        remaining -= length;
+    }
+    fclose(file);
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return ret;
+}
+
+bool WebServer::readDumpAt(void *context, uint32_t offset, uint8_t *buffer, size_t length) {
+    FILE* file = static_cast<FILE*>(context);
+    // Reads are sequential after the first, a seek would throw away the stdio buffer every time
+    if (ftell(file) != static_cast<long>(offset) && fseek(file, offset, SEEK_SET) != 0) {
+        return false;
+    }
+    return fread(buffer, 1, length, file) == length;
+}
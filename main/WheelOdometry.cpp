@@ -0,0 +1,52 @@
+#include "include/WheelOdometry.hpp"
+#include "interface/IEncoder.hpp"
+
+WheelOdometry::WheelOdometry(std::shared_ptr<IEncoder> p_left, std::shared_ptr<IEncoder> p_right)
+    : m_leftEncoder(p_left), m_rightEncoder(p_right), m_enabled(false) {}
+
+esp_err_t WheelOdometry::init(const IRuntimeConfig&) {
+    ESP_LOGI(TAG, "Initializing WheelOdometry");
+
+    if (!m_leftEncoder || !m_rightEncoder || !m_leftEncoder->isInitialized() || !m_rightEncoder->isInitialized()) {
+        ESP_LOGW(TAG, "Wheel encoders not available, odometry disabled");
+        return ESP_OK;
+    }
+
+    int32_t l_leftCount = 0, l_rightCount = 0;
+    esp_err_t l_ret = m_leftEncoder->getCount(l_leftCount);
+    if (l_ret == ESP_OK) {
+        l_ret = m_rightEncoder->getCount(l_rightCount);
+    }
+    if (l_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read initial encoder counts: %s", esp_err_to_name(l_ret));
+        return l_ret;
+    }
+
+    int64_t l_now = esp_timer_get_time();
+    m_leftEstimator.setCountsPerRevolution(m_leftEncoder->getCountsPerRevolution());
+    m_rightEstimator.setCountsPerRevolution(m_rightEncoder->getCountsPerRevolution());
+    m_leftEstimator.reset(l_leftCount, l_now);
+    m_rightEstimator.reset(l_rightCount, l_now);
+    m_enabled = true;
+
+    ESP_LOGI(TAG, "WheelOdometry initialized successfully");
+    return ESP_OK;
+}
+
+void WheelOdometry::update(SensorData& p_sensorData) {
+    if (!m_enabled) {
+        return;
+    }
+
+    int32_t l_leftCount, l_rightCount;
+    if (m_leftEncoder->getCount(l_leftCount) != ESP_OK || m_rightEncoder->getCount(l_rightCount) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to read encoders, keeping last wheel state");
+        return;
+    }
+
+    // Stamp with the IMU sample time so both measurements describe the same instant
+    p_sensorData.leftWheelSpeed = m_leftEstimator.update(l_leftCount, p_sensorData.timestamp);
+    p_sensorData.rightWheelSpeed = m_rightEstimator.update(l_rightCount, p_sensorData.timestamp);
+    p_sensorData.leftWheelAngle = m_leftEstimator.getAngle();
+    p_sensorData.rightWheelAngle = m_rightEstimator.getAngle();
+}
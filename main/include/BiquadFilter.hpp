@@ -0,0 +1,64 @@
+#pragma once
+
+enum class BiquadType : unsigned char {
+    NONE,
+    LOW_PASS,
+    HIGH_PASS,
+    NOTCH
+};
+
+struct BiquadStageConfig {
+    BiquadType type = BiquadType::NONE;
+    float frequencyHz = 0.0f;     // Cutoff, or centre frequency of a notch
+    float q = 0.7071f;            // Butterworth for LP/HP, f0 / bandwidth for a notch
+};
+
+// Fixed size so a whole filter bank fits a mailbox queue item
+struct FilterChainConfig {
+    static constexpr int MAX_STAGES = 4;
+
+    int stages = 0;
+    BiquadStageConfig stage[MAX_STAGES];
+};
+
+// Chains inserted at the points where vibration enters the loop
+struct FilterBankConfig {
+    FilterChainConfig gyro;       // Gyro Y and Z before the complementary filter and rate loops
+    FilterChainConfig accel;      // Accelerometer X, Y, Z before the tilt estimate
+    FilterChainConfig dTerm;      // Pitch PID derivative, after the d_filter low-pass
+    FilterChainConfig motor;      // Balance command before the output shaper
+};
+
+// Cascade of second-order sections in direct form II, the state layout of the ESP-DSP kernel
+// so target and host produce the same numbers. Coefficients are recomputed only when the chain
+// or the sample period changes. Stages with an invalid frequency are passed through. On the target
+// the per-stage loop runs on the ESP-DSP biquad kernel when the component is available.
+class BiquadCascade {
+public:
+    BiquadCascade();
+
+    void configure(const FilterChainConfig&, float p_dt);
+    void reset();
+
+    // Filters p_count consecutive samples of one axis in place
+    void process(float* p_samples, int p_count);
+    float process(float p_sample);
+
+    static bool isValid(const BiquadStageConfig&);
+
+private:
+    struct Section {
+        float coefficients[5];    // b0, b1, b2, a1, a2 with a0 normalized to 1
+        float state[2];
+    };
+
+    FilterChainConfig m_config;
+    float m_dt;
+    int m_sections;
+    bool m_primed;
+    Section m_section[FilterChainConfig::MAX_STAGES];
+
+    static bool sameChain(const FilterChainConfig&, const FilterChainConfig&);
+    static void design(const BiquadStageConfig&, float p_dt, float (&p_coefficients)[5]);
+    void prime(float p_sample);
+};
@@ -4,7 +4,9 @@
 #include "include/WebServer.hpp"
 #include "include/WifiManager.hpp"
 #include "include/PIDController.hpp"
-#include "include/MotorDriver.hpp"
+#include "include/LQRController.hpp"
+#include "include/DifferentialDrive.hpp"
+#include "include/WheelOdometry.hpp"
 #include "include/MPU6050Manager.hpp"
 #include "include/StateMachine.hpp"
 #include "include/SensorTask.hpp"
@@ -12,6 +14,11 @@
 #include "include/MotorControlTask.hpp"
 #include "include/TelemetryTask.hpp"
 #include "include/ConfigurationTask.hpp"
+#include "include/VibrationAnalysisTask.hpp"
+#include "include/SysIdLog.hpp"
+#include "include/FlightRecorder.hpp"
+#include "include/UdpTelemetrySender.hpp"
+#include "include/ControlMailboxes.hpp"
 
 #include <vector>
 #include <memory>
@@ -38,11 +45,32 @@ public:
 private:
     static constexpr const char* TAG = "Component Handler";
 
+    // LEDC channels of the two MX1616H bridges, configured by the HardwareManager
+    static constexpr ledc_mode_t MOTOR_SPEED_MODE = LEDC_HIGH_SPEED_MODE;
+    static constexpr ledc_channel_t LEFT_MOTOR_IN1 = LEDC_CHANNEL_0;
+    static constexpr ledc_channel_t LEFT_MOTOR_IN2 = LEDC_CHANNEL_1;
+    static constexpr ledc_channel_t RIGHT_MOTOR_IN1 = LEDC_CHANNEL_2;
+    static constexpr ledc_channel_t RIGHT_MOTOR_IN2 = LEDC_CHANNEL_3;
+
+    // Bridge ids in the HardwareManager MCPWM configuration, used with motor.driver "mcpwm"
+    static constexpr int LEFT_MOTOR_BRIDGE_ID = 0;
+    static constexpr int RIGHT_MOTOR_BRIDGE_ID = 1;
+
+    // Encoder ids in the HardwareManager encoder configuration
+    static constexpr int LEFT_ENCODER_ID = 0;
+    static constexpr int RIGHT_ENCODER_ID = 1;
+
     std::unique_ptr<IWiFiManager> m_wifiManager;
     std::unique_ptr<IWebServer> m_webServer;
     std::unique_ptr<IMotorDriver> m_motorDriver;
     std::unique_ptr<IPIDController> m_pidController;
+    std::unique_ptr<IPIDController> m_yawPidController;
     std::unique_ptr<IMPU6050Manager> m_mpu6050Manager;
+    std::unique_ptr<WheelOdometry> m_wheelOdometry;
+    std::unique_ptr<SysIdLog> m_sysIdLog;   // Written by PIDTask, exported by the WebServer
+    std::unique_ptr<TelemetryRing> m_telemetryRing; // Filled by PIDTask every cycle, drained by TelemetryTask
+    std::unique_ptr<FlightRecorder> m_flightRecorder;   // Fed by TelemetryTask, dumps listed by the WebServer
+    std::unique_ptr<UdpTelemetrySender> m_udpTelemetrySender;  // Fed by TelemetryTask, off unless configured
 
     std::unique_ptr<IStateMachine> m_stateMachine;
     std::unique_ptr<ISensorTask> m_sensorTask;
@@ -50,10 +78,9 @@ private:
     std::unique_ptr<IMotorControlTask> m_motorControlTask;
     std::unique_ptr<ITelemetryTask> m_telemetryTask;
     std::unique_ptr<IConfigurationTask> m_configurationTask;
+    std::unique_ptr<IVibrationAnalysisTask> m_vibrationAnalysisTask;
+
+    esp_err_t createMotorDriver(const IRuntimeConfig&);
 
-    QueueHandle_t m_sensorDataQueue;
-    QueueHandle_t m_pidOutputQueue;
-    QueueHandle_t m_motorControlQueue;
-    QueueHandle_t m_telemetryQueue;
-    QueueHandle_t m_configQueue;
+    ControlMailboxes m_mailboxes{};
 };
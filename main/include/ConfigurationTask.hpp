@@ -1,13 +1,15 @@
 #pragma once
 
 #include "interfaces/ITask.hpp"
+#include "include/ControlMailboxes.hpp"
+#include <string>
 
 class IRuntimeConfig;
 class IWebServer;
 
 class ConfigurationTask : public IConfigurationTask {
 public:
-    ConfigurationTask(IRuntimeConfig&, IWebServer&, QueueHandle_t);
+    ConfigurationTask(IRuntimeConfig&, IWebServer&, const ControlMailboxes&);
     ~ConfigurationTask();
     
     esp_err_t init(const IRuntimeConfig&) override;
@@ -21,12 +23,23 @@ private:
     IRuntimeConfig& m_runtimeConfig;
     IWebServer& m_webServer;
 
-    QueueHandle_t m_configUpdateQueue;
+    const ControlMailboxes& m_mailboxes;
     TaskHandle_t m_taskHandle;
 
     static void taskFunction(void* pvParameters);
     void run();
 
     void applyConfigUpdate(const PIDConfig&);
+    void applyConfigUpdate(const std::string&);
     void broadcastConfig();
+    void broadcastYawConfig();
+    void broadcastLQRConfig();
+    void broadcastGainSchedule();
+    void broadcastVelocityLoop();
+    void broadcastPredictor();
+    void broadcastFilterBank();
+    void broadcastLoopPeriod();
+    void broadcastMotorShaping();
+    void handleAutoTune();
+    void handleSysId();
 };
\ No newline at end of file
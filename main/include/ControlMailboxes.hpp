@@ -0,0 +1,30 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+// The queues between the control tasks, created together by the ComponentHandler and handed to
+// each task by reference. Config mailboxes hold a single item that is overwritten by the
+// ConfigurationTask and peeked by the tasks at the top of their cycle.
+struct ControlMailboxes {
+    QueueHandle_t sensorData;       // SensorData, written by SensorTask every cycle
+    QueueHandle_t pidOutput;        // PIDOutput, from PIDTask to MotorControlTask
+    QueueHandle_t motorControl;     // float, the StateMachine's stop command and TelemetryTask's motor speed
+    QueueHandle_t telemetry;        // TelemetryData from the StateMachine
+    QueueHandle_t config;           // PIDConfig of the balance controller
+    QueueHandle_t yawConfig;        // PIDConfig of the yaw-rate controller
+    QueueHandle_t lqrConfig;
+    QueueHandle_t gainSchedule;
+    QueueHandle_t velocityLoop;
+    QueueHandle_t predictor;
+    QueueHandle_t filterBank;       // Peeked by the sensor, PID and motor tasks
+    QueueHandle_t imuSample;        // Raw IMU samples for the vibration analysis, dropped when full
+    QueueHandle_t motorFeedback;    // Latency and wheel duties, written by MotorControlTask
+    QueueHandle_t loopPeriod;       // int, main_loop.interval_ms
+    QueueHandle_t motorShaping;
+    QueueHandle_t autoTune;         // AutoTuneRequest for PIDTask
+    QueueHandle_t autoTuneResult;   // PIDConfig found by the auto-tuner, persisted by the ConfigurationTask
+    QueueHandle_t sysId;            // SysIdRequest for PIDTask
+
+    // Every queue with its item type and depth, ESP_ERR_NO_MEM if one could not be allocated
+    esp_err_t create();
+};
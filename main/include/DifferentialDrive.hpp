@@ -0,0 +1,29 @@
+#pragma once
+
+#include "interfaces/IMotorDriver.hpp"
+#include <memory>
+
+class IMotor;
+class IMotorGroup;
+
+// Two independently driven wheels. Both wheels are staged and latched together
+// through a motor group, so they always change speed in the same control cycle.
+class DifferentialDrive : public IMotorDriver {
+public:
+    DifferentialDrive(std::shared_ptr<IMotor> p_left, std::shared_ptr<IMotor> p_right);
+    ~DifferentialDrive();
+
+    esp_err_t init(const IRuntimeConfig&) override;
+    esp_err_t setSpeed(float) override;
+    esp_err_t setSpeed(float, float) override;
+
+    // Splits the balance command into wheel commands. A positive turn command yaws
+    // counter-clockwise seen from above. Balance keeps priority: turning only gets
+    // the headroom left before either wheel saturates.
+    static void mix(float p_balance, float p_turn, float& p_left, float& p_right);
+
+private:
+    static constexpr const char* TAG = "DifferentialDrive";
+
+    std::unique_ptr<IMotorGroup> m_wheels;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// Wheel speed from an accumulated encoder count sampled once per control cycle.
+// Fast wheels use the count method (counts per cycle). Slow wheels, where a cycle
+// sees only a few counts, use the period method: the window reaches back over the
+// last few cycles that saw an edge, so one count more or less stays a small part of
+// the estimate. Cycles without an edge cap the estimate
+// at one count over the elapsed time, so the speed decays to zero instead of
+// holding the last value when the wheel stops.
+class EncoderVelocityEstimator {
+public:
+    EncoderVelocityEstimator();
+
+    void setCountsPerRevolution(int);
+    void reset(int32_t p_count, int64_t p_timeUs);
+
+    // Returns the wheel speed in rad/s
+    float update(int32_t p_count, int64_t p_timeUs);
+
+    float getAngle() const;
+    float getVelocity() const { return m_velocity; }
+
+private:
+    static constexpr int32_t COUNT_METHOD_THRESHOLD = 4;    // Counts per cycle above which the count method is used
+    static constexpr int64_t STOP_TIMEOUT_US = 250000;      // No edge for this long reads as standstill
+    static constexpr int EDGE_HISTORY = COUNT_METHOD_THRESHOLD;
+
+    // Count and time of a cycle that saw an edge
+    struct Edge {
+        int32_t count;
+        int64_t timeUs;
+    };
+
+    float m_radiansPerCount;
+    int32_t m_originCount;
+    int32_t m_lastCount;
+    int64_t m_lastTimeUs;
+    Edge m_edges[EDGE_HISTORY];     // Ring, m_edges[m_edgeHead] is the latest
+    int m_edgeHead;
+    int m_edgeCount;
+    bool m_countMethod;
+    float m_velocity;
+
+    const Edge& lastEdge() const { return m_edges[m_edgeHead]; }
+    void pushEdge(int32_t p_count, int64_t p_timeUs);
+    const Edge& periodStart(int64_t p_timeUs) const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+#include "include/FlightRecording.hpp"
+#include <atomic>
+
+// Black box of the last CAPACITY control cycles. TelemetryTask feeds it every record it drains from
+// the telemetry ring, the control loop never sees it. When a record shows the BALANCING to FALLING
+// transition the recorder keeps going for POST_TRIGGER_US, then freezes and its own task writes the
+// window to SPIFFS as a FlightRecording file. Records arriving while the dump is written are skipped,
+// the robot is down by then. Only the newest MAX_DUMPS files are kept.
+class FlightRecorder : public IComponent {
+public:
+    static constexpr int CAPACITY = 1024;       // 10 s at the default 10 ms loop, 48 kB
+    static constexpr int MAX_DUMPS = 3;
+    static constexpr int64_t POST_TRIGGER_US = 500000;
+    static constexpr size_t FRAME_SIZE = TelemetryCodec::HEADER_SIZE + TelemetryFrame::FIELD_COUNT * sizeof(uint16_t);
+
+    struct DumpInfo {
+        uint32_t id;
+        size_t size;
+    };
+
+    FlightRecorder();
+    ~FlightRecorder();
+
+    esp_err_t init(const IRuntimeConfig&) override;
+
+    // TelemetryTask only
+    void record(const TelemetryData&);
+
+    // Newest first, returns how many were found
+    int listDumps(DumpInfo* p_dumps, int p_max) const;
+    // False for an id that is not on flash
+    bool getDumpPath(uint32_t p_id, char* p_path, size_t p_size) const;
+
+private:
+    static constexpr const char* TAG = "FlightRecorder";
+    static constexpr int STACK_SIZE = 4096;
+    static constexpr UBaseType_t PRIORITY = 1;  // Flash writes take their time, nothing waits for them
+    static constexpr const char* DIRECTORY = "/spiffs";
+    static constexpr const char* PARTITION = "storage";
+    static constexpr size_t MAX_PATH = 32;
+
+    TaskHandle_t m_taskHandle;
+    // Set by record() once the post-trigger window is full, cleared by the writer task when the file is done
+    std::atomic<bool> m_frozen;
+
+    bool m_triggered;
+    int64_t m_triggerTimestamp;
+    int m_triggerIndex;
+    uint8_t m_lastState;
+
+    int m_next;     // Slot the next record goes into
+    int m_count;
+    uint32_t m_nextId;
+    uint8_t m_frames[CAPACITY][FRAME_SIZE];
+
+    static void taskFunction(void* pvParameters);
+    void run();
+
+    esp_err_t writeDump();
+    void removeOldDumps(size_t p_needed);
+    uint32_t findNextId() const;
+    static bool parseDumpName(const char* p_name, uint32_t& p_id);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+// A fall dump of FlightRecorder, little-endian, no padding:
+//   0  u32  magic "BBX1"
+//   4  u16  header size, the first frame starts here
+//   6  u16  frame size, the same for every frame of the file
+//   8  u32  frame count
+//   12 u32  index of the frame the fall was detected in
+//   16      frames oldest first, TelemetryCodec with half precision values
+// Readers skip header bytes they do not know and step through the frames by the frame size.
+
+#include <cstddef>
+#include <cstdint>
+#include "include/TelemetryFrame.hpp"
+
+struct FlightRecordingHeader {
+    uint16_t headerSize = 0;
+    uint16_t frameSize = 0;
+    uint32_t frameCount = 0;
+    uint32_t triggerIndex = 0;
+};
+
+class FlightRecording {
+public:
+    static constexpr uint32_t MAGIC = 0x31584242;   // "BBX1" read as little-endian
+    static constexpr size_t HEADER_SIZE = 16;
+
+    // Returns HEADER_SIZE, 0 when the buffer is too small
+    static size_t encodeHeader(const FlightRecordingHeader&, uint8_t* p_buffer, size_t p_size);
+    // Rejects a wrong magic, a truncated header and a frame size no frame fits in
+    static bool decodeHeader(const uint8_t* p_buffer, size_t p_length, FlightRecordingHeader&);
+};
+
+// The bytes of a dump download, either the file as stored or transcoded to CSV. They are produced
+// block by block from reads at arbitrary file offsets, so neither the file nor the output is ever in
+// RAM as a whole and a download can resume at any byte. Every CSV row has the same width, which is
+// what maps a byte offset of the CSV back to a frame.
+class FlightRecordingExport {
+public:
+    enum class Format : uint8_t {
+        BINARY,
+        CSV
+    };
+
+    // Reads p_length bytes of the file at p_offset, false on a short read
+    typedef bool (*Source)(void* p_context, uint32_t p_offset, uint8_t* p_buffer, size_t p_length);
+
+    static constexpr int BLOCK_FRAMES = 8;      // Frames read from the file at a time for the CSV
+    // sequence, state, timestamp_us, trigger, then one column per frame field
+    static constexpr size_t CSV_ROW_SIZE = 10 + 1 + 3 + 1 + 20 + 1 + 1 + TelemetryFrame::FIELD_COUNT * 11 + 1;
+
+    FlightRecordingExport(Format, Source, void* p_context);
+
+    // Reads and checks the file header. p_fileSize bounds the frame count of a truncated file.
+    bool open(uint32_t p_fileSize);
+    const FlightRecordingHeader& header() const { return m_header; }
+
+    // Length of the whole download
+    uint32_t size() const { return m_size; }
+    bool seek(uint32_t p_offset);
+    // Next bytes of the download, 0 at the end or once a file read failed
+    size_t read(char* p_buffer, size_t p_size);
+    bool failed() const { return m_failed; }
+
+    // A single "bytes=first-last", "bytes=first-" or "bytes=-suffix" range. False for anything else
+    // and for a range starting beyond p_size, p_last is clamped to the end.
+    static bool parseRange(const char* p_value, uint32_t p_size, uint32_t& p_first, uint32_t& p_last);
+
+private:
+    Format m_format;
+    Source m_source;
+    void* m_context;
+    FlightRecordingHeader m_header;
+    uint32_t m_frameCount;
+    uint32_t m_size;
+    uint32_t m_offset;
+    bool m_failed;
+
+    char m_headerLine[24 + TelemetryFrame::FIELD_COUNT * 24];
+    size_t m_headerLineLength;
+
+    uint8_t m_block[BLOCK_FRAMES * TelemetryCodec::MAX_SIZE];
+    uint32_t m_blockFirst;
+    uint32_t m_blockCount;
+    char m_row[CSV_ROW_SIZE + 1];
+    uint32_t m_rowIndex;        // Frame m_row holds, UINT32_MAX before the first
+
+    bool loadRow(uint32_t p_index);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+// Multipliers on kp, ki and kd at one operating point
+struct GainScale {
+    float kp = 1.0f;
+    float ki = 1.0f;
+    float kd = 1.0f;
+};
+
+// Multipliers on the base PID gains over |pitch error| (deg) and optionally |wheel speed| (rad/s).
+// Tables are indexed [speed][error]; with a single speed breakpoint the schedule is 1-D in the error.
+// Fixed size so it fits a mailbox queue item and the lookup never allocates.
+struct GainScheduleConfig {
+    static constexpr int MAX_POINTS = 8;
+
+    bool enabled = false;
+    int errorPoints = 0;
+    int speedPoints = 0;
+    float errorBreakpoints[MAX_POINTS] = {};
+    float speedBreakpoints[MAX_POINTS] = {};
+    float kpScale[MAX_POINTS][MAX_POINTS] = {};
+    float kiScale[MAX_POINTS][MAX_POINTS] = {};
+    float kdScale[MAX_POINTS][MAX_POINTS] = {};
+};
+
+// Bilinear interpolation in the schedule, clamped at the outermost breakpoints
+class GainSchedule {
+public:
+    GainSchedule();
+
+    // Returns false and keeps the previous table when the config is malformed
+    bool setConfig(const GainScheduleConfig&);
+    static bool isValid(const GainScheduleConfig&);
+
+    bool isEnabled() const { return m_config.enabled; }
+    GainScale evaluate(float p_pitchError, float p_wheelSpeed) const;
+
+private:
+    GainScheduleConfig m_config;
+
+    struct Segment {
+        int index;
+        float fraction;
+    };
+
+    static Segment locate(const float* p_breakpoints, int p_count, float p_value);
+    static float interpolate(const float (&p_table)[GainScheduleConfig::MAX_POINTS][GainScheduleConfig::MAX_POINTS],
+                             const Segment& p_speed, const Segment& p_error);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+// Bump allocator for cJSON parsing. cJSON_Parse makes one allocation per value and per key, on
+// the shared heap that is around a hundred small blocks per config document, interleaved with the
+// allocations of the other tasks. Inside a Scope those allocations of the calling task come from
+// the one block taken at construction instead, frees are ignored and the whole document is
+// released in one step when the scope ends. Keep the arena as a member to reserve the block for
+// good, or construct it for a single parse to pay one large allocation instead of a hundred.
+//
+// The capacity is a hard cap: once it is reached every allocation fails, cJSON_Parse returns NULL
+// and exhausted() tells an oversized document apart from a malformed one.
+//
+//   JsonArena::Scope scope(m_jsonArena);
+//   cJSON *root = cJSON_Parse(text);
+//   ...
+//   cJSON_Delete(root);     // Free of charge, and never after the scope ended
+//
+// cJSON values parsed in a scope must not outlive it. Outside any scope cJSON uses the heap as before.
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+class JsonArena {
+public:
+    explicit JsonArena(size_t p_capacity);
+    ~JsonArena();
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    // Routes the cJSON allocations of the calling task into the arena. A task that finds the arena
+    // in use waits for the other scope to end.
+    class Scope {
+    public:
+        explicit Scope(JsonArena&);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::lock_guard<std::mutex> m_lock;
+        JsonArena& m_arena;
+        JsonArena* m_previous;
+    };
+
+    // nullptr once the cap would be exceeded
+    void* allocate(size_t p_size);
+    bool owns(const void* p_pointer) const;
+
+    // Enough for a document of up to p_values values whose keys and strings take p_text bytes.
+    // Counted in cJSON nodes, which take 40 bytes on the ESP32 and 64 on a 64-bit host.
+    static size_t capacityFor(size_t p_values, size_t p_text);
+
+    size_t capacity() const { return m_capacity; }
+    size_t used() const { return m_used; }
+    // Most ever in use, to size the capacity from real documents
+    size_t highWater() const { return m_highWater; }
+    // An allocation was refused in the current or last scope
+    bool exhausted() const { return m_exhausted; }
+
+private:
+    static constexpr size_t ALIGNMENT = 8;
+
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_used;
+    size_t m_highWater;
+    bool m_exhausted;
+    std::mutex m_mutex;
+
+    void reset();
+};
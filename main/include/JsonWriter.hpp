@@ -0,0 +1,71 @@
+#pragma once
+
+// Streams a JSON document into a caller owned buffer without touching the heap. With a sink the
+// buffer is handed over every time it fills, so a document of any size goes out through a few
+// hundred bytes of stack. Without one the document must fit and is left NUL terminated.
+//
+//   char buf[256];
+//   JsonWriter json(buf, sizeof(buf), sendChunk, req);
+//   json.beginObject().number("pitch", pitch, 3).beginArray("gains").number(nullptr, kp).endArray().endObject();
+//   if (!json.finish()) ...
+//
+// Keys are required inside objects and must be nullptr inside arrays. Misuse, a sink error or an
+// overflow latch the writer into a failed state, the remaining calls are ignored and finish() reports it.
+
+#include <cstddef>
+
+class JsonWriter {
+public:
+    // Returns false to abort the document, the writer then stops producing output
+    typedef bool (*Sink)(void* p_context, const char* p_data, size_t p_length);
+
+    static constexpr int MAX_DEPTH = 8;
+    // Decimals of number() for the shortest text that reads back as the same float
+    static constexpr int SHORTEST = -1;
+
+    // Pretty output puts every object member on its own tab indented line, arrays stay on one line
+    JsonWriter(char* p_buffer, size_t p_size, Sink p_sink = nullptr, void* p_context = nullptr, bool p_pretty = false);
+
+    JsonWriter& beginObject(const char* p_key = nullptr);
+    JsonWriter& endObject();
+    JsonWriter& beginArray(const char* p_key = nullptr);
+    JsonWriter& endArray();
+
+    // NaN and infinities are written as null
+    JsonWriter& number(const char* p_key, double p_value, int p_decimals = SHORTEST);
+    JsonWriter& numbers(const char* p_key, const float* p_values, int p_count, int p_decimals = SHORTEST);
+    JsonWriter& integer(const char* p_key, long long p_value);
+    JsonWriter& boolean(const char* p_key, bool p_value);
+    JsonWriter& string(const char* p_key, const char* p_value);
+
+    // Hands the rest to the sink, false if the document is incomplete or anything failed on the way
+    bool finish();
+
+    bool ok() const { return m_ok; }
+    // Bytes produced so far, including those already handed to the sink
+    size_t length() const { return m_flushed + m_used; }
+
+private:
+    char* m_buffer;
+    size_t m_capacity;
+    size_t m_used;
+    size_t m_flushed;
+    Sink m_sink;
+    void* m_context;
+    bool m_pretty;
+    bool m_ok;
+
+    int m_depth;
+    bool m_inObject[MAX_DEPTH];
+    bool m_hasMembers[MAX_DEPTH];
+
+    bool beginValue(const char* p_key);
+    JsonWriter& open(const char* p_key, bool p_object);
+    JsonWriter& close(bool p_object);
+    void write(const char* p_data, size_t p_length);
+    void put(char p_char);
+    void newline(int p_depth);
+    void quoted(const char* p_text);
+    void formatNumber(double p_value, int p_decimals);
+    bool flush();
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "interfaces/IPIDController.hpp"
+#include <cmath>
+
+// Full state feedback balance controller behind the PID interface.
+// Target angle and output limits come from the "pid" config, the gains from the "lqr" config.
+class LQRController : public IPIDController {
+public:
+    LQRController();
+    ~LQRController();
+
+    esp_err_t init(const IRuntimeConfig&) override;
+    esp_err_t setConfig(const PIDConfig&) override;
+    void setTargetAngle(float) override;
+    esp_err_t setLQRConfig(const LQRConfig&) override;
+    void reset() override;
+    void setGainScale(const GainScale&) override;
+    void setDerivativeFilterChain(const FilterChainConfig&) override;
+    float bumplessIntegral(const PIDConfig&, float) const override;
+    void seedDerivative(float&, float) const override;
+
+    // p_integral carries the wheel travel since the robot started balancing, p_lastError the pitch error in degrees
+    float compute(float&, float&, float, float) const override;
+    float compute(float&, float&, const SensorData&) const override;
+    float mapOutput(float) const override;
+    ControllerTerms getLastTerms() const override;
+
+private:
+    static constexpr const char* TAG = "LQRController";
+    static constexpr float DEG_TO_RAD = static_cast<float>(M_PI) / 180.0f;
+
+    PIDConfig m_config;
+    LQRConfig m_gains;
+
+    SemaphoreHandle_t m_mutex;
+
+    mutable ControllerTerms m_lastTerms;
+};
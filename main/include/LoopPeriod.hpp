@@ -0,0 +1,38 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <algorithm>
+
+// Shared conversion helpers for main_loop.interval_ms. The interval is broadcast
+// through a single-slot mailbox queue and every control task picks it up at the
+// top of its cycle.
+namespace LoopPeriod {
+    static constexpr int DEFAULT_INTERVAL_MS = 10;  // 100Hz
+    static constexpr int MIN_INTERVAL_MS = 1;
+    static constexpr int MAX_INTERVAL_MS = 100;
+
+    inline int clampIntervalMs(int p_intervalMs) {
+        return std::clamp(p_intervalMs, MIN_INTERVAL_MS, MAX_INTERVAL_MS);
+    }
+
+    // Never return 0 ticks - vTaskDelayUntil would spin when the interval is below the tick period
+    inline TickType_t toTicks(int p_intervalMs) {
+        return std::max<TickType_t>(1, pdMS_TO_TICKS(clampIntervalMs(p_intervalMs)));
+    }
+
+    // Effective period in seconds after tick quantization
+    inline float toSeconds(TickType_t p_ticks) {
+        return (p_ticks * portTICK_PERIOD_MS) / 1000.0f;
+    }
+
+    // Non-blocking read of the latest broadcast interval, leaves the mailbox intact for other tasks
+    inline bool peekTicks(QueueHandle_t p_mailbox, TickType_t& p_ticks) {
+        int l_intervalMs;
+        if (p_mailbox == nullptr || xQueuePeek(p_mailbox, &l_intervalMs, 0) != pdTRUE) {
+            return false;
+        }
+        p_ticks = toTicks(l_intervalMs);
+        return true;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+// Single low-pass stage for the PID derivative path: first-order RC or a 2nd-order
+// Butterworth biquad. Coefficients are recomputed only when the cutoff or the sample
+// period changes, the per-sample cost is a handful of multiply-adds.
+class LowPassFilter {
+public:
+    LowPassFilter();
+
+    void configure(DerivativeFilterType, float p_cutoffHz, float p_dt);
+    void reset();
+
+    float apply(float p_input);
+
+private:
+    DerivativeFilterType m_requestedType;
+    DerivativeFilterType m_type;
+    float m_cutoffHz;
+    float m_dt;
+    bool m_primed;
+
+    // First order: y += alpha * (x - y)
+    float m_alpha;
+
+    // Biquad, direct form II transposed, a0 normalized to 1
+    float m_b0, m_b1, m_b2, m_a1, m_a2;
+    float m_z1, m_z2;
+
+    float m_output;
+};
@@ -3,14 +3,19 @@
 #include "interfaces/IMPU6050Manager.hpp"
 #include "esp_log.h"
 #include "include/mpu6050.hpp"
+#include "include/BiquadFilter.hpp"
 #include <memory>
 
 class MPU6050Manager : public IMPU6050Manager {
     public:
         esp_err_t init(const IRuntimeConfig&) override;
-        float calculatePitch(float&) const override; 
+        float calculatePitch(float&, float) const override; 
         float calculateRoll(float&) const override; 
         float calculateYaw(float&) const override;         
+        float getPitchRate() const override;
+        float getYawRate() const override;
+        ImuSample getLastImuSample() const override;
+        void setFilterConfig(const FilterChainConfig&, const FilterChainConfig&) override;
     private:
         static constexpr const char* TAG = "MPU6050Manager";
 
@@ -20,4 +25,14 @@ class MPU6050Manager : public IMPU6050Manager {
         static constexpr int CALIBRATION_SAMPLES = 200;
         static constexpr uint32_t I2C_MASTER_FREQ_HZ = 400000;
         float _gyro_error = 0.0f;
+        float _gyro_error_z = 0.0f;
+        mutable float _pitch_rate = 0.0f;
+        mutable float _yaw_rate = 0.0f;
+        mutable ImuSample _last_sample = {};
+
+        // One cascade per axis, gyro Y/Z and accel X/Y/Z
+        FilterChainConfig _gyro_chain;
+        FilterChainConfig _accel_chain;
+        mutable BiquadCascade _gyro_filter[2];
+        mutable BiquadCascade _accel_filter[3];
 };
\ No newline at end of file
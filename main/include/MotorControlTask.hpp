@@ -1,13 +1,16 @@
 #pragma once
 
 #include "interfaces/ITask.hpp"
+#include "include/MotorOutputShaper.hpp"
+#include "include/BiquadFilter.hpp"
+#include "include/ControlMailboxes.hpp"
 
 class IMotorDriver;
 class IStateMachine;
 
 class MotorControlTask : public IMotorControlTask {
 public:
-    MotorControlTask(IMotorDriver&, QueueHandle_t, IStateMachine&);
+    MotorControlTask(IMotorDriver&, const ControlMailboxes&, IStateMachine&);
     ~MotorControlTask();
 
     esp_err_t init(const IRuntimeConfig&) override;
@@ -15,20 +18,26 @@ private:
     static constexpr const char* TAG = "MotorControlTask";
     static constexpr int STACK_SIZE = 4096;
     static constexpr UBaseType_t PRIORITY = 5;  // High priority
-    static constexpr TickType_t CONTROL_PERIOD = pdMS_TO_TICKS(10);  // 100Hz
     static constexpr float MAX_SAFE_ANGLE = 45.0f;  // Maximum safe angle in degrees
-    static constexpr float MAX_MOTOR_SPEED = 1023.0f;  // Assuming 10-bit PWM
 
     IMotorDriver& m_motorDriver;
-    QueueHandle_t m_pidOutputQueue;
+    const ControlMailboxes& m_mailboxes;
     IStateMachine& m_stateMachine;
     TaskHandle_t m_taskHandle;
 
+    TickType_t m_controlPeriod;
+    MotorOutputShaper m_outputShaper;
+    FilterChainConfig m_outputFilterConfig;
+    BiquadCascade m_outputFilter;
+    MotorFeedback m_feedback;
     float currentSpeed;
 
     static void taskFunction(void* pvParameters);
     void run();
 
-    float applySpeedLimits(float speed);
+    void updateShapingConfig();
+    void updateFilterConfig();
+    esp_err_t applySpeed(const PIDOutput&);
+    void stopMotors();
     bool isSafeToOperate();
 };
\ No newline at end of file
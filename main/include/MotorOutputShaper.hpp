@@ -0,0 +1,34 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+// Output shaping between the controllers and the motor driver. The balance command is normalized,
+// then each wheel command out of the yaw mix goes through
+// slew-rate limit -> deadband / static friction offset -> per-motor trim
+class MotorOutputShaper {
+public:
+    enum class MotorSide {
+        LEFT,
+        RIGHT
+    };
+
+    MotorOutputShaper();
+
+    void setConfig(const MotorShapingConfig&);
+    void reset();
+
+    // Controller output to the [-1, 1] command range of the mix
+    float normalize(float p_command) const;
+    // Returns the duty for one wheel from its normalized, mixed command
+    float shape(float p_command, MotorSide p_side, float p_dt);
+
+private:
+    static constexpr const char* TAG = "MotorOutputShaper";
+
+    MotorShapingConfig m_config;
+    float m_lastCommand[2];     // Per side, the slew limit follows each wheel
+
+    float limitSlew(float p_command, MotorSide p_side, float p_dt);
+    float compensateFriction(float p_command) const;
+    float applyTrim(float p_command, MotorSide p_side) const;
+};
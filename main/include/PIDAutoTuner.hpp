@@ -0,0 +1,74 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+// Relay-feedback (Astrom-Hagglund) experiment around the balance point.
+// Drives a +/-d relay on the pitch error, measures the limit cycle amplitude and
+// period and derives the ultimate gain Ku = 4d / (pi * sqrt(a^2 - h^2)). A slow bias on the
+// relay keeps the oscillation centred on the setpoint.
+class PIDAutoTuner {
+public:
+    enum class Status {
+        IDLE,
+        RUNNING,
+        DONE,
+        ABORTED
+    };
+
+    PIDAutoTuner();
+
+    void start(const AutoTuneRequest&);
+    void abort();
+
+    // Returns the relay output in normalized units, call once per control cycle
+    float update(float p_pitch, float p_dt);
+
+    Status getStatus() const { return m_status; }
+    PIDConfig getResult() const { return m_result; }
+    float getUltimateGain() const { return m_ultimateGain; }
+    float getUltimatePeriod() const { return m_ultimatePeriod; }
+
+private:
+    static constexpr const char* TAG = "PIDAutoTuner";
+    static constexpr int SETTLE_CYCLES = 4;          // Oscillation periods discarded before measuring
+    static constexpr int MEASURE_CYCLES = 6;         // Oscillation periods averaged
+    static constexpr float CENTERING_PERIODS = 2.0f; // Integral time of the relay bias, in oscillation periods
+    static constexpr float TIMEOUT = 30.0f;          // Seconds
+    static constexpr float MIN_PERIOD = 0.05f;       // Seconds, anything faster is sensor noise
+    static constexpr float MAX_PERIOD = 5.0f;        // Seconds
+    static constexpr float MAX_RELAY_AMPLITUDE = 0.5f;
+    static constexpr float MAX_KP = 1.0f;            // Normalized output per degree
+    static constexpr float MAX_KI = 10.0f;
+    static constexpr float MAX_KD = 0.2f;
+
+    AutoTuneRequest m_request;
+    Status m_status;
+    PIDConfig m_result;
+
+    float m_relayOutput;
+    float m_elapsed;
+    float m_lastRisingSwitch;
+    float m_errorMax;
+    float m_errorMin;
+    int m_cycles;
+    float m_periodSum;
+    float m_amplitudeSum;
+    int m_measuredCycles;
+
+    // Last full cycle, and the relay bias that keeps the oscillation centred
+    float m_lastPeriod;
+    float m_lastAmplitude;
+    float m_bias;
+    float m_halfErrorIntegral;
+    float m_halfTime;
+    float m_previousHalfErrorIntegral;
+    float m_previousHalfTime;
+
+    float m_ultimateGain;
+    float m_ultimatePeriod;
+
+    void onRisingSwitch();
+    void recenter();
+    void finish();
+    void fail(const char* p_reason);
+};
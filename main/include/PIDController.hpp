@@ -2,6 +2,8 @@
 
 #include "interfaces/IPIDController.hpp"
 #include "interfaces/ITask.hpp"
+#include "include/LowPassFilter.hpp"
+#include "include/BiquadFilter.hpp"
 
 
 class PIDController : public IPIDController {
@@ -11,14 +13,37 @@ public:
     
     esp_err_t init(const IRuntimeConfig&) override;
     esp_err_t setConfig(const PIDConfig&) override;
+    void setTargetAngle(float) override;
+    esp_err_t setLQRConfig(const LQRConfig&) override;
+    void reset() override;
+    void setGainScale(const GainScale&) override;
+    void setDerivativeFilterChain(const FilterChainConfig&) override;
+    float bumplessIntegral(const PIDConfig&, float) const override;
+    void seedDerivative(float&, float) const override;
 
     float compute(float&, float&, float, float) const override;
+    float compute(float&, float&, const SensorData&) const override;
+    float mapOutput(float) const override;
+    ControllerTerms getLastTerms() const override;
 private:
     static constexpr const char* TAG = "PIDController";
   
     PIDConfig m_config;
+    GainScale m_gainScale;
 
     SemaphoreHandle_t m_mutex;
 
+    // Derivative path low-pass, state advances inside compute()
+    mutable LowPassFilter m_derivativeFilter;
+    FilterChainConfig m_derivativeChainConfig;
+    mutable BiquadCascade m_derivativeChain;
+
+    // Operating point of the last compute(), for bumpless gain changes
+    mutable float m_lastErrorSample;
+    mutable float m_lastDerivative;
+    mutable ControllerTerms m_lastTerms;
+
+    // p_errorRate is d(error)/dt, either differenced or from the gyro
+    float computeOutput(float& p_integral, float p_error, float p_errorRate, float p_dt) const;
     float applyLimits(float value, float min, float max) const;
 };
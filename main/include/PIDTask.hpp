@@ -1,37 +1,79 @@
 #pragma once
 
 #include "interfaces/ITask.hpp"
+#include "include/PIDAutoTuner.hpp"
+#include "include/VelocityLoop.hpp"
+#include "include/GainSchedule.hpp"
+#include "include/PitchPredictor.hpp"
+#include "include/SystemIdentifier.hpp"
+#include "include/ControlMailboxes.hpp"
 
 class IPIDController;
 class IStateMachine;
+class SysIdLog;
 
 class PIDTask : public IPIDTask {
 public:
-    PIDTask(IPIDController&, QueueHandle_t, QueueHandle_t, QueueHandle_t, IStateMachine&);
+    PIDTask(IPIDController&, IPIDController&, const ControlMailboxes&, SysIdLog&, TelemetryRing&, IStateMachine&);
     ~PIDTask();
 
     esp_err_t init(const IRuntimeConfig&) override;
-    QueueHandle_t getPIDOutputQueue() const { return m_pidOutputQueue; }
+    QueueHandle_t getPIDOutputQueue() const { return m_mailboxes.pidOutput; }
 
 private:
     static constexpr const char* TAG = "PIDTask";
     static constexpr int STACK_SIZE = 4096;
     static constexpr UBaseType_t PRIORITY = 4;  // High priority, but lower than sensor task
-    static constexpr TickType_t CONTROL_PERIOD = pdMS_TO_TICKS(10);  // 100Hz
 
     IPIDController& m_pidController;
-    QueueHandle_t m_sensorDataQueue;
-    QueueHandle_t m_pidOutputQueue;
-    QueueHandle_t m_configQueue;
+    IPIDController& m_yawController;
+    const ControlMailboxes& m_mailboxes;
     IStateMachine& m_stateMachine;
     
     TaskHandle_t m_taskHandle;
 
+    TickType_t m_controlPeriod;
+
     float m_integral;
     float m_lastError;
 
+    // Engage handling: derivative seeding and output ramp-in after entering BALANCING
+    bool m_wasBalancing;
+    bool m_seedPending;
+    float m_engageElapsed;
+    float m_engageRampTime;
+
+    // The yaw-rate integrator is the heading error, so it doubles as heading hold
+    float m_yawIntegral;
+    float m_yawLastError;
+
+    PIDAutoTuner m_autoTuner;
+    GainSchedule m_gainSchedule;
+    GainScheduleConfig m_receivedSchedule;  // Receive buffer, too large for the task stack
+
+    // Outer loop of the cascade, moves the pitch setpoint away from the configured target angle
+    VelocityLoop m_velocityLoop;
+    float m_baseTargetAngle;
+
+    // Compensates the sensor-to-actuation latency measured by MotorControlTask
+    PitchPredictor m_predictor;
+
+    // Excitation on top of the balance command, recorded for tools/sysid_fit.cpp
+    SystemIdentifier m_systemIdentifier;
+
+    // Every cycle goes to TelemetryTask, the sequence keeps counting over dropped records
+    TelemetryRing& m_telemetryRing;
+    uint32_t m_telemetrySequence;
+
     static void taskFunction(void* pvParameters);
     void run();
 
     void updateConfig();
+    void onEngage(const SensorData&);
+    float engageRamp(float p_dt);
+    void checkAutoTuneRequest();
+    void checkSysIdRequest();
+    float computeOutput(const SensorData&);
+    float computeYawOutput(const SensorData&);
+    void recordTelemetry(const SensorData&, const PIDOutput*, const MotorFeedback&);
 };
\ No newline at end of file
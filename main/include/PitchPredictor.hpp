@@ -0,0 +1,35 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+#include "include/LowPassFilter.hpp"
+
+// Moves the pitch of a sample forward by the sensor-to-actuation latency so the balance
+// controller acts on where the robot will be when the motors respond, not where it was.
+// First order uses the gyro rate, second order adds the filtered derivative of the rate.
+class PitchPredictor {
+public:
+    PitchPredictor();
+
+    void setConfig(const PredictorConfig&);
+    void reset();
+
+    // Latest measured sensor-to-actuation latency in seconds, smoothed before use
+    void updateLatency(float p_latency);
+
+    // Returns a copy of the sample with pitch (and pitch rate in second order) predicted over the horizon
+    SensorData predict(const SensorData&);
+    float getHorizon() const { return m_horizon; }
+
+private:
+    static constexpr float LATENCY_SMOOTHING = 0.05f;   // EMA weight of a new latency measurement
+
+    PredictorConfig m_config;
+
+    bool m_haveLatency;
+    float m_latency;
+    float m_horizon;
+
+    bool m_havePrevious;
+    float m_previousRate;
+    LowPassFilter m_accelFilter;
+};
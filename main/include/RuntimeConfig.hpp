@@ -16,6 +16,42 @@ public:
     PIDConfig getPidConfig() const override;
     void setPidConfig(PIDConfig);
 
+    // Yaw-rate PID parameters
+    PIDConfig getYawPidConfig() const override;
+    void setYawPidConfig(const PIDConfig&) override;
+
+    // Balance controller selection and LQR gains
+    ControllerType getControllerType() const override;
+    void setControllerType(ControllerType) override;
+    LQRConfig getLQRConfig() const override;
+    void setLQRConfig(const LQRConfig&) override;
+
+    // Gain schedule of the pitch PID
+    GainScheduleConfig getGainScheduleConfig() const override;
+    void setGainScheduleConfig(const GainScheduleConfig&) override;
+
+    // Cascaded velocity loop parameters
+    VelocityLoopConfig getVelocityLoopConfig() const override;
+    void setVelocityLoopConfig(const VelocityLoopConfig&) override;
+
+    // Pitch predictor parameters
+    PredictorConfig getPredictorConfig() const override;
+    void setPredictorConfig(const PredictorConfig&) override;
+
+    // Biquad filter chains on the sensor axes, D term and motor output
+    FilterBankConfig getFilterBankConfig() const override;
+    void setFilterBankConfig(const FilterBankConfig&) override;
+
+    // Motor bridge driver and output shaping parameters
+    MotorDriverType getMotorDriverType() const override;
+    void setMotorDriverType(MotorDriverType) override;
+    MotorShapingConfig getMotorShapingConfig() const override;
+    void setMotorShapingConfig(const MotorShapingConfig&) override;
+
+    // UDP telemetry destination
+    UdpTelemetryConfig getUdpTelemetryConfig() const override;
+    void setUdpTelemetryConfig(const UdpTelemetryConfig&) override;
+
     // MPU6050 parameters
     int getMpu6050CalibrationSamples() const override;
     void setMpu6050CalibrationSamples(int) override;
@@ -32,12 +68,24 @@ public:
 
     // JSON serialization/deserialization
     std::string toJson() const override;
+    bool writeJson(JsonWriter&, bool p_includeWifi) const override;
     esp_err_t fromJson(const std::string&) override;
 
 private:
     static constexpr const char* TAG = "RuntimeConfig";
+    static constexpr size_t JSON_CHUNK_SIZE = 256;
 
     PIDConfig m_pidConfig;
+    PIDConfig m_yawPidConfig;
+    ControllerType m_controllerType = ControllerType::PID;
+    LQRConfig m_lqrConfig;
+    GainScheduleConfig m_gainScheduleConfig;
+    VelocityLoopConfig m_velocityLoopConfig;
+    PredictorConfig m_predictorConfig;
+    FilterBankConfig m_filterBankConfig;
+    MotorDriverType m_motorDriverType = MotorDriverType::LEDC;
+    MotorShapingConfig m_motorShapingConfig;
+    UdpTelemetryConfig m_udpTelemetryConfig;
 
     // MPU6050 parameters
     int m_mpuCalibrationSamples;
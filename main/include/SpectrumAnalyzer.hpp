@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+// One IMU read as it leaves the sensor, before the filter bank
+struct ImuSample {
+    float accel[3];     // g
+    float gyro[3];      // deg/s, bias corrected where a calibration exists
+    float dt;           // Period the sample was taken with, s
+};
+
+struct VibrationPeak {
+    float frequencyHz;
+    float magnitude;    // Amplitude in the axis unit
+};
+
+// Fixed size, lives in the analysis task and the web server and is never allocated at run time
+struct VibrationSpectrum {
+    static constexpr int WINDOW = 256;
+    static constexpr int BINS = WINDOW / 2 + 1;
+    static constexpr int AXES = 6;      // Gyro X, Y, Z then accel X, Y, Z
+    static constexpr int MAX_PEAKS = 5;
+
+    bool valid = false;
+    uint32_t sequence = 0;              // Windows analyzed since boot
+    float sampleRateHz = 0.0f;
+    float magnitude[AXES][BINS] = {};   // Single-sided amplitude spectrum, mean removed
+    VibrationPeak peaks[AXES][MAX_PEAKS] = {};
+    int peakCount[AXES] = {};
+};
+
+// Collects a window of IMU samples and turns it into amplitude spectra and their strongest peaks.
+// The six real axes go through three complex FFTs, two axes packed per transform. On the target
+// the FFT runs on the ESP-DSP radix-2 kernel when the component is available.
+class SpectrumAnalyzer {
+public:
+    SpectrumAnalyzer();
+
+    // Appends a sample, returns true once the window is full
+    bool addSample(const ImuSample&);
+    // Transforms the collected window into p_result and starts the next window
+    void analyze(VibrationSpectrum& p_result);
+
+    static const char* axisName(int p_axis);
+
+private:
+    static constexpr int N = VibrationSpectrum::WINDOW;
+
+    float m_samples[VibrationSpectrum::AXES][N];
+    int m_count;
+    float m_elapsed;
+
+    float m_window[N];          // Hann
+    float m_twiddle[N];         // cos, -sin pairs for the first N/2 powers of the root of unity
+    float m_work[2 * N];        // Interleaved complex FFT buffer
+
+    void transform();
+    void separate(float* p_magnitudeA, float* p_magnitudeB) const;
+    static void findPeaks(const float* p_magnitude, float p_resolution, VibrationPeak* p_peaks, int& p_count);
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+// Lock-free ring for exactly one producer task and one consumer task. push() never waits: when the
+// consumer fell behind the record is dropped and counted, the producer keeps its timing. pop() takes
+// everything available up to the caller's batch size in one pass.
+//
+// The indices run freely and wrap at 2^32, CAPACITY being a power of two keeps the slot arithmetic
+// right across the wrap.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, uint32_t CAPACITY>
+class SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() : m_head(0), m_tail(0), m_dropped(0) {}
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. False when the ring is full, the record is counted as dropped.
+    bool push(const T& p_item) {
+        uint32_t l_head = m_head.load(std::memory_order_relaxed);
+        if (l_head - m_tail.load(std::memory_order_acquire) == CAPACITY) {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        m_items[l_head & MASK] = p_item;
+        m_head.store(l_head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Copies up to p_max records oldest first, returns how many.
+    size_t pop(T* p_items, size_t p_max) {
+        uint32_t l_tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t l_available = m_head.load(std::memory_order_acquire) - l_tail;
+        size_t l_count = l_available < p_max ? l_available : p_max;
+        for (size_t i = 0; i < l_count; i++) {
+            p_items[i] = m_items[(l_tail + i) & MASK];
+        }
+        m_tail.store(l_tail + static_cast<uint32_t>(l_count), std::memory_order_release);
+        return l_count;
+    }
+
+    // Either side, a snapshot that may be stale by the time it is used
+    size_t size() const {
+        // Tail first, the head read after it can only be further ahead
+        uint32_t l_tail = m_tail.load(std::memory_order_acquire);
+        return m_head.load(std::memory_order_acquire) - l_tail;
+    }
+    // Records refused since boot, only the producer writes it
+    uint32_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    static constexpr uint32_t capacity() { return CAPACITY; }
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    std::atomic<uint32_t> m_head;       // Next slot to write, producer only
+    std::atomic<uint32_t> m_tail;       // Next slot to read, consumer only
+    std::atomic<uint32_t> m_dropped;
+    T m_items[CAPACITY];
+};
@@ -2,12 +2,12 @@
 
 #include "interfaces/IStateMachine.hpp"
 #include "interfaces/ITask.hpp"
+#include "include/ControlMailboxes.hpp"
 
 
 class StateMachine : public IStateMachine {
 public:
-    StateMachine(QueueHandle_t sensorQueue, QueueHandle_t pidQueue, QueueHandle_t motorQueue,
-                 QueueHandle_t telemetryQueue, QueueHandle_t configQueue);
+    explicit StateMachine(const ControlMailboxes& mailboxes);
     ~StateMachine();
 
     esp_err_t init(const IRuntimeConfig&) override;
@@ -29,11 +29,7 @@ private:
     EventGroupHandle_t eventGroup;
     TaskHandle_t taskHandle;
 
-    QueueHandle_t sensorDataQueue;
-    QueueHandle_t pidOutputQueue;
-    QueueHandle_t motorControlQueue;
-    QueueHandle_t telemetryQueue;
-    QueueHandle_t configQueue;
+    const ControlMailboxes& mailboxes;
 
     float targetAngle;
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+#include <atomic>
+
+// RAM buffer of an identification run. PIDTask writes it at loop rate without locking,
+// the web server reads it only between acquire() and release(), which a new run cannot
+// interrupt and which is refused while a run is recording.
+class SysIdLog {
+public:
+    static constexpr int CAPACITY = 1500;   // 15 s at the default 10 ms loop, 48 kB
+
+    enum class State : uint8_t {
+        EMPTY,
+        RECORDING,
+        COMPLETE,
+        ABORTED
+    };
+
+    SysIdLog();
+    ~SysIdLog();
+
+    // Writer side, control loop only. begin() fails while an export holds the buffer.
+    bool begin(const SysIdRequest&, float p_dt);
+    // Returns false once the buffer is full
+    bool append(const SysIdRecord&);
+    void finish(State);
+
+    // Reader side
+    bool acquire();
+    void release();
+
+    State getState() const { return m_state.load(); }
+    int size() const { return m_count; }
+    const SysIdRecord& at(int p_index) const { return m_records[p_index]; }
+    const SysIdRequest& getRequest() const { return m_request; }
+    float getDt() const { return m_dt; }
+
+private:
+    SemaphoreHandle_t m_mutex;
+    std::atomic<State> m_state;
+    bool m_exporting;
+
+    SysIdRequest m_request;
+    float m_dt;
+    int m_count;
+    SysIdRecord m_records[CAPACITY];
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+class SysIdLog;
+
+// Closed-loop identification experiment: adds a chirp, PRBS or step to the balance command
+// and records every control cycle into the SysIdLog. Fit a model from the export with
+// tools/sysid_fit.cpp.
+class SystemIdentifier {
+public:
+    enum class Status {
+        IDLE,
+        RUNNING,
+        DONE,
+        ABORTED
+    };
+
+    explicit SystemIdentifier(SysIdLog&);
+
+    void start(const SysIdRequest&, float p_targetAngle, float p_dt);
+    void abort();
+
+    // Excitation for this cycle in normalized units, 0 unless running. Checks the safety limits.
+    float update(const SensorData&);
+    // Records the cycle with the command that was actually sent, call after update()
+    void record(const SensorData&, float p_command);
+
+    Status getStatus() const { return m_status; }
+
+private:
+    static constexpr const char* TAG = "SystemIdentifier";
+    static constexpr float MAX_AMPLITUDE = 0.5f;
+    static constexpr float MAX_DURATION = 60.0f;    // s, the buffer usually ends the run earlier
+
+    SysIdLog& m_log;
+    SysIdRequest m_request;
+    Status m_status;
+    float m_targetAngle;
+
+    float m_elapsed;
+    int m_cycle;
+    float m_excitation;
+    uint16_t m_lfsr;
+
+    float generate();
+    void finish();
+    void fail(const char* p_reason);
+};
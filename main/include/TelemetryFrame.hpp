@@ -0,0 +1,95 @@
+#pragma once
+
+// One telemetry record as a binary frame, the form the WebSocket, UDP and flight recorder streams carry.
+//
+// Version 1 layout, little-endian, no padding:
+//   0  u8   magic 0xB7
+//   1  u8   version
+//   2  u8   flags, bit 0: values are IEEE half floats instead of single
+//   3  u8   state, IStateMachine::State
+//   4  u32  sequence
+//   8  i64  SensorData::timestamp, us
+//   16      values in TelemetryFrame::Field order, 4 or 2 bytes each
+// Later versions only append fields, a decoder reads the ones it knows and ignores the rest.
+
+#include <cstddef>
+#include <cstdint>
+
+struct TelemetryFrame {
+    enum Field : int {
+        PITCH,                  // deg
+        ROLL,
+        YAW,
+        PITCH_RATE,             // deg/s
+        YAW_RATE,
+        LEFT_WHEEL_SPEED,       // rad/s
+        RIGHT_WHEEL_SPEED,
+        P_TERM,                 // Normalized controller terms, see ControllerTerms
+        I_TERM,
+        D_TERM,
+        PID_OUTPUT,             // PID output units
+        LEFT_DUTY,              // Normalized, after mixing and trim
+        RIGHT_DUTY,
+        PREDICTED_PITCH,        // deg
+        PREDICTION_HORIZON_MS,
+        LATENCY_MS,
+        FIELD_COUNT
+    };
+
+    uint8_t version = 0;
+    uint8_t flags = 0;
+    uint8_t state = 0;
+    uint32_t sequence = 0;
+    int64_t timestamp = 0;
+    int fieldCount = 0;             // Fields present in a decoded frame, the rest are left at 0
+    float values[FIELD_COUNT] = {};
+};
+
+class TelemetryCodec {
+public:
+    static constexpr uint8_t MAGIC = 0xB7;
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t FLAG_HALF_FLOAT = 0x01;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t MAX_SIZE = HEADER_SIZE + TelemetryFrame::FIELD_COUNT * sizeof(float);
+
+    // Returns the frame length, 0 when the buffer is too small
+    static size_t encode(const TelemetryFrame&, bool p_halfFloat, uint8_t* p_buffer, size_t p_size);
+    // Rejects a wrong magic or a truncated header, fields beyond the buffer stay 0
+    static bool decode(const uint8_t* p_buffer, size_t p_length, TelemetryFrame&);
+
+    // Round to nearest even, overflow saturates to infinity
+    static uint16_t toHalf(float);
+    static float fromHalf(uint16_t);
+
+    // Same names as the JSON telemetry keys
+    static const char* fieldName(int p_field);
+};
+
+// A UDP datagram of UdpTelemetrySender, little-endian, no padding:
+//   0  u8   magic 0xB9
+//   1  u8   version
+//   2  u16  frame size, the same for every frame of the datagram
+//   4  u32  datagram sequence, gaps are datagrams lost on the way
+//   8  i64  esp_timer time the datagram was sent, us
+//   16      frames oldest first, as many as the datagram length holds
+struct TelemetryDatagramHeader {
+    uint8_t version = 0;
+    uint16_t frameSize = 0;
+    uint32_t sequence = 0;
+    int64_t sentUs = 0;
+};
+
+class TelemetryDatagram {
+public:
+    static constexpr uint8_t MAGIC = 0xB9;
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    // Stays below the Ethernet MTU with the IP and UDP headers, a datagram is never fragmented
+    static constexpr size_t MAX_SIZE = 1400;
+
+    // Returns HEADER_SIZE, 0 when the buffer is too small
+    static size_t encodeHeader(const TelemetryDatagramHeader&, uint8_t* p_buffer, size_t p_size);
+    // Rejects a wrong magic, a truncated header and a frame size no frame fits in
+    static bool decodeHeader(const uint8_t* p_buffer, size_t p_length, TelemetryDatagramHeader&);
+};
@@ -3,10 +3,12 @@
 #include "interfaces/ITask.hpp"
 
 class IWebServer;
+class FlightRecorder;
+class UdpTelemetrySender;
 
 class TelemetryTask : public ITelemetryTask {
 public:
-    TelemetryTask(IWebServer&, QueueHandle_t, QueueHandle_t, QueueHandle_t);
+    TelemetryTask(IWebServer&, TelemetryRing&, FlightRecorder&, UdpTelemetrySender&, QueueHandle_t);
     ~TelemetryTask();
 
     esp_err_t init(const IRuntimeConfig&) override;
@@ -15,16 +17,29 @@ private:
     static constexpr const char* TAG = "TelemetryTask";
     static constexpr int STACK_SIZE = 4096;
     static constexpr UBaseType_t PRIORITY = 2;
-    static constexpr TickType_t UPDATE_PERIOD = pdMS_TO_TICKS(100); // 10Hz
+    // 20 records a batch at a 1 kHz loop, the ring holds several batches if this task is held up
+    static constexpr int BATCH_PERIOD_MS = 20;
+    static constexpr size_t MAX_BATCH = 64;
+    static constexpr int64_t DROP_REPORT_INTERVAL_US = 1000000;
 
     IWebServer& m_webServer;
-    QueueHandle_t m_sensorDataQueue;
-    QueueHandle_t m_pidOutputQueue;
+    TelemetryRing& m_telemetryRing;
+    FlightRecorder& m_flightRecorder;
+    UdpTelemetrySender& m_udpSender;
     QueueHandle_t m_motorSpeedQueue;
     TaskHandle_t m_taskHandle;
 
+    TelemetryData m_batch[MAX_BATCH];
+    uint32_t m_reportedDrops;
+    // Batches the web server was still busy for, recorded but not streamed
+    uint32_t m_unstreamed;
+    uint32_t m_reportedUnstreamed;
+    uint32_t m_reportedUdpFailures;
+    int64_t m_lastDropReportUs;
+
     static void taskFunction(void* pvParameters);
     void run();
 
-    void collectAndSendTelemetry();
-};
\ No newline at end of file
+    void drainAndSendTelemetry();
+    void reportDrops();
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+#include "lwip/sockets.h"
+
+// Telemetry over UDP to the collector configured in udp_telemetry, tools/udp_telemetry_collector.cpp
+// on the host. TelemetryTask hands it every batch it drains from the telemetry ring, next to the
+// WebSocket stream. Nothing is acknowledged or retransmitted, a datagram the network stack has no
+// buffer for is dropped and counted. The datagram and frame sequence numbers tell the collector
+// what went missing on the way.
+class UdpTelemetrySender : public IComponent {
+public:
+    // Full precision frames, 17 to a datagram
+    static constexpr size_t FRAME_SIZE = TelemetryCodec::HEADER_SIZE + TelemetryFrame::FIELD_COUNT * sizeof(float);
+
+    UdpTelemetrySender();
+    ~UdpTelemetrySender();
+
+    esp_err_t init(const IRuntimeConfig&) override;
+    bool isEnabled() const { return m_socket >= 0; }
+
+    // TelemetryTask only. The records go out in as few datagrams as they fit in, the last one
+    // is sent before returning so no record waits for the next batch.
+    void send(const TelemetryData* p_records, size_t p_count);
+    // Datagrams the network stack refused since boot
+    uint32_t failed() const { return m_failed; }
+
+private:
+    static constexpr const char* TAG = "UdpTelemetrySender";
+
+    int m_socket;
+    struct sockaddr_in m_destination;
+    uint32_t m_sequence;
+    uint32_t m_failed;
+
+    uint8_t m_datagram[TelemetryDatagram::MAX_SIZE];
+    size_t m_length;    // 0 while no frame is waiting
+
+    void flush();
+};
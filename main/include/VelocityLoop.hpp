@@ -0,0 +1,31 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+
+// Outer loop of the balance cascade. Runs at a fraction of the control rate on the
+// mean wheel speed and position and returns the pitch setpoint for the angle PID.
+class VelocityLoop {
+public:
+    VelocityLoop();
+
+    void setConfig(const VelocityLoopConfig&);
+    void reset();
+
+    // Call every inner cycle, returns the pitch setpoint. Disabled it returns p_baseTarget unchanged.
+    float update(const SensorData&, float p_baseTarget);
+
+private:
+    static constexpr const char* TAG = "VelocityLoop";
+
+    VelocityLoopConfig m_config;
+
+    bool m_handoverPending;
+    int m_cycle;
+    float m_elapsed;
+    float m_integral;
+    float m_holdPosition;
+    float m_tilt;
+
+    float computeTilt(float p_speedError, float p_positionError) const;
+    void handover(float p_speedError, float p_positionError);
+};
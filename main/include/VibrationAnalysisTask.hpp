@@ -0,0 +1,32 @@
+#pragma once
+
+#include "interfaces/ITask.hpp"
+#include "include/SpectrumAnalyzer.hpp"
+
+class IWebServer;
+
+// Background vibration analysis: windows of raw IMU samples from SensorTask are turned into
+// spectra and published on /spectrum. Runs just above idle, the control tasks always preempt it,
+// and all buffers are members allocated once at boot.
+class VibrationAnalysisTask : public IVibrationAnalysisTask {
+public:
+    VibrationAnalysisTask(IWebServer&, QueueHandle_t);
+    ~VibrationAnalysisTask();
+
+    esp_err_t init(const IRuntimeConfig&) override;
+
+private:
+    static constexpr const char* TAG = "VibrationAnalysisTask";
+    static constexpr int STACK_SIZE = 4096;
+    static constexpr UBaseType_t PRIORITY = tskIDLE_PRIORITY + 1;
+
+    IWebServer& m_webServer;
+    QueueHandle_t m_imuSampleQueue;
+    TaskHandle_t m_taskHandle;
+
+    SpectrumAnalyzer m_analyzer;
+    VibrationSpectrum m_spectrum;
+
+    static void taskFunction(void* pvParameters);
+    void run();
+};
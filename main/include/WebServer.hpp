@@ -1,33 +1,140 @@
 #pragma once
 
 #include "interfaces/IWebServer.hpp"
+#include "interfaces/IRuntimeConfig.hpp"
+#include "include/TelemetryFrame.hpp"
+#include "include/JsonArena.hpp"
+#include "include/FlightRecording.hpp"
+#include <atomic>
 
 class IComponentHandler;
+class SysIdLog;
+class FlightRecorder;
+class JsonWriter;
 
 class WebServer : public IWebServer {
     public:
-        WebServer();
+        WebServer(SysIdLog&, FlightRecorder&);
         ~WebServer();
         
         esp_err_t init(const IRuntimeConfig&) override;
-        void update_telemetry(const TelemetryData& telemetry) override;
+        bool update_telemetry(const TelemetryData* batch, size_t count) override;
+        void update_spectrum(const VibrationSpectrum& spectrum) override;
         bool hasConfigurationRequest() override;
-        PIDConfig getConfigurationRequest() override;
+        std::string getConfigurationRequest() override;
         void notifyConfigurationUpdated() override;
+        void notifyConfigurationResult(esp_err_t p_result) override;
+        bool hasAutoTuneRequest() override;
+        AutoTuneRequest getAutoTuneRequest() override;
+        bool hasSysIdRequest() override;
+        SysIdRequest getSysIdRequest() override;
 
     private:
         static constexpr const char* TAG = "WebServer";
         static constexpr int CONFIG_QUEUE_SIZE = 1;
+        static constexpr size_t MAX_CONFIG_SIZE = IRuntimeConfig::MAX_JSON_SIZE;
+        static constexpr size_t MAX_URI_HANDLERS = 12;
+        static constexpr size_t EXPORT_CHUNK_SIZE = 1024;
+        static constexpr size_t JSON_CHUNK_SIZE = 256;
+        static constexpr size_t PARSE_ARENA_SIZE = 8192;   // Command bodies of up to 256 bytes, at most about 128 values
+        static constexpr int MAX_WS_CLIENTS = 4;
+        static constexpr size_t WS_FRAME_SIZE = 512;
+        static constexpr int DEFAULT_WS_RATE_HZ = 10;
+        static constexpr int MAX_WS_RATE_HZ = 1000;   // Every control cycle up to a 1 kHz loop
+        static constexpr size_t MAX_TELEMETRY_BATCH = 64;
 
+        enum class StreamFormat : uint8_t {
+            JSON,
+            BINARY,         // TelemetryFrame with single precision values
+            BINARY_HALF     // TelemetryFrame with half precision values
+        };
+
+        // Of the last POST /config, the ConfigurationTask parses and applies it a moment later
+        enum class ConfigStatus : uint8_t {
+            NONE,
+            PENDING,
+            APPLIED,
+            REJECTED
+        };
+
+        // Gzipped at build time and linked into rodata, see main/CMakeLists.txt
+        struct StaticAsset {
+            const char *uri;
+            const char *type;
+            const uint8_t *start;
+            const uint8_t *end;
+            const char *etag;       // Hash of the content, without the quotes
+            bool versioned;         // Linked as uri?v=<etag>, a request for that URL may be cached for good
+        };
+        static const StaticAsset ASSETS[2];
+
+        // Only touched from the httpd task, handlers and queued work run there
+        struct WsClient {
+            int fd;
+            StreamFormat format;
+            int64_t intervalUs;
+            int64_t nextSendUs;
+        };
+
+        const IRuntimeConfig* m_runtimeConfig;
         httpd_handle_t m_server;
-        QueueHandle_t m_configRequestQueue;
+        QueueHandle_t m_configRequestQueue;     // Bodies on the heap, the receiver takes ownership
+        QueueHandle_t m_autoTuneRequestQueue;
+        QueueHandle_t m_sysIdRequestQueue;
+        SysIdLog& m_sysIdLog;
+        FlightRecorder& m_flightRecorder;
         SemaphoreHandle_t m_telemetryMutex;
         TelemetryData m_lastTelemetry;
+        SemaphoreHandle_t m_spectrumMutex;
+        VibrationSpectrum m_lastSpectrum;
+        // The /spectrum handler's copy, too big for the httpd stack; handlers run one at a time
+        VibrationSpectrum m_spectrumResponse;
+
+        WsClient m_wsClients[MAX_WS_CLIENTS];
+        std::atomic<int> m_wsClientCount;
+        // Handed to the httpd task with the flag set, rewritten only once the send work cleared it
+        std::atomic<bool> m_wsSendPending;
+        TelemetryData m_wsBatch[MAX_TELEMETRY_BATCH];
+        size_t m_wsBatchCount;
+        // Encoded on the httpd task, one record at a time
+        char m_wsFrame[WS_FRAME_SIZE];
+        size_t m_wsFrameLength;
+        uint8_t m_wsBinaryFrame[TelemetryCodec::MAX_SIZE];
+        size_t m_wsBinaryFrameLength;
+        uint8_t m_wsHalfFrame[TelemetryCodec::MAX_SIZE];
+        size_t m_wsHalfFrameLength;
         bool m_configUpdated;
+        std::atomic<ConfigStatus> m_configStatus;
+        std::atomic<esp_err_t> m_configResult;
+        // Command bodies are parsed in here, the handlers run one at a time on the httpd task. A
+        // configuration is only parsed once, by RuntimeConfig on the ConfigurationTask.
+        JsonArena m_jsonArena;
 
-        static esp_err_t indexHandler(httpd_req_t *req);
+        static esp_err_t assetHandler(httpd_req_t *req);
         static esp_err_t telemetryHandler(httpd_req_t *req);
+        static esp_err_t spectrumHandler(httpd_req_t *req);
+        static esp_err_t telemetryStreamHandler(httpd_req_t *req);
+        static void telemetryStreamWork(void *arg);
+        static int formatTelemetry(const TelemetryData&, char *buf, size_t size);
+        static bool writeTelemetry(JsonWriter&, const TelemetryData&);
+        static bool sendChunk(void *context, const char *data, size_t length);
+        static bool parseStreamFormat(const char *name, StreamFormat& format);
         static esp_err_t configHandler(httpd_req_t *req);
+        static esp_err_t configGetHandler(httpd_req_t *req);
+        static esp_err_t configStatusHandler(httpd_req_t *req);
+        static esp_err_t autoTuneHandler(httpd_req_t *req);
+        static esp_err_t sysIdHandler(httpd_req_t *req);
+        static esp_err_t sysIdExportHandler(httpd_req_t *req);
+        static esp_err_t blackBoxHandler(httpd_req_t *req);
+        static esp_err_t blackBoxListHandler(httpd_req_t *req);
+        static esp_err_t blackBoxDumpHandler(httpd_req_t *req, uint32_t id, FlightRecordingExport::Format format);
+        static bool readDumpAt(void *context, uint32_t offset, uint8_t *buffer, size_t length);
 
         void setupRoutes();
+        bool publishTelemetry(const TelemetryData* p_batch, size_t p_count);
+        size_t encodeTelemetry(const TelemetryData&, StreamFormat);
+        bool addWsClient(int p_fd, int p_rateHz, StreamFormat p_format);
+        void setWsClientRate(int p_fd, int p_rateHz);
+        void setWsClientFormat(int p_fd, StreamFormat p_format);
+        void removeWsClient(int p_index);
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "interfaces/IComponent.hpp"
+#include "include/EncoderVelocityEstimator.hpp"
+#include <memory>
+
+class IEncoder;
+
+// Reads both wheel encoders once per control cycle and fills the wheel fields of SensorData.
+// Without encoders the fields stay zero and balancing works as before.
+class WheelOdometry : public IComponent {
+public:
+    WheelOdometry(std::shared_ptr<IEncoder> p_left, std::shared_ptr<IEncoder> p_right);
+
+    esp_err_t init(const IRuntimeConfig&) override;
+    void update(SensorData&);
+
+private:
+    static constexpr const char* TAG = "WheelOdometry";
+
+    std::shared_ptr<IEncoder> m_leftEncoder;
+    std::shared_ptr<IEncoder> m_rightEncoder;
+    EncoderVelocityEstimator m_leftEstimator;
+    EncoderVelocityEstimator m_rightEstimator;
+    bool m_enabled;
+};
@@ -14,23 +14,99 @@
 #include "esp_log.h"
 #include "esp_err.h"
 
+#include "include/GainSchedule.hpp"
+#include "include/BiquadFilter.hpp"
+#include "include/SpectrumAnalyzer.hpp"
+#include "include/SpscRing.hpp"
+#include "include/TelemetryFrame.hpp"
+
 class IRuntimeConfig;
 
 struct SensorData {
     float pitch;
+    float pitchRate;    // Bias corrected gyro Y, deg/s, same sign as pitch
     float roll;
     float yaw;
+    float yawRate;      // Gyro Z, deg/s, positive counter-clockwise seen from above
+    float leftWheelAngle;   // rad since start, from the wheel encoders
+    float rightWheelAngle;
+    float leftWheelSpeed;   // rad/s
+    float rightWheelSpeed;
+    float dt;           // Loop period in seconds the sample was taken with
     int64_t timestamp;
 };
 
+// Contributions to the balance command before mapOutput, normalized.
+// The LQR reports pitch as p, wheel position and speed as i and pitch rate as d.
+struct ControllerTerms {
+    float p;
+    float i;
+    float d;
+};
+
 struct PIDOutput {
-    float output;
+    float output;       // Balance command, PID output units
+    float yawOutput;    // Turn command, normalized, see DifferentialDrive::mix
+    int64_t sampleTimestamp;    // SensorData::timestamp the command was computed from
+    float predictedPitch;       // Pitch the controller acted on, deg
+    float predictionHorizon;    // s, 0 while the predictor is off
+    ControllerTerms terms;
+};
+
+// Published by MotorControlTask every cycle through a mailbox
+struct MotorFeedback {
+    float latency;      // Sensor sample to motor update, s
+    float leftDuty;     // Normalized command sent to the driver after mixing and trim
+    float rightDuty;
 };
 
 struct TelemetryData {
+    uint32_t sequence;          // Counts control cycles, gaps show records that were dropped or thinned out
+    uint8_t state;              // IStateMachine::State
     SensorData sensorData;
     float pidOutput;
     float motorSpeed;
+    float predictedPitch;
+    float predictionHorizon;    // s
+    float measuredLatency;      // Sensor sample to motor update, s
+    ControllerTerms terms;
+    float leftDuty;
+    float rightDuty;
+};
+
+// One record per control cycle from PIDTask to TelemetryTask, 128 ms of headroom at a 1 kHz loop
+using TelemetryRing = SpscRing<TelemetryData, 128>;
+
+// Field order of the binary telemetry frame, shared by the WebSocket stream and the flight recorder
+inline TelemetryFrame toTelemetryFrame(const TelemetryData& p_telemetry) {
+    const SensorData& l_sensor = p_telemetry.sensorData;
+    TelemetryFrame l_frame;
+    l_frame.state = p_telemetry.state;
+    l_frame.sequence = p_telemetry.sequence;
+    l_frame.timestamp = l_sensor.timestamp;
+    l_frame.values[TelemetryFrame::PITCH] = l_sensor.pitch;
+    l_frame.values[TelemetryFrame::ROLL] = l_sensor.roll;
+    l_frame.values[TelemetryFrame::YAW] = l_sensor.yaw;
+    l_frame.values[TelemetryFrame::PITCH_RATE] = l_sensor.pitchRate;
+    l_frame.values[TelemetryFrame::YAW_RATE] = l_sensor.yawRate;
+    l_frame.values[TelemetryFrame::LEFT_WHEEL_SPEED] = l_sensor.leftWheelSpeed;
+    l_frame.values[TelemetryFrame::RIGHT_WHEEL_SPEED] = l_sensor.rightWheelSpeed;
+    l_frame.values[TelemetryFrame::P_TERM] = p_telemetry.terms.p;
+    l_frame.values[TelemetryFrame::I_TERM] = p_telemetry.terms.i;
+    l_frame.values[TelemetryFrame::D_TERM] = p_telemetry.terms.d;
+    l_frame.values[TelemetryFrame::PID_OUTPUT] = p_telemetry.pidOutput;
+    l_frame.values[TelemetryFrame::LEFT_DUTY] = p_telemetry.leftDuty;
+    l_frame.values[TelemetryFrame::RIGHT_DUTY] = p_telemetry.rightDuty;
+    l_frame.values[TelemetryFrame::PREDICTED_PITCH] = p_telemetry.predictedPitch;
+    l_frame.values[TelemetryFrame::PREDICTION_HORIZON_MS] = p_telemetry.predictionHorizon * 1000.0f;
+    l_frame.values[TelemetryFrame::LATENCY_MS] = p_telemetry.measuredLatency * 1000.0f;
+    return l_frame;
+}
+
+enum class DerivativeFilterType : uint8_t {
+    NONE,
+    FIRST_ORDER,
+    BIQUAD          // 2nd-order Butterworth
 };
 
 struct PIDConfig {
@@ -42,6 +118,118 @@ struct PIDConfig {
     float itermMax;
     float outputMin;
     float outputMax;
+    DerivativeFilterType dFilterType = DerivativeFilterType::NONE;
+    float dCutoffHz = 0.0f;
+    int engageRampMs = 0;   // Output ramp-in after entering BALANCING, pitch config only
+};
+
+// Outer loop of the cascade: wheel velocity (and optionally position) error -> pitch setpoint offset.
+// Flip the gain signs if positive wheel speed and positive pitch point opposite ways on the chassis.
+struct VelocityLoopConfig {
+    bool enabled = false;
+    float kp = 0.0f;              // deg of tilt per rad/s of wheel speed error
+    float ki = 0.0f;
+    float positionKp = 0.0f;      // deg of tilt per rad of wheel position error, 0 disables position hold
+    float targetSpeed = 0.0f;     // rad/s
+    float itermMin = -10.0f;
+    float itermMax = 10.0f;
+    float maxTilt = 5.0f;         // deg, limit of the offset added to the configured target angle
+    int divider = 5;              // Outer loop runs once every this many inner cycles
+};
+
+// Extrapolates pitch over the measured sensor-to-actuation latency before the balance controller runs.
+// The measurement starts after the IMU read, extraLatencyMs covers what it cannot see (I2C transfer, PWM period).
+struct PredictorConfig {
+    bool enabled = false;
+    bool secondOrder = false;     // Also use the pitch acceleration, differentiated from the gyro rate
+    float extraLatencyMs = 0.0f;
+    float maxLatencyMs = 20.0f;   // Horizon limit, a stalled queue must not turn into a wild extrapolation
+    float accelCutoffHz = 20.0f;  // Low-pass on the differentiated gyro rate, second order only
+};
+
+enum class ControllerType : uint8_t {
+    PID,
+    LQR
+};
+
+// State feedback u = -K (x - x_ref) over x = (pitch, pitch rate, wheel travel, wheel speed) in rad, rad/s.
+// u is normalized to [-1, 1] like the PID output before mapOutput; compute K with tools/lqr_gains.cpp.
+struct LQRConfig {
+    float kPitch = 0.0f;
+    float kPitchRate = 0.0f;
+    float kPosition = 0.0f;       // Wheel travel since the robot started balancing
+    float kVelocity = 0.0f;
+};
+
+// Bridge driver of the wheel motors
+enum class MotorDriverType : uint8_t {
+    LEDC,       // MX1616H inputs on four LEDC channels
+    MCPWM       // Center-aligned MCPWM bridges with dead time
+};
+
+struct MotorShapingConfig {
+    float inputScale = 1023.0f;   // PID output that maps to full duty
+    float deadband = 0.01f;       // Normalized commands below this are treated as zero
+    float frictionOffset = 0.0f;  // Static friction compensation added to non-zero commands
+    float slewRate = 0.0f;        // Max change of the normalized command per second, 0 disables
+    float trimLeft = 1.0f;
+    float trimRight = 1.0f;
+};
+
+// Telemetry stream over UDP next to the WebSocket one, read at boot
+struct UdpTelemetryConfig {
+    bool enabled = false;
+    char host[16] = "";           // IPv4 address of the collector, no name lookup
+    uint16_t port = 5005;
+};
+
+enum class AutoTuneRule : uint8_t {
+    ZIEGLER_NICHOLS,
+    TYREUS_LUYBEN
+};
+
+struct AutoTuneRequest {
+    // What an empty POST /autotune runs with. The band is a small fraction of the 1 to 2 degree
+    // limit cycle the default relay drives, a wider one moves the measured point off the ultimate one
+    static constexpr float DEFAULT_RELAY_AMPLITUDE = 0.2f;
+    static constexpr float DEFAULT_HYSTERESIS = 0.05f;
+    static constexpr float DEFAULT_MAX_PITCH_DEVIATION = 15.0f;
+
+    AutoTuneRule rule;
+    float relayAmplitude;     // Relay output as a fraction of full scale (0..1]
+    float hysteresis;         // Relay switching band in degrees
+    float maxPitchDeviation;  // Abort when |error| exceeds this, degrees
+    PIDConfig baseConfig;     // Limits and setpoint the tuned gains are applied on top of
+};
+
+enum class ExcitationType : uint8_t {
+    CHIRP,          // Logarithmic sine sweep
+    PRBS,           // Maximum length pseudo-random binary sequence
+    STEP
+};
+
+// Identification experiment, the excitation is added to the balance command in closed loop
+struct SysIdRequest {
+    ExcitationType type = ExcitationType::CHIRP;
+    float amplitude = 0.1f;           // Normalized command, same units as the auto-tune relay
+    float duration = 10.0f;           // s, also capped by the recording buffer
+    float startFrequencyHz = 0.2f;    // Chirp only
+    float endFrequencyHz = 10.0f;
+    int prbsBitCycles = 1;            // Control cycles each PRBS bit is held
+    float stepDelay = 1.0f;           // s of zero excitation before the step
+    float maxPitchDeviation = 15.0f;  // Abort when |pitch - target| exceeds this, degrees
+};
+
+// One control cycle of an identification run
+struct SysIdRecord {
+    float time;             // s since the start of the run
+    float excitation;       // Normalized command injected this cycle
+    float command;          // Total balance command sent to the motors, PID output units
+    float pitch;            // deg
+    float pitchRate;        // deg/s
+    float leftWheelSpeed;   // rad/s
+    float rightWheelSpeed;
+    float wheelAngle;       // Mean wheel angle, rad
 };
 
 class IComponent {
@@ -3,8 +3,17 @@
 
 class IMPU6050Manager : public IComponent {
     public:
-        virtual float calculatePitch(float&) const = 0; 
+        virtual float calculatePitch(float&, float) const = 0; 
         virtual float calculateRoll(float&) const = 0; 
         virtual float calculateYaw(float&) const = 0; 
+
+        // Bias corrected gyro Y from the last calculatePitch() read, deg/s
+        virtual float getPitchRate() const = 0;
+        // Bias corrected gyro Z from the last calculatePitch() read, deg/s
+        virtual float getYawRate() const = 0;
+        // Accel and bias corrected gyro of the last calculatePitch() read, before the filter bank
+        virtual ImuSample getLastImuSample() const = 0;
+        // Biquad chains applied to the raw gyro and accelerometer axes inside calculatePitch()
+        virtual void setFilterConfig(const FilterChainConfig& p_gyro, const FilterChainConfig& p_accel) = 0;
         virtual ~IMPU6050Manager() = default;   
 };
@@ -0,0 +1,10 @@
+#pragma once
+#include "interfaces/IComponent.hpp"
+
+// Speeds are normalized to [-1, 1]
+class IMotorDriver : public IComponent {
+    public:
+        virtual esp_err_t setSpeed(float) = 0;
+        virtual esp_err_t setSpeed(float, float) = 0;
+        virtual ~IMotorDriver() = default;
+};
@@ -5,6 +5,24 @@
 class IPIDController : public IComponent{
   public:
     virtual float compute(float&, float&, float, float) const = 0;
+    // Balance loop entry point, state feedback controllers read more than the pitch
+    virtual float compute(float&, float&, const SensorData&) const = 0;
+    virtual float mapOutput(float) const = 0;
+    // Breakdown of the last compute(), for telemetry
+    virtual ControllerTerms getLastTerms() const = 0;
     virtual esp_err_t setConfig(const PIDConfig&) = 0;
+    // Per-cycle setpoint from an outer loop, cheaper than a full setConfig
+    virtual void setTargetAngle(float) = 0;
+    virtual esp_err_t setLQRConfig(const LQRConfig&) = 0;
+    // Per-cycle multipliers on the configured gains from the gain schedule
+    virtual void setGainScale(const GainScale&) = 0;
+    // Biquad chain on the derivative path, after the d_filter low-pass
+    virtual void setDerivativeFilterChain(const FilterChainConfig&) = 0;
+    // Bumpless transfer: integrator value that keeps the last output unchanged under the new gains
+    virtual float bumplessIntegral(const PIDConfig&, float p_integral) const = 0;
+    // Seeds the last error from the current measurement so the first differenced D term is zero
+    virtual void seedDerivative(float& p_lastError, float p_currentValue) const = 0;
+    // Clears internal filter state, the caller owns and resets integral and last error
+    virtual void reset() = 0;
     virtual ~IPIDController() = default;
 };
\ No newline at end of file
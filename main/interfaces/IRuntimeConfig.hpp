@@ -4,8 +4,17 @@
 #include "esp_err.h"
 #include <string>
 
+class JsonWriter;
+
 class IRuntimeConfig {
     public:
+        // Largest configuration document fromJson takes, and the values and key text it may hold.
+        // A full config with three 8x8 gain tables and four stages in every filter chain is about
+        // 4.7 kB with 370 values and 1.5 kB of keys, tools/config_roundtrip_check.cpp measures it.
+        static constexpr size_t MAX_JSON_SIZE = 6144;
+        static constexpr size_t MAX_JSON_VALUES = 448;
+        static constexpr size_t MAX_JSON_TEXT = 2048;
+
         virtual esp_err_t init(const std::string& p_filename = "/spiffs/config.json") = 0;
         virtual esp_err_t save(const std::string& p_filename = "/spiffs/config.json") const = 0;
         virtual ~IRuntimeConfig() = default;
@@ -14,6 +23,42 @@ class IRuntimeConfig {
         virtual PIDConfig getPidConfig() const = 0;
         virtual void setPidConfig(PIDConfig) = 0;
 
+        // Yaw-rate PID, targetAngle is the target yaw rate in deg/s
+        virtual PIDConfig getYawPidConfig() const = 0;
+        virtual void setYawPidConfig(const PIDConfig&) = 0;
+
+        // Balance controller selection (read at boot) and LQR state feedback gains (reloadable)
+        virtual ControllerType getControllerType() const = 0;
+        virtual void setControllerType(ControllerType) = 0;
+        virtual LQRConfig getLQRConfig() const = 0;
+        virtual void setLQRConfig(const LQRConfig&) = 0;
+
+        // Gain schedule over |pitch error| and |wheel speed|, multipliers on the pitch PID gains
+        virtual GainScheduleConfig getGainScheduleConfig() const = 0;
+        virtual void setGainScheduleConfig(const GainScheduleConfig&) = 0;
+
+        // Cascaded wheel velocity/position loop around the pitch PID
+        virtual VelocityLoopConfig getVelocityLoopConfig() const = 0;
+        virtual void setVelocityLoopConfig(const VelocityLoopConfig&) = 0;
+
+        // Latency-compensating pitch predictor in front of the balance controller
+        virtual PredictorConfig getPredictorConfig() const = 0;
+        virtual void setPredictorConfig(const PredictorConfig&) = 0;
+
+        // Notch/low-pass/high-pass chains on the gyro, accelerometer, D term and motor output
+        virtual FilterBankConfig getFilterBankConfig() const = 0;
+        virtual void setFilterBankConfig(const FilterBankConfig&) = 0;
+
+        // Motor bridge driver (read at boot) and output shaping parameters (reloadable)
+        virtual MotorDriverType getMotorDriverType() const = 0;
+        virtual void setMotorDriverType(MotorDriverType) = 0;
+        virtual MotorShapingConfig getMotorShapingConfig() const = 0;
+        virtual void setMotorShapingConfig(const MotorShapingConfig&) = 0;
+
+        // Destination of the UDP telemetry stream (read at boot)
+        virtual UdpTelemetryConfig getUdpTelemetryConfig() const = 0;
+        virtual void setUdpTelemetryConfig(const UdpTelemetryConfig&) = 0;
+
         // MPU6050 parameters
         virtual int getMpu6050CalibrationSamples() const = 0;
         virtual void setMpu6050CalibrationSamples(int) = 0;
@@ -30,5 +75,7 @@ class IRuntimeConfig {
 
         // JSON serialization/deserialization
         virtual std::string toJson() const = 0;
+        // Streams the document through the writer and finishes it, the WiFi credentials are optional
+        virtual bool writeJson(JsonWriter&, bool p_includeWifi) const = 0;
         virtual esp_err_t fromJson(const std::string&) = 0;
 };
\ No newline at end of file
@@ -21,4 +21,6 @@ class IMotorControlTask : public ITask {};
 
 class ITelemetryTask : public ITask {};
 
-class IConfigurationTask : public ITask {};
\ No newline at end of file
+class IConfigurationTask : public ITask {};
+
+class IVibrationAnalysisTask : public ITask {};
\ No newline at end of file
@@ -1,12 +1,22 @@
 #pragma once
 #include "interfaces/IComponent.hpp"
 #include "interfaces/ITask.hpp"
+#include <string>
 
 class IWebServer : public IComponent{
     public:
-    virtual void update_telemetry(const TelemetryData&) = 0;
+    // Records oldest first. False while the previous batch is still going out, this one is not
+    // streamed and the sequence gap shows it to the clients.
+    virtual bool update_telemetry(const TelemetryData*, size_t) = 0;
+    virtual void update_spectrum(const VibrationSpectrum&) = 0;
     virtual bool hasConfigurationRequest() = 0;
-    virtual PIDConfig getConfigurationRequest() = 0;
+    virtual std::string getConfigurationRequest() = 0;
     virtual void notifyConfigurationUpdated() = 0;
+    // Outcome of the request getConfigurationRequest() returned, ESP_OK once it is applied
+    virtual void notifyConfigurationResult(esp_err_t) = 0;
+    virtual bool hasAutoTuneRequest() = 0;
+    virtual AutoTuneRequest getAutoTuneRequest() = 0;
+    virtual bool hasSysIdRequest() = 0;
+    virtual SysIdRequest getSysIdRequest() = 0;
     virtual ~IWebServer() = default;
 };
\ No newline at end of file
@@ -79,7 +79,7 @@ void pidControlTask(void* pvParameters)
 
     while (true) {
         // Read sensor data
-        pitch = mpu.calculatePitch(pitch);
+        pitch = mpu.calculatePitch(pitch, 0.01f);
 
         // Compute PID output
         float output = pid.compute(integral, lastError, pitch, 0.01);  // 0.01s as dt
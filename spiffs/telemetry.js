@@ -0,0 +1,44 @@
+// Decoder for the binary telemetry frame, see main/include/TelemetryFrame.hpp for the layout.
+// Returns an object with the same keys as the JSON telemetry, or null for a frame that is not ours.
+const TELEMETRY_FIELDS = [
+    'pitch', 'roll', 'yaw', 'pitchRate', 'yawRate', 'leftWheelSpeed', 'rightWheelSpeed',
+    'pTerm', 'iTerm', 'dTerm', 'pidOutput', 'leftDuty', 'rightDuty',
+    'predictedPitch', 'predictionHorizonMs', 'latencyMs'
+];
+const TELEMETRY_MAGIC = 0xB7;
+const TELEMETRY_HEADER_SIZE = 16;
+const TELEMETRY_FLAG_HALF_FLOAT = 0x01;
+
+function halfToFloat(half) {
+    const sign = (half & 0x8000) ? -1 : 1;
+    const exponent = (half >> 10) & 0x1F;
+    const mantissa = half & 0x3FF;
+    if (exponent === 0) return sign * Math.pow(2, -14) * (mantissa / 1024);
+    if (exponent === 0x1F) return mantissa ? NaN : sign * Infinity;
+    return sign * Math.pow(2, exponent - 15) * (1 + mantissa / 1024);
+}
+
+function decodeTelemetryFrame(buffer) {
+    const view = new DataView(buffer);
+    if (view.byteLength < TELEMETRY_HEADER_SIZE || view.getUint8(0) !== TELEMETRY_MAGIC) {
+        return null;
+    }
+    const flags = view.getUint8(2);
+    const frame = {
+        version: view.getUint8(1),
+        state: view.getUint8(3),
+        sequence: view.getUint32(4, true),
+        // Microseconds since boot, exact up to 2^53
+        timestamp: Number(view.getBigInt64(8, true))
+    };
+
+    const half = (flags & TELEMETRY_FLAG_HALF_FLOAT) !== 0;
+    const size = half ? 2 : 4;
+    // Newer firmware only appends fields, older firmware may send fewer
+    const count = Math.min(TELEMETRY_FIELDS.length, Math.floor((view.byteLength - TELEMETRY_HEADER_SIZE) / size));
+    for (let i = 0; i < count; i++) {
+        const offset = TELEMETRY_HEADER_SIZE + i * size;
+        frame[TELEMETRY_FIELDS[i]] = half ? halfToFloat(view.getUint16(offset, true)) : view.getFloat32(offset, true);
+    }
+    return frame;
+}
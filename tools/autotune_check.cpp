@@ -0,0 +1,254 @@
+// Host check of the relay auto-tuner against a simulated robot.
+//
+// Build: g++ -std=c++20 -O2 -Itools/host -Imain -o autotune_check tools/autotune_check.cpp main/PIDAutoTuner.cpp
+// Usage: ./autotune_check [config=spiffs/config.json]
+//
+// The plant is the robot body as an inverted pendulum on wheels that follow a speed command with
+// a first-order lag, sampled every control period with one period of sensor-to-motor latency. A
+// positive command drives the wheels under a body leaning back, as the wiring is set up on the robot:
+//
+//   v' = (-K u - v) / tau        theta'' = (g sin(theta) - v' cos(theta)) / l
+//
+// From the motor command to the pitch that is G(s) = (K / l) s e^(-s Td) / ((tau s + 1)(s^2 - g / l)),
+// whose phase crosses -180 degrees where atan(w tau) + w Td = pi / 2. Ku = 1 / |G(jw)| and
+// Pu = 2 pi / w there, with Td the latency plus half a period for the output hold. PIDAutoTuner
+// runs the relay experiment in closed loop the way PIDTask does; its Ku and Pu must land within
+// TOLERANCE of those values and the Ziegler-Nichols and Tyreus-Luyben gains within GAIN_TOLERANCE,
+// as Ki and Kd carry the error of both. What remains is the describing function ignoring the
+// harmonics of the square relay output, the limit cycle period rounding to whole control periods
+// and the hysteresis band moving the point the relay finds asin(h / a) off the phase crossover,
+// where the phase of this plant falls slowly.
+//
+// The checked request is the one an empty POST /autotune sends, the AutoTuneRequest defaults, at
+// the main_loop.interval_ms of the shipped config, and again without hysteresis at half that
+// period. The centring bias has to hold the mean pitch: the wheels only push the body back while
+// they accelerate, without it the oscillation drifts off before the experiment completes.
+//
+// Then the safety checks: a deviation limit below the oscillation aborts the run and the relay
+// goes quiet, as do out of range requests and a robot that is knocked over mid run.
+
+#include "include/PIDAutoTuner.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr float TOLERANCE = 0.1f;
+constexpr float GAIN_TOLERANCE = 0.15f;
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = 180.0 / PI;
+
+struct Plant {
+    double gravity = 9.81;
+    double length = 0.1;           // Wheel axle to centre of mass, m
+    double speedGain = 1.0;        // Wheel ground speed at full command, m/s
+    double tau = 0.1;              // Motor speed time constant, s
+    double period = 0.01;          // Control period, s
+    int latency = 1;               // Control periods from the pitch sample to the motor command
+};
+
+// G(jw) in degrees of pitch per unit of command, latency and output hold included
+std::complex<double> response(const Plant& p_plant, double p_omega) {
+    const std::complex<double> l_s(0.0, p_omega);
+    double l_delay = p_plant.latency * p_plant.period + p_plant.period / 2.0;
+    return (p_plant.speedGain / p_plant.length) * l_s * std::exp(-l_s * l_delay) /
+           ((p_plant.tau * l_s + 1.0) * (l_s * l_s - p_plant.gravity / p_plant.length)) * DEG;
+}
+
+// Phase crossover by bisection, the phase falls monotonically from -90 degrees
+void ultimate(const Plant& p_plant, double& p_ku, double& p_pu) {
+    double l_low = 1e-3, l_high = 1e3;
+    for (int i = 0; i < 200; i++) {
+        double l_mid = std::sqrt(l_low * l_high);
+        std::complex<double> l_g = response(p_plant, l_mid);
+        // Below the crossover the response sits in the lower half plane left of the axis
+        if (l_g.imag() < 0.0) {
+            l_low = l_mid;
+        } else {
+            l_high = l_mid;
+        }
+    }
+    p_ku = 1.0 / std::abs(response(p_plant, l_low));
+    p_pu = 2.0 * PI / l_low;
+}
+
+class Simulation {
+public:
+    explicit Simulation(const Plant& p_plant, double p_pitchDeg = 0.0)
+        : m_plant(p_plant), m_theta(p_pitchDeg / DEG), m_rate(0.0), m_speed(0.0), m_command(0.0) {}
+
+    // One control period with the command from the previous sample, returns the new sample in degrees
+    float step(float p_command) {
+        m_pending.push_back(p_command);
+        if (static_cast<int>(m_pending.size()) > m_plant.latency) {
+            m_command = m_pending.front();
+            m_pending.pop_front();
+        }
+        const int l_substeps = 20;
+        double l_h = m_plant.period / l_substeps;
+        for (int i = 0; i < l_substeps; i++) {
+            double l_accel = (-m_plant.speedGain * m_command - m_speed) / m_plant.tau;
+            double l_thetaAccel = (m_plant.gravity * std::sin(m_theta) - l_accel * std::cos(m_theta)) / m_plant.length;
+            m_speed += l_accel * l_h;
+            m_rate += l_thetaAccel * l_h;
+            m_theta += m_rate * l_h;
+        }
+        return static_cast<float>(m_theta * DEG);
+    }
+
+    void push(double p_rateDegPerSecond) { m_rate += p_rateDegPerSecond / DEG; }
+
+private:
+    Plant m_plant;
+    double m_theta;
+    double m_rate;
+    double m_speed;
+    double m_command;
+    std::deque<float> m_pending;
+};
+
+// As WebServer fills it for an empty body
+AutoTuneRequest request(AutoTuneRule p_rule, float p_hysteresis = AutoTuneRequest::DEFAULT_HYSTERESIS) {
+    AutoTuneRequest l_request;
+    l_request.rule = p_rule;
+    l_request.relayAmplitude = AutoTuneRequest::DEFAULT_RELAY_AMPLITUDE;
+    l_request.hysteresis = p_hysteresis;
+    l_request.maxPitchDeviation = AutoTuneRequest::DEFAULT_MAX_PITCH_DEVIATION;
+    l_request.baseConfig = PIDConfig{0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, -1.0f, 1.0f};
+    return l_request;
+}
+
+// Until the tuner stops or p_seconds run out, returns the seconds it took
+float run(PIDAutoTuner& p_tuner, Simulation& p_simulation, const Plant& p_plant, float p_seconds,
+          float p_pushAt = -1.0f, double p_push = 0.0) {
+    float l_pitch = p_simulation.step(0.0f);
+    float l_elapsed = 0.0f;
+    bool l_quiet = true;
+    while (p_tuner.getStatus() == PIDAutoTuner::Status::RUNNING && l_elapsed < p_seconds) {
+        float l_output = p_tuner.update(l_pitch, static_cast<float>(p_plant.period));
+        if (p_tuner.getStatus() != PIDAutoTuner::Status::RUNNING && l_output != 0.0f) {
+            l_quiet = false;
+        }
+        if (p_pushAt >= 0.0f && l_elapsed >= p_pushAt) {
+            p_simulation.push(p_push);
+            p_pushAt = -1.0f;
+        }
+        l_pitch = p_simulation.step(l_output);
+        l_elapsed += static_cast<float>(p_plant.period);
+    }
+    // Once stopped the relay must stay off
+    if (p_tuner.update(l_pitch, static_cast<float>(p_plant.period)) != 0.0f || !l_quiet) {
+        std::printf("  relay still driving after the run stopped\n");
+        return -1.0f;
+    }
+    return l_elapsed;
+}
+
+bool near(const char* p_name, double p_value, double p_expected, double p_tolerance) {
+    double l_error = (p_value - p_expected) / p_expected;
+    bool l_ok = std::fabs(l_error) <= p_tolerance;
+    std::printf("  %-3s %9.4f  analytic %9.4f  %+6.1f%%  %s\n", p_name, p_value, p_expected, 100.0 * l_error,
+                l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+bool checkRule(const Plant& p_plant, const AutoTuneRequest& p_request, double p_ku, double p_pu) {
+    bool l_zn = p_request.rule == AutoTuneRule::ZIEGLER_NICHOLS;
+    PIDAutoTuner l_tuner;
+    Simulation l_simulation(p_plant);
+    l_tuner.start(p_request);
+    float l_seconds = run(l_tuner, l_simulation, p_plant, 60.0f);
+    if (l_tuner.getStatus() != PIDAutoTuner::Status::DONE || l_seconds < 0.0f) {
+        std::printf("%s: tuner did not finish\n", l_zn ? "Ziegler-Nichols" : "Tyreus-Luyben");
+        return false;
+    }
+
+    // The rules as published, on the analytic ultimate point
+    double l_kp = l_zn ? 0.6 * p_ku : p_ku / 2.2;
+    double l_ti = l_zn ? 0.5 * p_pu : 2.2 * p_pu;
+    double l_td = l_zn ? 0.125 * p_pu : p_pu / 6.3;
+    PIDConfig l_result = l_tuner.getResult();
+    std::printf("%s, finished after %.2f s:\n", l_zn ? "Ziegler-Nichols" : "Tyreus-Luyben", l_seconds);
+    bool l_ok = near("Ku", l_tuner.getUltimateGain(), p_ku, TOLERANCE);
+    l_ok = near("Pu", l_tuner.getUltimatePeriod(), p_pu, TOLERANCE) && l_ok;
+    l_ok = near("Kp", l_result.kp, l_kp, GAIN_TOLERANCE) && l_ok;
+    l_ok = near("Ki", l_result.ki, l_kp / l_ti, GAIN_TOLERANCE) && l_ok;
+    l_ok = near("Kd", l_result.kd, l_kp * l_td, GAIN_TOLERANCE) && l_ok;
+    return l_ok;
+}
+
+// Both rules on one plant
+bool checkRequest(const Plant& p_plant, float p_hysteresis) {
+    double l_ku, l_pu;
+    ultimate(p_plant, l_ku, l_pu);
+    std::printf("Plant: l %.2f m, tau %.2f s, %.0f ms period, latency %d -> Ku %.4f /deg, Pu %.3f s\n",
+                p_plant.length, p_plant.tau, p_plant.period * 1000.0, p_plant.latency, l_ku, l_pu);
+    std::printf("Relay %.2f, hysteresis %.2f deg\n", AutoTuneRequest::DEFAULT_RELAY_AMPLITUDE, p_hysteresis);
+    bool l_ok = checkRule(p_plant, request(AutoTuneRule::ZIEGLER_NICHOLS, p_hysteresis), l_ku, l_pu);
+    l_ok = checkRule(p_plant, request(AutoTuneRule::TYREUS_LUYBEN, p_hysteresis), l_ku, l_pu) && l_ok;
+    std::printf("\n");
+    return l_ok;
+}
+
+// main_loop.interval_ms, without a JSON parser on the host
+double shippedPeriod(const char* p_path) {
+    std::ifstream l_file(p_path);
+    std::string l_config((std::istreambuf_iterator<char>(l_file)), std::istreambuf_iterator<char>());
+    size_t l_section = l_config.find("\"main_loop\"");
+    size_t l_key = l_section == std::string::npos ? l_section : l_config.find("\"interval_ms\"", l_section);
+    size_t l_colon = l_key == std::string::npos ? l_key : l_config.find(':', l_key);
+    if (l_colon == std::string::npos) {
+        return 0.0;
+    }
+    return std::strtod(l_config.c_str() + l_colon + 1, nullptr) * 1e-3;
+}
+
+bool checkAbort(const char* p_name, const Plant& p_plant, AutoTuneRequest p_request, float p_pushAt = -1.0f, double p_push = 0.0) {
+    PIDAutoTuner l_tuner;
+    Simulation l_simulation(p_plant);
+    l_tuner.start(p_request);
+    float l_seconds = run(l_tuner, l_simulation, p_plant, 60.0f, p_pushAt, p_push);
+    bool l_ok = l_tuner.getStatus() == PIDAutoTuner::Status::ABORTED && l_seconds >= 0.0f;
+    std::printf("%-32s %s after %.2f s  %s\n", p_name, l_ok ? "aborted" : "not aborted", l_seconds, l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* l_path = argc > 1 ? argv[1] : "spiffs/config.json";
+    Plant l_plant;
+    l_plant.period = shippedPeriod(l_path);
+    if (l_plant.period <= 0.0) {
+        std::printf("no main_loop.interval_ms in %s\n", l_path);
+        return 1;
+    }
+
+    bool l_ok = checkRequest(l_plant, AutoTuneRequest::DEFAULT_HYSTERESIS);
+    Plant l_fast = l_plant;
+    l_fast.period = l_plant.period / 2.0;
+    l_ok = checkRequest(l_fast, 0.0f) && l_ok;
+
+    // About 1 degree of oscillation against a 0.5 degree limit
+    AutoTuneRequest l_tight = request(AutoTuneRule::ZIEGLER_NICHOLS);
+    l_tight.maxPitchDeviation = 0.5f;
+    l_ok = checkAbort("deviation limit", l_plant, l_tight) && l_ok;
+
+    AutoTuneRequest l_strong = request(AutoTuneRule::ZIEGLER_NICHOLS);
+    l_strong.relayAmplitude = 0.8f;
+    l_ok = checkAbort("relay amplitude out of range", l_plant, l_strong) && l_ok;
+
+    AutoTuneRequest l_band = request(AutoTuneRule::ZIEGLER_NICHOLS);
+    l_band.hysteresis = 20.0f;
+    l_ok = checkAbort("hysteresis above the limit", l_plant, l_band) && l_ok;
+
+    l_ok = checkAbort("knocked over mid run", l_plant, request(AutoTuneRule::ZIEGLER_NICHOLS), 0.5f, 200.0) && l_ok;
+
+    return l_ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Host check of a filter chain before it goes into the "filters" section of config.json.
+//
+// Build: g++ -std=c++17 -O2 -Imain -o biquad_response tools/biquad_response.cpp main/BiquadFilter.cpp
+// Usage: ./biquad_response rate_hz=100 type:freq_hz:q [type:freq_hz:q ...]
+//   e.g. ./biquad_response rate_hz=100 notch:35:4 low_pass:40:0.707
+//
+// Prints the gain and delay of the chain at a sweep of frequencies, measured by running
+// sine waves through the same portable kernel the firmware uses off target, and the cost
+// of filtering a batch of samples.
+
+#include "include/BiquadFilter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+bool parseStage(const char* p_text, BiquadStageConfig& p_stage) {
+    char l_type[16];
+    if (std::sscanf(p_text, "%15[a-z_]:%f:%f", l_type, &p_stage.frequencyHz, &p_stage.q) != 3) {
+        return false;
+    }
+    if (std::strcmp(l_type, "low_pass") == 0) p_stage.type = BiquadType::LOW_PASS;
+    else if (std::strcmp(l_type, "high_pass") == 0) p_stage.type = BiquadType::HIGH_PASS;
+    else if (std::strcmp(l_type, "notch") == 0) p_stage.type = BiquadType::NOTCH;
+    else return false;
+    return BiquadCascade::isValid(p_stage);
+}
+
+// Steady state amplitude and phase lag of the chain at one frequency, by correlation over whole periods
+void measure(const FilterChainConfig& p_chain, float p_dt, float p_frequency, double& p_gain, double& p_delayMs) {
+    BiquadCascade l_filter;
+    l_filter.configure(p_chain, p_dt);
+
+    int l_settle = static_cast<int>(5.0f / p_dt);
+    int l_periods = std::max(1, static_cast<int>(2.0f * p_frequency));
+    int l_length = static_cast<int>(std::lround(l_periods / (p_frequency * p_dt)));
+    std::vector<float> l_samples(l_settle + l_length);
+    for (size_t n = 0; n < l_samples.size(); n++) {
+        l_samples[n] = std::sin(2.0 * M_PI * p_frequency * n * p_dt);
+    }
+    l_filter.process(l_samples.data(), static_cast<int>(l_samples.size()));
+
+    double l_in = 0.0, l_quad = 0.0;
+    for (int n = 0; n < l_length; n++) {
+        double l_phase = 2.0 * M_PI * p_frequency * (l_settle + n) * p_dt;
+        l_in += l_samples[l_settle + n] * std::sin(l_phase);
+        l_quad += l_samples[l_settle + n] * std::cos(l_phase);
+    }
+    p_gain = 2.0 * std::hypot(l_in, l_quad) / l_length;
+    double l_lag = -std::atan2(l_quad, l_in);
+    if (l_lag < 0.0) l_lag += 2.0 * M_PI;
+    p_delayMs = l_lag / (2.0 * M_PI * p_frequency) * 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    float l_rate = 100.0f;
+    FilterChainConfig l_chain;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "rate_hz=", 8) == 0) {
+            l_rate = std::strtof(argv[i] + 8, nullptr);
+        } else if (l_chain.stages < FilterChainConfig::MAX_STAGES && parseStage(argv[i], l_chain.stage[l_chain.stages])) {
+            l_chain.stages++;
+        } else {
+            std::fprintf(stderr, "bad argument '%s', expected rate_hz=N or type:freq_hz:q (max %d stages)\n",
+                         argv[i], FilterChainConfig::MAX_STAGES);
+            return 1;
+        }
+    }
+    if (l_rate <= 0.0f) {
+        std::fprintf(stderr, "rate_hz must be positive\n");
+        return 1;
+    }
+    float l_dt = 1.0f / l_rate;
+
+    for (int i = 0; i < l_chain.stages; i++) {
+        if (l_chain.stage[i].frequencyHz >= 0.5f * l_rate) {
+            std::printf("stage %d at %.1f Hz is above Nyquist, the firmware passes it through\n", i, l_chain.stage[i].frequencyHz);
+        }
+    }
+
+    std::printf("%10s %10s %10s %10s\n", "freq_hz", "gain", "gain_db", "delay_ms");
+    for (int i = 1; i <= 19; i++) {
+        float l_frequency = 0.5f * l_rate * i / 20.0f;
+        double l_gain, l_delay;
+        measure(l_chain, l_dt, l_frequency, l_gain, l_delay);
+        std::printf("%10.2f %10.4f %10.2f %10.2f\n", l_frequency, l_gain, 20.0 * std::log10(std::max(l_gain, 1e-9)), l_delay);
+    }
+
+    // Whole batches, as a FIFO burst would be filtered
+    BiquadCascade l_filter;
+    l_filter.configure(l_chain, l_dt);
+    std::vector<float> l_batch(32, 1.0f);
+    const long l_batches = 200000;
+    auto l_start = std::chrono::steady_clock::now();
+    for (long i = 0; i < l_batches; i++) {
+        l_filter.process(l_batch.data(), static_cast<int>(l_batch.size()));
+    }
+    auto l_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - l_start).count();
+    std::printf("\n%d stages: %.2f ns/sample in batches of %zu (sink %.3f)\n", l_chain.stages,
+                l_elapsed / (l_batches * l_batch.size()), l_batch.size(), l_batch[0]);
+    return 0;
+}
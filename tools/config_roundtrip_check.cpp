@@ -0,0 +1,195 @@
+// Host check that the largest configuration the robot takes over POST /config fits the request
+// cap and the parse arena, and comes back unchanged through RuntimeConfig::fromJson.
+//
+// Builds main/RuntimeConfig.cpp against the stand-ins in tools/host and the cJSON sources, which
+// ship with ESP-IDF:
+//   gcc -O2 -c $IDF_PATH/components/json/cJSON/cJSON.c -o cJSON.o
+//   g++ -std=c++20 -O2 -Itools/host -Imain -I$IDF_PATH/components/json/cJSON -o config_roundtrip_check
+//       tools/config_roundtrip_check.cpp main/RuntimeConfig.cpp main/JsonArena.cpp main/JsonWriter.cpp
+//       main/GainSchedule.cpp main/BiquadFilter.cpp cJSON.o
+// Usage: ./config_roundtrip_check [config=spiffs/config.json]
+//
+// Starts from the shipped config, fills the gain schedule to 8x8 with values that need all nine
+// digits and every filter chain to four stages, then serializes it the way GET /config does. That
+// document, and a gain schedule update on its own, must stay under IRuntimeConfig::MAX_JSON_SIZE,
+// hold no more values and key text than the arena is sized for, and parse back into the same
+// configuration. Also prints what the arena would use on the target, where a cJSON node is 40
+// bytes instead of 64.
+
+#include "include/RuntimeConfig.hpp"
+#include "include/JsonArena.hpp"
+#include "include/JsonWriter.hpp"
+#include "cJSON.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr size_t TARGET_NODE_SIZE = 40;
+constexpr size_t ARENA_ALIGNMENT = 8;
+
+bool appendToString(void* p_context, const char* p_data, size_t p_length) {
+    static_cast<std::string*>(p_context)->append(p_data, p_length);
+    return true;
+}
+
+GainScheduleConfig fullSchedule() {
+    GainScheduleConfig l_schedule;
+    l_schedule.enabled = true;
+    l_schedule.errorPoints = GainScheduleConfig::MAX_POINTS;
+    l_schedule.speedPoints = GainScheduleConfig::MAX_POINTS;
+    for (int i = 0; i < GainScheduleConfig::MAX_POINTS; i++) {
+        l_schedule.errorBreakpoints[i] = 0.37f + i * 1.713f;
+        l_schedule.speedBreakpoints[i] = 0.11f + i * 2.917f;
+    }
+    for (int s = 0; s < GainScheduleConfig::MAX_POINTS; s++) {
+        for (int e = 0; e < GainScheduleConfig::MAX_POINTS; e++) {
+            int l_cell = s * GainScheduleConfig::MAX_POINTS + e;
+            l_schedule.kpScale[s][e] = 0.5f + l_cell / 7.0f;
+            l_schedule.kiScale[s][e] = 0.25f + l_cell / 11.0f;
+            l_schedule.kdScale[s][e] = 0.75f + l_cell / 13.0f;
+        }
+    }
+    return l_schedule;
+}
+
+FilterBankConfig fullFilterBank() {
+    FilterBankConfig l_bank;
+    for (FilterChainConfig* l_chain : {&l_bank.gyro, &l_bank.accel, &l_bank.dTerm, &l_bank.motor}) {
+        l_chain->stages = FilterChainConfig::MAX_STAGES;
+        for (int i = 0; i < FilterChainConfig::MAX_STAGES; i++) {
+            l_chain->stage[i].type = i % 2 ? BiquadType::HIGH_PASS : BiquadType::NOTCH;
+            l_chain->stage[i].frequencyHz = 123.456f + i / 3.0f;
+            l_chain->stage[i].q = 0.7071068f + i / 7.0f;
+        }
+    }
+    return l_bank;
+}
+
+// Indented like GET /config serves it, a client that posts it back unchanged sends the most bytes
+std::string serialize(const RuntimeConfig& p_config) {
+    std::string l_document;
+    char l_buffer[256];
+    JsonWriter l_json(l_buffer, sizeof(l_buffer), appendToString, &l_document, true);
+    p_config.writeJson(l_json, false);
+    return l_document;
+}
+
+// The body a client sends to change only the schedule, rows per speed breakpoint
+std::string scheduleUpdate(const GainScheduleConfig& p_schedule) {
+    std::string l_document;
+    char l_buffer[256];
+    JsonWriter l_json(l_buffer, sizeof(l_buffer), appendToString, &l_document);
+    l_json.beginObject().beginObject("gain_schedule")
+        .boolean("enabled", p_schedule.enabled)
+        .numbers("error_breakpoints", p_schedule.errorBreakpoints, p_schedule.errorPoints)
+        .numbers("speed_breakpoints", p_schedule.speedBreakpoints, p_schedule.speedPoints);
+    const struct { const char* name; const float (*table)[GainScheduleConfig::MAX_POINTS]; } l_tables[] = {
+        {"kp_scale", p_schedule.kpScale}, {"ki_scale", p_schedule.kiScale}, {"kd_scale", p_schedule.kdScale}
+    };
+    for (const auto& l_table : l_tables) {
+        l_json.beginArray(l_table.name);
+        for (int s = 0; s < p_schedule.speedPoints; s++) {
+            l_json.numbers(nullptr, l_table.table[s], p_schedule.errorPoints);
+        }
+        l_json.endArray();
+    }
+    l_json.endObject().endObject();
+    l_json.finish();
+    return l_document;
+}
+
+bool sameSchedule(const GainScheduleConfig& p_a, const GainScheduleConfig& p_b) {
+    return p_a.enabled == p_b.enabled && p_a.errorPoints == p_b.errorPoints && p_a.speedPoints == p_b.speedPoints &&
+           memcmp(p_a.errorBreakpoints, p_b.errorBreakpoints, sizeof(p_a.errorBreakpoints)) == 0 &&
+           memcmp(p_a.speedBreakpoints, p_b.speedBreakpoints, sizeof(p_a.speedBreakpoints)) == 0 &&
+           memcmp(p_a.kpScale, p_b.kpScale, sizeof(p_a.kpScale)) == 0 &&
+           memcmp(p_a.kiScale, p_b.kiScale, sizeof(p_a.kiScale)) == 0 &&
+           memcmp(p_a.kdScale, p_b.kdScale, sizeof(p_a.kdScale)) == 0;
+}
+
+int countValues(const cJSON* p_item) {
+    int l_count = 0;
+    for (; p_item; p_item = p_item->next) {
+        l_count += 1 + countValues(p_item->child);
+    }
+    return l_count;
+}
+
+// Size, values and key text against the limits in IRuntimeConfig
+bool checkLimits(const char* p_name, const std::string& p_document) {
+    JsonArena l_arena(1 << 20);
+    size_t l_values = 0;
+    {
+        JsonArena::Scope l_scope(l_arena);
+        cJSON* l_root = cJSON_Parse(p_document.c_str());
+        if (!l_root) {
+            std::printf("%-16s does not parse\n", p_name);
+            return false;
+        }
+        l_values = countValues(l_root);
+        cJSON_Delete(l_root);
+    }
+    size_t l_hostNode = (sizeof(cJSON) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    size_t l_text = l_arena.highWater() - l_values * l_hostNode;
+    size_t l_target = l_values * TARGET_NODE_SIZE + l_text;
+    bool l_ok = p_document.size() < IRuntimeConfig::MAX_JSON_SIZE && l_values <= IRuntimeConfig::MAX_JSON_VALUES &&
+                l_text <= IRuntimeConfig::MAX_JSON_TEXT;
+    std::printf("%-16s %5zu / %zu bytes, %3zu / %zu values, %4zu / %zu bytes of keys, "
+                "arena %5zu on the host, %5zu / %zu on the target  %s\n",
+                p_name, p_document.size(), IRuntimeConfig::MAX_JSON_SIZE, l_values, IRuntimeConfig::MAX_JSON_VALUES,
+                l_text, IRuntimeConfig::MAX_JSON_TEXT, l_arena.highWater(), l_target,
+                IRuntimeConfig::MAX_JSON_VALUES * TARGET_NODE_SIZE + IRuntimeConfig::MAX_JSON_TEXT, l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* l_path = argc > 1 ? argv[1] : "spiffs/config.json";
+    std::ifstream l_file(l_path);
+    if (!l_file) {
+        std::printf("cannot open %s\n", l_path);
+        return 1;
+    }
+    std::string l_shipped((std::istreambuf_iterator<char>(l_file)), std::istreambuf_iterator<char>());
+
+    RuntimeConfig l_source;
+    if (l_source.fromJson(l_shipped) != ESP_OK) {
+        std::printf("%s does not load\n", l_path);
+        return 1;
+    }
+    GainScheduleConfig l_schedule = fullSchedule();
+    l_source.setGainScheduleConfig(l_schedule);
+    l_source.setFilterBankConfig(fullFilterBank());
+    // Not the default, the round trip into defaults only passes if the driver is read back
+    l_source.setMotorDriverType(MotorDriverType::MCPWM);
+    std::string l_full = serialize(l_source);
+    std::string l_update = scheduleUpdate(l_schedule);
+
+    bool l_ok = checkLimits("full config", l_full);
+    l_ok = checkLimits("schedule update", l_update) && l_ok;
+
+    // The whole document into defaults, then out again byte for byte
+    RuntimeConfig l_copy;
+    bool l_loaded = l_copy.fromJson(l_full) == ESP_OK;
+    bool l_same = l_loaded && sameSchedule(l_copy.getGainScheduleConfig(), l_schedule) && serialize(l_copy) == l_full;
+    std::printf("full config      fromJson %s, round trip %s\n", l_loaded ? "ok" : "FAILED", l_same ? "ok" : "FAILED");
+    l_ok = l_same && l_ok;
+
+    // The schedule on its own over the shipped config, the rest must stay as it was
+    RuntimeConfig l_updated;
+    l_updated.fromJson(l_shipped);
+    RuntimeConfig l_expected;
+    l_expected.fromJson(l_shipped);
+    l_expected.setGainScheduleConfig(l_schedule);
+    l_loaded = l_updated.fromJson(l_update) == ESP_OK;
+    l_same = l_loaded && sameSchedule(l_updated.getGainScheduleConfig(), l_schedule) && serialize(l_updated) == serialize(l_expected);
+    std::printf("schedule update  fromJson %s, round trip %s\n", l_loaded ? "ok" : "FAILED", l_same ? "ok" : "FAILED");
+    l_ok = l_same && l_ok;
+
+    return l_ok ? 0 : 1;
+}
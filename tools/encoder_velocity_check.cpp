@@ -0,0 +1,210 @@
+// Host check of EncoderVelocityEstimator, read through FakeEncoder the way WheelOdometry reads the
+// PCNT encoders: one count per wheel per control cycle.
+//
+// Build: g++ -std=c++20 -O2 -Itools/host -Imain -Imain/HardwareManager -o encoder_velocity_check
+//            tools/encoder_velocity_check.cpp main/EncoderVelocityEstimator.cpp
+// Usage: ./encoder_velocity_check [counts_per_rev=1320] [period_ms=10]
+//
+// The default encoder is an 11 line Hall sensor on a 30:1 gearmotor, counted 4x. At 10 ms a cycle
+// sees four counts at 1.9 rad/s, which is where the estimator switches from the period method to
+// the count method. It switches back a count lower, at 1.4 rad/s.
+//
+// Checked:
+//   - constant speeds from 0.05 to 20 rad/s, both directions and a reversed encoder: the mean
+//     estimate within MEAN_TOLERANCE and no sample off by a count per cycle, the error of the count
+//     method at its worst. What the count method alone would read is printed next to it. The
+//     period method's windows start and end on whole cycles, which reads a few percent fast
+//     where a cycle sees less than a count; on the default encoder the mean is within 1.2%.
+//     Below one count per STOP_TIMEOUT the wheel reads as stopped, those speeds are skipped
+//   - a ramp through the switchover: the estimate follows within RAMP_TOLERANCE, the period
+//     method's window trails the wheel by a cycle or two, and does not jump when the method changes
+//   - the wheel stops dead from several speeds: from the stop on the estimate never exceeds one
+//     count over the time since the last edge, and it is exactly zero STOP_TIMEOUT after it
+
+#include "FakeEncoder.hpp"
+#include "include/EncoderVelocityEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr double MEAN_TOLERANCE = 0.05;
+constexpr double RAMP_TOLERANCE = 0.05;
+constexpr double STOP_TIMEOUT = 0.25;
+constexpr int COUNT_METHOD_THRESHOLD = 4;
+
+struct Wheel {
+    Wheel(int p_countsPerRevolution, bool p_reversed)
+        : encoder(EncoderConfig{0, 0, 1, p_countsPerRevolution, 1000, p_reversed}), angle(0.0), time(0) {
+        encoder.init();
+        estimator.setCountsPerRevolution(encoder.getCountsPerRevolution());
+        int32_t l_count = 0;
+        encoder.getCount(l_count);
+        estimator.reset(l_count, time);
+    }
+
+    // One control cycle at p_speed, returns the estimate and the counts the cycle saw
+    float cycle(double p_speed, double p_period, int32_t& p_delta) {
+        angle += p_speed * p_period;
+        time += static_cast<int64_t>(std::llround(p_period * 1e6));
+        encoder.setAngle(angle);
+        int32_t l_count = 0;
+        encoder.getCount(l_count);
+        p_delta = l_count - lastCount;
+        lastCount = l_count;
+        return estimator.update(l_count, time);
+    }
+
+    FakeEncoder encoder;
+    EncoderVelocityEstimator estimator;
+    double angle;
+    int64_t time;
+    int32_t lastCount = 0;
+};
+
+struct Setup {
+    int countsPerRevolution;
+    double period;
+    double radiansPerCount() const { return 2.0 * M_PI / countsPerRevolution; }
+};
+
+// Mean and worst case of the estimate at one speed, after a second to settle
+bool checkSpeed(const Setup& p_setup, double p_speed, bool p_reversed) {
+    if (std::fabs(p_speed) * STOP_TIMEOUT < p_setup.radiansPerCount()) {
+        std::printf("%7.2f      below one count per %.2f s, skipped\n", p_speed, STOP_TIMEOUT);
+        return true;
+    }
+    Wheel l_wheel(p_setup.countsPerRevolution, p_reversed);
+    int l_settle = static_cast<int>(1.0 / p_setup.period);
+    int l_cycles = static_cast<int>(4.0 / p_setup.period);
+
+    double l_sum = 0.0;
+    double l_worst = 0.0;
+    double l_worstCountOnly = 0.0;
+    for (int i = 0; i < l_settle + l_cycles; i++) {
+        int32_t l_delta = 0;
+        double l_estimate = l_wheel.cycle(p_speed, p_setup.period, l_delta);
+        if (i < l_settle) {
+            continue;
+        }
+        l_sum += l_estimate;
+        l_worst = std::max(l_worst, std::fabs(l_estimate - p_speed));
+        l_worstCountOnly = std::max(l_worstCountOnly, std::fabs(l_delta * p_setup.radiansPerCount() / p_setup.period - p_speed));
+    }
+
+    double l_mean = l_sum / l_cycles;
+    double l_meanError = (l_mean - p_speed) / p_speed;
+    bool l_ok = std::fabs(l_meanError) <= MEAN_TOLERANCE && l_worst < p_setup.radiansPerCount() / p_setup.period;
+    std::printf("%7.2f %s  %7.3f  %+6.2f%%  %6.3f   %6.3f  %s\n", p_speed, p_reversed ? "rev" : "   ", l_mean,
+                100.0 * l_meanError, l_worst, l_worstCountOnly, l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+// From a third to three times the switchover speed over five seconds
+bool checkRamp(const Setup& p_setup) {
+    double l_switchover = COUNT_METHOD_THRESHOLD * p_setup.radiansPerCount() / p_setup.period;
+    double l_from = l_switchover / 3.0;
+    double l_to = l_switchover * 3.0;
+    int l_cycles = static_cast<int>(5.0 / p_setup.period);
+
+    Wheel l_wheel(p_setup.countsPerRevolution, false);
+    int32_t l_delta = 0;
+    for (int i = 0; i < static_cast<int>(1.0 / p_setup.period); i++) {
+        l_wheel.cycle(l_from, p_setup.period, l_delta);
+    }
+
+    // Single estimates may be a count off, so the estimate and the speed both go through the same
+    // 100 ms low-pass before they are compared. Neighbouring estimates must not jump further than
+    // that count either way plus what the wheel sped up by.
+    double l_smoothedEstimate = l_from;
+    double l_smoothedSpeed = l_from;
+    double l_previous = l_from;
+    double l_worstTracking = 0.0;
+    double l_largestStep = 0.0;
+    double l_alpha = p_setup.period / 0.1;
+    for (int i = 0; i < l_cycles; i++) {
+        double l_speed = l_from + (l_to - l_from) * i / l_cycles;
+        double l_estimate = l_wheel.cycle(l_speed, p_setup.period, l_delta);
+        l_smoothedEstimate += l_alpha * (l_estimate - l_smoothedEstimate);
+        l_smoothedSpeed += l_alpha * (l_speed - l_smoothedSpeed);
+        l_worstTracking = std::max(l_worstTracking, std::fabs(l_smoothedEstimate - l_smoothedSpeed) / l_smoothedSpeed);
+        l_largestStep = std::max(l_largestStep, std::fabs(l_estimate - l_previous));
+        l_previous = l_estimate;
+    }
+
+    double l_stepLimit = 2.0 * p_setup.radiansPerCount() / p_setup.period + (l_to - l_from) / l_cycles;
+    bool l_ok = l_worstTracking <= RAMP_TOLERANCE && l_largestStep <= l_stepLimit;
+    std::printf("Ramp %.2f -> %.2f rad/s: smoothed estimate within %.1f%%, largest step %.3f rad/s (limit %.3f)  %s\n",
+                l_from, l_to, 100.0 * l_worstTracking, l_largestStep, l_stepLimit, l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+// Runs at p_speed, then the wheel stops dead between two edges
+bool checkStop(const Setup& p_setup, double p_speed) {
+    Wheel l_wheel(p_setup.countsPerRevolution, false);
+    int32_t l_delta = 0;
+    int64_t l_lastEdge = 0;
+    for (int i = 0; i < static_cast<int>(1.0 / p_setup.period); i++) {
+        l_wheel.cycle(p_speed, p_setup.period, l_delta);
+        if (l_delta != 0) {
+            l_lastEdge = l_wheel.time;
+        }
+    }
+    float l_before = l_wheel.estimator.getVelocity();
+
+    bool l_bounded = true;
+    bool l_zeroAtTimeout = true;
+    double l_zeroAfter = NAN;
+    int l_cycles = static_cast<int>(2.0 * STOP_TIMEOUT / p_setup.period);
+    for (int i = 1; i <= l_cycles; i++) {
+        double l_estimate = l_wheel.cycle(0.0, p_setup.period, l_delta);
+        double l_sinceEdge = (l_wheel.time - l_lastEdge) * 1e-6;
+        l_bounded = l_bounded && std::fabs(l_estimate) <= p_setup.radiansPerCount() / l_sinceEdge + 1e-4;
+        if (l_sinceEdge >= STOP_TIMEOUT - 1e-9) {
+            l_zeroAtTimeout = l_zeroAtTimeout && l_estimate == 0.0;
+        }
+        if (l_estimate == 0.0 && std::isnan(l_zeroAfter)) {
+            l_zeroAfter = i * p_setup.period;
+        }
+    }
+
+    bool l_ok = l_bounded && l_zeroAtTimeout;
+    std::printf("Stop from %5.2f rad/s (estimate %6.3f): under one count over the time since the edge %s, "
+                "zero %.2f s after the stop  %s\n",
+                p_speed, l_before, l_bounded ? "yes" : "NO", l_zeroAfter, l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Setup l_setup {argc > 1 ? std::atoi(argv[1]) : 1320, (argc > 2 ? std::atof(argv[2]) : 10.0) * 1e-3};
+    if (l_setup.countsPerRevolution <= 0 || l_setup.period <= 0.0) {
+        std::printf("counts per revolution and period must be positive\n");
+        return 1;
+    }
+    std::printf("%d counts/rev, %.1f ms cycle, count method from %.2f rad/s\n\n", l_setup.countsPerRevolution,
+                l_setup.period * 1e3, COUNT_METHOD_THRESHOLD * l_setup.radiansPerCount() / l_setup.period);
+
+    std::printf("  rad/s       mean    error   worst  count-only  (worst errors in rad/s)\n");
+    bool l_ok = true;
+    for (double l_speed : {0.05, 0.2, 0.5, 1.0, 1.5, 1.8, 2.0, 2.5, 5.0, 10.0, 20.0}) {
+        l_ok = checkSpeed(l_setup, l_speed, false) && l_ok;
+    }
+    l_ok = checkSpeed(l_setup, -0.5, false) && l_ok;
+    l_ok = checkSpeed(l_setup, -5.0, false) && l_ok;
+    l_ok = checkSpeed(l_setup, 0.5, true) && l_ok;
+    l_ok = checkSpeed(l_setup, -5.0, true) && l_ok;
+    std::printf("\n");
+
+    l_ok = checkRamp(l_setup) && l_ok;
+    std::printf("\n");
+
+    for (double l_speed : {0.05, 0.5, 2.0, 20.0}) {
+        l_ok = checkStop(l_setup, l_speed) && l_ok;
+    }
+    return l_ok ? 0 : 1;
+}
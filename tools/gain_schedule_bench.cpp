@@ -0,0 +1,100 @@
+// Host benchmark of the gain schedule lookup that runs inside the control cycle.
+//
+// Build: g++ -std=c++17 -O2 -Imain -o gain_schedule_bench tools/gain_schedule_bench.cpp main/GainSchedule.cpp
+// Usage: ./gain_schedule_bench [iterations]
+//
+// Checks that the table is reproduced exactly at the breakpoints and clamped outside
+// them, then times evaluate() over random operating points for a 1-D and a full
+// MAX_POINTS x MAX_POINTS schedule.
+
+#include "include/GainSchedule.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+GainScheduleConfig makeSchedule(int p_errorPoints, int p_speedPoints) {
+    GainScheduleConfig l_config;
+    l_config.enabled = true;
+    l_config.errorPoints = p_errorPoints;
+    l_config.speedPoints = p_speedPoints;
+    for (int e = 0; e < p_errorPoints; e++) l_config.errorBreakpoints[e] = 45.0f * e / (p_errorPoints - 1);
+    for (int s = 0; s < p_speedPoints; s++) l_config.speedBreakpoints[s] = 2.0f * s;
+    for (int s = 0; s < p_speedPoints; s++) {
+        for (int e = 0; e < p_errorPoints; e++) {
+            l_config.kpScale[s][e] = 1.0f + 0.1f * e + 0.01f * s;
+            l_config.kiScale[s][e] = 1.0f - 0.05f * e;
+            l_config.kdScale[s][e] = 1.0f + 0.2f * s;
+        }
+    }
+    return l_config;
+}
+
+bool checkBreakpoints(const GainSchedule& p_schedule, const GainScheduleConfig& p_config) {
+    bool l_ok = true;
+    for (int s = 0; s < p_config.speedPoints; s++) {
+        for (int e = 0; e < p_config.errorPoints; e++) {
+            GainScale l_scale = p_schedule.evaluate(p_config.errorBreakpoints[e], p_config.speedBreakpoints[s]);
+            if (std::fabs(l_scale.kp - p_config.kpScale[s][e]) > 1e-5f ||
+                std::fabs(l_scale.ki - p_config.kiScale[s][e]) > 1e-5f ||
+                std::fabs(l_scale.kd - p_config.kdScale[s][e]) > 1e-5f) {
+                std::printf("  mismatch at speed %d, error %d\n", s, e);
+                l_ok = false;
+            }
+        }
+    }
+    // Beyond the last breakpoints the table is held, negative inputs fold onto their magnitude
+    int l_lastE = p_config.errorPoints - 1, l_lastS = p_config.speedPoints - 1;
+    GainScale l_outside = p_schedule.evaluate(-1000.0f, 1000.0f);
+    if (std::fabs(l_outside.kp - p_config.kpScale[l_lastS][l_lastE]) > 1e-5f) {
+        std::printf("  not clamped outside the table\n");
+        l_ok = false;
+    }
+    return l_ok;
+}
+
+void benchmark(const char* p_name, const GainScheduleConfig& p_config, long p_iterations) {
+    GainSchedule l_schedule;
+    if (!l_schedule.setConfig(p_config)) {
+        std::printf("%s: schedule rejected\n", p_name);
+        std::exit(1);
+    }
+    bool l_ok = checkBreakpoints(l_schedule, p_config);
+
+    std::mt19937 l_random(42);
+    std::uniform_real_distribution<float> l_error(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> l_speed(-20.0f, 20.0f);
+    std::vector<float> l_errors(4096), l_speeds(4096);
+    for (size_t i = 0; i < l_errors.size(); i++) {
+        l_errors[i] = l_error(l_random);
+        l_speeds[i] = l_speed(l_random);
+    }
+
+    volatile float l_sink = 0.0f;
+    auto l_start = std::chrono::steady_clock::now();
+    for (long i = 0; i < p_iterations; i++) {
+        GainScale l_scale = l_schedule.evaluate(l_errors[i & 4095], l_speeds[i & 4095]);
+        l_sink = l_sink + l_scale.kp + l_scale.ki + l_scale.kd;
+    }
+    auto l_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - l_start).count();
+
+    std::printf("%-12s %dx%d  %s  %.1f ns/lookup\n", p_name, p_config.speedPoints, p_config.errorPoints,
+                l_ok ? "exact at breakpoints" : "FAILED", l_elapsed / p_iterations);
+    if (!l_ok) std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    long l_iterations = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+    benchmark("1-D", makeSchedule(5, 1), l_iterations);
+    benchmark("2-D", makeSchedule(5, 3), l_iterations);
+    benchmark("2-D full", makeSchedule(GainScheduleConfig::MAX_POINTS, GainScheduleConfig::MAX_POINTS), l_iterations);
+    return 0;
+}
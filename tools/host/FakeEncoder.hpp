@@ -0,0 +1,62 @@
+#pragma once
+
+// IEncoder over a simulated wheel. The caller sets the wheel angle, the count follows it the way
+// the PCNT unit follows quadrature edges: whole counts only, counted against the wheel when the
+// encoder is mounted reversed and flipped back as PCNTEncoder does.
+
+#include "interface/IEncoder.hpp"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <cmath>
+
+class FakeEncoder : public IEncoder {
+    public:
+        FakeEncoder(const EncoderConfig& p_config) : m_config(p_config), m_raw(0), m_failReads(false) {}
+
+        //IHalComponent
+        esp_err_t init() override {
+            if (m_config.countsPerRevolution <= 0) {
+                setStateError();
+                return ESP_ERR_INVALID_ARG;
+            }
+            m_raw = 0;
+            setStateInitialized();
+            return ESP_OK;
+        }
+
+        //IEncoder
+        esp_err_t getCount(int32_t& p_count) const override {
+            if (!isInitialized()) {
+                return notInitialized();
+            }
+            if (m_failReads) {
+                return ESP_FAIL;
+            }
+            p_count = m_config.reversed ? -m_raw : m_raw;
+            return ESP_OK;
+        }
+
+        int getCountsPerRevolution() const override { return m_config.countsPerRevolution; }
+
+        // Wheel angle in rad since init, positive forwards
+        void setAngle(double p_angle) {
+            int32_t l_count = static_cast<int32_t>(std::floor(p_angle * m_config.countsPerRevolution / (2.0 * M_PI)));
+            m_raw = m_config.reversed ? -l_count : l_count;
+        }
+
+        // Reads fail until cleared, as a stalled PCNT driver would
+        void failReads(bool p_fail) { m_failReads = p_fail; }
+
+    private:
+        static constexpr const char* TAG = "FakeEncoder";
+
+        esp_err_t notInitialized() const override {
+            ESP_LOGE(TAG, "Encoder %d is not initialized", m_config.encoderId);
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        const EncoderConfig m_config;
+        int32_t m_raw;
+        bool m_failReads;
+};
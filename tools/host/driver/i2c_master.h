@@ -0,0 +1,12 @@
+#pragma once
+
+// Types only, for the HAL config structs
+
+#include "driver/gpio.h"
+
+typedef int i2c_port_num_t;
+typedef enum { I2C_ADDR_BIT_LEN_7, I2C_ADDR_BIT_LEN_10 } i2c_addr_bit_len_t;
+typedef enum { I2C_CLK_SRC_DEFAULT } i2c_clock_source_t;
+
+#define I2C_NUM_0 0
+#define I2C_NUM_1 1
@@ -0,0 +1,277 @@
+#pragma once
+
+// The MCPWM driver calls the HAL makes, recorded instead of driving a peripheral. Every object the
+// driver would allocate lives in host_mcpwm() until host_mcpwm_reset(). Compare values follow the
+// hardware: set_compare_value writes a shadow register that a comparator created with
+// update_cmp_on_tez latches when host_mcpwm_timer_zero() is called for its operator's timer, and
+// right away otherwise. host_mcpwm().afterCall runs after every driver call, so a check can put a
+// timer zero between any two of them.
+
+#include "esp_err.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef enum {
+    MCPWM_TIMER_COUNT_MODE_PAUSE,
+    MCPWM_TIMER_COUNT_MODE_UP,
+    MCPWM_TIMER_COUNT_MODE_DOWN,
+    MCPWM_TIMER_COUNT_MODE_UP_DOWN,
+} mcpwm_timer_count_mode_t;
+
+typedef enum { MCPWM_TIMER_CLK_SRC_DEFAULT } mcpwm_timer_clock_source_t;
+typedef enum { MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_DIRECTION_DOWN } mcpwm_timer_direction_t;
+typedef enum { MCPWM_TIMER_EVENT_EMPTY, MCPWM_TIMER_EVENT_FULL, MCPWM_TIMER_EVENT_INVALID } mcpwm_timer_event_t;
+typedef enum { MCPWM_GEN_ACTION_KEEP, MCPWM_GEN_ACTION_LOW, MCPWM_GEN_ACTION_HIGH, MCPWM_GEN_ACTION_TOGGLE } mcpwm_generator_action_t;
+typedef enum { MCPWM_TIMER_STOP_EMPTY, MCPWM_TIMER_STOP_FULL, MCPWM_TIMER_START_NO_STOP } mcpwm_timer_start_stop_cmd_t;
+
+typedef struct mcpwm_timer_t* mcpwm_timer_handle_t;
+typedef struct mcpwm_oper_t* mcpwm_oper_handle_t;
+typedef struct mcpwm_cmpr_t* mcpwm_cmpr_handle_t;
+typedef struct mcpwm_gen_t* mcpwm_gen_handle_t;
+
+typedef struct {
+    int group_id;
+    mcpwm_timer_clock_source_t clk_src;
+    uint32_t resolution_hz;
+    mcpwm_timer_count_mode_t count_mode;
+    uint32_t period_ticks;
+} mcpwm_timer_config_t;
+
+typedef struct {
+    int group_id;
+} mcpwm_operator_config_t;
+
+typedef struct {
+    struct {
+        uint32_t update_cmp_on_tez : 1;
+        uint32_t update_cmp_on_tep : 1;
+    } flags;
+} mcpwm_comparator_config_t;
+
+typedef struct {
+    int gen_gpio_num;
+} mcpwm_generator_config_t;
+
+typedef struct {
+    uint32_t posedge_delay_ticks;
+    uint32_t negedge_delay_ticks;
+} mcpwm_dead_time_config_t;
+
+typedef struct {
+    mcpwm_timer_direction_t direction;
+    mcpwm_cmpr_handle_t comparator;
+    mcpwm_generator_action_t action;
+} mcpwm_gen_compare_event_action_t;
+
+typedef struct {
+    mcpwm_timer_direction_t direction;
+    mcpwm_timer_event_t event;
+    mcpwm_generator_action_t action;
+} mcpwm_gen_timer_event_action_t;
+
+#define MCPWM_GEN_COMPARE_EVENT_ACTION(dir, cmp, act) mcpwm_gen_compare_event_action_t{dir, cmp, act}
+#define MCPWM_GEN_TIMER_EVENT_ACTION(dir, ev, act) mcpwm_gen_timer_event_action_t{dir, ev, act}
+
+struct mcpwm_timer_t {
+    mcpwm_timer_config_t config;
+    bool enabled;
+    bool started;
+};
+
+struct mcpwm_oper_t {
+    int groupId;
+    mcpwm_timer_t* timer;
+};
+
+struct mcpwm_cmpr_t {
+    mcpwm_oper_t* oper;
+    bool updateOnZero;
+    uint32_t shadow;
+    uint32_t active;
+    int writes;
+};
+
+struct mcpwm_gen_t {
+    mcpwm_oper_t* oper;
+    int gpio;
+    std::vector<mcpwm_gen_compare_event_action_t> compareActions;
+    std::vector<mcpwm_gen_timer_event_action_t> timerActions;
+    bool deadTimeSet;
+    mcpwm_gen_t* deadTimeOut;
+    mcpwm_dead_time_config_t deadTime;
+};
+
+struct HostMcpwm {
+    std::vector<std::unique_ptr<mcpwm_timer_t>> timers;
+    std::vector<std::unique_ptr<mcpwm_oper_t>> operators;
+    std::vector<std::unique_ptr<mcpwm_cmpr_t>> comparators;
+    std::vector<std::unique_ptr<mcpwm_gen_t>> generators;
+    std::function<void(const char*)> afterCall;
+    std::string failCall;   // A driver call by this name returns ESP_FAIL
+
+    mcpwm_gen_t* generatorOn(int p_gpio) const {
+        for (const auto& l_generator : generators) {
+            if (l_generator->gpio == p_gpio) {
+                return l_generator.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // The comparator the generator's compare actions refer to
+    mcpwm_cmpr_t* comparatorOf(const mcpwm_gen_t* p_generator) const {
+        return p_generator && !p_generator->compareActions.empty() ? p_generator->compareActions.front().comparator : nullptr;
+    }
+};
+
+inline HostMcpwm& host_mcpwm() {
+    static HostMcpwm s_state;
+    return s_state;
+}
+
+inline void host_mcpwm_reset() {
+    host_mcpwm() = HostMcpwm();
+}
+
+// Start of a PWM period: comparators on this timer that update on zero take their shadow value
+inline void host_mcpwm_timer_zero(mcpwm_timer_handle_t p_timer) {
+    for (const auto& l_comparator : host_mcpwm().comparators) {
+        if (l_comparator->updateOnZero && l_comparator->oper && l_comparator->oper->timer == p_timer) {
+            l_comparator->active = l_comparator->shadow;
+        }
+    }
+}
+
+inline esp_err_t host_mcpwm_call(const char* p_name, esp_err_t p_result = ESP_OK) {
+    HostMcpwm& l_state = host_mcpwm();
+    if (l_state.failCall == p_name) {
+        p_result = ESP_FAIL;
+    }
+    if (l_state.afterCall) {
+        l_state.afterCall(p_name);
+    }
+    return p_result;
+}
+
+inline esp_err_t mcpwm_new_timer(const mcpwm_timer_config_t* p_config, mcpwm_timer_handle_t* p_timer) {
+    if (!p_config || !p_timer || p_config->resolution_hz == 0 || p_config->period_ticks == 0) {
+        return host_mcpwm_call("mcpwm_new_timer", ESP_ERR_INVALID_ARG);
+    }
+    host_mcpwm().timers.push_back(std::make_unique<mcpwm_timer_t>(mcpwm_timer_t{*p_config, false, false}));
+    *p_timer = host_mcpwm().timers.back().get();
+    return host_mcpwm_call("mcpwm_new_timer");
+}
+
+inline esp_err_t mcpwm_timer_enable(mcpwm_timer_handle_t p_timer) {
+    if (!p_timer || p_timer->enabled) {
+        return host_mcpwm_call("mcpwm_timer_enable", ESP_ERR_INVALID_STATE);
+    }
+    p_timer->enabled = true;
+    return host_mcpwm_call("mcpwm_timer_enable");
+}
+
+inline esp_err_t mcpwm_timer_start_stop(mcpwm_timer_handle_t p_timer, mcpwm_timer_start_stop_cmd_t p_command) {
+    if (!p_timer || !p_timer->enabled) {
+        return host_mcpwm_call("mcpwm_timer_start_stop", ESP_ERR_INVALID_STATE);
+    }
+    p_timer->started = p_command == MCPWM_TIMER_START_NO_STOP;
+    return host_mcpwm_call("mcpwm_timer_start_stop");
+}
+
+inline esp_err_t mcpwm_new_operator(const mcpwm_operator_config_t* p_config, mcpwm_oper_handle_t* p_operator) {
+    if (!p_config || !p_operator) {
+        return host_mcpwm_call("mcpwm_new_operator", ESP_ERR_INVALID_ARG);
+    }
+    host_mcpwm().operators.push_back(std::make_unique<mcpwm_oper_t>(mcpwm_oper_t{p_config->group_id, nullptr}));
+    *p_operator = host_mcpwm().operators.back().get();
+    return host_mcpwm_call("mcpwm_new_operator");
+}
+
+inline esp_err_t mcpwm_operator_connect_timer(mcpwm_oper_handle_t p_operator, mcpwm_timer_handle_t p_timer) {
+    // Operator and timer have to be in the same group
+    if (!p_operator || !p_timer || p_operator->groupId != p_timer->config.group_id) {
+        return host_mcpwm_call("mcpwm_operator_connect_timer", ESP_ERR_INVALID_ARG);
+    }
+    p_operator->timer = p_timer;
+    return host_mcpwm_call("mcpwm_operator_connect_timer");
+}
+
+inline esp_err_t mcpwm_new_comparator(mcpwm_oper_handle_t p_operator, const mcpwm_comparator_config_t* p_config,
+                                      mcpwm_cmpr_handle_t* p_comparator) {
+    if (!p_operator || !p_config || !p_comparator) {
+        return host_mcpwm_call("mcpwm_new_comparator", ESP_ERR_INVALID_ARG);
+    }
+    host_mcpwm().comparators.push_back(
+        std::make_unique<mcpwm_cmpr_t>(mcpwm_cmpr_t{p_operator, p_config->flags.update_cmp_on_tez != 0, 0, 0, 0}));
+    *p_comparator = host_mcpwm().comparators.back().get();
+    return host_mcpwm_call("mcpwm_new_comparator");
+}
+
+inline esp_err_t mcpwm_comparator_set_compare_value(mcpwm_cmpr_handle_t p_comparator, uint32_t p_ticks) {
+    if (!p_comparator) {
+        return host_mcpwm_call("mcpwm_comparator_set_compare_value", ESP_ERR_INVALID_ARG);
+    }
+    // Above the timer's period the driver refuses the value
+    mcpwm_timer_t* l_timer = p_comparator->oper->timer;
+    if (l_timer && p_ticks > l_timer->config.period_ticks) {
+        return host_mcpwm_call("mcpwm_comparator_set_compare_value", ESP_ERR_INVALID_ARG);
+    }
+    esp_err_t l_ret = host_mcpwm_call("mcpwm_comparator_set_compare_value");
+    if (l_ret == ESP_OK) {
+        p_comparator->shadow = p_ticks;
+        p_comparator->writes++;
+        if (!p_comparator->updateOnZero) {
+            p_comparator->active = p_ticks;
+        }
+    }
+    return l_ret;
+}
+
+inline esp_err_t mcpwm_new_generator(mcpwm_oper_handle_t p_operator, const mcpwm_generator_config_t* p_config,
+                                     mcpwm_gen_handle_t* p_generator) {
+    if (!p_operator || !p_config || !p_generator) {
+        return host_mcpwm_call("mcpwm_new_generator", ESP_ERR_INVALID_ARG);
+    }
+    host_mcpwm().generators.push_back(std::make_unique<mcpwm_gen_t>());
+    mcpwm_gen_t* l_generator = host_mcpwm().generators.back().get();
+    l_generator->oper = p_operator;
+    l_generator->gpio = p_config->gen_gpio_num;
+    l_generator->deadTimeSet = false;
+    l_generator->deadTimeOut = nullptr;
+    l_generator->deadTime = {};
+    *p_generator = l_generator;
+    return host_mcpwm_call("mcpwm_new_generator");
+}
+
+inline esp_err_t mcpwm_generator_set_action_on_compare_event(mcpwm_gen_handle_t p_generator,
+                                                             mcpwm_gen_compare_event_action_t p_action) {
+    if (!p_generator || !p_action.comparator || p_action.comparator->oper != p_generator->oper) {
+        return host_mcpwm_call("mcpwm_generator_set_action_on_compare_event", ESP_ERR_INVALID_ARG);
+    }
+    p_generator->compareActions.push_back(p_action);
+    return host_mcpwm_call("mcpwm_generator_set_action_on_compare_event");
+}
+
+inline esp_err_t mcpwm_generator_set_action_on_timer_event(mcpwm_gen_handle_t p_generator,
+                                                           mcpwm_gen_timer_event_action_t p_action) {
+    if (!p_generator) {
+        return host_mcpwm_call("mcpwm_generator_set_action_on_timer_event", ESP_ERR_INVALID_ARG);
+    }
+    p_generator->timerActions.push_back(p_action);
+    return host_mcpwm_call("mcpwm_generator_set_action_on_timer_event");
+}
+
+inline esp_err_t mcpwm_generator_set_dead_time(mcpwm_gen_handle_t p_in, mcpwm_gen_handle_t p_out,
+                                               const mcpwm_dead_time_config_t* p_config) {
+    if (!p_in || !p_out || !p_config) {
+        return host_mcpwm_call("mcpwm_generator_set_dead_time", ESP_ERR_INVALID_ARG);
+    }
+    p_out->deadTimeSet = true;
+    p_out->deadTimeOut = p_out;
+    p_out->deadTime = *p_config;
+    return host_mcpwm_call("mcpwm_generator_set_dead_time");
+}
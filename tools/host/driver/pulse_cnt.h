@@ -0,0 +1,6 @@
+#pragma once
+
+// Types only, the host reads encoders through FakeEncoder instead of a PCNT unit
+
+typedef struct pcnt_unit_t* pcnt_unit_handle_t;
+typedef struct pcnt_chan_t* pcnt_channel_handle_t;
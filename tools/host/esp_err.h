@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-ins for the ESP-IDF headers the control code includes, so tools/ can build the real
+// sources from main/ with g++. Put this directory on the include path ahead of main:
+//   g++ -std=c++17 -Itools/host -Imain ...
+// Everything runs on the calling thread: queues and semaphores never block, a call that would
+// wait returns at once with pdFALSE.
+
+#include <cstdint>
+
+typedef int esp_err_t;
+
+#define ESP_OK                      0
+#define ESP_FAIL                    -1
+#define ESP_ERR_NO_MEM              0x101
+#define ESP_ERR_INVALID_ARG         0x102
+#define ESP_ERR_INVALID_STATE       0x103
+#define ESP_ERR_INVALID_SIZE        0x104
+#define ESP_ERR_NOT_FOUND           0x105
+#define ESP_ERR_NOT_SUPPORTED       0x106
+#define ESP_ERR_TIMEOUT             0x107
+#define ESP_ERR_INVALID_RESPONSE    0x108
+
+inline const char* esp_err_to_name(esp_err_t p_error) {
+    switch (p_error) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+#define ESP_ERROR_CHECK(x) do { esp_err_t l_rc = (x); if (l_rc != ESP_OK) { abort(); } } while (0)
@@ -0,0 +1,18 @@
+#pragma once
+
+// Types only, enough for the headers that pass requests around. Nothing on the host serves HTTP.
+
+#include "esp_err.h"
+
+#include <cstddef>
+
+typedef void* httpd_handle_t;
+
+typedef struct httpd_req {
+    httpd_handle_t handle;
+    int method;
+    const char uri[513];
+    size_t content_len;
+    void* aux;
+    void* user_ctx;
+} httpd_req_t;
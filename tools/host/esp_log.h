@@ -0,0 +1,19 @@
+#pragma once
+
+// Errors and warnings go to stderr, info only with HOST_LOG_INFO defined, debug and verbose never
+
+#include <cstdio>
+
+typedef enum { ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE } esp_log_level_t;
+
+inline void esp_log_level_set(const char*, esp_log_level_t) {}
+
+#define ESP_LOGE(tag, format, ...) fprintf(stderr, "E (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fprintf(stderr, "W (%s) " format "\n", tag, ##__VA_ARGS__)
+#ifdef HOST_LOG_INFO
+#define ESP_LOGI(tag, format, ...) fprintf(stderr, "I (%s) " format "\n", tag, ##__VA_ARGS__)
+#else
+#define ESP_LOGI(tag, format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); (void)(tag); } while (0)
+#endif
+#define ESP_LOGD(tag, format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); (void)(tag); } while (0)
+#define ESP_LOGV(tag, format, ...) do { if (0) fprintf(stderr, format, ##__VA_ARGS__); (void)(tag); } while (0)
@@ -0,0 +1,30 @@
+#pragma once
+
+// Microseconds since the first call. A simulation that steps its own time sets host_timer_set().
+
+#include <chrono>
+#include <cstdint>
+
+inline int64_t& host_timer_offset() {
+    static int64_t s_offset = 0;
+    return s_offset;
+}
+
+inline bool& host_timer_manual() {
+    static bool s_manual = false;
+    return s_manual;
+}
+
+inline int64_t esp_timer_get_time() {
+    if (host_timer_manual()) {
+        return host_timer_offset();
+    }
+    static const auto s_start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+// From here on esp_timer_get_time() returns p_us until the next call
+inline void host_timer_set(int64_t p_us) {
+    host_timer_manual() = true;
+    host_timer_offset() = p_us;
+}
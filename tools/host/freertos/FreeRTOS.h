@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE      1
+#define pdFALSE     0
+#define pdPASS      pdTRUE
+#define pdFAIL      pdFALSE
+
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           0xffffffffu
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskIDLE_PRIORITY        0
+
+#define BIT0    0x01
+#define BIT1    0x02
+#define BIT2    0x04
+#define BIT3    0x08
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+
+// A queue of copies, semaphores are queues of empty items as in FreeRTOS
+struct QueueDefinition {
+    size_t length;
+    size_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+typedef QueueDefinition* QueueHandle_t;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+inline QueueHandle_t xQueueCreate(UBaseType_t p_length, UBaseType_t p_itemSize) {
+    return new QueueDefinition{p_length, p_itemSize, {}};
+}
+
+inline void vQueueDelete(QueueHandle_t p_queue) {
+    delete p_queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t p_queue, const void* p_item, TickType_t) {
+    if (p_queue->items.size() >= p_queue->length) {
+        return pdFALSE;
+    }
+    const uint8_t* l_bytes = static_cast<const uint8_t*>(p_item);
+    p_queue->items.emplace_back(l_bytes, l_bytes ? l_bytes + p_queue->itemSize : l_bytes);
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSendToBack(QueueHandle_t p_queue, const void* p_item, TickType_t p_wait) {
+    return xQueueSend(p_queue, p_item, p_wait);
+}
+
+inline BaseType_t xQueueOverwrite(QueueHandle_t p_queue, const void* p_item) {
+    p_queue->items.clear();
+    return xQueueSend(p_queue, p_item, 0);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t p_queue, void* p_item, TickType_t) {
+    if (p_queue->items.empty()) {
+        return pdFALSE;
+    }
+    if (p_item != nullptr) {
+        memcpy(p_item, p_queue->items.front().data(), p_queue->itemSize);
+    }
+    p_queue->items.pop_front();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueuePeek(QueueHandle_t p_queue, void* p_item, TickType_t) {
+    if (p_queue->items.empty()) {
+        return pdFALSE;
+    }
+    memcpy(p_item, p_queue->items.front().data(), p_queue->itemSize);
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t p_queue) {
+    return static_cast<UBaseType_t>(p_queue->items.size());
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t p_queue) {
+    p_queue->items.clear();
+    return pdPASS;
+}
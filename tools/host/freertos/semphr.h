@@ -0,0 +1,27 @@
+#pragma once
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    SemaphoreHandle_t l_mutex = xQueueCreate(1, 0);
+    xQueueSend(l_mutex, nullptr, 0);
+    return l_mutex;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return xQueueCreate(1, 0);
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t p_semaphore, TickType_t p_wait) {
+    return xQueueReceive(p_semaphore, nullptr, p_wait);
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t p_semaphore) {
+    return xQueueSend(p_semaphore, nullptr, 0);
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t p_semaphore) {
+    vQueueDelete(p_semaphore);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// No scheduler: tasks are never started, the tick count follows esp_timer_get_time()
+
+#include "FreeRTOS.h"
+#include "esp_timer.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline TickType_t xTaskGetTickCount() {
+    return static_cast<TickType_t>(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* p_handle) {
+    if (p_handle) {
+        *p_handle = nullptr;
+    }
+    return pdFAIL;
+}
+
+inline void vTaskDelete(TaskHandle_t) {}
+inline void vTaskDelay(TickType_t) {}
+inline void vTaskDelayUntil(TickType_t*, TickType_t) {}
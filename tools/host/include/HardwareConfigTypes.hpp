@@ -0,0 +1,7 @@
+#pragma once
+
+// The HAL includes its headers as include/ while the directory is Include/, which only resolves on
+// a case-insensitive file system. This forwards to the real one, everything else under include/
+// falls through to -Imain.
+
+#include "../../../main/HardwareManager/Include/HardwareConfigTypes.hpp"
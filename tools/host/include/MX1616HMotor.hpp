@@ -0,0 +1,5 @@
+#pragma once
+
+// See HardwareConfigTypes.hpp
+
+#include "../../../main/HardwareManager/Components/Include/MX1616HMotor.hpp"
@@ -0,0 +1,367 @@
+// Host measurement of cJSON request parsing on the shared heap versus in a JsonArena.
+//
+// Needs the cJSON sources, which ship with ESP-IDF:
+//   gcc -O2 -c $IDF_PATH/components/json/cJSON/cJSON.c -o cJSON.o
+//   g++ -std=c++17 -O2 -Imain -I$IDF_PATH/components/json/cJSON -o json_arena_bench
+//       tools/json_arena_bench.cpp main/JsonArena.cpp cJSON.o
+// Usage: ./json_arena_bench [requests=20000] [config=spiffs/config.json]
+//
+// Replays a long session of web requests against a model of the target heap: a first-fit heap
+// with coalescing and a per-block header, sized like the free internal RAM of the robot. Between
+// requests, and while a parse is running, the other tasks keep allocating and freeing blocks of
+// random size and lifetime. Each request parses one of the documents the robot receives, either with cJSON on the model heap or
+// in an arena, reserved once at startup or taken for the request. Reports the heap calls per request, the heap high-water,
+// the fragmentation (1 - largest free block / free bytes) and the parse time, then the arena
+// high-water per document, which is what WebServer and RuntimeConfig size their arenas from,
+// and checks that the cap rejects an oversized document. A cJSON node is 64 bytes on a 64-bit host
+// against 40 on the ESP32, so the host arena numbers overstate the target by about half.
+
+#include "include/JsonArena.hpp"
+#include "cJSON.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// First fit over a fixed region, blocks carry an 8 byte header like the IDF heap
+class ModelHeap {
+public:
+    static constexpr size_t SIZE = 160 * 1024;
+    static constexpr size_t HEADER = 8;
+
+    ModelHeap() : m_memory(SIZE) { m_blocks.push_back({0, SIZE, true}); }
+
+    void* allocate(size_t p_size) {
+        size_t l_size = ((p_size + 7) & ~size_t(7)) + HEADER;
+        for (size_t i = 0; i < m_blocks.size(); i++) {
+            Block& l_block = m_blocks[i];
+            if (!l_block.free || l_block.size < l_size) continue;
+            if (l_block.size - l_size >= HEADER + 8) {
+                m_blocks.insert(m_blocks.begin() + i + 1, {l_block.offset + l_size, l_block.size - l_size, true});
+                m_blocks[i].size = l_size;
+            }
+            m_blocks[i].free = false;
+            m_used += m_blocks[i].size;
+            m_highWater = std::max(m_highWater, m_used);
+            m_calls++;
+            return m_memory.data() + m_blocks[i].offset + HEADER;
+        }
+        m_failures++;
+        return nullptr;
+    }
+
+    void release(void* p_pointer) {
+        if (p_pointer == nullptr) return;
+        size_t l_offset = static_cast<uint8_t*>(p_pointer) - m_memory.data() - HEADER;
+        auto l_it = std::lower_bound(m_blocks.begin(), m_blocks.end(), l_offset,
+                                     [](const Block& b, size_t o) { return b.offset < o; });
+        l_it->free = true;
+        m_used -= l_it->size;
+        m_calls++;
+        size_t i = l_it - m_blocks.begin();
+        if (i + 1 < m_blocks.size() && m_blocks[i + 1].free) {
+            m_blocks[i].size += m_blocks[i + 1].size;
+            m_blocks.erase(m_blocks.begin() + i + 1);
+        }
+        if (i > 0 && m_blocks[i - 1].free) {
+            m_blocks[i - 1].size += m_blocks[i].size;
+            m_blocks.erase(m_blocks.begin() + i);
+        }
+    }
+
+    size_t largestFree() const {
+        size_t l_largest = 0;
+        for (const Block& b : m_blocks) if (b.free) l_largest = std::max(l_largest, b.size);
+        return l_largest;
+    }
+
+    double fragmentation() const {
+        size_t l_free = SIZE - m_used;
+        return l_free ? 1.0 - static_cast<double>(largestFree()) / l_free : 0.0;
+    }
+
+    size_t used() const { return m_used; }
+    size_t highWater() const { return m_highWater; }
+    long calls() const { return m_calls; }
+    long failures() const { return m_failures; }
+
+private:
+    struct Block {
+        size_t offset;
+        size_t size;
+        bool free;
+    };
+    std::vector<uint8_t> m_memory;
+    std::vector<Block> m_blocks;
+    size_t m_used = 0;
+    size_t m_highWater = 0;
+    long m_calls = 0;
+    long m_failures = 0;
+};
+
+ModelHeap* g_heap = nullptr;
+
+struct Request {
+    const char* name;
+    std::string text;
+    int weight;             // Relative frequency in the session
+    int preemptions = -1;   // Other task allocations landing during the parse, counted on the heap
+};
+
+// Keeps the other tasks busy on the heap, blocks of 16..512 bytes living 1..100 requests
+struct Background {
+    std::mt19937 random{7};
+    std::vector<std::pair<void*, long>> live;
+    long now = 0;
+
+    void allocate() {
+        size_t l_size = 16 + random() % 497;
+        void* l_pointer = g_heap->allocate(l_size);
+        if (l_pointer) live.push_back({l_pointer, now + 1 + static_cast<long>(random() % 100)});
+    }
+
+    void step(long p_now) {
+        now = p_now;
+        for (size_t i = 0; i < live.size();) {
+            if (live[i].second <= p_now) {
+                g_heap->release(live[i].first);
+                live[i] = live.back();
+                live.pop_back();
+            } else {
+                i++;
+            }
+        }
+        for (int n = 0; n < 2; n++) allocate();
+    }
+};
+
+Background* g_background = nullptr;
+int g_parseAllocations = 0;
+int g_preemptions = 0;
+long g_cjsonCalls = 0;
+
+// The other tasks preempt the parse, one of their allocations lands every PREEMPT_EVERY cJSON allocations
+constexpr int PREEMPT_EVERY = 16;
+
+void* modelMalloc(size_t p_size) {
+    g_cjsonCalls++;
+    if (++g_parseAllocations % PREEMPT_EVERY == 0) {
+        g_background->allocate();
+        g_preemptions++;
+    }
+    return g_heap->allocate(p_size);
+}
+
+void modelFree(void* p_pointer) {
+    g_cjsonCalls++;
+    g_heap->release(p_pointer);
+}
+
+std::vector<Request> makeRequests(const std::string& p_config) {
+    return {
+        {"ws rate change", "{\"rate_hz\":50,\"format\":\"binary\"}", 40},
+        {"partial config", "{\"pid\":{\"kp\":7.25,\"ki\":0.4,\"kd\":0.31},\"yaw\":{\"kp\":0.012}}", 30},
+        {"autotune", "{\"rule\":\"tyreus_luyben\",\"relay_amplitude\":0.25,\"hysteresis\":0.5,\"max_deviation\":12}", 5},
+        {"sysid", "{\"type\":\"chirp\",\"amplitude\":0.1,\"duration\":20,\"start_freq_hz\":0.2,\"end_freq_hz\":15,"
+                  "\"step_delay\":1,\"max_deviation\":12}", 5},
+        {"full config", p_config, 20},
+    };
+}
+
+struct Result {
+    long heapCalls = 0;
+    size_t highWater = 0;
+    double fragmentation = 0.0;
+    double worstFragmentation = 0.0;
+    size_t smallestLargestFree = ModelHeap::SIZE;
+    double parseNs = 0.0;
+    long failed = 0;
+};
+
+// Same requests, same background, only where cJSON allocates differs
+template <typename Parse>
+Result session(std::vector<Request>& p_requests, long p_count, size_t p_reserved, Parse p_parse) {
+    ModelHeap l_heap;
+    g_heap = &l_heap;
+    // The arena block is taken once at startup, before the session fragments anything
+    if (p_reserved) l_heap.allocate(p_reserved);
+
+    Background l_background;
+    g_background = &l_background;
+    std::mt19937 l_random(11);
+    int l_total = 0;
+    for (const Request& r : p_requests) l_total += r.weight;
+
+    Result l_result;
+    double l_parseNs = 0.0;
+    g_cjsonCalls = 0;
+    for (long i = 0; i < p_count; i++) {
+        l_background.step(i);
+
+        int l_pick = l_random() % l_total;
+        Request* l_request = &p_requests[0];
+        for (Request& r : p_requests) {
+            if (l_pick < r.weight) { l_request = &r; break; }
+            l_pick -= r.weight;
+        }
+        g_parseAllocations = 0;
+        g_preemptions = 0;
+        auto l_start = std::chrono::steady_clock::now();
+        if (!p_parse(l_request->text)) l_result.failed++;
+        l_parseNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - l_start).count();
+
+        // The parse on the heap recorded how often it was preempted, the arena parse never reaches
+        // the heap and gets the same allocations of the other tasks right after
+        if (l_request->preemptions < 0) l_request->preemptions = g_preemptions;
+        for (int n = g_preemptions; n < l_request->preemptions; n++) l_background.allocate();
+
+        double l_fragmentation = l_heap.fragmentation();
+        l_result.worstFragmentation = std::max(l_result.worstFragmentation, l_fragmentation);
+        l_result.smallestLargestFree = std::min(l_result.smallestLargestFree, l_heap.largestFree());
+    }
+    l_result.fragmentation = l_heap.fragmentation();
+    l_result.highWater = l_heap.highWater();
+    l_result.parseNs = l_parseNs / p_count;
+    l_result.heapCalls = g_cjsonCalls;
+    g_heap = nullptr;
+    g_background = nullptr;
+    return l_result;
+}
+
+void print(const char* p_name, const Result& p_result, long p_count) {
+    std::printf("%-8s %10.1f %10zu %9.1f%% %9.1f%% %12zu %10.0f %7ld\n", p_name,
+                static_cast<double>(p_result.heapCalls) / p_count, p_result.highWater,
+                100.0 * p_result.fragmentation, 100.0 * p_result.worstFragmentation,
+                p_result.smallestLargestFree, p_result.parseNs, p_result.failed);
+}
+
+// Touches every value like the handlers do, so the parse is not optimized into nothing
+long walk(const cJSON* p_item) {
+    long l_count = 0;
+    for (; p_item; p_item = p_item->next) l_count += 1 + walk(p_item->child);
+    return l_count;
+}
+
+const char* argument(int argc, char** argv, const char* p_name, const char* p_default) {
+    size_t l_length = std::strlen(p_name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], p_name, l_length) == 0 && argv[i][l_length] == '=') {
+            return argv[i] + l_length + 1;
+        }
+    }
+    return p_default;
+}
+
+int argument(int argc, char** argv, const char* p_name, int p_default) {
+    const char* l_value = argument(argc, argv, p_name, static_cast<const char*>(nullptr));
+    return l_value ? std::atoi(l_value) : p_default;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    long l_count = std::max(1, argument(argc, argv, "requests", 20000));
+    const char* l_path = argument(argc, argv, "config", "spiffs/config.json");
+    std::ifstream l_file(l_path);
+    if (!l_file) {
+        std::fprintf(stderr, "cannot read %s\n", l_path);
+        return 1;
+    }
+    std::stringstream l_text;
+    l_text << l_file.rdbuf();
+    std::vector<Request> l_requests = makeRequests(l_text.str());
+
+    std::printf("session of %ld requests, model heap of %zu bytes\n\n", l_count, ModelHeap::SIZE);
+    std::printf("%-8s %10s %10s %10s %10s %12s %10s %7s\n", "", "calls/req", "high_water", "frag_end", "frag_worst",
+                "min_largest", "parse_ns", "failed");
+
+    // The first JsonArena installs its dispatching hooks for good, so the heap session runs before
+    // any exists, with cJSON pointed straight at the model heap
+    cJSON_Hooks l_hooks = {modelMalloc, modelFree};
+    cJSON_InitHooks(&l_hooks);
+    Result l_heapResult = session(l_requests, l_count, 0, [](const std::string& p_text) {
+        cJSON* l_root = cJSON_Parse(p_text.c_str());
+        bool l_ok = l_root && walk(l_root) > 0;
+        cJSON_Delete(l_root);
+        return l_ok;
+    });
+    print("heap", l_heapResult, l_count);
+
+    // Largest arena use per document, measured with an arena far bigger than needed
+    size_t l_arenaSize = 0;
+    char l_sizes[512];
+    int l_sizesLength = 0;
+    {
+        JsonArena l_probe(64 * 1024);
+        for (const Request& r : l_requests) {
+            JsonArena::Scope l_scope(l_probe);
+            cJSON* l_root = cJSON_Parse(r.text.c_str());
+            l_sizesLength += std::snprintf(l_sizes + l_sizesLength, sizeof(l_sizes) - l_sizesLength, "%-16s %8zu %12zu%s\n",
+                                           r.name, r.text.size(), l_probe.used(), l_root ? "" : "  PARSE FAILED");
+            l_arenaSize = std::max(l_arenaSize, l_probe.used());
+            cJSON_Delete(l_root);
+        }
+    }
+    // Headroom for a config with a full gain schedule
+    l_arenaSize = l_arenaSize * 2;
+
+    JsonArena l_arena(l_arenaSize);
+    Result l_arenaResult = session(l_requests, l_count, l_arenaSize, [&](const std::string& p_text) {
+        JsonArena::Scope l_scope(l_arena);
+        cJSON* l_root = cJSON_Parse(p_text.c_str());
+        bool l_ok = l_root && walk(l_root) > 0;
+        cJSON_Delete(l_root);
+        return l_ok;
+    });
+    print("arena", l_arenaResult, l_count);
+
+    // The same arena taken from the heap for each request instead, as RuntimeConfig::fromJson does
+    // for the rare full config: one large block per parse and nothing reserved in between
+    Result l_blockResult = session(l_requests, l_count, 0, [&](const std::string& p_text) {
+        void* l_block = g_heap->allocate(l_arenaSize);
+        g_cjsonCalls += 2;
+        if (l_block == nullptr) return false;
+        JsonArena::Scope l_scope(l_arena);
+        cJSON* l_root = cJSON_Parse(p_text.c_str());
+        bool l_ok = l_root && walk(l_root) > 0;
+        cJSON_Delete(l_root);
+        g_heap->release(l_block);
+        return l_ok;
+    });
+    print("per-req", l_blockResult, l_count);
+
+    std::printf("\n%-16s %8s %12s\n%s\narena of %zu bytes, twice the largest document\n", "document", "bytes",
+                "arena_bytes", l_sizes, l_arenaSize);
+
+    // A document past the cap fails cleanly and is recognizable as such
+    std::string l_oversized = "[";
+    for (int i = 0; i < 4000; i++) l_oversized += i ? ",1" : "1";
+    l_oversized += "]";
+    bool l_rejected;
+    {
+        JsonArena::Scope l_scope(l_arena);
+        cJSON* l_root = cJSON_Parse(l_oversized.c_str());
+        l_rejected = l_root == nullptr && l_arena.exhausted();
+        cJSON_Delete(l_root);
+    }
+    // And the arena is usable again right after
+    bool l_recovered;
+    {
+        JsonArena::Scope l_scope(l_arena);
+        cJSON* l_root = cJSON_Parse(l_requests[0].text.c_str());
+        l_recovered = l_root != nullptr && !l_arena.exhausted();
+        cJSON_Delete(l_root);
+    }
+    std::printf("\n%zu byte document over the cap: %s, next parse: %s\n", l_oversized.size(),
+                l_rejected ? "rejected as exhausted" : "NOT REJECTED", l_recovered ? "ok" : "FAILED");
+    return l_rejected && l_recovered && l_arenaResult.failed == 0 ? 0 : 1;
+}
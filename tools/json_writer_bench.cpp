@@ -0,0 +1,364 @@
+// Host benchmark of the streaming JSON writer used by the HTTP handlers and the config file.
+//
+// Build: g++ -std=c++17 -O2 -Imain -o json_writer_bench tools/json_writer_bench.cpp main/JsonWriter.cpp
+// With the cJSON comparison, from an ESP-IDF checkout:
+//        gcc -O2 -c $IDF_PATH/components/json/cJSON/cJSON.c -o cJSON.o
+//        g++ -std=c++17 -O2 -Imain -I$IDF_PATH/components/json/cJSON -DHAVE_CJSON -o json_writer_bench
+//            tools/json_writer_bench.cpp main/JsonWriter.cpp cJSON.o
+// Usage: ./json_writer_bench [iterations=100000]
+//
+// Checks the writer output on a few edge cases, then serializes a document shaped like config.json
+// and one telemetry sample, and reports the throughput, the heap allocations per document and the
+// peak heap in use. The heap numbers come from interposing malloc, which needs glibc.
+
+#include "include/JsonWriter.hpp"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+
+namespace {
+
+struct HeapStats {
+    long allocations = 0;
+    long long live = 0;
+    long long peak = 0;
+};
+
+HeapStats g_heap;
+bool g_counting = false;
+
+void onAllocate(void* p_pointer) {
+    if (!g_counting || p_pointer == nullptr) return;
+    g_heap.allocations++;
+    g_heap.live += malloc_usable_size(p_pointer);
+    if (g_heap.live > g_heap.peak) g_heap.peak = g_heap.live;
+}
+
+void onFree(void* p_pointer) {
+    if (g_counting && p_pointer != nullptr) g_heap.live -= malloc_usable_size(p_pointer);
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t p_size) {
+    void* l_pointer = __libc_malloc(p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void* calloc(size_t p_count, size_t p_size) {
+    void* l_pointer = __libc_calloc(p_count, p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void* realloc(void* p_pointer, size_t p_size) {
+    onFree(p_pointer);
+    void* l_pointer = __libc_realloc(p_pointer, p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void free(void* p_pointer) {
+    onFree(p_pointer);
+    __libc_free(p_pointer);
+}
+
+}  // extern "C"
+
+namespace {
+
+// Values of a plausible config, the shape is what matters
+struct Document {
+    float pid[10] = {8.5f, 0.35f, 0.42f, 1.2f, -50.0f, 50.0f, -100.0f, 100.0f, 20.0f, 250.0f};
+    float yaw[9] = {0.8f, 0.05f, 0.0f, 0.0f, -20.0f, 20.0f, -30.0f, 30.0f, 10.0f};
+    float lqr[4] = {-42.1f, -3.75f, -0.5f, -1.9f};
+    float errorBreakpoints[5] = {0.0f, 2.0f, 5.0f, 10.0f, 20.0f};
+    float speedBreakpoints[3] = {0.0f, 5.0f, 10.0f};
+    float scale[3][5] = {{1.0f, 1.1f, 1.25f, 1.4f, 1.6f}, {0.9f, 1.0f, 1.1f, 1.2f, 1.3f}, {0.8f, 0.9f, 1.0f, 1.1f, 1.2f}};
+    float velocity[7] = {0.02f, 0.001f, 0.1f, 0.0f, -5.0f, 5.0f, 8.0f};
+    float filters[2][2] = {{35.0f, 4.0f}, {40.0f, 0.7071f}};
+    float motor[6] = {1.0f, 0.02f, 0.08f, 4.0f, 1.0f, 0.97f};
+    float telemetry[16] = {1.234f, -0.456f, 12.5f, 3.21f, -0.5f, 2.345f, 2.301f, 0.1234f,
+                           0.0456f, -0.0321f, 13.57f, 0.1357f, 0.1299f, 1.301f, 18.0f, 6.25f};
+};
+
+const char* const TELEMETRY_KEYS[16] = {"pitch", "roll", "yaw", "pitchRate", "yawRate", "leftWheelSpeed",
+                                        "rightWheelSpeed", "pTerm", "iTerm", "dTerm", "pidOutput", "leftDuty",
+                                        "rightDuty", "predictedPitch", "predictionHorizonMs", "latencyMs"};
+
+const char* const PID_KEYS[10] = {"kp", "ki", "kd", "target_angle", "iterm_min", "iterm_max",
+                                  "output_min", "output_max", "d_cutoff_hz", "engage_ramp_ms"};
+
+bool discard(void* p_context, const char*, size_t p_length) {
+    *static_cast<size_t*>(p_context) += p_length;
+    return true;
+}
+
+bool append(void* p_context, const char* p_data, size_t p_length) {
+    static_cast<std::string*>(p_context)->append(p_data, p_length);
+    return true;
+}
+
+void writeConfig(JsonWriter& p_json, const Document& p_doc) {
+    p_json.beginObject().beginObject("pid");
+    for (int i = 0; i < 10; i++) p_json.number(PID_KEYS[i], p_doc.pid[i]);
+    p_json.string("d_filter", "biquad").endObject().beginObject("yaw");
+    for (int i = 0; i < 9; i++) p_json.number(PID_KEYS[i], p_doc.yaw[i]);
+    p_json.endObject().string("controller", "pid").beginObject("lqr")
+        .number("k_pitch", p_doc.lqr[0]).number("k_pitch_rate", p_doc.lqr[1])
+        .number("k_position", p_doc.lqr[2]).number("k_velocity", p_doc.lqr[3])
+        .endObject();
+    p_json.beginObject("gain_schedule").boolean("enabled", true)
+        .numbers("error_breakpoints", p_doc.errorBreakpoints, 5)
+        .numbers("speed_breakpoints", p_doc.speedBreakpoints, 3);
+    for (const char* l_key : {"kp_scale", "ki_scale", "kd_scale"}) {
+        p_json.beginArray(l_key);
+        for (int s = 0; s < 3; s++) p_json.numbers(nullptr, p_doc.scale[s], 5);
+        p_json.endArray();
+    }
+    p_json.endObject().beginObject("velocity_loop").boolean("enabled", false);
+    for (int i = 0; i < 7; i++) p_json.number(PID_KEYS[i], p_doc.velocity[i]);
+    p_json.integer("divider", 5).endObject().beginObject("filters");
+    for (const char* l_key : {"gyro", "accel", "d_term", "motor"}) {
+        p_json.beginArray(l_key);
+        for (int i = 0; i < 2; i++) {
+            p_json.beginObject().string("type", i == 0 ? "notch" : "low_pass")
+                .number("freq_hz", p_doc.filters[i][0]).number("q", p_doc.filters[i][1]).endObject();
+        }
+        p_json.endArray();
+    }
+    p_json.endObject().beginObject("motor");
+    for (int i = 0; i < 6; i++) p_json.number(PID_KEYS[i], p_doc.motor[i]);
+    p_json.endObject()
+        .beginObject("mpu6050").integer("calibration_samples", 1000).endObject()
+        .beginObject("main_loop").integer("interval_ms", 10).endObject()
+        .endObject();
+}
+
+void writeTelemetry(JsonWriter& p_json, const Document& p_doc) {
+    p_json.beginObject().integer("sequence", 123456).integer("state", 2).integer("timestamp", 987654321012LL);
+    for (int i = 0; i < 16; i++) p_json.number(TELEMETRY_KEYS[i], p_doc.telemetry[i], i >= 7 && i <= 9 ? 4 : 3);
+    p_json.endObject();
+}
+
+bool expect(const char* p_name, bool p_condition) {
+    if (!p_condition) std::printf("  check failed: %s\n", p_name);
+    return p_condition;
+}
+
+bool selfCheck() {
+    bool l_ok = true;
+    char l_buffer[256];
+
+    JsonWriter l_json(l_buffer, sizeof(l_buffer));
+    l_json.beginObject().string("s", "a\"b\\c\n\x01").number("f", 0.1f).number("n", NAN).number("d", 2.5, 2)
+        .integer("i", -7).boolean("b", false).beginArray("a").number(nullptr, 1.0f).number(nullptr, 1e-7f).endArray()
+        .beginObject("e").endObject().endObject();
+    l_ok &= expect("edge cases", l_json.finish() &&
+                   std::strcmp(l_buffer, "{\"s\":\"a\\\"b\\\\c\\n\\u0001\",\"f\":0.1,\"n\":null,\"d\":2.50,"
+                                         "\"i\":-7,\"b\":false,\"a\":[1,1e-07],\"e\":{}}") == 0);
+
+    JsonWriter l_pretty(l_buffer, sizeof(l_buffer), nullptr, nullptr, true);
+    l_pretty.beginObject().beginObject("o").numbers("a", Document().speedBreakpoints, 3).endObject().endObject();
+    l_ok &= expect("pretty", l_pretty.finish() && std::strcmp(l_buffer, "{\n\t\"o\": {\n\t\t\"a\": [0, 5, 10]\n\t}\n}") == 0);
+
+    JsonWriter l_missingKey(l_buffer, sizeof(l_buffer));
+    l_missingKey.beginObject().number(nullptr, 1.0).endObject();
+    l_ok &= expect("missing key rejected", !l_missingKey.finish());
+
+    JsonWriter l_unbalanced(l_buffer, sizeof(l_buffer));
+    l_unbalanced.beginObject().beginArray("a").endObject();
+    l_ok &= expect("unbalanced rejected", !l_unbalanced.finish());
+
+    char l_small[16];
+    JsonWriter l_overflow(l_small, sizeof(l_small));
+    l_overflow.beginObject().string("key", "longer than the buffer").endObject();
+    l_ok &= expect("overflow rejected", !l_overflow.finish());
+
+    // Chunked through a tiny buffer the output must be byte for byte the same as in one piece
+    Document l_doc;
+    std::string l_whole, l_chunked;
+    char l_large[4096], l_tiny[7];
+    JsonWriter l_one(l_large, sizeof(l_large));
+    writeConfig(l_one, l_doc);
+    l_ok &= expect("config fits", l_one.finish());
+    l_whole = l_large;
+    JsonWriter l_many(l_tiny, sizeof(l_tiny), append, &l_chunked);
+    writeConfig(l_many, l_doc);
+    l_ok &= expect("chunked identical", l_many.finish() && l_chunked == l_whole && l_many.length() == l_whole.size());
+
+    // Fixed decimals agree with printf, up to ties rounded the other way
+    for (double v = -1234.5678; v < 1234.5678; v += 0.3217) {
+        for (int l_decimals = 0; l_decimals <= 4; l_decimals++) {
+            char l_reference[32];
+            std::snprintf(l_reference, sizeof(l_reference), "%.*f", l_decimals, v);
+            JsonWriter l_number(l_buffer, sizeof(l_buffer));
+            l_number.number(nullptr, v, l_decimals);
+            if (!l_number.finish() || std::fabs(std::strtod(l_buffer, nullptr) - std::strtod(l_reference, nullptr)) >
+                                          1.01 * std::pow(10.0, -l_decimals)) {
+                l_ok &= expect("fixed decimals", false);
+                std::printf("  %s vs %s\n", l_buffer, l_reference);
+                v = 1e9;
+                break;
+            }
+        }
+    }
+
+    // Every float comes back exactly
+    for (float v = 1e-6f; v < 1e6f; v *= 1.37f) {
+        JsonWriter l_number(l_buffer, sizeof(l_buffer));
+        l_number.number(nullptr, v);
+        if (!l_number.finish() || std::strtof(l_buffer, nullptr) != v) {
+            l_ok &= expect("float round trip", false);
+            break;
+        }
+    }
+    return l_ok;
+}
+
+template <typename Function>
+void report(const char* p_name, long p_iterations, Function p_serialize) {
+    size_t l_bytes = p_serialize();
+
+    g_heap = HeapStats();
+    g_counting = true;
+    p_serialize();
+    g_counting = false;
+    HeapStats l_heap = g_heap;
+
+    auto l_start = std::chrono::steady_clock::now();
+    for (long i = 0; i < p_iterations; i++) p_serialize();
+    double l_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    std::printf("%-28s %7zu %10.2f %10.1f %8ld %10lld\n", p_name, l_bytes, p_iterations * l_bytes / l_seconds / 1e6,
+                l_seconds / p_iterations * 1e9, l_heap.allocations, l_heap.peak);
+}
+
+#ifdef HAVE_CJSON
+// The DOM the handlers used to build, same keys and values
+cJSON* buildConfig(const Document& p_doc) {
+    cJSON* l_root = cJSON_CreateObject();
+    cJSON* l_pid = cJSON_AddObjectToObject(l_root, "pid");
+    for (int i = 0; i < 10; i++) cJSON_AddNumberToObject(l_pid, PID_KEYS[i], p_doc.pid[i]);
+    cJSON_AddStringToObject(l_pid, "d_filter", "biquad");
+    cJSON* l_yaw = cJSON_AddObjectToObject(l_root, "yaw");
+    for (int i = 0; i < 9; i++) cJSON_AddNumberToObject(l_yaw, PID_KEYS[i], p_doc.yaw[i]);
+    cJSON_AddStringToObject(l_root, "controller", "pid");
+    cJSON* l_lqr = cJSON_AddObjectToObject(l_root, "lqr");
+    cJSON_AddNumberToObject(l_lqr, "k_pitch", p_doc.lqr[0]);
+    cJSON_AddNumberToObject(l_lqr, "k_pitch_rate", p_doc.lqr[1]);
+    cJSON_AddNumberToObject(l_lqr, "k_position", p_doc.lqr[2]);
+    cJSON_AddNumberToObject(l_lqr, "k_velocity", p_doc.lqr[3]);
+    cJSON* l_schedule = cJSON_AddObjectToObject(l_root, "gain_schedule");
+    cJSON_AddBoolToObject(l_schedule, "enabled", true);
+    cJSON_AddItemToObject(l_schedule, "error_breakpoints", cJSON_CreateFloatArray(p_doc.errorBreakpoints, 5));
+    cJSON_AddItemToObject(l_schedule, "speed_breakpoints", cJSON_CreateFloatArray(p_doc.speedBreakpoints, 3));
+    for (const char* l_key : {"kp_scale", "ki_scale", "kd_scale"}) {
+        cJSON* l_rows = cJSON_AddArrayToObject(l_schedule, l_key);
+        for (int s = 0; s < 3; s++) cJSON_AddItemToArray(l_rows, cJSON_CreateFloatArray(p_doc.scale[s], 5));
+    }
+    cJSON* l_velocity = cJSON_AddObjectToObject(l_root, "velocity_loop");
+    cJSON_AddBoolToObject(l_velocity, "enabled", false);
+    for (int i = 0; i < 7; i++) cJSON_AddNumberToObject(l_velocity, PID_KEYS[i], p_doc.velocity[i]);
+    cJSON_AddNumberToObject(l_velocity, "divider", 5);
+    cJSON* l_filters = cJSON_AddObjectToObject(l_root, "filters");
+    for (const char* l_key : {"gyro", "accel", "d_term", "motor"}) {
+        cJSON* l_stages = cJSON_AddArrayToObject(l_filters, l_key);
+        for (int i = 0; i < 2; i++) {
+            cJSON* l_stage = cJSON_CreateObject();
+            cJSON_AddStringToObject(l_stage, "type", i == 0 ? "notch" : "low_pass");
+            cJSON_AddNumberToObject(l_stage, "freq_hz", p_doc.filters[i][0]);
+            cJSON_AddNumberToObject(l_stage, "q", p_doc.filters[i][1]);
+            cJSON_AddItemToArray(l_stages, l_stage);
+        }
+    }
+    cJSON* l_motor = cJSON_AddObjectToObject(l_root, "motor");
+    for (int i = 0; i < 6; i++) cJSON_AddNumberToObject(l_motor, PID_KEYS[i], p_doc.motor[i]);
+    cJSON_AddNumberToObject(cJSON_AddObjectToObject(l_root, "mpu6050"), "calibration_samples", 1000);
+    cJSON_AddNumberToObject(cJSON_AddObjectToObject(l_root, "main_loop"), "interval_ms", 10);
+    return l_root;
+}
+
+cJSON* buildTelemetry(const Document& p_doc) {
+    cJSON* l_root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(l_root, "sequence", 123456);
+    cJSON_AddNumberToObject(l_root, "state", 2);
+    cJSON_AddNumberToObject(l_root, "timestamp", 987654321012.0);
+    for (int i = 0; i < 16; i++) cJSON_AddNumberToObject(l_root, TELEMETRY_KEYS[i], p_doc.telemetry[i]);
+    return l_root;
+}
+
+size_t printAndFree(cJSON* p_root, bool p_pretty) {
+    char* l_text = p_pretty ? cJSON_Print(p_root) : cJSON_PrintUnformatted(p_root);
+    size_t l_length = std::strlen(l_text);
+    std::free(l_text);
+    cJSON_Delete(p_root);
+    return l_length;
+}
+#endif
+
+int argument(int argc, char** argv, const char* p_name, int p_default) {
+    size_t l_length = std::strlen(p_name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], p_name, l_length) == 0 && argv[i][l_length] == '=') {
+            return std::atoi(argv[i] + l_length + 1);
+        }
+    }
+    return p_default;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    long l_iterations = std::max(1, argument(argc, argv, "iterations", 100000));
+    if (!selfCheck()) {
+        std::printf("writer self check FAILED\n");
+        return 1;
+    }
+    std::printf("writer self check passed\n\n");
+
+    Document l_doc;
+    std::printf("%-28s %7s %10s %10s %8s %10s\n", "", "bytes", "MB/s", "ns/doc", "mallocs", "peak_heap");
+
+    report("config, writer 256 B chunks", l_iterations, [&] {
+        char l_buffer[256];
+        size_t l_sent = 0;
+        JsonWriter l_json(l_buffer, sizeof(l_buffer), discard, &l_sent, true);
+        writeConfig(l_json, l_doc);
+        l_json.finish();
+        return l_sent;
+    });
+    report("telemetry, writer", l_iterations, [&] {
+        char l_buffer[512];
+        JsonWriter l_json(l_buffer, sizeof(l_buffer));
+        writeTelemetry(l_json, l_doc);
+        l_json.finish();
+        return l_json.length();
+    });
+#ifdef HAVE_CJSON
+    report("config, cJSON_Print", l_iterations, [&] { return printAndFree(buildConfig(l_doc), true); });
+    report("telemetry, cJSON_Print", l_iterations, [&] { return printAndFree(buildTelemetry(l_doc), true); });
+#else
+    std::printf("\nbuilt without HAVE_CJSON, see the header for the cJSON comparison\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,280 @@
+// Host tool: LQR gains for the balancing robot from model parameters.
+//
+// Build: g++ -std=c++17 -O2 -o lqr_gains tools/lqr_gains.cpp
+// Usage: ./lqr_gains [key=value ...]     (./lqr_gains help lists the keys and defaults)
+//
+// Linearised wheeled inverted pendulum, both wheels lumped together, driven by the
+// normalized motor command u in [-1, 1]. The continuous model is discretised with a
+// zero-order hold at the control period and the discrete algebraic Riccati equation
+// is solved by fixed-point iteration. The gains are printed in the units LQRController
+// expects: pitch in rad measured from the target angle, pitch rate in rad/s, wheel
+// travel in rad as seen by the encoders and wheel speed in rad/s.
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace {
+
+constexpr int N = 4;  // theta, theta_dot, phi, phi_dot
+using Matrix = std::array<std::array<double, N>, N>;
+using Vector = std::array<double, N>;
+
+constexpr double GRAVITY = 9.81;
+
+struct Parameter {
+    double value;
+    const char* description;
+};
+
+std::map<std::string, Parameter> defaultParameters() {
+    return {
+        {"body_mass",      {1.0,     "kg, everything but the wheels"}},
+        {"body_inertia",   {0.004,   "kg m^2, body about its centre of mass"}},
+        {"com_height",     {0.08,    "m, axle to body centre of mass"}},
+        {"wheel_mass",     {0.1,     "kg, both wheels"}},
+        {"wheel_inertia",  {5.4e-5,  "kg m^2, both wheels including the reflected rotor inertia"}},
+        {"wheel_radius",   {0.033,   "m"}},
+        {"stall_torque",   {0.3,     "N m at the wheels for u = 1, both motors"}},
+        {"no_load_speed",  {30.0,    "rad/s at the wheels for u = 1"}},
+        {"dt",             {0.01,    "s, control period (main_loop.interval_ms / 1000)"}},
+        {"q_pitch",        {100.0,   "state weight"}},
+        {"q_pitch_rate",   {1.0,     "state weight"}},
+        {"q_position",     {1.0,     "state weight"}},
+        {"q_velocity",     {1.0,     "state weight"}},
+        {"r",              {10.0,    "input weight"}},
+        {"pitch_sign",     {-1.0,    "-1 when positive pitch is corrected by a negative command (as with the PID)"}},
+    };
+}
+
+Matrix multiply(const Matrix& p_a, const Matrix& p_b) {
+    Matrix l_result {};
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            for (int k = 0; k < N; k++)
+                l_result[i][j] += p_a[i][k] * p_b[k][j];
+    return l_result;
+}
+
+Matrix transpose(const Matrix& p_a) {
+    Matrix l_result {};
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            l_result[i][j] = p_a[j][i];
+    return l_result;
+}
+
+Vector multiply(const Matrix& p_a, const Vector& p_x) {
+    Vector l_result {};
+    for (int i = 0; i < N; i++)
+        for (int k = 0; k < N; k++)
+            l_result[i] += p_a[i][k] * p_x[k];
+    return l_result;
+}
+
+double dot(const Vector& p_a, const Vector& p_b) {
+    double l_sum = 0.0;
+    for (int i = 0; i < N; i++) l_sum += p_a[i] * p_b[i];
+    return l_sum;
+}
+
+// Zero-order hold of x' = A x + B u via the augmented matrix exponential [[A, B], [0, 0]]
+void discretise(const Matrix& p_a, const Vector& p_b, double p_dt, Matrix& p_ad, Vector& p_bd) {
+    constexpr int M = N + 1;
+    double l_m[M][M] = {};
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) l_m[i][j] = p_a[i][j] * p_dt;
+        l_m[i][N] = p_b[i] * p_dt;
+    }
+
+    // Scale so the norm is small, Taylor series, then square back up
+    double l_norm = 0.0;
+    for (int i = 0; i < M; i++)
+        for (int j = 0; j < M; j++) l_norm = std::max(l_norm, std::abs(l_m[i][j]));
+    int l_squarings = std::max(0, static_cast<int>(std::ceil(std::log2(l_norm * M))) + 1);
+    double l_scale = std::ldexp(1.0, -l_squarings);
+    for (int i = 0; i < M; i++)
+        for (int j = 0; j < M; j++) l_m[i][j] *= l_scale;
+
+    double l_exp[M][M] = {};
+    double l_term[M][M] = {};
+    for (int i = 0; i < M; i++) l_exp[i][i] = l_term[i][i] = 1.0;
+    for (int k = 1; k <= 16; k++) {
+        double l_next[M][M] = {};
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < M; j++)
+                for (int n = 0; n < M; n++) l_next[i][j] += l_term[i][n] * l_m[n][j] / k;
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < M; j++) {
+                l_term[i][j] = l_next[i][j];
+                l_exp[i][j] += l_next[i][j];
+            }
+    }
+    for (int s = 0; s < l_squarings; s++) {
+        double l_squared[M][M] = {};
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < M; j++)
+                for (int n = 0; n < M; n++) l_squared[i][j] += l_exp[i][n] * l_exp[n][j];
+        std::memcpy(l_exp, l_squared, sizeof(l_exp));
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) p_ad[i][j] = l_exp[i][j];
+        p_bd[i] = l_exp[i][N];
+    }
+}
+
+// Riccati recursion in the Joseph form P = Q + K'RK + (A - BK)' P (A - BK), which keeps P
+// symmetric positive semi-definite where the textbook form drifts numerically.
+// Single input, so (R + B'PB)^-1 is a division.
+bool solveRiccati(const Matrix& p_a, const Vector& p_b, const Matrix& p_q, double p_r, Vector& p_k) {
+    Matrix l_p = p_q;
+
+    for (int l_iteration = 0; l_iteration < 200000; l_iteration++) {
+        Vector l_pb = multiply(l_p, p_b);
+        double l_denominator = p_r + dot(p_b, l_pb);
+        Vector l_k {};
+        for (int j = 0; j < N; j++)
+            for (int i = 0; i < N; i++) l_k[j] += l_pb[i] * p_a[i][j] / l_denominator;
+
+        Matrix l_closed = p_a;
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++) l_closed[i][j] -= p_b[i] * l_k[j];
+
+        Matrix l_next = multiply(transpose(l_closed), multiply(l_p, l_closed));
+        double l_change = 0.0;
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                l_next[i][j] += p_q[i][j] + p_r * l_k[i] * l_k[j];
+            }
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = i; j < N; j++) {
+                l_next[i][j] = l_next[j][i] = 0.5 * (l_next[i][j] + l_next[j][i]);
+                l_change = std::max(l_change, std::abs(l_next[i][j] - l_p[i][j]) / (1.0 + std::abs(l_p[i][j])));
+            }
+        }
+        l_p = l_next;
+        p_k = l_k;
+
+        if (!std::isfinite(l_change)) return false;
+        if (l_change < 1e-12) return true;
+    }
+    return false;
+}
+
+// Slowest closed loop time constant from the decay of a pitch disturbance, infinite when unstable
+double slowestTimeConstant(const Matrix& p_a, const Vector& p_b, const Vector& p_k, double p_dt) {
+    Matrix l_closed = p_a;
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++) l_closed[i][j] -= p_b[i] * p_k[j];
+
+    // Let the fast modes die out, then measure the per-step contraction of what is left
+    Vector l_x {0.1, 0.0, 0.0, 0.0};
+    int l_steps = static_cast<int>(10.0 / p_dt);
+    for (int s = 0; s < l_steps; s++) l_x = multiply(l_closed, l_x);
+    double l_before = std::sqrt(dot(l_x, l_x));
+    for (int s = 0; s < l_steps; s++) l_x = multiply(l_closed, l_x);
+    double l_after = std::sqrt(dot(l_x, l_x));
+
+    if (l_before == 0.0 || l_after == 0.0) return 0.0;
+    double l_rate = std::log(l_after / l_before) / l_steps;
+    return l_rate < 0.0 ? -p_dt / l_rate : INFINITY;
+}
+
+void printUsage(const std::map<std::string, Parameter>& p_parameters) {
+    std::printf("usage: lqr_gains [key=value ...]\n\n");
+    for (const auto& [l_key, l_parameter] : p_parameters) {
+        std::printf("  %-14s %-10g %s\n", l_key.c_str(), l_parameter.value, l_parameter.description);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto l_parameters = defaultParameters();
+
+    for (int i = 1; i < argc; i++) {
+        const char* l_separator = std::strchr(argv[i], '=');
+        auto l_entry = l_separator ? l_parameters.find(std::string(argv[i], l_separator - argv[i])) : l_parameters.end();
+        if (l_entry == l_parameters.end()) {
+            printUsage(l_parameters);
+            return std::strcmp(argv[i], "help") == 0 ? 0 : 1;
+        }
+        l_entry->second.value = std::atof(l_separator + 1);
+    }
+
+    auto l_get = [&](const char* p_key) { return l_parameters.at(p_key).value; };
+    double l_mb = l_get("body_mass"), l_ib = l_get("body_inertia"), l_l = l_get("com_height");
+    double l_mw = l_get("wheel_mass"), l_iw = l_get("wheel_inertia"), l_r = l_get("wheel_radius");
+    double l_stall = l_get("stall_torque"), l_noLoad = l_get("no_load_speed"), l_dt = l_get("dt");
+
+    // Lagrange with q = (phi, theta): phi absolute wheel angle, theta body pitch, motor torque
+    // tau = stall * u - damping * (phi' - theta') acts between body and wheels.
+    double l_m11 = (l_mw + l_mb) * l_r * l_r + l_iw;
+    double l_m12 = l_mb * l_r * l_l;
+    double l_m22 = l_mb * l_l * l_l + l_ib;
+    double l_det = l_m11 * l_m22 - l_m12 * l_m12;
+    double l_damping = l_stall / l_noLoad;
+    double l_gravity = l_mb * GRAVITY * l_l;
+
+    // M^-1 applied to the generalised forces (tau, -tau + gravity * theta)
+    double l_phiTau = (l_m22 + l_m12) / l_det;       // phi''   per unit tau
+    double l_thetaTau = -(l_m12 + l_m11) / l_det;    // theta'' per unit tau
+    double l_phiGravity = -l_m12 * l_gravity / l_det;
+    double l_thetaGravity = l_m11 * l_gravity / l_det;
+
+    Matrix l_a {};
+    Vector l_b {};
+    l_a[0][1] = 1.0;
+    l_a[2][3] = 1.0;
+    l_a[1][0] = l_thetaGravity;
+    l_a[3][0] = l_phiGravity;
+    // Back EMF damping on the relative speed phi' - theta'
+    l_a[1][3] = -l_thetaTau * l_damping;
+    l_a[1][1] = l_thetaTau * l_damping;
+    l_a[3][3] = -l_phiTau * l_damping;
+    l_a[3][1] = l_phiTau * l_damping;
+    l_b[1] = l_thetaTau * l_stall;
+    l_b[3] = l_phiTau * l_stall;
+
+    Matrix l_ad {};
+    Vector l_bd {};
+    discretise(l_a, l_b, l_dt, l_ad, l_bd);
+
+    Matrix l_q {};
+    l_q[0][0] = l_get("q_pitch");
+    l_q[1][1] = l_get("q_pitch_rate");
+    l_q[2][2] = l_get("q_position");
+    l_q[3][3] = l_get("q_velocity");
+
+    Vector l_k {};
+    if (!solveRiccati(l_ad, l_bd, l_q, l_get("r"), l_k)) {
+        std::fprintf(stderr, "Riccati iteration did not converge, check the model parameters\n");
+        return 1;
+    }
+
+    double l_timeConstant = slowestTimeConstant(l_ad, l_bd, l_k, l_dt);
+    if (!std::isfinite(l_timeConstant)) {
+        std::fprintf(stderr, "Closed loop is unstable, check the model parameters\n");
+        return 1;
+    }
+    std::fprintf(stderr, "slowest closed loop time constant: %.3f s\n", l_timeConstant);
+
+    // The encoders measure the wheel relative to the body: phi = phi_enc + theta
+    double l_sign = l_get("pitch_sign");
+    double l_kPitch = l_sign * (l_k[0] + l_k[2]);
+    double l_kPitchRate = l_sign * (l_k[1] + l_k[3]);
+
+    std::printf("\"lqr\": {\n");
+    std::printf("  \"k_pitch\": %.6g,\n", l_kPitch);
+    std::printf("  \"k_pitch_rate\": %.6g,\n", l_kPitchRate);
+    std::printf("  \"k_position\": %.6g,\n", l_k[2]);
+    std::printf("  \"k_velocity\": %.6g\n", l_k[3]);
+    std::printf("}\n");
+    return 0;
+}
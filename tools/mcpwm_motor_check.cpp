@@ -0,0 +1,293 @@
+// Host check of the MCPWM motor path: MCPWMTimer, MCPWMMotor with its two MCPWMPWM legs and the
+// MX1616H direction logic, run against the recording driver in tools/host/driver/mcpwm_prelude.h.
+//
+// Build: g++ -std=c++20 -O2 -Itools/host -Imain -Imain/HardwareManager -o mcpwm_motor_check
+//            tools/mcpwm_motor_check.cpp main/HardwareManager/Components/MCPWMTimer.cpp
+//            main/HardwareManager/Components/MCPWMPWM.cpp main/HardwareManager/Components/MCPWMMotor.cpp
+//            main/HardwareManager/Components/MX1616HMotor.cpp
+// Usage: ./mcpwm_motor_check
+//
+// Checked, on the default 80 MHz timer at 20 kHz:
+//   - timer, operator, comparator and generator setup: the timer runs, the operator is on it, and
+//     each leg's comparator only latches on timer zero
+//   - generator actions per count mode: center aligned sets the leg low on the compare match
+//     counting up and high counting down; edge aligned sets it high at zero and low on the match
+//   - compare values: lround(duty * peak) with a peak of 2000 center aligned and 4000 edge
+//     aligned, duties above one clamp to the peak, a negative duty is refused, staging a duty that
+//     is already set makes no driver call
+//   - dead time: a rising-edge delay of the configured ticks on the leg's own generator, none
+//     when it is zero
+//   - direction reversal: nothing changes on the pins before the next timer zero, which then
+//     switches both legs. With a timer zero after any one of the driver calls of the update, no
+//     PWM period has both legs driven
+//   - a failing driver call leaves the motor uninitialized and refusing speeds
+
+#include "include/MCPWMTimer.hpp"
+#include "include/MCPWMPWM.hpp"
+#include "include/MCPWMMotor.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+
+constexpr int PIN_IN1 = 25;
+constexpr int PIN_IN2 = 26;
+constexpr uint32_t DEAD_TIME_TICKS = 16;
+
+bool check(const char* p_what, bool p_ok) {
+    std::printf("  %-72s %s\n", p_what, p_ok ? "ok" : "FAILED");
+    return p_ok;
+}
+
+bool check(const std::string& p_what, bool p_ok) {
+    return check(p_what.c_str(), p_ok);
+}
+
+MCPWMBridgeConfig bridgeConfig(uint32_t p_deadTimeTicks) {
+    MCPWMBridgeConfig l_config;
+    l_config.bridgeId = 0;
+    l_config.pinIn1 = PIN_IN1;
+    l_config.pinIn2 = PIN_IN2;
+    l_config.deadTimeTicks = p_deadTimeTicks;
+    return l_config;
+}
+
+// A timer and one bridge on it, set up the way HardwareManager does
+struct Bridge {
+    Bridge(mcpwm_timer_count_mode_t p_countMode, uint32_t p_deadTimeTicks) {
+        host_mcpwm_reset();
+        MCPWMTimerConfig l_timerConfig;
+        l_timerConfig.countMode = p_countMode;
+        timer = std::make_shared<MCPWMTimer>(l_timerConfig);
+        timerResult = timer->init();
+        motor = std::make_unique<MCPWMMotor>(bridgeConfig(p_deadTimeTicks), timer);
+        motorResult = motor->init();
+        in1 = host_mcpwm().generatorOn(PIN_IN1);
+        in2 = host_mcpwm().generatorOn(PIN_IN2);
+    }
+
+    mcpwm_cmpr_t* comparator(const mcpwm_gen_t* p_generator) const { return host_mcpwm().comparatorOf(p_generator); }
+    uint32_t active(const mcpwm_gen_t* p_generator) const { return comparator(p_generator)->active; }
+    int writes() const { return comparator(in1)->writes + comparator(in2)->writes; }
+    void timerZero() const { host_mcpwm_timer_zero(timer->getHandle()); }
+
+    std::shared_ptr<MCPWMTimer> timer;
+    std::unique_ptr<MCPWMMotor> motor;
+    esp_err_t timerResult;
+    esp_err_t motorResult;
+    mcpwm_gen_t* in1;
+    mcpwm_gen_t* in2;
+};
+
+bool sameCompareAction(const mcpwm_gen_compare_event_action_t& p_a, const mcpwm_gen_compare_event_action_t& p_b) {
+    return p_a.direction == p_b.direction && p_a.comparator == p_b.comparator && p_a.action == p_b.action;
+}
+
+bool checkSetup() {
+    std::printf("Setup, center aligned, %u ticks dead time\n", DEAD_TIME_TICKS);
+    Bridge l_bridge(MCPWM_TIMER_COUNT_MODE_UP_DOWN, DEAD_TIME_TICKS);
+    const HostMcpwm& l_driver = host_mcpwm();
+
+    bool l_ok = check("timer and motor init", l_bridge.timerResult == ESP_OK && l_bridge.motorResult == ESP_OK &&
+                                              l_bridge.motor->isInitialized());
+    const mcpwm_timer_t* l_timer = l_bridge.timer->getHandle();
+    l_ok = check("timer: 4000 ticks per period counting up and down, started",
+                 l_timer->config.period_ticks == 4000 && l_timer->config.count_mode == MCPWM_TIMER_COUNT_MODE_UP_DOWN &&
+                 l_timer->enabled && l_timer->started) && l_ok;
+    l_ok = check("one operator, connected to the timer",
+                 l_driver.operators.size() == 1 && l_driver.operators[0]->timer == l_timer) && l_ok;
+    l_ok = check("a generator on each input pin, on that operator",
+                 l_driver.generators.size() == 2 && l_bridge.in1 && l_bridge.in2 &&
+                 l_bridge.in1->oper == l_driver.operators[0].get() && l_bridge.in2->oper == l_driver.operators[0].get()) && l_ok;
+    if (!l_ok) {
+        return false;
+    }
+
+    mcpwm_cmpr_t* l_cmp1 = l_bridge.comparator(l_bridge.in1);
+    mcpwm_cmpr_t* l_cmp2 = l_bridge.comparator(l_bridge.in2);
+    l_ok = check("a comparator per leg, latched on timer zero, starting at 0",
+                 l_cmp1 && l_cmp2 && l_cmp1 != l_cmp2 && l_cmp1->updateOnZero && l_cmp2->updateOnZero &&
+                 l_cmp1->active == 0 && l_cmp2->active == 0) && l_ok;
+
+    bool l_actions = true;
+    for (const mcpwm_gen_t* l_generator : {l_bridge.in1, l_bridge.in2}) {
+        mcpwm_cmpr_t* l_comparator = l_bridge.comparator(l_generator);
+        l_actions = l_actions && l_generator->timerActions.empty() && l_generator->compareActions.size() == 2 &&
+                    sameCompareAction(l_generator->compareActions[0],
+                        MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, l_comparator, MCPWM_GEN_ACTION_LOW)) &&
+                    sameCompareAction(l_generator->compareActions[1],
+                        MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_DOWN, l_comparator, MCPWM_GEN_ACTION_HIGH));
+    }
+    l_ok = check("actions: low on the match counting up, high counting down", l_actions) && l_ok;
+
+    bool l_deadTime = true;
+    for (const mcpwm_gen_t* l_generator : {l_bridge.in1, l_bridge.in2}) {
+        l_deadTime = l_deadTime && l_generator->deadTimeSet && l_generator->deadTimeOut == l_generator &&
+                     l_generator->deadTime.posedge_delay_ticks == DEAD_TIME_TICKS &&
+                     l_generator->deadTime.negedge_delay_ticks == 0;
+    }
+    l_ok = check("dead time: rising edge delayed on each leg's own generator", l_deadTime) && l_ok;
+    return l_ok;
+}
+
+bool checkEdgeAligned() {
+    std::printf("Setup, edge aligned, no dead time\n");
+    Bridge l_bridge(MCPWM_TIMER_COUNT_MODE_UP, 0);
+    bool l_ok = check("timer and motor init", l_bridge.timerResult == ESP_OK && l_bridge.motorResult == ESP_OK);
+    if (!l_ok || !l_bridge.in1 || !l_bridge.in2) {
+        return false;
+    }
+
+    bool l_actions = true;
+    for (const mcpwm_gen_t* l_generator : {l_bridge.in1, l_bridge.in2}) {
+        l_actions = l_actions && l_generator->timerActions.size() == 1 && l_generator->compareActions.size() == 1 &&
+                    l_generator->timerActions[0].direction == MCPWM_TIMER_DIRECTION_UP &&
+                    l_generator->timerActions[0].event == MCPWM_TIMER_EVENT_EMPTY &&
+                    l_generator->timerActions[0].action == MCPWM_GEN_ACTION_HIGH &&
+                    sameCompareAction(l_generator->compareActions[0],
+                        MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, l_bridge.comparator(l_generator), MCPWM_GEN_ACTION_LOW));
+    }
+    l_ok = check("actions: high at zero, low on the match", l_actions) && l_ok;
+    l_ok = check("no dead time configured", !l_bridge.in1->deadTimeSet && !l_bridge.in2->deadTimeSet) && l_ok;
+
+    l_bridge.motor->setSpeed(0.3337f);
+    l_bridge.timerZero();
+    l_ok = check("duty 0.3337 is compare value 1335 of 4000",
+                 l_bridge.active(l_bridge.in1) == 1335 && l_bridge.active(l_bridge.in2) == 0) && l_ok;
+    return l_ok;
+}
+
+bool checkCompareValues() {
+    std::printf("Compare values, center aligned\n");
+    Bridge l_bridge(MCPWM_TIMER_COUNT_MODE_UP_DOWN, DEAD_TIME_TICKS);
+    uint32_t l_peak = l_bridge.timer->getPeakTicks();
+    bool l_ok = check("2000 duty steps", l_peak == 2000);
+
+    const struct { float speed; uint32_t in1; uint32_t in2; } l_cases[] = {
+        {0.25f, 500, 0}, {0.3337f, 667, 0}, {0.00024f, 0, 0}, {0.00026f, 1, 0}, {1.0f, 2000, 0}, {1.7f, 2000, 0},
+        {-0.5f, 0, 1000}, {-1.7f, 0, 2000}, {0.0f, 0, 0},
+    };
+    for (const auto& l_case : l_cases) {
+        esp_err_t l_ret = l_bridge.motor->setSpeed(l_case.speed);
+        l_bridge.timerZero();
+        uint32_t l_in1 = l_bridge.active(l_bridge.in1);
+        uint32_t l_in2 = l_bridge.active(l_bridge.in2);
+        char l_what[96];
+        std::snprintf(l_what, sizeof(l_what), "speed %+.5f: IN1 %4u IN2 %4u, expected %4u %4u", l_case.speed, l_in1, l_in2,
+                      l_case.in1, l_case.in2);
+        l_ok = check(l_what, l_ret == ESP_OK && l_in1 == l_case.in1 && l_in2 == l_case.in2) && l_ok;
+    }
+
+    l_bridge.motor->setSpeed(0.42f);
+    int l_writes = l_bridge.writes();
+    esp_err_t l_ret = l_bridge.motor->setSpeed(0.42f);
+    l_ret = l_ret == ESP_OK ? l_bridge.motor->setSpeed(0.42001f) : l_ret;
+    l_ok = check("the same duty again makes no driver call", l_ret == ESP_OK && l_bridge.writes() == l_writes) && l_ok;
+
+    // A leg on its own, the bridge only ever stages magnitudes
+    mcpwm_oper_handle_t l_operator = nullptr;
+    mcpwm_operator_config_t l_operatorConfig = {};
+    mcpwm_new_operator(&l_operatorConfig, &l_operator);
+    mcpwm_operator_connect_timer(l_operator, l_bridge.timer->getHandle());
+    MCPWMPWM l_leg(27, l_operator, l_bridge.timer, 0);
+    l_ok = check("a leg refuses duties before init", l_leg.stageDuty(0.5f) == ESP_ERR_INVALID_STATE) && l_ok;
+    l_leg.init();
+    mcpwm_cmpr_t* l_comparator = host_mcpwm().comparatorOf(host_mcpwm().generatorOn(27));
+    l_leg.setDuty(0.5f);
+    l_writes = l_comparator->writes;
+    l_ret = l_leg.stageDuty(-0.1f);
+    l_ok = check("a negative duty is refused and leaves the compare value",
+                 l_ret == ESP_ERR_INVALID_ARG && l_comparator->writes == l_writes && l_comparator->shadow == 1000) && l_ok;
+    return l_ok;
+}
+
+// Both legs above zero for a PWM period drives the bridge against itself
+bool bothDriven(const Bridge& p_bridge) {
+    return p_bridge.active(p_bridge.in1) > 0 && p_bridge.active(p_bridge.in2) > 0;
+}
+
+bool checkReversal() {
+    std::printf("Direction reversal\n");
+    Bridge l_bridge(MCPWM_TIMER_COUNT_MODE_UP_DOWN, DEAD_TIME_TICKS);
+    l_bridge.motor->setSpeed(0.6f);
+    l_bridge.timerZero();
+
+    l_bridge.motor->stageSpeed(-0.6f);
+    l_bridge.motor->commitSpeed();
+    bool l_ok = check("staged and committed: pins unchanged until the timer zero",
+                      l_bridge.active(l_bridge.in1) == 1200 && l_bridge.active(l_bridge.in2) == 0);
+    l_bridge.timerZero();
+    l_ok = check("one timer zero switches both legs",
+                 l_bridge.active(l_bridge.in1) == 0 && l_bridge.active(l_bridge.in2) == 1200) && l_ok;
+
+    // The timer runs on while the task updates, its zero can fall after any driver call
+    int l_calls = 0;
+    host_mcpwm().afterCall = [&l_calls](const char*) { l_calls++; };
+    l_bridge.motor->setSpeed(0.6f);
+    int l_callsPerReversal = l_calls;
+    host_mcpwm().afterCall = nullptr;
+
+    bool l_neverBoth = true;
+    int l_cases = 0;
+    for (float l_from : {0.6f, -0.6f, 1.0f, -0.05f}) {
+        for (int l_zeroAfter = 1; l_zeroAfter <= l_callsPerReversal; l_zeroAfter++) {
+            l_bridge.motor->setSpeed(l_from);
+            l_bridge.timerZero();
+            l_calls = 0;
+            host_mcpwm().afterCall = [&](const char*) {
+                if (++l_calls == l_zeroAfter) {
+                    l_bridge.timerZero();
+                    l_neverBoth = l_neverBoth && !bothDriven(l_bridge);
+                }
+            };
+            l_bridge.motor->setSpeed(-l_from);
+            host_mcpwm().afterCall = nullptr;
+            l_neverBoth = l_neverBoth && !bothDriven(l_bridge);
+            l_bridge.timerZero();
+            l_neverBoth = l_neverBoth && !bothDriven(l_bridge) &&
+                          l_bridge.active(l_from > 0 ? l_bridge.in2 : l_bridge.in1) == std::lround(std::fabs(l_from) * 2000);
+            l_cases++;
+        }
+    }
+    char l_what[96];
+    std::snprintf(l_what, sizeof(l_what), "timer zero after each of %d driver calls, %d reversals: never both driven",
+                  l_callsPerReversal, l_cases);
+    l_ok = check(l_what, l_neverBoth && l_callsPerReversal == 2) && l_ok;
+    return l_ok;
+}
+
+bool checkInitFailure() {
+    std::printf("Driver failures\n");
+    bool l_ok = true;
+    for (const char* l_call : {"mcpwm_new_operator", "mcpwm_operator_connect_timer", "mcpwm_new_comparator",
+                               "mcpwm_new_generator", "mcpwm_generator_set_action_on_compare_event",
+                               "mcpwm_generator_set_dead_time"}) {
+        host_mcpwm_reset();
+        auto l_timer = std::make_shared<MCPWMTimer>(MCPWMTimerConfig{});
+        l_timer->init();
+        host_mcpwm().failCall = l_call;
+        MCPWMMotor l_motor(bridgeConfig(DEAD_TIME_TICKS), l_timer);
+        esp_err_t l_ret = l_motor.init();
+        l_ok = check(std::string(l_call) + " fails: motor left uninitialized",
+                     l_ret == ESP_FAIL && !l_motor.isInitialized() && l_motor.setSpeed(0.5f) == ESP_ERR_INVALID_STATE) && l_ok;
+    }
+    return l_ok;
+}
+
+}  // namespace
+
+int main() {
+    bool l_ok = checkSetup();
+    std::printf("\n");
+    l_ok = checkEdgeAligned() && l_ok;
+    std::printf("\n");
+    l_ok = checkCompareValues() && l_ok;
+    std::printf("\n");
+    l_ok = checkReversal() && l_ok;
+    std::printf("\n");
+    l_ok = checkInitFailure() && l_ok;
+    return l_ok ? 0 : 1;
+}
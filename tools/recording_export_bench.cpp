@@ -0,0 +1,433 @@
+// Host check and benchmark of the fall dump download behind GET /blackbox?id=N.
+//
+// Build: g++ -std=c++17 -O2 -pthread -Imain -o recording_export_bench tools/recording_export_bench.cpp
+//            main/FlightRecording.cpp main/TelemetryFrame.cpp
+// Usage: ./recording_export_bench [frames=1024] [rounds=50]
+//
+// Writes a synthetic dump, serves it on loopback with the loop of WebServer::blackBoxDumpHandler
+// (the same FlightRecordingExport, 1 kB chunks, chunked transfer encoding, Range handling) and
+// downloads it with a minimal HTTP client standing in for the browser or curl. Checks that the
+// binary download is the file, that every CSV row has the same width and reads back as the frame
+// values, and that downloads resumed with a Range request at awkward offsets match the full one.
+// Then reports the throughput of the transcoding alone and over loopback, and the memory the
+// server side needs: the heap it allocates while serving, counted by interposing malloc (needs
+// glibc), and the fixed buffers on its stack.
+
+#include "include/FlightRecording.hpp"
+#include "include/TelemetryFrame.hpp"
+
+#include <arpa/inet.h>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+
+namespace {
+
+struct HeapStats {
+    long allocations = 0;
+    long long live = 0;
+    long long peak = 0;
+};
+
+// Only the server thread counts, the client's strings are not part of the robot's bill
+HeapStats g_heap;
+int g_downloads = 0;
+thread_local bool t_counting = false;
+
+void onAllocate(void* p_pointer) {
+    if (!t_counting || p_pointer == nullptr) return;
+    g_heap.allocations++;
+    g_heap.live += malloc_usable_size(p_pointer);
+    if (g_heap.live > g_heap.peak) g_heap.peak = g_heap.live;
+}
+
+void onFree(void* p_pointer) {
+    if (t_counting && p_pointer != nullptr) g_heap.live -= malloc_usable_size(p_pointer);
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t p_size) {
+    void* l_pointer = __libc_malloc(p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void* calloc(size_t p_count, size_t p_size) {
+    void* l_pointer = __libc_calloc(p_count, p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void* realloc(void* p_pointer, size_t p_size) {
+    onFree(p_pointer);
+    void* l_pointer = __libc_realloc(p_pointer, p_size);
+    onAllocate(l_pointer);
+    return l_pointer;
+}
+
+void free(void* p_pointer) {
+    onFree(p_pointer);
+    __libc_free(p_pointer);
+}
+
+}  // extern "C"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Format = FlightRecordingExport::Format;
+
+constexpr size_t EXPORT_CHUNK_SIZE = 1024;      // WebServer::EXPORT_CHUNK_SIZE
+constexpr const char* DUMP_PATH = "/tmp/recording_export_bench.bbx";
+
+int argument(int argc, char** argv, const char* p_name, int p_default) {
+    size_t l_length = std::strlen(p_name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], p_name, l_length) == 0 && argv[i][l_length] == '=') {
+            return std::atoi(argv[i] + l_length + 1);
+        }
+    }
+    return p_default;
+}
+
+// A fall: a slow wobble that grows until the last quarter, shaped like FlightRecorder output
+std::string makeDump(int p_frames) {
+    FlightRecordingHeader l_header;
+    l_header.frameSize = TelemetryCodec::HEADER_SIZE + TelemetryFrame::FIELD_COUNT * sizeof(uint16_t);
+    l_header.frameCount = p_frames;
+    l_header.triggerIndex = p_frames * 3 / 4;
+
+    std::string l_dump(FlightRecording::HEADER_SIZE + p_frames * l_header.frameSize, '\0');
+    uint8_t* l_bytes = reinterpret_cast<uint8_t*>(&l_dump[0]);
+    FlightRecording::encodeHeader(l_header, l_bytes, FlightRecording::HEADER_SIZE);
+    for (int n = 0; n < p_frames; n++) {
+        TelemetryFrame l_frame;
+        l_frame.state = n < static_cast<int>(l_header.triggerIndex) ? 2 : 3;
+        l_frame.sequence = 100000 + n;
+        l_frame.timestamp = 1234567890LL + n * 10000LL;
+        float l_growth = 1.0f + 4.0f * n / p_frames;
+        for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+            float l_scale = i == TelemetryFrame::PID_OUTPUT ? 1023.0f : 10.0f;
+            l_frame.values[i] = l_scale * l_growth * std::sin(0.05f * n + i);
+        }
+        TelemetryCodec::encode(l_frame, true, l_bytes + FlightRecording::HEADER_SIZE + n * l_header.frameSize,
+                               l_header.frameSize);
+    }
+    return l_dump;
+}
+
+bool readFileAt(void* p_context, uint32_t p_offset, uint8_t* p_buffer, size_t p_length) {
+    FILE* l_file = static_cast<FILE*>(p_context);
+    if (ftell(l_file) != static_cast<long>(p_offset) && fseek(l_file, p_offset, SEEK_SET) != 0) {
+        return false;
+    }
+    return fread(p_buffer, 1, p_length, l_file) == p_length;
+}
+
+bool readMemoryAt(void* p_context, uint32_t p_offset, uint8_t* p_buffer, size_t p_length) {
+    const std::string& l_dump = *static_cast<const std::string*>(p_context);
+    if (p_offset + p_length > l_dump.size()) return false;
+    std::memcpy(p_buffer, l_dump.data() + p_offset, p_length);
+    return true;
+}
+
+bool sendAll(int p_fd, const char* p_data, size_t p_length) {
+    while (p_length > 0) {
+        ssize_t l_sent = send(p_fd, p_data, p_length, MSG_NOSIGNAL);
+        if (l_sent <= 0) return false;
+        p_data += l_sent;
+        p_length -= l_sent;
+    }
+    return true;
+}
+
+bool sendChunk(int p_fd, const char* p_data, size_t p_length) {
+    char l_size[16];
+    int l_header = std::snprintf(l_size, sizeof(l_size), "%zx\r\n", p_length);
+    return sendAll(p_fd, l_size, l_header) && sendAll(p_fd, p_data, p_length) && sendAll(p_fd, "\r\n", 2);
+}
+
+// The robot's handler with httpd replaced by a socket
+void serve(int p_fd, Format p_format, const char* p_range) {
+    struct stat l_stat;
+    FILE* l_file = stat(DUMP_PATH, &l_stat) == 0 ? fopen(DUMP_PATH, "rb") : nullptr;
+    FlightRecordingExport l_recording(p_format, readFileAt, l_file);
+    if (l_file == nullptr || !l_recording.open(static_cast<uint32_t>(l_stat.st_size))) {
+        const char* l_error = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        sendAll(p_fd, l_error, std::strlen(l_error));
+        if (l_file) fclose(l_file);
+        return;
+    }
+
+    uint32_t l_size = l_recording.size();
+    uint32_t l_first = 0;
+    uint32_t l_last = l_size > 0 ? l_size - 1 : 0;
+    char l_head[256];
+    int l_length;
+    if (p_range != nullptr && !FlightRecordingExport::parseRange(p_range, l_size, l_first, l_last)) {
+        l_length = std::snprintf(l_head, sizeof(l_head), "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%u\r\n"
+                                 "Content-Length: 0\r\nConnection: close\r\n\r\n", l_size);
+        sendAll(p_fd, l_head, l_length);
+        fclose(l_file);
+        return;
+    }
+    l_length = std::snprintf(l_head, sizeof(l_head), "HTTP/1.1 %s\r\nContent-Type: %s\r\nAccept-Ranges: bytes\r\n",
+                             p_range ? "206 Partial Content" : "200 OK", p_format == Format::CSV ? "text/csv" : "application/octet-stream");
+    if (p_range) {
+        l_length += std::snprintf(l_head + l_length, sizeof(l_head) - l_length, "Content-Range: bytes %u-%u/%u\r\n",
+                                  l_first, l_last, l_size);
+    }
+    l_length += std::snprintf(l_head + l_length, sizeof(l_head) - l_length, "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n");
+    bool l_ok = sendAll(p_fd, l_head, l_length);
+
+    char l_chunk[EXPORT_CHUNK_SIZE];
+    uint32_t l_remaining = l_size > 0 ? l_last - l_first + 1 : 0;
+    l_recording.seek(l_first);
+    while (l_ok && l_remaining > 0) {
+        size_t l_count = l_recording.read(l_chunk, std::min<size_t>(sizeof(l_chunk), l_remaining));
+        if (l_count == 0) break;
+        l_ok = sendChunk(p_fd, l_chunk, l_count);
+        l_remaining -= l_count;
+    }
+    fclose(l_file);
+    if (l_ok) sendAll(p_fd, "0\r\n\r\n", 5);
+}
+
+void serverLoop(int p_listenFd) {
+    while (true) {
+        int l_fd = accept(p_listenFd, nullptr, nullptr);
+        if (l_fd < 0) return;
+
+        std::string l_request;
+        char l_buffer[1024];
+        while (l_request.find("\r\n\r\n") == std::string::npos) {
+            ssize_t l_received = recv(l_fd, l_buffer, sizeof(l_buffer), 0);
+            if (l_received <= 0) break;
+            l_request.append(l_buffer, l_received);
+        }
+        if (l_request.compare(0, 10, "GET /quit ") == 0) {
+            close(l_fd);
+            return;
+        }
+        Format l_format = l_request.find("format=csv") != std::string::npos ? Format::CSV : Format::BINARY;
+        std::string l_range;
+        size_t l_position = l_request.find("\r\nRange: ");
+        if (l_position != std::string::npos) {
+            size_t l_start = l_position + 9;
+            l_range = l_request.substr(l_start, l_request.find("\r\n", l_start) - l_start);
+        }
+
+        g_downloads++;
+        t_counting = true;
+        serve(l_fd, l_format, l_range.empty() ? nullptr : l_range.c_str());
+        t_counting = false;
+        close(l_fd);
+    }
+}
+
+struct Response {
+    int status = 0;
+    std::string headers;
+    std::string body;
+};
+
+Response get(int p_port, const std::string& p_target, const std::string& p_range = "") {
+    Response l_response;
+    int l_fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in l_address {};
+    l_address.sin_family = AF_INET;
+    l_address.sin_port = htons(p_port);
+    l_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(l_fd, reinterpret_cast<sockaddr*>(&l_address), sizeof(l_address)) != 0) {
+        close(l_fd);
+        return l_response;
+    }
+    std::string l_request = "GET " + p_target + " HTTP/1.1\r\nHost: robot\r\n";
+    if (!p_range.empty()) l_request += "Range: " + p_range + "\r\n";
+    l_request += "\r\n";
+    sendAll(l_fd, l_request.data(), l_request.size());
+
+    std::string l_raw;
+    char l_buffer[16384];
+    ssize_t l_received;
+    while ((l_received = recv(l_fd, l_buffer, sizeof(l_buffer), 0)) > 0) {
+        l_raw.append(l_buffer, l_received);
+    }
+    close(l_fd);
+
+    size_t l_end = l_raw.find("\r\n\r\n");
+    if (l_end == std::string::npos) return l_response;
+    l_response.headers = l_raw.substr(0, l_end + 2);
+    l_response.status = std::atoi(l_raw.c_str() + 9);
+    if (l_response.headers.find("Transfer-Encoding: chunked") == std::string::npos) {
+        l_response.body = l_raw.substr(l_end + 4);
+        return l_response;
+    }
+    size_t l_position = l_end + 4;
+    while (l_position < l_raw.size()) {
+        size_t l_size = std::strtoul(l_raw.c_str() + l_position, nullptr, 16);
+        l_position = l_raw.find("\r\n", l_position) + 2;
+        if (l_size == 0) break;
+        l_response.body.append(l_raw, l_position, l_size);
+        l_position += l_size + 2;
+    }
+    return l_response;
+}
+
+bool checkCsv(const std::string& p_csv, const std::string& p_dump) {
+    FlightRecordingHeader l_header;
+    FlightRecording::decodeHeader(reinterpret_cast<const uint8_t*>(p_dump.data()), p_dump.size(), l_header);
+    size_t l_headerLine = p_csv.find('\n') + 1;
+    if (p_csv.size() != l_headerLine + l_header.frameCount * FlightRecordingExport::CSV_ROW_SIZE) {
+        std::printf("  csv: %zu bytes, expected %zu\n", p_csv.size(),
+                    l_headerLine + l_header.frameCount * FlightRecordingExport::CSV_ROW_SIZE);
+        return false;
+    }
+    for (uint32_t n = 0; n < l_header.frameCount; n++) {
+        const char* l_row = p_csv.c_str() + l_headerLine + n * FlightRecordingExport::CSV_ROW_SIZE;
+        if (l_row[FlightRecordingExport::CSV_ROW_SIZE - 1] != '\n') {
+            std::printf("  csv: row %u is not %zu bytes wide\n", n, FlightRecordingExport::CSV_ROW_SIZE);
+            return false;
+        }
+        TelemetryFrame l_frame;
+        TelemetryCodec::decode(reinterpret_cast<const uint8_t*>(p_dump.data()) + l_header.headerSize + n * l_header.frameSize,
+                               l_header.frameSize, l_frame);
+        char* l_cursor;
+        unsigned long l_sequence = std::strtoul(l_row, &l_cursor, 10);
+        std::strtoul(l_cursor + 1, &l_cursor, 10);
+        long long l_timestamp = std::strtoll(l_cursor + 1, &l_cursor, 10);
+        long l_trigger = std::strtol(l_cursor + 1, &l_cursor, 10);
+        if (l_sequence != l_frame.sequence || l_timestamp != l_frame.timestamp || (l_trigger == 1) != (n == l_header.triggerIndex)) {
+            std::printf("  csv: row %u header columns wrong\n", n);
+            return false;
+        }
+        for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+            double l_value = std::strtod(l_cursor + 1, &l_cursor);
+            if (std::fabs(l_value - l_frame.values[i]) > 0.0006) {
+                std::printf("  csv: row %u %s %.4f, frame has %.4f\n", n, TelemetryCodec::fieldName(i), l_value, l_frame.values[i]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool checkResume(int p_port, const std::string& p_target, const std::string& p_full, size_t p_headerLine) {
+    bool l_ok = true;
+    size_t l_row = FlightRecordingExport::CSV_ROW_SIZE;
+    size_t l_offsets[] = {1, 37, p_headerLine - 1, p_headerLine, p_headerLine + l_row - 1, p_headerLine + 5 * l_row + 100,
+                          p_full.size() / 2, p_full.size() - 1};
+    for (size_t l_offset : l_offsets) {
+        Response l_response = get(p_port, p_target, "bytes=" + std::to_string(l_offset) + "-");
+        if (l_response.status != 206 || l_response.body != p_full.substr(l_offset)) {
+            std::printf("  %s: resume at %zu gave status %d and %zu bytes\n", p_target.c_str(), l_offset, l_response.status,
+                        l_response.body.size());
+            l_ok = false;
+        }
+    }
+    Response l_head = get(p_port, p_target, "bytes=0-99");
+    Response l_tail = get(p_port, p_target, "bytes=-50");
+    Response l_beyond = get(p_port, p_target, "bytes=" + std::to_string(p_full.size()) + "-");
+    if (l_head.body != p_full.substr(0, 100) || l_tail.body != p_full.substr(p_full.size() - 50) || l_beyond.status != 416) {
+        std::printf("  %s: bounded, suffix or unsatisfiable range wrong\n", p_target.c_str());
+        l_ok = false;
+    }
+    return l_ok;
+}
+
+double transcodeRate(const std::string& p_dump, Format p_format, int p_rounds, uint32_t& p_size) {
+    char l_chunk[EXPORT_CHUNK_SIZE];
+    uint64_t l_bytes = 0;
+    auto l_start = Clock::now();
+    for (int r = 0; r < p_rounds; r++) {
+        FlightRecordingExport l_recording(p_format, readMemoryAt, const_cast<std::string*>(&p_dump));
+        l_recording.open(p_dump.size());
+        p_size = l_recording.size();
+        size_t l_count;
+        while ((l_count = l_recording.read(l_chunk, sizeof(l_chunk))) > 0) l_bytes += l_count;
+    }
+    return l_bytes / std::chrono::duration<double>(Clock::now() - l_start).count() / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int l_frames = std::max(1, argument(argc, argv, "frames", 1024));
+    int l_rounds = std::max(1, argument(argc, argv, "rounds", 50));
+
+    std::string l_dump = makeDump(l_frames);
+    FILE* l_file = std::fopen(DUMP_PATH, "wb");
+    if (l_file == nullptr || std::fwrite(l_dump.data(), 1, l_dump.size(), l_file) != l_dump.size()) {
+        std::printf("Failed to write %s\n", DUMP_PATH);
+        return 1;
+    }
+    std::fclose(l_file);
+
+    int l_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in l_address {};
+    l_address.sin_family = AF_INET;
+    l_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t l_addressLength = sizeof(l_address);
+    if (bind(l_listenFd, reinterpret_cast<sockaddr*>(&l_address), sizeof(l_address)) != 0 || listen(l_listenFd, 4) != 0 ||
+        getsockname(l_listenFd, reinterpret_cast<sockaddr*>(&l_address), &l_addressLength) != 0) {
+        std::printf("Failed to listen on loopback\n");
+        return 1;
+    }
+    int l_port = ntohs(l_address.sin_port);
+    std::thread l_server(serverLoop, l_listenFd);
+
+    std::printf("Dump of %d frames, %zu bytes, served on 127.0.0.1:%d\n", l_frames, l_dump.size(), l_port);
+    Response l_binary = get(l_port, "/blackbox?id=0&format=binary");
+    Response l_csv = get(l_port, "/blackbox?id=0&format=csv");
+    bool l_binaryOk = l_binary.status == 200 && l_binary.body == l_dump;
+    bool l_csvOk = l_csv.status == 200 && checkCsv(l_csv.body, l_dump);
+    size_t l_headerLine = l_csv.body.find('\n') + 1;
+    bool l_resumeOk = checkResume(l_port, "/blackbox?id=0&format=binary", l_dump, FlightRecording::HEADER_SIZE + 1) &&
+                      checkResume(l_port, "/blackbox?id=0&format=csv", l_csv.body, l_headerLine);
+    std::printf("  binary download matches the file: %s\n", l_binaryOk ? "ok" : "FAILED");
+    std::printf("  csv download, %zu bytes in %zu byte rows, values read back: %s\n", l_csv.body.size(),
+                FlightRecordingExport::CSV_ROW_SIZE, l_csvOk ? "ok" : "FAILED");
+    std::printf("  ranges resumed at row, chunk and header boundaries: %s\n", l_resumeOk ? "ok" : "FAILED");
+
+    std::printf("\n%-10s %12s %16s %16s\n", "", "bytes", "transcode MB/s", "loopback MB/s");
+    for (Format l_format : {Format::BINARY, Format::CSV}) {
+        uint32_t l_size = 0;
+        double l_transcode = transcodeRate(l_dump, l_format, l_rounds, l_size);
+        std::string l_target = l_format == Format::CSV ? "/blackbox?id=0&format=csv" : "/blackbox?id=0&format=binary";
+        uint64_t l_bytes = 0;
+        auto l_start = Clock::now();
+        for (int r = 0; r < l_rounds; r++) l_bytes += get(l_port, l_target).body.size();
+        double l_loopback = l_bytes / std::chrono::duration<double>(Clock::now() - l_start).count() / 1e6;
+        std::printf("%-10s %12u %16.1f %16.1f\n", l_format == Format::CSV ? "csv" : "binary", l_size, l_transcode, l_loopback);
+    }
+
+    std::printf("\nServer side per download: %.1f heap allocations, peak heap %lld bytes (the FILE and its stdio buffer),\n"
+                "%zu bytes of exporter and %zu bytes of chunk on the stack\n",
+                static_cast<double>(g_heap.allocations) / g_downloads, g_heap.peak,
+                sizeof(FlightRecordingExport), EXPORT_CHUNK_SIZE);
+
+    get(l_port, "/quit");
+    l_server.join();
+    close(l_listenFd);
+    std::remove(DUMP_PATH);
+    return l_binaryOk && l_csvOk && l_resumeOk ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+// Host check and benchmark of the telemetry ring between PIDTask and TelemetryTask.
+//
+// Build: g++ -std=c++17 -O2 -pthread -Imain -o spsc_ring_bench tools/spsc_ring_bench.cpp
+// Usage: ./spsc_ring_bench [loop_hz=1000] [seconds=5] [batch_ms=20] [stall_ms=0]
+//   e.g. ./spsc_ring_bench loop_hz=1000 stall_ms=200
+//
+// A producer thread pushes one record per loop period like the control loop, a consumer
+// thread drains up to a batch every batch_ms like the telemetry task and, with stall_ms,
+// stops draining for that long once a second to stand in for a stalled web server. Checks
+// that every record arrives once and in order and that the sequence gaps add up to the
+// dropped count, then reports the cost of push() and the batch sizes seen. A final pass
+// pushes flat out to measure the throughput of the ring itself.
+
+#include "include/SpscRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same size as TelemetryData on the ESP32
+struct Record {
+    uint32_t sequence;
+    uint8_t payload[92];
+};
+static_assert(sizeof(Record) == 96, "Record should match TelemetryData");
+
+// Same capacity and batch size as the robot
+using Ring = SpscRing<Record, 128>;
+constexpr size_t MAX_BATCH = 64;
+
+struct Result {
+    uint32_t produced = 0;
+    uint32_t received = 0;
+    uint32_t gaps = 0;          // Records missing between consecutive received ones
+    uint32_t outOfOrder = 0;
+    size_t maxBatch = 0;
+    std::vector<double> pushNs;
+};
+
+int argument(int argc, char** argv, const char* p_name, int p_default) {
+    size_t l_length = std::strlen(p_name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], p_name, l_length) == 0 && argv[i][l_length] == '=') {
+            return std::atoi(argv[i] + l_length + 1);
+        }
+    }
+    return p_default;
+}
+
+double percentile(std::vector<double>& p_values, double p_fraction) {
+    if (p_values.empty()) return 0.0;
+    size_t l_index = static_cast<size_t>(p_fraction * (p_values.size() - 1));
+    std::nth_element(p_values.begin(), p_values.begin() + l_index, p_values.end());
+    return p_values[l_index];
+}
+
+void consume(Ring& p_ring, Result& p_result, bool& p_first, uint32_t& p_expected) {
+    Record l_batch[MAX_BATCH];
+    size_t l_count = p_ring.pop(l_batch, MAX_BATCH);
+    p_result.maxBatch = std::max(p_result.maxBatch, l_count);
+    for (size_t i = 0; i < l_count; i++) {
+        uint32_t l_sequence = l_batch[i].sequence;
+        // The payload is written from the sequence, a torn record would not match
+        if (l_batch[i].payload[0] != static_cast<uint8_t>(l_sequence) ||
+            l_batch[i].payload[91] != static_cast<uint8_t>(l_sequence >> 8)) {
+            p_result.outOfOrder++;
+        }
+        if (!p_first && l_sequence < p_expected) {
+            p_result.outOfOrder++;
+        } else if (!p_first) {
+            p_result.gaps += l_sequence - p_expected;
+        }
+        p_first = false;
+        p_expected = l_sequence + 1;
+        p_result.received++;
+    }
+}
+
+Result run(Ring& p_ring, int p_loopHz, int p_seconds, int p_batchMs, int p_stallMs) {
+    Result l_result;
+    std::atomic<bool> l_producerDone(false);
+    bool l_first = true;
+    uint32_t l_expected = 0;
+
+    std::thread l_consumer([&] {
+        auto l_start = Clock::now();
+        auto l_next = l_start;
+        while (!l_producerDone.load() || p_ring.size() > 0) {
+            double l_second = std::chrono::duration<double>(Clock::now() - l_start).count();
+            bool l_stalled = p_stallMs > 0 && (l_second - static_cast<int>(l_second)) * 1000.0 < p_stallMs;
+            if (!l_stalled || l_producerDone.load()) {
+                consume(p_ring, l_result, l_first, l_expected);
+            }
+            l_next += std::chrono::milliseconds(p_batchMs);
+            std::this_thread::sleep_until(l_next);
+        }
+    });
+
+    auto l_period = std::chrono::nanoseconds(1000000000LL / p_loopHz);
+    auto l_next = Clock::now();
+    uint32_t l_total = static_cast<uint32_t>(p_loopHz) * p_seconds;
+    l_result.pushNs.reserve(l_total);
+    for (uint32_t n = 0; n < l_total; n++) {
+        Record l_record;
+        l_record.sequence = n;
+        std::memset(l_record.payload, 0, sizeof(l_record.payload));
+        l_record.payload[0] = static_cast<uint8_t>(n);
+        l_record.payload[91] = static_cast<uint8_t>(n >> 8);
+
+        auto l_before = Clock::now();
+        p_ring.push(l_record);
+        l_result.pushNs.push_back(std::chrono::duration<double, std::nano>(Clock::now() - l_before).count());
+        l_result.produced++;
+
+        l_next += l_period;
+        std::this_thread::sleep_until(l_next);
+    }
+    l_producerDone.store(true);
+    l_consumer.join();
+    // Records dropped after the last one received leave no gap behind them
+    l_result.gaps += l_result.produced - l_expected;
+    return l_result;
+}
+
+double flatOut(uint32_t p_count) {
+    Ring l_ring;
+    std::atomic<bool> l_done(false);
+    uint32_t l_received = 0;
+    std::thread l_consumer([&] {
+        Record l_batch[MAX_BATCH];
+        while (!l_done.load() || l_ring.size() > 0) {
+            size_t l_count = l_ring.pop(l_batch, MAX_BATCH);
+            l_received += l_count;
+            // Gives the producer the core on a single CPU machine
+            if (l_count == 0) std::this_thread::yield();
+        }
+    });
+    Record l_record {};
+    auto l_start = Clock::now();
+    for (uint32_t n = 0; n < p_count; n++) {
+        l_record.sequence = n;
+        while (!l_ring.push(l_record)) {
+            std::this_thread::yield();
+        }
+    }
+    l_done.store(true);
+    l_consumer.join();
+    double l_seconds = std::chrono::duration<double>(Clock::now() - l_start).count();
+    // Retried pushes also count as dropped, only the delivered ones are throughput
+    return l_received / l_seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int l_loopHz = std::max(1, argument(argc, argv, "loop_hz", 1000));
+    int l_seconds = std::max(1, argument(argc, argv, "seconds", 5));
+    int l_batchMs = std::max(1, argument(argc, argv, "batch_ms", 20));
+    int l_stallMs = std::max(0, argument(argc, argv, "stall_ms", 0));
+
+    std::printf("Ring of %u records of %zu bytes (%zu bytes), %d Hz loop for %d s, batches every %d ms",
+                Ring::capacity(), sizeof(Record), sizeof(Ring), l_loopHz, l_seconds, l_batchMs);
+    if (l_stallMs > 0) std::printf(", consumer stalls %d ms every second", l_stallMs);
+    std::printf("\n");
+    std::fflush(stdout);
+
+    auto* l_ring = new Ring();
+    Result l_result = run(*l_ring, l_loopHz, l_seconds, l_batchMs, l_stallMs);
+
+    bool l_ok = l_result.outOfOrder == 0 && l_result.received + l_ring->dropped() == l_result.produced &&
+                l_result.gaps == l_ring->dropped();
+    std::printf("  produced %u, received %u, dropped %u, sequence gaps %u, out of order or torn %u: %s\n",
+                l_result.produced, l_result.received, l_ring->dropped(), l_result.gaps, l_result.outOfOrder,
+                l_ok ? "ok" : "FAILED");
+    std::printf("  largest batch %zu of %zu\n", l_result.maxBatch, MAX_BATCH);
+    std::printf("  push: median %.0f ns, p99 %.0f ns, max %.0f ns\n", percentile(l_result.pushNs, 0.5),
+                percentile(l_result.pushNs, 0.99), percentile(l_result.pushNs, 1.0));
+    delete l_ring;
+
+    std::printf("Flat out: %.1f M records/s\n", flatOut(20000000) / 1e6);
+    return l_ok ? 0 : 1;
+}
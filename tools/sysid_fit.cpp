@@ -0,0 +1,218 @@
+// Fits a discrete transfer function to an identification run exported from GET /sysid.
+//
+// Build: g++ -std=c++17 -O2 -o sysid_fit tools/sysid_fit.cpp
+// Usage: ./sysid_fit run.csv [na=2] [nb=2] [nk=1] [input=command|excitation] [output=pitch|rate|speed]
+//   e.g. curl -s http://robot/sysid > run.csv && ./sysid_fit run.csv na=2 nb=2 input=excitation
+//
+// Least squares ARX model  y[k] + a1 y[k-1] + ... + a_na y[k-na] = b1 u[k-nk] + ... + b_nb u[k-nk-nb+1]
+// Prints the coefficients, the discrete poles with their continuous equivalents and the fit of a
+// free-run simulation of the model against the recording.
+//
+// The run is recorded in closed loop. With input=excitation the fit is the closed-loop response,
+// which is unbiased. With input=command it approximates the open-loop plant, but the balance
+// controller feeds the pitch noise back into the command, so keep the excitation well above the
+// noise floor and treat slow poles with care.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Recording {
+    float dt = 0.0f;
+    std::vector<double> excitation, command, pitch, pitchRate, wheelSpeed;
+};
+
+bool load(const char* p_path, Recording& p_recording) {
+    std::ifstream l_file(p_path);
+    if (!l_file) {
+        return false;
+    }
+    std::string l_line;
+    while (std::getline(l_file, l_line)) {
+        if (l_line.empty()) continue;
+        if (l_line[0] == '#') {
+            size_t l_pos = l_line.find("dt=");
+            if (l_pos != std::string::npos) p_recording.dt = std::strtof(l_line.c_str() + l_pos + 3, nullptr);
+            if (l_line.find("status=aborted") != std::string::npos) std::printf("note: the run was aborted, fitting what was recorded\n");
+            continue;
+        }
+        if (l_line.compare(0, 6, "time_s") == 0) continue;
+
+        double l_values[8];
+        if (std::sscanf(l_line.c_str(), "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf", &l_values[0], &l_values[1], &l_values[2],
+                        &l_values[3], &l_values[4], &l_values[5], &l_values[6], &l_values[7]) != 8) {
+            std::fprintf(stderr, "skipping malformed row '%s'\n", l_line.c_str());
+            continue;
+        }
+        p_recording.excitation.push_back(l_values[1]);
+        p_recording.command.push_back(l_values[2]);
+        p_recording.pitch.push_back(l_values[3]);
+        p_recording.pitchRate.push_back(l_values[4]);
+        p_recording.wheelSpeed.push_back(0.5 * (l_values[5] + l_values[6]));
+    }
+    return p_recording.dt > 0.0f && !p_recording.pitch.empty();
+}
+
+void removeMean(std::vector<double>& p_signal) {
+    double l_mean = 0.0;
+    for (double v : p_signal) l_mean += v;
+    l_mean /= p_signal.size();
+    for (double& v : p_signal) v -= l_mean;
+}
+
+// Solves A x = b in place by Gaussian elimination with partial pivoting
+bool solve(std::vector<std::vector<double>>& p_a, std::vector<double>& p_b) {
+    int n = static_cast<int>(p_b.size());
+    for (int col = 0; col < n; col++) {
+        int l_pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (std::fabs(p_a[row][col]) > std::fabs(p_a[l_pivot][col])) l_pivot = row;
+        }
+        if (std::fabs(p_a[l_pivot][col]) < 1e-12) return false;
+        std::swap(p_a[col], p_a[l_pivot]);
+        std::swap(p_b[col], p_b[l_pivot]);
+        for (int row = col + 1; row < n; row++) {
+            double l_factor = p_a[row][col] / p_a[col][col];
+            for (int k = col; k < n; k++) p_a[row][k] -= l_factor * p_a[col][k];
+            p_b[row] -= l_factor * p_b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--) {
+        for (int k = row + 1; k < n; k++) p_b[row] -= p_a[row][k] * p_b[k];
+        p_b[row] /= p_a[row][row];
+    }
+    return true;
+}
+
+// Regressor of sample k: past outputs then delayed inputs
+void regressor(const std::vector<double>& p_y, const std::vector<double>& p_u, int k, int p_na, int p_nb, int p_nk,
+               std::vector<double>& p_phi) {
+    for (int i = 0; i < p_na; i++) p_phi[i] = -p_y[k - 1 - i];
+    for (int i = 0; i < p_nb; i++) p_phi[p_na + i] = p_u[k - p_nk - i];
+}
+
+// Roots of z^n + c[0] z^(n-1) + ... + c[n-1] by Durand-Kerner iteration
+std::vector<std::complex<double>> roots(const std::vector<double>& p_coefficients) {
+    int n = static_cast<int>(p_coefficients.size());
+    std::vector<std::complex<double>> l_roots(n);
+    for (int i = 0; i < n; i++) l_roots[i] = std::pow(std::complex<double>(0.4, 0.9), i);
+    auto evaluate = [&](std::complex<double> z) {
+        std::complex<double> l_value = 1.0;
+        for (double c : p_coefficients) l_value = l_value * z + c;
+        return l_value;
+    };
+    for (int iteration = 0; iteration < 500; iteration++) {
+        for (int i = 0; i < n; i++) {
+            std::complex<double> l_denominator = 1.0;
+            for (int j = 0; j < n; j++) {
+                if (j != i) l_denominator *= l_roots[i] - l_roots[j];
+            }
+            l_roots[i] -= evaluate(l_roots[i]) / l_denominator;
+        }
+    }
+    return l_roots;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s run.csv [na=2] [nb=2] [nk=1] [input=command|excitation] [output=pitch|rate|speed]\n", argv[0]);
+        return 1;
+    }
+    int l_na = 2, l_nb = 2, l_nk = 1;
+    std::string l_input = "command", l_output = "pitch";
+    for (int i = 2; i < argc; i++) {
+        if (std::strncmp(argv[i], "na=", 3) == 0) l_na = std::atoi(argv[i] + 3);
+        else if (std::strncmp(argv[i], "nb=", 3) == 0) l_nb = std::atoi(argv[i] + 3);
+        else if (std::strncmp(argv[i], "nk=", 3) == 0) l_nk = std::atoi(argv[i] + 3);
+        else if (std::strncmp(argv[i], "input=", 6) == 0) l_input = argv[i] + 6;
+        else if (std::strncmp(argv[i], "output=", 7) == 0) l_output = argv[i] + 7;
+        else {
+            std::fprintf(stderr, "bad argument '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+    if (l_na < 1 || l_nb < 1 || l_nk < 0 || l_na > 8 || l_nb > 8) {
+        std::fprintf(stderr, "orders must be 1..8 and nk >= 0\n");
+        return 1;
+    }
+
+    Recording l_recording;
+    if (!load(argv[1], l_recording)) {
+        std::fprintf(stderr, "could not read an identification run from %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<double> l_u = l_input == "excitation" ? l_recording.excitation : l_recording.command;
+    std::vector<double> l_y = l_output == "rate" ? l_recording.pitchRate
+                            : l_output == "speed" ? l_recording.wheelSpeed : l_recording.pitch;
+    // Fit deviations around the operating point, the balance angle is not part of the dynamics
+    removeMean(l_u);
+    removeMean(l_y);
+
+    int l_parameters = l_na + l_nb;
+    int l_start = std::max(l_na, l_nk + l_nb - 1);
+    int l_samples = static_cast<int>(l_y.size());
+    if (l_samples - l_start < 4 * l_parameters) {
+        std::fprintf(stderr, "only %d samples, too short for %d parameters\n", l_samples, l_parameters);
+        return 1;
+    }
+
+    // Normal equations, small enough that forming Phi'Phi is fine
+    std::vector<std::vector<double>> l_normal(l_parameters, std::vector<double>(l_parameters, 0.0));
+    std::vector<double> l_theta(l_parameters, 0.0), l_phi(l_parameters);
+    for (int k = l_start; k < l_samples; k++) {
+        regressor(l_y, l_u, k, l_na, l_nb, l_nk, l_phi);
+        for (int i = 0; i < l_parameters; i++) {
+            for (int j = 0; j < l_parameters; j++) l_normal[i][j] += l_phi[i] * l_phi[j];
+            l_theta[i] += l_phi[i] * l_y[k];
+        }
+    }
+    if (!solve(l_normal, l_theta)) {
+        std::fprintf(stderr, "singular regression, is the excitation too small or the input constant?\n");
+        return 1;
+    }
+
+    std::printf("%d samples, dt %.4f s, %s -> %s, na=%d nb=%d nk=%d\n\n", l_samples, l_recording.dt,
+                l_input.c_str(), l_output.c_str(), l_na, l_nb, l_nk);
+    std::printf("A(z) = 1");
+    for (int i = 0; i < l_na; i++) std::printf(" %+.6f z^-%d", l_theta[i], i + 1);
+    std::printf("\nB(z) =");
+    for (int i = 0; i < l_nb; i++) std::printf(" %+.6f z^-%d", l_theta[l_na + i], l_nk + i);
+    std::printf("\n\n%24s %24s %10s %10s\n", "z pole", "s pole (1/s)", "|z|", "f (Hz)");
+
+    std::vector<double> l_a(l_theta.begin(), l_theta.begin() + l_na);
+    for (const std::complex<double>& z : roots(l_a)) {
+        std::complex<double> s = std::log(z) / static_cast<double>(l_recording.dt);
+        char l_zText[32], l_sText[32];
+        std::snprintf(l_zText, sizeof(l_zText), "%.4f%+.4fj", z.real(), z.imag());
+        std::snprintf(l_sText, sizeof(l_sText), "%.3f%+.3fj", s.real(), s.imag());
+        std::printf("%24s %24s %10.4f %10.3f%s\n", l_zText, l_sText, std::abs(z), std::abs(s) / (2.0 * M_PI),
+                    std::abs(z) > 1.0 ? "  unstable" : "");
+    }
+
+    // Free-run simulation from the input alone, the one-step prediction would flatter the model
+    std::vector<double> l_simulated(l_samples, 0.0);
+    for (int k = 0; k < l_start; k++) l_simulated[k] = l_y[k];
+    double l_error = 0.0, l_energy = 0.0;
+    for (int k = l_start; k < l_samples; k++) {
+        regressor(l_simulated, l_u, k, l_na, l_nb, l_nk, l_phi);
+        double l_value = 0.0;
+        for (int i = 0; i < l_parameters; i++) l_value += l_phi[i] * l_theta[i];
+        l_simulated[k] = l_value;
+        l_error += (l_y[k] - l_value) * (l_y[k] - l_value);
+        l_energy += l_y[k] * l_y[k];
+    }
+    std::printf("\nsimulation fit %.1f%%\n", 100.0 * (1.0 - std::sqrt(l_error / std::max(l_energy, 1e-12))));
+    return 0;
+}
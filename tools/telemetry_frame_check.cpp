@@ -0,0 +1,139 @@
+// Host check of the binary telemetry frame used on /ws/telemetry.
+//
+// Build: g++ -std=c++17 -O2 -Imain -o telemetry_frame_check tools/telemetry_frame_check.cpp main/TelemetryFrame.cpp
+// Usage: ./telemetry_frame_check [frames]
+//
+// Round trips a frame in both precisions, checks the half float conversion over every
+// 16-bit pattern, then compares frame size and encode cost with the JSON fallback.
+// Host programs decode frames by building main/TelemetryFrame.cpp the same way.
+
+#include "include/TelemetryFrame.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+TelemetryFrame makeFrame(uint32_t p_sequence) {
+    TelemetryFrame l_frame;
+    l_frame.state = 2;
+    l_frame.sequence = p_sequence;
+    l_frame.timestamp = 123456789012LL + p_sequence * 10000LL;
+    for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+        l_frame.values[i] = std::sin(0.1f * p_sequence + i) * (i == TelemetryFrame::PID_OUTPUT ? 1023.0f : 10.0f);
+    }
+    return l_frame;
+}
+
+bool checkRoundTrip(bool p_half) {
+    TelemetryFrame l_in = makeFrame(77);
+    uint8_t l_buffer[TelemetryCodec::MAX_SIZE];
+    size_t l_length = TelemetryCodec::encode(l_in, p_half, l_buffer, sizeof(l_buffer));
+
+    TelemetryFrame l_out;
+    if (l_length == 0 || !TelemetryCodec::decode(l_buffer, l_length, l_out)) {
+        std::printf("  %s: encode or decode failed\n", p_half ? "half" : "single");
+        return false;
+    }
+    bool l_ok = l_out.sequence == l_in.sequence && l_out.timestamp == l_in.timestamp && l_out.state == l_in.state &&
+                l_out.fieldCount == TelemetryFrame::FIELD_COUNT;
+    for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+        // Half floats keep 11 significant bits
+        float l_tolerance = p_half ? std::fabs(l_in.values[i]) / 1024.0f + 1e-4f : 0.0f;
+        if (std::fabs(l_out.values[i] - l_in.values[i]) > l_tolerance) {
+            std::printf("  %s: %s %.6f decoded as %.6f\n", p_half ? "half" : "single", TelemetryCodec::fieldName(i),
+                        l_in.values[i], l_out.values[i]);
+            l_ok = false;
+        }
+    }
+
+    // A decoder must cope with a shorter frame from an older firmware
+    TelemetryFrame l_short;
+    size_t l_valueSize = p_half ? 2 : 4;
+    if (!TelemetryCodec::decode(l_buffer, TelemetryCodec::HEADER_SIZE + 3 * l_valueSize, l_short) || l_short.fieldCount != 3) {
+        std::printf("  %s: truncated frame not handled\n", p_half ? "half" : "single");
+        l_ok = false;
+    }
+    std::printf("%-7s round trip %s, %zu bytes\n", p_half ? "half" : "single", l_ok ? "ok" : "FAILED", l_length);
+    return l_ok;
+}
+
+bool checkHalf() {
+    int l_errors = 0;
+    for (uint32_t l_bits = 0; l_bits < 0x10000u; l_bits++) {
+        uint16_t l_half = static_cast<uint16_t>(l_bits);
+        float l_value = TelemetryCodec::fromHalf(l_half);
+        if (std::isnan(l_value)) continue;
+        if (TelemetryCodec::toHalf(l_value) != l_half) l_errors++;
+    }
+    // Rounding, overflow and underflow at the edges of the range
+    struct { float value; uint16_t half; } l_cases[] = {
+        {1.0f, 0x3C00}, {-2.0f, 0xC000}, {65504.0f, 0x7BFF}, {65520.0f, 0x7C00}, {1e9f, 0x7C00},
+        {1.0f + 1.0f / 2048.0f, 0x3C00}, {1.0f + 3.0f / 2048.0f, 0x3C02}, {5.96e-8f, 0x0001}, {1e-10f, 0x0000},
+    };
+    for (const auto& l_case : l_cases) {
+        if (TelemetryCodec::toHalf(l_case.value) != l_case.half) {
+            std::printf("  toHalf(%g) = 0x%04X, expected 0x%04X\n", l_case.value, TelemetryCodec::toHalf(l_case.value), l_case.half);
+            l_errors++;
+        }
+    }
+    std::printf("half    conversion %s\n", l_errors == 0 ? "exact over all 65536 patterns" : "FAILED");
+    return l_errors == 0;
+}
+
+// Same format string as WebServer::formatTelemetry, motorSpeed is not in the frame and repeats pidOutput
+int formatJson(const TelemetryFrame& p_frame, char* p_buffer, size_t p_size) {
+    const float* v = p_frame.values;
+    return std::snprintf(p_buffer, p_size,
+                         "{\"sequence\":%u,\"state\":%u,\"timestamp\":%lld,\"pitch\":%.3f,\"roll\":%.3f,\"yaw\":%.3f,"
+                         "\"pitchRate\":%.2f,\"yawRate\":%.2f,\"leftWheelSpeed\":%.3f,\"rightWheelSpeed\":%.3f,"
+                         "\"pTerm\":%.4f,\"iTerm\":%.4f,\"dTerm\":%.4f,\"pidOutput\":%.2f,\"motorSpeed\":%.2f,"
+                         "\"leftDuty\":%.4f,\"rightDuty\":%.4f,\"predictedPitch\":%.3f,\"predictionHorizonMs\":%.2f,\"latencyMs\":%.2f}",
+                         static_cast<unsigned>(p_frame.sequence), static_cast<unsigned>(p_frame.state),
+                         static_cast<long long>(p_frame.timestamp), v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
+                         v[9], v[10], v[10], v[11], v[12], v[13], v[14], v[15]);
+}
+
+template <typename Encode>
+double nsPerFrame(long p_frames, Encode p_encode) {
+    auto l_start = std::chrono::steady_clock::now();
+    for (long i = 0; i < p_frames; i++) p_encode(static_cast<uint32_t>(i));
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - l_start).count() / p_frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    long l_frames = argc > 1 ? std::atol(argv[1]) : 200000;
+
+    bool l_ok = checkRoundTrip(false);
+    l_ok = checkRoundTrip(true) && l_ok;
+    l_ok = checkHalf() && l_ok;
+
+    TelemetryFrame l_frame = makeFrame(1);
+    uint8_t l_binary[TelemetryCodec::MAX_SIZE];
+    char l_json[768];
+    volatile size_t l_sink = 0;
+
+    double l_single = nsPerFrame(l_frames, [&](uint32_t i) {
+        l_frame.sequence = i;
+        l_sink = l_sink + TelemetryCodec::encode(l_frame, false, l_binary, sizeof(l_binary));
+    });
+    double l_half = nsPerFrame(l_frames, [&](uint32_t i) {
+        l_frame.sequence = i;
+        l_sink = l_sink + TelemetryCodec::encode(l_frame, true, l_binary, sizeof(l_binary));
+    });
+    double l_text = nsPerFrame(l_frames, [&](uint32_t i) {
+        l_frame.sequence = i;
+        l_sink = l_sink + formatJson(l_frame, l_json, sizeof(l_json));
+    });
+
+    std::printf("\n%-8s %8s %12s\n", "format", "bytes", "ns/frame");
+    std::printf("%-8s %8zu %12.1f\n", "single", TelemetryCodec::HEADER_SIZE + TelemetryFrame::FIELD_COUNT * 4, l_single);
+    std::printf("%-8s %8zu %12.1f\n", "half", TelemetryCodec::HEADER_SIZE + TelemetryFrame::FIELD_COUNT * 2, l_half);
+    std::printf("%-8s %8d %12.1f\n", "json", formatJson(l_frame, l_json, sizeof(l_json)), l_text);
+    return l_ok ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+// Host collector of the UDP telemetry stream of UdpTelemetrySender.
+//
+// Build: g++ -std=c++17 -O2 -pthread -Imain -o udp_telemetry_collector tools/udp_telemetry_collector.cpp main/TelemetryFrame.cpp
+// Usage: ./udp_telemetry_collector [port=5005] [out=telemetry.frames] [seconds=0] [loopback=0] [loop_hz=1000] [loss=0]
+//   e.g. ./udp_telemetry_collector port=5005 out=run1.frames      with "udp_telemetry" pointed at this host
+//        ./udp_telemetry_collector loopback=1 seconds=5 loss=5    without a robot
+//
+// Listens on the port, appends every frame it receives to the out file back to back as sent
+// (TelemetryCodec frames of the size in the datagram header) and prints once a second:
+//   - datagrams lost, from gaps in the datagram sequence, and late ones that arrived out of order
+//   - records missing, from gaps in the frame sequence: lost datagrams plus ring drops on the robot
+//   - batch age, the time between a record's sample and its datagram leaving the robot
+//   - transit above the fastest datagram seen. The robot and host clocks are not synchronized, so
+//     the one-way delay is only known up to a constant: the smallest receive minus send time seen
+//     so far is taken as the zero. Spikes and queueing show, the constant wire time does not.
+// Runs until Ctrl-C or for the given seconds.
+//
+// With loopback=1 a thread stands in for the robot: records at loop_hz, sent every 20 ms packed
+// the way UdpTelemetrySender packs them, loss percent of the datagrams skipped on purpose. At the
+// end the counted losses must equal the skipped datagrams and records.
+
+#include "include/TelemetryFrame.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int BATCH_PERIOD_MS = 20;         // TelemetryTask::BATCH_PERIOD_MS
+constexpr size_t FRAME_SIZE = TelemetryCodec::MAX_SIZE;     // UdpTelemetrySender::FRAME_SIZE, full precision
+
+std::atomic<bool> g_stop(false);
+const Clock::time_point g_epoch = Clock::now();
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - g_epoch).count();
+}
+
+const char* argument(int argc, char** argv, const char* p_name, const char* p_default) {
+    size_t l_length = std::strlen(p_name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], p_name, l_length) == 0 && argv[i][l_length] == '=') {
+            return argv[i] + l_length + 1;
+        }
+    }
+    return p_default;
+}
+
+int argument(int argc, char** argv, const char* p_name, int p_default) {
+    const char* l_value = argument(argc, argv, p_name, static_cast<const char*>(nullptr));
+    return l_value ? std::atoi(l_value) : p_default;
+}
+
+double percentile(std::vector<double>& p_values, double p_fraction) {
+    if (p_values.empty()) return 0.0;
+    size_t l_index = static_cast<size_t>(p_fraction * (p_values.size() - 1));
+    std::nth_element(p_values.begin(), p_values.begin() + l_index, p_values.end());
+    return p_values[l_index];
+}
+
+struct Totals {
+    uint64_t datagrams = 0;
+    uint64_t frames = 0;
+    uint64_t datagramsLost = 0;
+    uint64_t late = 0;
+    uint64_t recordsMissing = 0;
+    uint64_t malformed = 0;
+};
+
+class Collector {
+public:
+    // A sequence further back than this is a restart, not a late datagram
+    static constexpr uint32_t RESTART_WINDOW = 256;
+
+    explicit Collector(FILE* p_out) : m_out(p_out) {}
+
+    void receive(const uint8_t* p_datagram, size_t p_length, int64_t p_receivedUs) {
+        TelemetryDatagramHeader l_header;
+        if (!TelemetryDatagram::decodeHeader(p_datagram, p_length, l_header)) {
+            m_interval.malformed++;
+            return;
+        }
+        m_interval.datagrams++;
+        if (!m_started || l_header.sequence + RESTART_WINDOW < m_nextDatagram) {
+            // First datagram, or the robot restarted and counts from 0 again
+            m_started = true;
+            m_framesStarted = false;
+            m_nextDatagram = 0;
+            m_minOffset = INT64_MAX;
+        } else if (l_header.sequence >= m_nextDatagram) {
+            m_interval.datagramsLost += l_header.sequence - m_nextDatagram;
+        } else {
+            // Counted as lost when the gap showed up
+            m_interval.late++;
+            if (m_interval.datagramsLost > 0) m_interval.datagramsLost--;
+            else if (m_total.datagramsLost > 0) m_total.datagramsLost--;
+        }
+        m_nextDatagram = std::max(m_nextDatagram, l_header.sequence + 1);
+
+        int64_t l_offset = p_receivedUs - l_header.sentUs;
+        m_minOffset = std::min(m_minOffset, l_offset);
+        m_transitUs.push_back(static_cast<double>(l_offset));
+
+        for (size_t l_position = TelemetryDatagram::HEADER_SIZE; l_position + l_header.frameSize <= p_length;
+             l_position += l_header.frameSize) {
+            TelemetryFrame l_frame;
+            if (!TelemetryCodec::decode(p_datagram + l_position, l_header.frameSize, l_frame)) {
+                m_interval.malformed++;
+                continue;
+            }
+            m_interval.frames++;
+            if (m_framesStarted && l_frame.sequence > m_nextFrame) {
+                m_interval.recordsMissing += l_frame.sequence - m_nextFrame;
+            }
+            if (!m_framesStarted || l_frame.sequence >= m_nextFrame) {
+                m_nextFrame = l_frame.sequence + 1;
+            }
+            m_framesStarted = true;
+            m_batchAgeUs.push_back(static_cast<double>(l_header.sentUs - l_frame.timestamp));
+            if (m_out) std::fwrite(p_datagram + l_position, 1, l_header.frameSize, m_out);
+        }
+    }
+
+    // Prints the interval since the last call and folds it into the totals
+    void report(double p_seconds, double p_elapsed) {
+        std::vector<double> l_transit;
+        for (double l_offset : m_transitUs) l_transit.push_back(l_offset - m_minOffset);
+        uint64_t l_sent = m_interval.datagrams + m_interval.datagramsLost;
+        std::printf("%6.1f s  %5.0f datagrams/s  %6.0f records/s  lost %llu (%.2f%%)  late %llu  missing records %llu"
+                    "  batch age p50 %.1f max %.1f ms  transit above min p50 %.2f p99 %.2f max %.2f ms\n",
+                    p_elapsed, m_interval.datagrams / p_seconds, m_interval.frames / p_seconds,
+                    static_cast<unsigned long long>(m_interval.datagramsLost), l_sent ? 100.0 * m_interval.datagramsLost / l_sent : 0.0,
+                    static_cast<unsigned long long>(m_interval.late), static_cast<unsigned long long>(m_interval.recordsMissing),
+                    percentile(m_batchAgeUs, 0.5) / 1000.0, percentile(m_batchAgeUs, 1.0) / 1000.0,
+                    percentile(l_transit, 0.5) / 1000.0, percentile(l_transit, 0.99) / 1000.0, percentile(l_transit, 1.0) / 1000.0);
+        std::fflush(stdout);
+        if (m_out) std::fflush(m_out);
+
+        m_total.datagrams += m_interval.datagrams;
+        m_total.frames += m_interval.frames;
+        m_total.datagramsLost += m_interval.datagramsLost;
+        m_total.late += m_interval.late;
+        m_total.recordsMissing += m_interval.recordsMissing;
+        m_total.malformed += m_interval.malformed;
+        m_interval = Totals();
+        m_transitUs.clear();
+        m_batchAgeUs.clear();
+    }
+
+    const Totals& total() const { return m_total; }
+
+private:
+    FILE* m_out;
+    Totals m_interval;
+    Totals m_total;
+    bool m_started = false;
+    bool m_framesStarted = false;
+    uint32_t m_nextDatagram = 0;
+    uint32_t m_nextFrame = 0;
+    int64_t m_minOffset = INT64_MAX;
+    std::vector<double> m_transitUs;
+    std::vector<double> m_batchAgeUs;
+};
+
+struct Injected {
+    uint64_t datagrams = 0;
+    uint64_t frames = 0;
+    uint64_t skippedDatagrams = 0;
+    uint64_t skippedFrames = 0;
+    // Skipped before the first or after the last datagram sent, no gap can show them
+    uint64_t unseenDatagrams = 0;
+    uint64_t unseenFrames = 0;
+};
+
+// UdpTelemetrySender::send and flush with the socket on loopback and the loss on purpose
+class RobotStandIn {
+public:
+    RobotStandIn(int p_port, int p_lossPercent) : m_lossPercent(p_lossPercent) {
+        m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+        m_destination.sin_family = AF_INET;
+        m_destination.sin_port = htons(p_port);
+        m_destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    ~RobotStandIn() { close(m_socket); }
+
+    void send(const TelemetryFrame* p_frames, size_t p_count) {
+        for (size_t i = 0; i < p_count; i++) {
+            if (m_length == 0) m_length = TelemetryDatagram::HEADER_SIZE;
+            m_length += TelemetryCodec::encode(p_frames[i], false, m_datagram + m_length, sizeof(m_datagram) - m_length);
+            m_frames++;
+            if (sizeof(m_datagram) - m_length < FRAME_SIZE) flush();
+        }
+        flush();
+    }
+
+    Injected injected() const {
+        Injected l_injected = m_injected;
+        l_injected.unseenDatagrams += m_trailingDatagrams;
+        l_injected.unseenFrames += m_trailingFrames;
+        return l_injected;
+    }
+
+private:
+    int m_socket;
+    sockaddr_in m_destination {};
+    int m_lossPercent;
+    uint32_t m_sequence = 0;
+    uint8_t m_datagram[TelemetryDatagram::MAX_SIZE];
+    size_t m_length = 0;
+    size_t m_frames = 0;
+    Injected m_injected;
+    bool m_sentAny = false;
+    uint64_t m_trailingDatagrams = 0;
+    uint64_t m_trailingFrames = 0;
+
+    void flush() {
+        if (m_length <= TelemetryDatagram::HEADER_SIZE) return;
+        TelemetryDatagramHeader l_header;
+        l_header.frameSize = FRAME_SIZE;
+        l_header.sequence = m_sequence++;
+        l_header.sentUs = nowUs();
+        TelemetryDatagram::encodeHeader(l_header, m_datagram, sizeof(m_datagram));
+        m_injected.datagrams++;
+        m_injected.frames += m_frames;
+        if (std::rand() % 100 < m_lossPercent) {
+            m_injected.skippedDatagrams++;
+            m_injected.skippedFrames += m_frames;
+            m_trailingDatagrams++;
+            m_trailingFrames += m_frames;
+            if (!m_sentAny) {
+                m_injected.unseenDatagrams++;
+                m_injected.unseenFrames += m_frames;
+            }
+        } else {
+            sendto(m_socket, m_datagram, m_length, 0, reinterpret_cast<sockaddr*>(&m_destination), sizeof(m_destination));
+            m_sentAny = true;
+            m_trailingDatagrams = 0;
+            m_trailingFrames = 0;
+        }
+        m_length = 0;
+        m_frames = 0;
+    }
+};
+
+void runRobot(RobotStandIn& p_robot, int p_loopHz, int p_seconds) {
+    int64_t l_periodUs = 1000000 / p_loopHz;
+    uint32_t l_sequence = 0;
+    int64_t l_nextSampleUs = nowUs();
+    int64_t l_endUs = l_nextSampleUs + p_seconds * 1000000LL;
+    std::vector<TelemetryFrame> l_batch;
+    auto l_wake = Clock::now();
+    while (!g_stop.load() && nowUs() < l_endUs) {
+        l_wake += std::chrono::milliseconds(BATCH_PERIOD_MS);
+        std::this_thread::sleep_until(l_wake);
+        // Every cycle since the last batch, as TelemetryTask finds them in the ring
+        l_batch.clear();
+        for (int64_t l_now = nowUs(); l_nextSampleUs <= l_now; l_nextSampleUs += l_periodUs) {
+            TelemetryFrame l_frame;
+            l_frame.state = 2;
+            l_frame.sequence = l_sequence++;
+            l_frame.timestamp = l_nextSampleUs;
+            for (int i = 0; i < TelemetryFrame::FIELD_COUNT; i++) {
+                l_frame.values[i] = std::sin(0.01f * l_frame.sequence + i);
+            }
+            l_batch.push_back(l_frame);
+        }
+        p_robot.send(l_batch.data(), l_batch.size());
+    }
+}
+
+void onSignal(int) {
+    g_stop.store(true);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int l_port = argument(argc, argv, "port", 5005);
+    const char* l_outPath = argument(argc, argv, "out", "telemetry.frames");
+    bool l_loopback = argument(argc, argv, "loopback", 0) != 0;
+    int l_seconds = std::max(0, argument(argc, argv, "seconds", l_loopback ? 5 : 0));
+    int l_loopHz = std::max(1, argument(argc, argv, "loop_hz", 1000));
+    int l_lossPercent = std::min(100, std::max(0, argument(argc, argv, "loss", 0)));
+
+    int l_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in l_address {};
+    l_address.sin_family = AF_INET;
+    l_address.sin_port = htons(l_port);
+    l_address.sin_addr.s_addr = htonl(l_loopback ? INADDR_LOOPBACK : INADDR_ANY);
+    // A second of telemetry fits in the receive buffer while this thread prints
+    int l_bufferSize = 1 << 20;
+    setsockopt(l_socket, SOL_SOCKET, SO_RCVBUF, &l_bufferSize, sizeof(l_bufferSize));
+    timeval l_timeout {0, 100000};
+    setsockopt(l_socket, SOL_SOCKET, SO_RCVTIMEO, &l_timeout, sizeof(l_timeout));
+    if (bind(l_socket, reinterpret_cast<sockaddr*>(&l_address), sizeof(l_address)) != 0) {
+        std::printf("Failed to bind UDP port %d\n", l_port);
+        return 1;
+    }
+    FILE* l_out = std::fopen(l_outPath, "wb");
+    if (l_out == nullptr) {
+        std::printf("Failed to open %s\n", l_outPath);
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+
+    std::printf("Collecting on UDP port %d into %s%s\n", l_port, l_outPath, l_loopback ? ", robot stand-in on loopback" : "");
+    std::fflush(stdout);
+
+    RobotStandIn l_robot(l_port, l_lossPercent);
+    std::thread l_robotThread;
+    if (l_loopback) {
+        std::srand(1);
+        l_robotThread = std::thread(runRobot, std::ref(l_robot), l_loopHz, l_seconds);
+    }
+
+    Collector l_collector(l_out);
+    uint8_t l_datagram[65536];
+    auto l_start = Clock::now();
+    auto l_lastReport = l_start;
+    while (!g_stop.load()) {
+        ssize_t l_length = recv(l_socket, l_datagram, sizeof(l_datagram), 0);
+        if (l_length > 0) {
+            l_collector.receive(l_datagram, static_cast<size_t>(l_length), nowUs());
+        }
+        auto l_now = Clock::now();
+        double l_interval = std::chrono::duration<double>(l_now - l_lastReport).count();
+        double l_elapsed = std::chrono::duration<double>(l_now - l_start).count();
+        if (l_interval >= 1.0) {
+            l_collector.report(l_interval, l_elapsed);
+            l_lastReport = l_now;
+        }
+        // The stand-in's last datagrams are in by the time the socket has been quiet for a timeout
+        if (l_seconds > 0 && l_elapsed >= l_seconds && (!l_loopback || l_length <= 0)) {
+            break;
+        }
+    }
+    g_stop.store(true);
+    if (l_robotThread.joinable()) l_robotThread.join();
+    l_collector.report(std::max(1e-3, std::chrono::duration<double>(Clock::now() - l_lastReport).count()),
+                       std::chrono::duration<double>(Clock::now() - l_start).count());
+    std::fclose(l_out);
+    close(l_socket);
+
+    const Totals& l_total = l_collector.total();
+    std::printf("Total: %llu datagrams, %llu records written, %llu datagrams lost, %llu late, %llu records missing, %llu malformed\n",
+                static_cast<unsigned long long>(l_total.datagrams), static_cast<unsigned long long>(l_total.frames),
+                static_cast<unsigned long long>(l_total.datagramsLost), static_cast<unsigned long long>(l_total.late),
+                static_cast<unsigned long long>(l_total.recordsMissing), static_cast<unsigned long long>(l_total.malformed));
+    if (!l_loopback) {
+        return 0;
+    }
+
+    Injected l_injected = l_robot.injected();
+    bool l_ok = l_total.datagrams == l_injected.datagrams - l_injected.skippedDatagrams &&
+                l_total.frames == l_injected.frames - l_injected.skippedFrames &&
+                l_total.datagramsLost == l_injected.skippedDatagrams - l_injected.unseenDatagrams &&
+                l_total.recordsMissing == l_injected.skippedFrames - l_injected.unseenFrames &&
+                l_total.late == 0 && l_total.malformed == 0;
+    std::printf("Stand-in sent %llu datagrams with %llu records, skipped %llu with %llu records: %s\n",
+                static_cast<unsigned long long>(l_injected.datagrams), static_cast<unsigned long long>(l_injected.frames),
+                static_cast<unsigned long long>(l_injected.skippedDatagrams), static_cast<unsigned long long>(l_injected.skippedFrames),
+                l_ok ? "ok" : "FAILED");
+    return l_ok ? 0 : 1;
+}
@@ -0,0 +1,275 @@
+// Host simulation of the balance cascade: VelocityLoop feeding the pitch setpoint of PIDController
+// on a cart-pendulum model of the robot.
+//
+// Build: g++ -std=c++20 -O2 -Itools/host -Imain -o velocity_loop_sim tools/velocity_loop_sim.cpp
+//            main/VelocityLoop.cpp main/PIDController.cpp main/LowPassFilter.cpp main/BiquadFilter.cpp
+// Usage: ./velocity_loop_sim [trace.csv]
+//
+// The plant is the model tools/lqr_gains.cpp uses, reduced to what the cascade sees: wheels that
+// follow the motor command with a first-order lag and a body balanced on them,
+//
+//   v' = (K u - v) / tau        theta'' = (g sin(theta + c) - v' cos(theta + c)) / l
+//
+// with theta leaning towards positive travel and c the angle of a centre of mass that sits off the
+// line the IMU was levelled on. Like on the robot, a positive pitch is corrected by a negative
+// command, and the encoders count with the command and measure the wheel against the body. The
+// control code runs the way PIDTask calls it, one period of latency between sample and motor.
+//
+// Checked cases:
+//   - with a centre of mass offset the robot, started upright, stops rolling away: wheel speed
+//     settles on the target and the pitch and setpoint on the true balance point
+//   - with position hold as well the wheels stop offset / (Ki + position Kp) rad from where the
+//     loop took over. The speed integral is wheel travel, so both terms act on position and
+//     nothing integrates it further to take the offset out
+//   - a speed target is reached and held
+//   - the loop is enabled while the inner loop alone lets the robot roll away: the setpoint of
+//     the enable cycle is the base target angle and no later outer cycle moves it as far as an
+//     enable without the integrator preload would have. The preload is bounded by the integral
+//     limits, a proportional term beyond Ki * iterm_max still steps the setpoint by the rest.
+
+#include "include/VelocityLoop.hpp"
+#include "include/PIDController.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = 180.0 / PI;
+constexpr double GRAVITY = 9.81;
+
+struct Plant {
+    double length = 0.08;        // Axle to centre of mass, m
+    double wheelRadius = 0.033;  // m
+    double speedGain = 1.0;      // Ground speed at full command, m/s
+    double tau = 0.1;            // Motor speed time constant, s
+    double offset = 0.0;         // Centre of mass off the levelled line, deg towards positive travel
+    double period = 0.01;        // Control period, s
+};
+
+struct State {
+    double position = 0.0;  // m
+    double speed = 0.0;     // m/s
+    double angle = 0.0;     // rad
+    double rate = 0.0;      // rad/s
+};
+
+class Simulation {
+public:
+    explicit Simulation(const Plant& p_plant) : m_plant(p_plant), m_state(), m_command(0.0), m_timestamp(0) {}
+
+    // Applies the command from the previous call, as the motor task does one period later
+    SensorData step(double p_command) {
+        constexpr int SUBSTEPS = 20;
+        double l_h = m_plant.period / SUBSTEPS;
+        double l_offset = m_plant.offset / DEG;
+        for (int i = 0; i < SUBSTEPS; i++) {
+            double l_acceleration = (m_plant.speedGain * m_command - m_state.speed) / m_plant.tau;
+            double l_lean = m_state.angle + l_offset;
+            double l_angular = (GRAVITY * std::sin(l_lean) - l_acceleration * std::cos(l_lean)) / m_plant.length;
+            m_state.position += m_state.speed * l_h;
+            m_state.speed += l_acceleration * l_h;
+            m_state.angle += m_state.rate * l_h;
+            m_state.rate += l_angular * l_h;
+        }
+        m_command = std::clamp(p_command, -1.0, 1.0);
+        m_timestamp += static_cast<int64_t>(m_plant.period * 1e6);
+        return sample();
+    }
+
+    SensorData sample() const {
+        SensorData l_data {};
+        l_data.pitch = static_cast<float>(-m_state.angle * DEG);
+        l_data.pitchRate = static_cast<float>(-m_state.rate * DEG);
+        l_data.leftWheelAngle = static_cast<float>(m_state.position / m_plant.wheelRadius - m_state.angle);
+        l_data.rightWheelAngle = l_data.leftWheelAngle;
+        l_data.leftWheelSpeed = static_cast<float>(m_state.speed / m_plant.wheelRadius - m_state.rate);
+        l_data.rightWheelSpeed = l_data.leftWheelSpeed;
+        l_data.dt = static_cast<float>(m_plant.period);
+        l_data.timestamp = m_timestamp;
+        return l_data;
+    }
+
+private:
+    Plant m_plant;
+    State m_state;
+    double m_command;
+    int64_t m_timestamp;
+};
+
+PIDConfig innerConfig() {
+    PIDConfig l_config {};
+    l_config.kp = 0.12f;
+    l_config.ki = 0.3f;
+    l_config.kd = 0.006f;
+    l_config.targetAngle = 0.0f;
+    l_config.itermMin = -2.0f;
+    l_config.itermMax = 2.0f;
+    l_config.outputMin = -1.0f;
+    l_config.outputMax = 1.0f;
+    return l_config;
+}
+
+VelocityLoopConfig outerConfig() {
+    VelocityLoopConfig l_config;
+    l_config.enabled = true;
+    l_config.kp = 0.5f;
+    l_config.ki = 0.2f;
+    return l_config;
+}
+
+// PIDTask::computeOutput without the auto-tuner and gain schedule
+class Cascade {
+public:
+    Cascade() : m_integral(0.0f), m_lastError(0.0f), m_target(0.0f) {
+        m_pid.setConfig(innerConfig());
+    }
+
+    void setOuter(const VelocityLoopConfig& p_config) { m_outer.setConfig(p_config); }
+
+    float update(const SensorData& p_data) {
+        m_target = m_outer.update(p_data, 0.0f);
+        m_pid.setTargetAngle(m_target);
+        return m_pid.compute(m_integral, m_lastError, p_data);
+    }
+
+    float target() const { return m_target; }
+
+private:
+    PIDController m_pid;
+    VelocityLoop m_outer;
+    float m_integral;
+    float m_lastError;
+    float m_target;
+};
+
+FILE* g_trace = nullptr;
+
+void trace(const char* p_case, double p_time, const SensorData& p_data, float p_target, float p_command) {
+    if (g_trace) {
+        std::fprintf(g_trace, "%s,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f\n", p_case, p_time, p_data.pitch, p_target,
+                     p_data.leftWheelSpeed, p_data.leftWheelAngle, p_command);
+    }
+}
+
+bool check(const char* p_what, double p_value, double p_expected, double p_tolerance, const char* p_unit) {
+    bool l_ok = std::isfinite(p_value) && std::fabs(p_value - p_expected) <= p_tolerance;
+    std::printf("  %-28s %9.4f %-6s expected %9.4f +- %.3f  %s\n", p_what, p_value, p_unit, p_expected, p_tolerance,
+                l_ok ? "ok" : "FAILED");
+    return l_ok;
+}
+
+// Started upright on the levelled line, the outer loop on from the first cycle
+bool checkConvergence(const char* p_name, const Plant& p_plant, const VelocityLoopConfig& p_outer,
+                      double p_duration, bool p_holdPosition) {
+    std::printf("%s: offset %.1f deg, target %.1f rad/s, position Kp %.2f\n", p_name, p_plant.offset,
+                p_outer.targetSpeed, p_outer.positionKp);
+    Simulation l_simulation(p_plant);
+    Cascade l_cascade;
+    l_cascade.setOuter(p_outer);
+
+    SensorData l_data = l_simulation.sample();
+    SensorData l_first = l_data;
+    float l_command = 0.0f;
+    double l_peak = 0.0;
+    int l_steps = static_cast<int>(p_duration / p_plant.period);
+    for (int i = 0; i < l_steps; i++) {
+        l_command = l_cascade.update(l_data);
+        l_data = l_simulation.step(l_command);
+        l_peak = std::max(l_peak, std::fabs(static_cast<double>(l_data.pitch)));
+        trace(p_name, (i + 1) * p_plant.period, l_data, l_cascade.target(), l_command);
+    }
+
+    // Balanced, the IMU reads the offset as pitch
+    bool l_ok = check("wheel speed", l_data.leftWheelSpeed, p_outer.targetSpeed, 0.05, "rad/s");
+    l_ok = check("pitch", l_data.pitch, p_plant.offset, 0.05, "deg") && l_ok;
+    l_ok = check("setpoint", l_cascade.target(), p_plant.offset, 0.05, "deg") && l_ok;
+    if (p_holdPosition) {
+        double l_droop = p_plant.offset / (p_outer.ki + p_outer.positionKp);
+        l_ok = check("wheel position", l_data.leftWheelAngle, l_first.leftWheelAngle + l_droop, 0.1, "rad") && l_ok;
+    }
+    l_ok = check("largest pitch", l_peak, 0.0, p_outer.maxTilt + std::fabs(p_plant.offset), "deg") && l_ok;
+    return l_ok;
+}
+
+// Balancing on the inner loop alone while the offset makes the robot run off, then the outer loop
+// is switched on mid run the way a config broadcast does it
+bool checkBumpless(const Plant& p_plant) {
+    std::printf("Enable while rolling: offset %.1f deg\n", p_plant.offset);
+    Simulation l_simulation(p_plant);
+    Cascade l_cascade;
+    VelocityLoopConfig l_outer = outerConfig();
+    l_outer.enabled = false;
+    l_cascade.setOuter(l_outer);
+
+    constexpr double ENABLE_AT = 0.3;
+    SensorData l_data = l_simulation.sample();
+    float l_previous = 0.0f;
+    float l_enableSetpoint = NAN;
+    float l_speedAtEnable = 0.0f;
+    double l_largestStep = 0.0;
+    int l_steps = static_cast<int>(15.0 / p_plant.period);
+    int l_enableStep = static_cast<int>(ENABLE_AT / p_plant.period);
+    for (int i = 0; i < l_steps; i++) {
+        if (i == l_enableStep) {
+            l_outer.enabled = true;
+            l_cascade.setOuter(l_outer);
+            l_speedAtEnable = l_data.leftWheelSpeed;
+        }
+        float l_command = l_cascade.update(l_data);
+        if (i == l_enableStep) {
+            l_enableSetpoint = l_cascade.target();
+        } else if (i > l_enableStep) {
+            l_largestStep = std::max(l_largestStep, std::fabs(static_cast<double>(l_cascade.target() - l_previous)));
+        }
+        l_previous = l_cascade.target();
+        l_data = l_simulation.step(l_command);
+        trace("bumpless", (i + 1) * p_plant.period, l_data, l_cascade.target(), l_command);
+    }
+
+    double l_naiveStep = std::min(std::fabs(static_cast<double>(l_outer.kp * l_speedAtEnable)), static_cast<double>(l_outer.maxTilt));
+    std::printf("  wheel speed at enable %.3f rad/s, an enable without preload would step the setpoint %.3f deg\n",
+                l_speedAtEnable, l_naiveStep);
+    bool l_ok = check("setpoint at enable", l_enableSetpoint, 0.0, 1e-6, "deg");
+    l_ok = check("largest setpoint step", l_largestStep, 0.0, l_naiveStep, "deg") && l_ok;
+    l_ok = check("wheel speed after", l_data.leftWheelSpeed, 0.0, 0.05, "rad/s") && l_ok;
+    return l_ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        g_trace = std::fopen(argv[1], "w");
+        if (!g_trace) {
+            std::printf("cannot open %s\n", argv[1]);
+            return 1;
+        }
+        std::fprintf(g_trace, "case,time,pitch,setpoint,wheel_speed,wheel_angle,command\n");
+    }
+
+    Plant l_plant;
+    l_plant.offset = 1.5;
+
+    bool l_ok = checkConvergence("Speed loop", l_plant, outerConfig(), 15.0, false);
+    std::printf("\n");
+
+    VelocityLoopConfig l_hold = outerConfig();
+    l_hold.positionKp = 0.2f;
+    l_ok = checkConvergence("Position hold", l_plant, l_hold, 15.0, true) && l_ok;
+    std::printf("\n");
+
+    VelocityLoopConfig l_moving = outerConfig();
+    l_moving.targetSpeed = 5.0f;
+    l_ok = checkConvergence("Speed target", l_plant, l_moving, 15.0, false) && l_ok;
+    std::printf("\n");
+
+    l_ok = checkBumpless(l_plant) && l_ok;
+
+    if (g_trace) {
+        std::fclose(g_trace);
+    }
+    return l_ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// Load test of the telemetry WebSocket with several concurrent clients.
+//
+// Build: g++ -std=c++17 -O2 -Imain -o ws_load_test tools/ws_load_test.cpp main/TelemetryFrame.cpp
+// Usage: ./ws_load_test host[:port] [clients=4] [rate_hz=50] [seconds=10] [format=json|binary|binary16]
+//                      [path=/ws/telemetry]
+//   e.g. ./ws_load_test 192.168.4.1 clients=4 rate_hz=100
+//
+// Opens the clients at once, each asking for rate_hz, and reports per client the frames
+// received, the achieved rate, the worst gap between frames and the telemetry timestamps
+// that were repeated. Binary frames are decoded with main/TelemetryFrame.cpp. A client that
+// is refused (more than the server's client limit) is reported as such.
+
+#include "include/TelemetryFrame.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Client {
+    int fd = -1;
+    bool open = false;
+    std::string buffer;
+    long frames = 0;
+    long bytes = 0;
+    long repeated = 0;
+    long long lastTimestamp = -1;
+    double maxGapMs = 0.0;
+    Clock::time_point lastFrame;
+};
+
+int connectTo(const std::string& p_host, const std::string& p_port) {
+    addrinfo l_hints {};
+    l_hints.ai_family = AF_INET;
+    l_hints.ai_socktype = SOCK_STREAM;
+    addrinfo* l_result = nullptr;
+    if (getaddrinfo(p_host.c_str(), p_port.c_str(), &l_hints, &l_result) != 0) {
+        return -1;
+    }
+    int l_fd = socket(l_result->ai_family, l_result->ai_socktype, l_result->ai_protocol);
+    if (l_fd >= 0 && connect(l_fd, l_result->ai_addr, l_result->ai_addrlen) != 0) {
+        close(l_fd);
+        l_fd = -1;
+    }
+    freeaddrinfo(l_result);
+    return l_fd;
+}
+
+// Blocking handshake, the accept key is not verified, this is a load test and not a conformance test
+bool handshake(Client& p_client, const std::string& p_host, const std::string& p_target) {
+    std::string l_request = "GET " + p_target + " HTTP/1.1\r\nHost: " + p_host +
+                            "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (send(p_client.fd, l_request.data(), l_request.size(), 0) != static_cast<ssize_t>(l_request.size())) {
+        return false;
+    }
+    char l_chunk[512];
+    while (p_client.buffer.find("\r\n\r\n") == std::string::npos) {
+        ssize_t l_received = recv(p_client.fd, l_chunk, sizeof(l_chunk), 0);
+        if (l_received <= 0) return false;
+        p_client.buffer.append(l_chunk, l_received);
+    }
+    if (p_client.buffer.compare(0, 12, "HTTP/1.1 101") != 0) {
+        return false;
+    }
+    // Frames may have arrived right behind the response
+    p_client.buffer.erase(0, p_client.buffer.find("\r\n\r\n") + 4);
+    return true;
+}
+
+// Client to server frames must be masked, the mask itself can be anything
+void sendText(int p_fd, const std::string& p_text) {
+    std::string l_frame;
+    l_frame += static_cast<char>(0x81);
+    l_frame += static_cast<char>(0x80 | p_text.size());
+    const unsigned char l_mask[4] = {0x12, 0x34, 0x56, 0x78};
+    l_frame.append(reinterpret_cast<const char*>(l_mask), 4);
+    for (size_t i = 0; i < p_text.size(); i++) l_frame += static_cast<char>(p_text[i] ^ l_mask[i % 4]);
+    send(p_fd, l_frame.data(), l_frame.size(), 0);
+}
+
+void onFrame(Client& p_client, bool p_binary, const char* p_payload, size_t p_length) {
+    auto l_now = Clock::now();
+    if (p_client.frames > 0) {
+        double l_gap = std::chrono::duration<double, std::milli>(l_now - p_client.lastFrame).count();
+        p_client.maxGapMs = std::max(p_client.maxGapMs, l_gap);
+    }
+    p_client.lastFrame = l_now;
+    p_client.frames++;
+    p_client.bytes += p_length;
+
+    long long l_timestamp = -1;
+    if (p_binary) {
+        TelemetryFrame l_frame;
+        if (TelemetryCodec::decode(reinterpret_cast<const uint8_t*>(p_payload), p_length, l_frame)) {
+            l_timestamp = l_frame.timestamp;
+        }
+    } else {
+        std::string l_text(p_payload, p_length);
+        size_t l_pos = l_text.find("\"timestamp\":");
+        if (l_pos != std::string::npos) l_timestamp = std::strtoll(l_text.c_str() + l_pos + 12, nullptr, 10);
+    }
+    if (l_timestamp >= 0) {
+        if (l_timestamp == p_client.lastTimestamp) p_client.repeated++;
+        p_client.lastTimestamp = l_timestamp;
+    }
+}
+
+// Consumes every complete frame in the buffer, returns false on a close frame
+bool parseFrames(Client& p_client) {
+    std::string& l_buffer = p_client.buffer;
+    while (l_buffer.size() >= 2) {
+        unsigned char l_opcode = l_buffer[0] & 0x0F;
+        size_t l_length = l_buffer[1] & 0x7F;
+        size_t l_header = 2;
+        if (l_length == 126) {
+            if (l_buffer.size() < 4) return true;
+            l_length = (static_cast<unsigned char>(l_buffer[2]) << 8) | static_cast<unsigned char>(l_buffer[3]);
+            l_header = 4;
+        } else if (l_length == 127) {
+            if (l_buffer.size() < 10) return true;
+            l_length = 0;
+            for (int i = 0; i < 8; i++) l_length = (l_length << 8) | static_cast<unsigned char>(l_buffer[2 + i]);
+            l_header = 10;
+        }
+        if (l_buffer.size() < l_header + l_length) return true;
+
+        if (l_opcode == 0x8) return false;
+        if (l_opcode == 0x1 || l_opcode == 0x2) onFrame(p_client, l_opcode == 0x2, l_buffer.data() + l_header, l_length);
+        l_buffer.erase(0, l_header + l_length);
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s host[:port] [clients=4] [rate_hz=50] [seconds=10] [format=json] [path=/ws/telemetry]\n", argv[0]);
+        return 1;
+    }
+    std::string l_host = argv[1], l_port = "80";
+    size_t l_colon = l_host.find(':');
+    if (l_colon != std::string::npos) {
+        l_port = l_host.substr(l_colon + 1);
+        l_host = l_host.substr(0, l_colon);
+    }
+    int l_clients = 4, l_rate = 50;
+    double l_seconds = 10.0;
+    std::string l_path = "/ws/telemetry", l_format = "json";
+    for (int i = 2; i < argc; i++) {
+        if (std::strncmp(argv[i], "clients=", 8) == 0) l_clients = std::atoi(argv[i] + 8);
+        else if (std::strncmp(argv[i], "rate_hz=", 8) == 0) l_rate = std::atoi(argv[i] + 8);
+        else if (std::strncmp(argv[i], "seconds=", 8) == 0) l_seconds = std::atof(argv[i] + 8);
+        else if (std::strncmp(argv[i], "path=", 5) == 0) l_path = argv[i] + 5;
+        else if (std::strncmp(argv[i], "format=", 7) == 0) l_format = argv[i] + 7;
+        else {
+            std::fprintf(stderr, "bad argument '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Client> l_pool(std::max(l_clients, 1));
+    std::string l_target = l_path + "?rate_hz=" + std::to_string(l_rate) + "&format=" + l_format;
+    for (size_t i = 0; i < l_pool.size(); i++) {
+        Client& l_client = l_pool[i];
+        l_client.fd = connectTo(l_host, l_port);
+        l_client.open = l_client.fd >= 0 && handshake(l_client, l_host, l_target);
+        if (!l_client.open) {
+            std::printf("client %zu: refused\n", i);
+            continue;
+        }
+        // Exercise the in-band rate change too, with the same rate so the numbers stay comparable
+        sendText(l_client.fd, "{\"rate_hz\":" + std::to_string(l_rate) + "}");
+    }
+
+    auto l_start = Clock::now();
+    auto l_end = l_start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(l_seconds));
+    std::vector<pollfd> l_fds;
+    char l_chunk[4096];
+    while (Clock::now() < l_end) {
+        l_fds.clear();
+        for (Client& l_client : l_pool) {
+            if (l_client.open) l_fds.push_back({l_client.fd, POLLIN, 0});
+        }
+        if (l_fds.empty()) break;
+        if (poll(l_fds.data(), l_fds.size(), 100) <= 0) continue;
+
+        for (const pollfd& l_entry : l_fds) {
+            if (!(l_entry.revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Client& l_client = *std::find_if(l_pool.begin(), l_pool.end(), [&](const Client& c) { return c.fd == l_entry.fd; });
+            ssize_t l_received = recv(l_client.fd, l_chunk, sizeof(l_chunk), 0);
+            if (l_received <= 0) {
+                l_client.open = false;
+                continue;
+            }
+            l_client.buffer.append(l_chunk, l_received);
+            if (!parseFrames(l_client)) l_client.open = false;
+        }
+    }
+    double l_elapsed = std::chrono::duration<double>(Clock::now() - l_start).count();
+
+    std::printf("\n%6s %8s %10s %10s %12s %10s %s\n", "client", "frames", "rate_hz", "kB/s", "max_gap_ms", "repeated", "");
+    long l_total = 0;
+    for (size_t i = 0; i < l_pool.size(); i++) {
+        const Client& l_client = l_pool[i];
+        if (l_client.fd < 0) continue;
+        std::printf("%6zu %8ld %10.1f %10.2f %12.1f %10ld %s\n", i, l_client.frames, l_client.frames / l_elapsed,
+                    l_client.bytes / l_elapsed / 1024.0, l_client.maxGapMs, l_client.repeated,
+                    l_client.open ? "" : "(closed)");
+        l_total += l_client.frames;
+        close(l_client.fd);
+    }
+    std::printf("\n%ld %s frames in %.1f s over %zu clients, requested %d Hz each\n", l_total, l_format.c_str(), l_elapsed,
+                l_pool.size(), l_rate);
+    return 0;
+}